@@ -0,0 +1,463 @@
+#ifndef K_CV_BITMAPPACKED_H
+#define K_CV_BITMAPPACKED_H
+
+#include "Bitmap.h"
+#include "ImageChannel.h"
+#include "../geo/Point2.h"
+#include "../Assertions.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+namespace K {
+
+	/** one horizontal run of set pixels [x0:x1[ within row y */
+	struct BitmapRun {
+
+		/** the run's row */
+		int y;
+
+		/** the first set pixel */
+		int x0;
+
+		/** the pixel behind the last set one */
+		int x1;
+
+		/** the connected component the run belongs to */
+		int label;
+
+		/** ctor */
+		BitmapRun(const int y, const int x0, const int x1) : y(y), x0(x0), x1(x1), label(-1) {;}
+
+	};
+
+	/**
+	 * binary image (yes/no) packed into 64-bit words.
+	 *
+	 * each row is padded to a multiple of 64 pixels, pixel x of a row
+	 * is bit (x % 64) within word (x / 64). padding bits are always zero.
+	 *
+	 * this way boolean operations, counting, dilation/erosion and the
+	 * extraction of runs (for connected components) process 64 pixels
+	 * at once, instead of one pixel (and one branch) after another.
+	 */
+	class BitmapPacked {
+
+	private:
+
+		/** the bitmap's width */
+		int width;
+
+		/** the bitmap's height */
+		int height;
+
+		/** number of 64-bit words per row */
+		int wordsPerRow;
+
+		/** the packed pixels */
+		std::vector<uint64_t> words;
+
+	public:
+
+		/** empty ctor */
+		BitmapPacked() : width(0), height(0), wordsPerRow(0) {;}
+
+		/** ctor with image size. all pixels are cleared */
+		BitmapPacked(const int w, const int h) : width(w), height(h), wordsPerRow((w+63)/64), words(wordsPerRow*h, 0) {;}
+
+		/** ctor from image. all pixels above the threshold are set */
+		BitmapPacked(const ImageChannel& img, const float threshold = 0.5f) : BitmapPacked(img.getWidth(), img.getHeight()) {
+			for (int y = 0; y < height; ++y) {
+				const float* src = img.getData() + y*width;
+				uint64_t* row = getRow(y);
+				for (int x = 0; x < width; ++x) {
+					row[x >> 6] |= ((uint64_t)(src[x] > threshold)) << (x & 63);
+				}
+			}
+		}
+
+		/** ctor from an unpacked bitmap */
+		explicit BitmapPacked(const Bitmap& bmp) : BitmapPacked(bmp.getWidth(), bmp.getHeight()) {
+			for (int y = 0; y < height; ++y) {
+				for (int x = 0; x < width; ++x) {
+					if (bmp.isSet(x,y)) {set(x,y);}
+				}
+			}
+		}
+
+
+		/** get the bitmap's width */
+		int getWidth() const {return width;}
+
+		/** get the bitmap's height */
+		int getHeight() const {return height;}
+
+		/** get the number of 64-bit words per row */
+		int getWordsPerRow() const {return wordsPerRow;}
+
+		/** get the words of the given row */
+		uint64_t* getRow(const int y) {return words.data() + y*wordsPerRow;}
+
+		/** get the words of the given row */
+		const uint64_t* getRow(const int y) const {return words.data() + y*wordsPerRow;}
+
+
+		void set(const Point2i p)					{set(p.x, p.y);}
+		void set(const int x, const int y)			{getRow(y)[x >> 6] |= bit(x);}
+
+		void clear(const Point2i p)					{clear(p.x, p.y);}
+		void clear(const int x, const int y)		{getRow(y)[x >> 6] &= ~bit(x);}
+
+		bool isSet(const Point2i p) const			{return isSet(p.x, p.y);}
+		bool isSet(const int x, const int y) const	{return (getRow(y)[x >> 6] & bit(x)) != 0;}
+
+		/** set all pixels */
+		void setAll() {
+			std::fill(words.begin(), words.end(), ~(uint64_t)0);
+			maskPadding();
+		}
+
+		/** clear all pixels */
+		void clearAll() {
+			std::fill(words.begin(), words.end(), 0);
+		}
+
+		/** invert all pixels */
+		void invert() {
+			for (uint64_t& w : words) {w = ~w;}
+			maskPadding();
+		}
+
+		/** get the number of set pixels */
+		int count() const {
+			int cnt = 0;
+			for (const uint64_t w : words) {cnt += popcount(w);}
+			return cnt;
+		}
+
+		/** get the number of set pixels within the given row */
+		int count(const int y) const {
+			int cnt = 0;
+			const uint64_t* row = getRow(y);
+			for (int i = 0; i < wordsPerRow; ++i) {cnt += popcount(row[i]);}
+			return cnt;
+		}
+
+		BitmapPacked& operator |= (const BitmapPacked& o) {
+			assertSameSize(o);
+			for (size_t i = 0; i < words.size(); ++i) {words[i] |= o.words[i];}
+			return *this;
+		}
+
+		BitmapPacked& operator &= (const BitmapPacked& o) {
+			assertSameSize(o);
+			for (size_t i = 0; i < words.size(); ++i) {words[i] &= o.words[i];}
+			return *this;
+		}
+
+		BitmapPacked& operator ^= (const BitmapPacked& o) {
+			assertSameSize(o);
+			for (size_t i = 0; i < words.size(); ++i) {words[i] ^= o.words[i];}
+			return *this;
+		}
+
+		bool operator == (const BitmapPacked& o) const {
+			return width == o.width && height == o.height && words == o.words;
+		}
+
+		bool operator != (const BitmapPacked& o) const {
+			return !(*this == o);
+		}
+
+
+		/** convert to an unpacked bitmap */
+		Bitmap toBitmap() const {
+			Bitmap bmp(width, height);
+			for (const BitmapRun& r : getRuns()) {
+				for (int x = r.x0; x < r.x1; ++x) {bmp.set(x, r.y);}
+			}
+			return bmp;
+		}
+
+		/** convert to an image using the given values for set and cleared pixels */
+		ImageChannel toImage(const float valSet = 1.0f, const float valClear = 0.0f) const {
+			ImageChannel img(width, height);
+			for (int y = 0; y < height; ++y) {
+				float* dst = img.getData() + y*width;
+				const uint64_t* row = getRow(y);
+				for (int x = 0; x < width; ++x) {
+					dst[x] = (row[x >> 6] & bit(x)) ? (valSet) : (valClear);
+				}
+			}
+			return img;
+		}
+
+
+		/**
+		 * dilate the bitmap using a structuring element that is symmetric in x.
+		 * extents[dy+r] (with r = extents.size()/2) is the element's horizontal
+		 * half-width for the row-offset dy, or -1 if the row is not part of the element.
+		 * pixels outside of the bitmap count as cleared.
+		 */
+		BitmapPacked dilate(const std::vector<int>& extents) const {
+
+			_assertTrue(extents.size() % 2 == 1, "the number of extents must be odd");
+
+			const int r = (int) extents.size() / 2;
+			BitmapPacked out(width, height);
+
+			#pragma omp parallel
+			{
+
+				// per-thread buffers for one horizontally dilated row
+				std::vector<uint64_t> tmp1(wordsPerRow);
+				std::vector<uint64_t> tmp2(wordsPerRow);
+
+				#pragma omp for
+				for (int y = 0; y < height; ++y) {
+					uint64_t* dst = out.getRow(y);
+					for (int dy = -r; dy <= r; ++dy) {
+						const int a = extents[dy+r];
+						const int ys = y - dy;
+						if (a < 0 || ys < 0 || ys >= height) {continue;}
+						dilateRow(getRow(ys), a, tmp1.data(), tmp2.data());
+						for (int i = 0; i < wordsPerRow; ++i) {dst[i] |= tmp1[i];}
+					}
+				}
+
+			}
+
+			out.maskPadding();
+			return out;
+
+		}
+
+		/**
+		 * erode the bitmap using the given structuring element (see dilate()).
+		 * pixels outside of the bitmap count as set, hence set pixels at the edges remain
+		 */
+		BitmapPacked erode(const std::vector<int>& extents) const {
+			BitmapPacked inv = *this;
+			inv.invert();
+			BitmapPacked out = inv.dilate(std::vector<int>(extents.rbegin(), extents.rend()));
+			out.invert();
+			return out;
+		}
+
+		/** dilate using a (2r+1)x(2r+1) square */
+		BitmapPacked dilateSquare(const int r) const {
+			return dilate(std::vector<int>(2*r+1, r));
+		}
+
+		/** dilate using a diamond (all pixels with |dx|+|dy| <= r) */
+		BitmapPacked dilateDiamond(const int r) const {
+			return dilate(getDiamond(r));
+		}
+
+		/** erode using a (2r+1)x(2r+1) square */
+		BitmapPacked erodeSquare(const int r) const {
+			return erode(std::vector<int>(2*r+1, r));
+		}
+
+		/** erode using a diamond (all pixels with |dx|+|dy| <= r) */
+		BitmapPacked erodeDiamond(const int r) const {
+			return erode(getDiamond(r));
+		}
+
+
+		/** get all runs of set pixels, row by row, from left to right */
+		std::vector<BitmapRun> getRuns() const {
+			std::vector<BitmapRun> runs;
+			for (int y = 0; y < height; ++y) {addRuns(y, runs);}
+			return runs;
+		}
+
+		/**
+		 * label all 8-connected components of set pixels.
+		 * the runs of each row are connected to the overlapping runs of the previous
+		 * row using union-find, thus no per-pixel flood-fill (and no stack) is needed.
+		 * @param runs all runs of set pixels, with their label [0:n[ (ordered by the first run)
+		 * @return the number of components n
+		 */
+		int getComponents(std::vector<BitmapRun>& runs) const {
+
+			runs.clear();
+			std::vector<int> parent;
+
+			size_t prevStart = 0;
+			size_t prevEnd = 0;
+
+			for (int y = 0; y < height; ++y) {
+
+				const size_t curStart = runs.size();
+				addRuns(y, runs);
+
+				// each new run is its own component, until connected to the previous row
+				size_t j = prevStart;
+				for (size_t i = curStart; i < runs.size(); ++i) {
+					parent.push_back((int)i);
+					const BitmapRun& cur = runs[i];
+					// skip previous runs ending before the current one (8-connected: touching diagonally suffices)
+					while (j < prevEnd && runs[j].x1 < cur.x0) {++j;}
+					for (size_t k = j; k < prevEnd && runs[k].x0 <= cur.x1; ++k) {
+						unite(parent, (int)i, (int)k);
+					}
+				}
+
+				prevStart = curStart;
+				prevEnd = runs.size();
+
+			}
+
+			// resolve the final labels [0:n[ in order of appearance
+			int cnt = 0;
+			std::vector<int> labels(runs.size(), -1);
+			for (size_t i = 0; i < runs.size(); ++i) {
+				const int root = find(parent, (int)i);
+				if (labels[root] < 0) {labels[root] = cnt++;}
+				runs[i].label = labels[root];
+			}
+
+			return cnt;
+
+		}
+
+		/** get the number of set bits within the given word */
+		static inline int popcount(const uint64_t w) {
+#if defined(__GNUC__)
+			return __builtin_popcountll(w);
+#else
+			uint64_t v = w - ((w >> 1) & 0x5555555555555555ull);
+			v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+			v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+			return (int) ((v * 0x0101010101010101ull) >> 56);
+#endif
+		}
+
+		/** get the index of the lowest set bit within the given (non-zero) word */
+		static inline int ctz(const uint64_t w) {
+#if defined(__GNUC__)
+			return __builtin_ctzll(w);
+#else
+			int i = 0;
+			while (!(w & ((uint64_t)1 << i))) {++i;}
+			return i;
+#endif
+		}
+
+		/**
+		 * dst[] |= src[] shifted by s pixels (s > 0: towards larger x, s < 0: towards smaller x).
+		 * both rows contain n words and must not overlap
+		 */
+		static inline void orShifted(uint64_t* dst, const uint64_t* src, const int n, const int s) {
+			const int q = std::abs(s) / 64;
+			const int b = std::abs(s) % 64;
+			if (s >= 0) {
+				for (int i = q; i < n; ++i) {
+					uint64_t v = src[i-q] << b;
+					if (b && i-q-1 >= 0) {v |= src[i-q-1] >> (64-b);}
+					dst[i] |= v;
+				}
+			} else {
+				for (int i = 0; i < n-q; ++i) {
+					uint64_t v = src[i+q] >> b;
+					if (b && i+q+1 < n) {v |= src[i+q+1] << (64-b);}
+					dst[i] |= v;
+				}
+			}
+		}
+
+	private:
+
+		/** the bit for pixel x within its word */
+		static inline uint64_t bit(const int x) {return (uint64_t)1 << (x & 63);}
+
+		/** the structuring element for a diamond of radius r */
+		static std::vector<int> getDiamond(const int r) {
+			std::vector<int> ext(2*r+1);
+			for (int dy = -r; dy <= r; ++dy) {ext[dy+r] = r - std::abs(dy);}
+			return ext;
+		}
+
+		/** ensure the padding bits of each row are zero */
+		void maskPadding() {
+			const int rem = width % 64;
+			if (rem == 0) {return;}
+			const uint64_t mask = (((uint64_t)1) << rem) - 1;
+			for (int y = 0; y < height; ++y) {getRow(y)[wordsPerRow-1] &= mask;}
+		}
+
+		/**
+		 * dilate one row horizontally by +/- a pixels into out, using tmp as scratch.
+		 * uses log2(a) shift steps by doubling the already covered range
+		 */
+		void dilateRow(const uint64_t* src, const int a, uint64_t* out, uint64_t* tmp) const {
+			std::copy(src, src + wordsPerRow, out);
+			int covered = 0;
+			while (covered < a) {
+				const int s = std::min(covered + 1, a - covered);
+				std::copy(out, out + wordsPerRow, tmp);
+				orShifted(out, tmp, wordsPerRow, +s);
+				orShifted(out, tmp, wordsPerRow, -s);
+				covered += s;
+			}
+		}
+
+		/** append all runs of row y */
+		void addRuns(const int y, std::vector<BitmapRun>& runs) const {
+
+			const uint64_t* row = getRow(y);
+			int x = 0;
+
+			while (x < width) {
+
+				// find the next set pixel
+				const int x0 = findNext(row, x, false);
+				if (x0 >= width) {break;}
+
+				// find the next cleared pixel
+				const int x1 = findNext(row, x0, true);
+				runs.push_back(BitmapRun(y, x0, x1));
+				x = x1;
+
+			}
+
+		}
+
+		/** find the first pixel >= x that is set (inverted = false) or cleared (inverted = true). returns width if there is none */
+		int findNext(const uint64_t* row, const int x, const bool inverted) const {
+			int i = x >> 6;
+			uint64_t w = (inverted ? ~row[i] : row[i]) & (~(uint64_t)0 << (x & 63));
+			while (true) {
+				if (w) {return std::min(width, i*64 + ctz(w));}
+				if (++i >= wordsPerRow) {return width;}
+				w = inverted ? ~row[i] : row[i];
+			}
+		}
+
+		static int find(std::vector<int>& parent, int i) {
+			while (parent[i] != i) {
+				parent[i] = parent[parent[i]];
+				i = parent[i];
+			}
+			return i;
+		}
+
+		static void unite(std::vector<int>& parent, const int a, const int b) {
+			const int ra = find(parent, a);
+			const int rb = find(parent, b);
+			if (ra < rb) {parent[rb] = ra;} else if (rb < ra) {parent[ra] = rb;}
+		}
+
+		void assertSameSize(const BitmapPacked& o) const {
+			_assertEqual(width, o.width, "width of both bitmaps differs");
+			_assertEqual(height, o.height, "height of both bitmaps differs");
+		}
+
+	};
+
+}
+
+#endif // K_CV_BITMAPPACKED_H
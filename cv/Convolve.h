@@ -3,6 +3,7 @@
 
 #include "ImageChannel.h"
 #include "Kernel.h"
+#include "ConvolveSeparable.h"
 
 #include <cmath>
 
@@ -17,8 +18,40 @@ namespace K {
 		 * returns a newly created image.
 		 */
 		static ImageChannel run(const ImageChannel& src, const Kernel& k) {
-
 			ImageChannel dst(src.getWidth(), src.getHeight());
+			runGeneric(ConstImageView(src), k, ImageView(dst));
+			return dst;
+		}
+
+		/**
+		 * convolve the given image with the provided kernel into the (already allocated) dst.
+		 * separable kernels use the faster ConvolveSeparable, all others the generic convolution.
+		 */
+		static void run(const ImageChannel& src, const Kernel& k, ImageChannel& dst) {
+			run(ConstImageView(src), k, ImageView(dst));
+		}
+
+		/**
+		 * convolve the given src view with the provided kernel into the dst view of the same size.
+		 * separable kernels use the faster ConvolveSeparable, all others the generic convolution.
+		 */
+		static void run(const ConstImageView& src, const Kernel& k, const ImageView& dst) {
+			Kernel kH;
+			Kernel kV;
+			if (k.separate(kH, kV)) {
+				ConvolveSeparable(kH, kV).run(src, dst);
+			} else {
+				runGeneric(src, k, dst);
+			}
+		}
+
+	private:
+
+		/** generic (non-separable) convolution of src into dst */
+		static void runGeneric(const ConstImageView& src, const Kernel& k, const ImageView& dst) {
+
+			_assertEqual(src.getWidth(), dst.getWidth(), "width of src and dst differs");
+			_assertEqual(src.getHeight(), dst.getHeight(), "height of src and dst differs");
 
 			#pragma omp parallel for
 			for (int y = 0; y < src.getHeight(); ++y) {
@@ -57,8 +90,6 @@ namespace K {
 				}
 			}
 
-			return dst;
-
 		}
 
 
@@ -0,0 +1,202 @@
+#ifndef K_CV_CONVOLVESEPARABLE_H
+#define K_CV_CONVOLVESEPARABLE_H
+
+#include "ImageChannel.h"
+#include "Kernel.h"
+#include "../Assertions.h"
+#include "../Exception.h"
+
+#include <vector>
+#include <algorithm>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace K {
+
+	/**
+	 * convolution using a separable kernel (2x1D).
+	 *
+	 * the result equals Convolve::run() with the corresponding 2D kernel,
+	 * including the normalization of edge pixels using the sum of all
+	 * kernel values that are within the image.
+	 *
+	 * each output row is processed in column-tiles: the vertical kernel
+	 * is applied to the needed source rows of the tile (into a small per-thread buffer)
+	 * and the horizontal kernel is applied to this buffer, writing the final
+	 * values into the destination. the interior of each row runs branch-free
+	 * using SSE/AVX (when available), edges are handled separately.
+	 */
+	class ConvolveSeparable {
+
+	private:
+
+		/** the horizontal kernel's values */
+		std::vector<float> kH;
+
+		/** the vertical kernel's values */
+		std::vector<float> kV;
+
+		/** the horizontal kernel's center */
+		int oH;
+
+		/** the vertical kernel's center */
+		int oV;
+
+		/** number of destination pixels per column-tile */
+		static inline int getTileWidth() {return 2048;}
+
+	public:
+
+		/** ctor with horizontal and vertical 1D kernels (orientation of both does not matter) */
+		ConvolveSeparable(const Kernel& kH, const Kernel& kV) :
+			kH(kH.getData(), kH.getData() + kH.getWidth()*kH.getHeight()),
+			kV(kV.getData(), kV.getData() + kV.getWidth()*kV.getHeight()),
+			oH((int)this->kH.size()/2), oV((int)this->kV.size()/2) {
+			;
+		}
+
+		/** ctor with a 2D kernel. throws if the kernel is not separable */
+		ConvolveSeparable(const Kernel& k) : oH(k.getWidth()/2), oV(k.getHeight()/2) {
+			Kernel h;
+			Kernel v;
+			if (!k.separate(h, v)) {throw Exception("the given kernel is not separable");}
+			kH.assign(h.getData(), h.getData() + h.getWidth());
+			kV.assign(v.getData(), v.getData() + v.getHeight());
+		}
+
+		/** convolve the given image. returns a newly created image */
+		ImageChannel run(const ImageChannel& src) const {
+			ImageChannel dst(src.getWidth(), src.getHeight());
+			run(src, dst);
+			return dst;
+		}
+
+		/** convolve src into the (already allocated) dst. src and dst must not be the same image */
+		void run(const ImageChannel& src, ImageChannel& dst) const {
+			run(ConstImageView(src), ImageView(dst));
+		}
+
+		/** convolve the src view into the dst view of the same size. both must not overlap */
+		void run(const ConstImageView& src, const ImageView& dst) const {
+
+			_assertEqual(src.getWidth(), dst.getWidth(), "width of src and dst differs");
+			_assertEqual(src.getHeight(), dst.getHeight(), "height of src and dst differs");
+			_assertFalse(src.getData() == dst.getData(), "src and dst must not be the same image");
+
+			const int w = src.getWidth();
+			const int h = src.getHeight();
+			const int nH = (int) kH.size();
+			const int tileW = getTileWidth();
+
+			// normalization for all pixels within the image's interior
+			const float normH = 1.0f / getSum(kH, 0, nH);
+
+			#pragma omp parallel
+			{
+
+				// per-thread buffer for the vertically convolved part of one row-tile
+				std::vector<float> tmp(tileW + nH);
+
+				#pragma omp for
+				for (int y = 0; y < h; ++y) {
+
+					// vertical taps that are within the image, and their normalization
+					const int j0 = std::max(0, oV - y);
+					const int j1 = std::min((int)kV.size(), h + oV - y);
+					const float normV = 1.0f / getSum(kV, j0, j1);
+
+					float* dRow = dst.getData() + y*dst.getStride();
+
+					for (int x0 = 0; x0 < w; x0 += tileW) {
+
+						const int x1 = std::min(w, x0 + tileW);
+
+						// source columns needed for this tile
+						const int c0 = std::max(0, x0 - oH);
+						const int c1 = std::min(w, x1 + (nH - 1 - oH));
+
+						// vertical pass into the buffer
+						std::fill(tmp.begin(), tmp.begin() + (c1-c0), 0.0f);
+						for (int j = j0; j < j1; ++j) {
+							const float* sRow = src.getData() + (y + j - oV) * src.getStride();
+							madd(tmp.data(), sRow + c0, kV[j] * normV, c1-c0);
+						}
+
+						// the tile's interior: all horizontal taps are within the image
+						const int xa = std::max(x0, oH);
+						const int xb = std::min(x1, w - (nH - 1 - oH));
+
+						for (int x = x0; x < std::min(xa, x1); ++x) {dRow[x] = getEdgeH(tmp.data(), c0, x, w);}
+
+						if (xb > xa) {
+							std::fill(dRow + xa, dRow + xb, 0.0f);
+							for (int i = 0; i < nH; ++i) {
+								madd(dRow + xa, tmp.data() + (xa + i - oH - c0), kH[i] * normH, xb-xa);
+							}
+						}
+
+						for (int x = std::max(xa, xb); x < x1; ++x) {dRow[x] = getEdgeH(tmp.data(), c0, x, w);}
+
+					}
+
+				}
+
+			}
+
+		}
+
+	private:
+
+		/** horizontal convolution for one edge pixel, normalized by the in-image taps */
+		inline float getEdgeH(const float* tmp, const int c0, const int x, const int w) const {
+			const int i0 = std::max(0, oH - x);
+			const int i1 = std::min((int)kH.size(), w + oH - x);
+			float val = 0;
+			for (int i = i0; i < i1; ++i) {val += kH[i] * tmp[x + i - oH - c0];}
+			const float res = val / getSum(kH, i0, i1);
+			_assertNotNAN(res, "detected NaN");
+			return res;
+		}
+
+		/** sum of the kernel's values [i0:i1[ */
+		static inline float getSum(const std::vector<float>& k, const int i0, const int i1) {
+			float sum = 0;
+			for (int i = i0; i < i1; ++i) {sum += k[i];}
+			return sum;
+		}
+
+		/** dst[i] += src[i] * f for i in [0:n[ */
+		static inline void madd(float* dst, const float* src, const float f, const int n) {
+
+			int i = 0;
+
+#if defined(__AVX__)
+			const __m256 vf = _mm256_set1_ps(f);
+			for (; i <= n - 8; i += 8) {
+				const __m256 vs = _mm256_loadu_ps(src + i);
+				const __m256 vd = _mm256_loadu_ps(dst + i);
+				_mm256_storeu_ps(dst + i, _mm256_add_ps(vd, _mm256_mul_ps(vs, vf)));
+			}
+#endif
+
+#if defined(__SSE2__)
+			const __m128 vf4 = _mm_set1_ps(f);
+			for (; i <= n - 4; i += 4) {
+				const __m128 vs = _mm_loadu_ps(src + i);
+				const __m128 vd = _mm_loadu_ps(dst + i);
+				_mm_storeu_ps(dst + i, _mm_add_ps(vd, _mm_mul_ps(vs, vf4)));
+			}
+#endif
+
+			// remaining elements (or scalar fallback)
+			for (; i < n; ++i) {dst[i] += src[i] * f;}
+
+		}
+
+	};
+
+}
+
+#endif // K_CV_CONVOLVESEPARABLE_H
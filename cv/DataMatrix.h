@@ -6,6 +6,7 @@
 #include <functional>
 
 #include "../Assertions.h"
+#include "DataMatrixView.h"
 
 namespace K {
 
@@ -124,6 +125,16 @@ namespace K {
 			std::fill(data.begin(), data.end(), v);
 		}
 
+		/** get a (non-copying) view onto the given region */
+		DataMatrixView<T> getView(const int x, const int y, const int w, const int h) {
+			return DataMatrixView<T>(*this).getView(x, y, w, h);
+		}
+
+		/** get a (non-copying) read-only view onto the given region */
+		DataMatrixView<const T> getView(const int x, const int y, const int w, const int h) const {
+			return DataMatrixView<const T>(*this).getView(x, y, w, h);
+		}
+
 		/** debug output */
 		friend std::ostream& operator << (std::ostream& out, const DataMatrix& m) {
 			for (int y = 0; y < m.getHeight(); ++y) {
@@ -145,8 +156,8 @@ namespace K {
 			return true;
 		}
 
-		/** call the given function for each of the channels's pixels.*/
-		void forEach(std::function<void(const int, const int, const T)> exec) const {
+		/** call the given function void(x,y,value) for each of the channels's pixels.*/
+		template <typename Func> void forEach(Func exec) const {
 
 			// run function for each element
 			for (int y = 0; y < height; ++y) {
@@ -182,19 +193,6 @@ namespace K {
 		}
 
 
-		template <typename DM> DM operator - (const DM& o) {
-			DM copy = *((DM*)this);
-			copy -= o;
-			return copy;
-		}
-
-		template <typename DM> DM operator * (const float val) {
-			DM copy = *((DM*)this);
-			copy *= val;
-			return copy;
-		}
-
-
 
 	};
 
@@ -0,0 +1,154 @@
+#ifndef K_CV_DATAMATRIXVIEW_H
+#define K_CV_DATAMATRIXVIEW_H
+
+#include <string>
+#include <algorithm>
+#include <type_traits>
+
+#include "../Assertions.h"
+
+namespace K {
+
+	template <typename T> class DataMatrix;
+
+	/**
+	 * non-owning, strided view onto (a region of) 2D data, e.g. a DataMatrix.
+	 * the view does not copy anything: cropping or processing sub-regions
+	 * works directly on the underlying data, which must outlive the view.
+	 *
+	 * use DataMatrixView<const T> for read-only access.
+	 */
+	template <typename T> class DataMatrixView {
+
+	public:
+
+		static typename std::remove_const<T>::type scalar;
+
+	private:
+
+		/** the view's origin (x=0,y=0) within the underlying data */
+		T* data;
+
+		/** the view's width */
+		int width;
+
+		/** the view's height */
+		int height;
+
+		/** number of elements between two consecutive rows */
+		int stride;
+
+	public:
+
+		/** empty ctor */
+		DataMatrixView() : data(nullptr), width(0), height(0), stride(0) {
+			;
+		}
+
+		/** ctor with origin, size and stride */
+		DataMatrixView(T* data, const int width, const int height, const int stride) :
+			data(data), width(width), height(height), stride(stride) {
+			;
+		}
+
+		/** view onto the whole matrix */
+		DataMatrixView(DataMatrix<typename std::remove_const<T>::type>& m) :
+			data(m.getData()), width(m.getWidth()), height(m.getHeight()), stride(m.getWidth()) {
+			;
+		}
+
+		/** read-only view onto the whole matrix */
+		DataMatrixView(const DataMatrix<typename std::remove_const<T>::type>& m) :
+			data(m.getData()), width(m.getWidth()), height(m.getHeight()), stride(m.getWidth()) {
+			;
+		}
+
+		/** convert from a compatible view (e.g. writeable to read-only) */
+		template <typename U> DataMatrixView(const DataMatrixView<U>& o) :
+			data(o.getData()), width(o.getWidth()), height(o.getHeight()), stride(o.getStride()) {
+			;
+		}
+
+
+		/** get the view's width */
+		inline int getWidth() const {return width;}
+
+		/** get the view's height */
+		inline int getHeight() const {return height;}
+
+		/** get the number of elements between two consecutive rows */
+		inline int getStride() const {return stride;}
+
+		/** get the view's origin */
+		inline T* getData() const {return data;}
+
+		/** get the first element of the given row */
+		inline T* getRow(const int y) const {
+			_assertBetween(y, 0, getHeight()-1, "y out of bounds: " + std::to_string(y));
+			return data + y*stride;
+		}
+
+		/** are all rows consecutive in memory? */
+		inline bool isContiguous() const {return stride == width;}
+
+		/** get the value at (x,y) */
+		inline T& get(const int x, const int y) const {
+			_assertBetween(x, 0, getWidth()-1, "x out of bounds: " + std::to_string(x));
+			_assertBetween(y, 0, getHeight()-1, "y out of bounds: " + std::to_string(y));
+			return data[x + y*stride];
+		}
+
+		/** constant array access */
+		inline T& operator () (const int x, const int y) const {return get(x,y);}
+
+		/** set the value at (x,y) */
+		inline void set(const int x, const int y, const T v) const {
+			get(x,y) = v;
+		}
+
+		/** set all entries to the given value */
+		void setAll(const T v) const {
+			for (int y = 0; y < height; ++y) {
+				T* row = data + y*stride;
+				for (int x = 0; x < width; ++x) {row[x] = v;}
+			}
+		}
+
+		/** copy all entries into the given view of the same size */
+		void copyTo(const DataMatrixView<typename std::remove_const<T>::type>& dst) const {
+			_assertEqual(getWidth(), dst.getWidth(), "width differs");
+			_assertEqual(getHeight(), dst.getHeight(), "height differs");
+			for (int y = 0; y < height; ++y) {
+				const T* src = data + y*stride;
+				std::copy(src, src+width, dst.getData() + y*dst.getStride());
+			}
+		}
+
+		/** get a view onto a sub-region of this view */
+		DataMatrixView getView(const int x, const int y, const int w, const int h) const {
+			_assertBetween(x, 0, getWidth(), "x out of bounds: " + std::to_string(x));
+			_assertBetween(y, 0, getHeight(), "y out of bounds: " + std::to_string(y));
+			_assertBetween(x+w, x, getWidth(), "width out of bounds: " + std::to_string(w));
+			_assertBetween(y+h, y, getHeight(), "height out of bounds: " + std::to_string(h));
+			return DataMatrixView(data + x + y*stride, w, h, stride);
+		}
+
+		/** call the given function for each of the view's elements */
+		template <typename Func> void forEach(Func exec) const {
+			for (int y = 0; y < height; ++y) {
+				const T* row = data + y*stride;
+				for (int x = 0; x < width; ++x) {exec(x, y, row[x]);}
+			}
+		}
+
+	};
+
+	/** writeable view onto an ImageChannel */
+	typedef DataMatrixView<float> ImageView;
+
+	/** read-only view onto an ImageChannel */
+	typedef DataMatrixView<const float> ConstImageView;
+
+}
+
+#endif // K_CV_DATAMATRIXVIEW_H
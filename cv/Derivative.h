@@ -13,49 +13,73 @@ namespace K {
 		/** derive the image in x direction */
 		static ImageChannel getX(const ImageChannel& img) {
 			ImageChannel out(img.getWidth(), img.getHeight());
-			out.zero();
-			for (int y = 0; y < img.getHeight(); ++y) {
-				for (int x = 0; x < img.getWidth() - 1; ++x) {
-					out.set(x,y, getX(img,x,y));
-				}
-			}
+			getX(ConstImageView(img), ImageView(out));
 			return out;
 		}
 
 		/** derive the image in y direction */
 		static ImageChannel getY(const ImageChannel& img) {
 			ImageChannel out(img.getWidth(), img.getHeight());
-			out.zero();
-			for (int y = 0; y < img.getHeight() - 1; ++y) {
-				for (int x = 0; x < img.getWidth(); ++x) {
-					out.set(x,y, getY(img,x,y));
-				}
-			}
+			getY(ConstImageView(img), ImageView(out));
 			return out;
 		}
 
 		/** derive the image in x direction */
 		static ImageChannel getXcen(const ImageChannel& img) {
 			ImageChannel out(img.getWidth(), img.getHeight());
-			out.zero();
-			for (int y = 0; y < img.getHeight(); ++y) {
-				for (int x = 1; x < img.getWidth() - 1; ++x) {
-					out.set(x,y, getXcen(img,x,y));
-				}
-			}
-			return std::move(out);
+			getXcen(ConstImageView(img), ImageView(out));
+			return out;
 		}
 
 		/** derive the image in y direction */
 		static ImageChannel getYcen(const ImageChannel& img) {
 			ImageChannel out(img.getWidth(), img.getHeight());
-			out.zero();
-			for (int y = 1; y < img.getHeight() - 1; ++y) {
-				for (int x = 0; x < img.getWidth(); ++x) {
-					out.set(x,y, getYcen(img,x,y));
+			getYcen(ConstImageView(img), ImageView(out));
+			return out;
+		}
+
+		/** derive the src view in x direction (x,x+1) into the dst view of the same size */
+		static void getX(const ConstImageView& src, const ImageView& dst) {
+			assertSameSize(src, dst);
+			dst.setAll(0);
+			for (int y = 0; y < src.getHeight(); ++y) {
+				for (int x = 0; x < src.getWidth() - 1; ++x) {
+					dst.set(x,y, getX(src,x,y));
+				}
+			}
+		}
+
+		/** derive the src view in y direction (y,y+1) into the dst view of the same size */
+		static void getY(const ConstImageView& src, const ImageView& dst) {
+			assertSameSize(src, dst);
+			dst.setAll(0);
+			for (int y = 0; y < src.getHeight() - 1; ++y) {
+				for (int x = 0; x < src.getWidth(); ++x) {
+					dst.set(x,y, getY(src,x,y));
+				}
+			}
+		}
+
+		/** derive the src view in x direction (x-1,x+1) into the dst view of the same size */
+		static void getXcen(const ConstImageView& src, const ImageView& dst) {
+			assertSameSize(src, dst);
+			dst.setAll(0);
+			for (int y = 0; y < src.getHeight(); ++y) {
+				for (int x = 1; x < src.getWidth() - 1; ++x) {
+					dst.set(x,y, getXcen(src,x,y));
+				}
+			}
+		}
+
+		/** derive the src view in y direction (y-1,y+1) into the dst view of the same size */
+		static void getYcen(const ConstImageView& src, const ImageView& dst) {
+			assertSameSize(src, dst);
+			dst.setAll(0);
+			for (int y = 1; y < src.getHeight() - 1; ++y) {
+				for (int x = 0; x < src.getWidth(); ++x) {
+					dst.set(x,y, getYcen(src,x,y));
 				}
 			}
-			return std::move(out);
 		}
 
 //		/** derive the image in xy direction */
@@ -112,6 +136,14 @@ namespace K {
 //			return (img.get(x+1,y+1) - img.get(x,y));
 //		}
 
+	private:
+
+		static inline void assertSameSize(const ConstImageView& src, const ImageView& dst) {
+			_assertEqual(src.getWidth(), dst.getWidth(), "width of src and dst differs");
+			_assertEqual(src.getHeight(), dst.getHeight(), "height of src and dst differs");
+			(void) src; (void) dst;
+		}
+
 	};
 
 }
@@ -3,6 +3,7 @@
 
 
 #include "DataMatrix.h"
+#include "ImageExpression.h"
 #include <functional>
 #include <algorithm>
 #include "../math/statistics/Statistics.h"
@@ -22,6 +23,27 @@ namespace K {
 		/** ctor without data */
 		ImageChannel(const int width, const int height) : DataMatrix(width, height) {;}
 
+		/** ctor evaluating the given expression, e.g. ImageChannel res = (1 - img) * k; */
+		template <typename E> ImageChannel(const ImageExpr<E>& e) : DataMatrix(e.getWidth(), e.getHeight()) {
+			assign(e.self());
+		}
+
+		/** evaluate the given expression into this image, e.g. res = (1 - img) * k; */
+		template <typename E> ImageChannel& operator = (const ImageExpr<E>& e) {
+			if (width != e.getWidth() || height != e.getHeight()) {
+				// evaluate first, the expression might reference this image
+				*this = ImageChannel(e);
+			} else {
+				assign(e.self());
+			}
+			return *this;
+		}
+
+		/** ctor with a (deep) copy of the given view's data */
+		explicit ImageChannel(const ConstImageView& view) : DataMatrix(view.getWidth(), view.getHeight()) {
+			view.copyTo(*this);
+		}
+
 
 
 
@@ -60,26 +82,27 @@ namespace K {
 			return stats;
 		}
 
-		/** call the given function for each of the channels's pixels.*/
-		void setEach(std::function<float(const int, const int)> func) {
+		/** set each of the channel's pixels to the result of the given function float(x,y) */
+		template <typename Func> void setEach(Func func) {
 
 			// run function for each element
 			for (int y = 0; y < height; ++y) {
+				float* row = &data[y*width];
 				for (int x = 0; x < width; ++x) {
-					set(x,y, func(x,y));
+					row[x] = (float) func(x,y);
 				}
 			}
 
 		}
 
-		/** call the given function for each of the channels's pixels.*/
-		void forEachModify(std::function<float(const int, const int, const float)> exec) {
+		/** replace each of the channel's pixels by the result of the given function float(x,y,value) */
+		template <typename Func> void forEachModify(Func exec) {
 
 			// run function for each element
 			for (int y = 0; y < height; ++y) {
+				float* row = &data[y*width];
 				for (int x = 0; x < width; ++x) {
-					const float val = exec(x, y, get(x,y));
-					set(x,y,val);
+					row[x] = (float) exec(x, y, row[x]);
 				}
 			}
 
@@ -101,27 +124,20 @@ namespace K {
 		}
 
 
-		friend K::ImageChannel operator - (const float val, const K::ImageChannel& img) {
-			K::ImageChannel copy = img;
-			for (int i = 0; i < (int) img.data.size(); ++i) { copy.data[i] = val - copy.data[i]; }
-//			copy.forEachModify(
-//				[val] (const int x, const int y, const float v) {(void)x; (void)y; return val-v;}
-//			);
-			return copy;
+		/** get a copy with all values made absolute (ImageExprRef(img).abs() is the lazy variant) */
+		ImageChannel abs() const {
+			return ImageChannel(ImageExprRef(*this).abs());
 		}
 
-		friend K::ImageChannel operator * (const K::ImageChannel& img, const float val) {
-			K::ImageChannel copy = img;
-			for (int i = 0; i < (int) img.data.size(); ++i) { copy.data[i] = copy.data[i] * val; }
-			return copy;
+		/**
+		 * apply the given function float(float) to each value (lazily evaluated expression).
+		 * the expression references this image, which must outlive it. not available for temporaries
+		 */
+		template <typename Func> ImageExprUnary<ImageExprRef, Func> map(Func func) const & {
+			return ImageExprRef(*this).map(func);
 		}
 
-		/** make all values absolute */
-		K::ImageChannel abs() const {
-			K::ImageChannel copy = *this;
-			for (int i = 0; i < (int) copy.data.size(); ++i) { copy.data[i] = std::abs(copy.data[i]); }
-			return copy;
-		}
+		template <typename Func> ImageExprUnary<ImageExprRef, Func> map(Func func) && = delete;
 
 		/** check whether the picture contains the given pixel */
 		bool contains(const int x, const int y) const {
@@ -134,6 +150,15 @@ namespace K {
 
 	private:
 
+		/** evaluate the expression (of the same size) into this image within one loop */
+		template <typename E> void assign(const E& e) {
+			_assertEqual(width, e.getWidth(), "width of the expression differs");
+			_assertEqual(height, e.getHeight(), "height of the expression differs");
+			float* dst = data.data();
+			const int numElems = width*height;
+			for (int i = 0; i < numElems; ++i) {dst[i] = e.eval(i);}
+		}
+
 		/** clamp the given value to [min:max] */
 		static inline int clamp(const int val, const int min, const int max) {
 			if (val < min) {return min;}
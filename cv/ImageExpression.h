@@ -0,0 +1,212 @@
+#ifndef K_CV_IMAGEEXPRESSION_H
+#define K_CV_IMAGEEXPRESSION_H
+
+#include <cmath>
+#include <type_traits>
+
+#include "DataMatrix.h"
+#include "../Assertions.h"
+
+namespace K {
+
+	/**
+	 * lazily evaluated, element-wise expressions on ImageChannels.
+	 *
+	 * operators on ImageChannels (e.g. (1 - img) * k) do not create temporary
+	 * images but a tree of expressions, that is evaluated within one single
+	 * loop when assigned to an ImageChannel:
+	 *
+	 *	ImageChannel res = (1 - img) * k;
+	 *	res = (imgA - imgB).abs() + 0.5f;
+	 *
+	 * expressions only reference the underlying images, which must thus
+	 * outlive the expression (assign it before the statement ends).
+	 */
+
+	class ImageChannel;
+	template <typename E, typename Func> class ImageExprUnary;
+	struct ImageExprAbs;
+	struct ImageExprSqrt;
+
+	/** tag for all expressions */
+	struct ImageExprBase {};
+
+	/** base-class for all expressions (CRTP) */
+	template <typename E> class ImageExpr : public ImageExprBase {
+
+	public:
+
+		/** element-wise absolute value */
+		ImageExprUnary<E, ImageExprAbs> abs() const {return ImageExprUnary<E, ImageExprAbs>(self(), ImageExprAbs());}
+
+		/** element-wise square root */
+		ImageExprUnary<E, ImageExprSqrt> sqrt() const {return ImageExprUnary<E, ImageExprSqrt>(self(), ImageExprSqrt());}
+
+		/** apply the given function float(float) to each element */
+		template <typename Func> ImageExprUnary<E, Func> map(Func func) const {return ImageExprUnary<E, Func>(self(), func);}
+
+		/** the expression's width (-1 for scalars) */
+		int getWidth() const {return self().getWidth();}
+
+		/** the expression's height (-1 for scalars) */
+		int getHeight() const {return self().getHeight();}
+
+		/** evaluate the expression for the given element-index */
+		float eval(const int idx) const {return self().eval(idx);}
+
+		const E& self() const {return static_cast<const E&>(*this);}
+
+	};
+
+	/** expression referencing an existing image */
+	class ImageExprRef : public ImageExpr<ImageExprRef> {
+
+	private:
+
+		const float* data;
+		int width;
+		int height;
+
+	public:
+
+		ImageExprRef(const DataMatrix<float>& img) : data(img.getData()), width(img.getWidth()), height(img.getHeight()) {;}
+
+		inline int getWidth() const {return width;}
+		inline int getHeight() const {return height;}
+		inline float eval(const int idx) const {return data[idx];}
+
+	};
+
+	/** expression for a constant value */
+	class ImageExprScalar : public ImageExpr<ImageExprScalar> {
+
+	private:
+
+		float val;
+
+	public:
+
+		ImageExprScalar(const float val) : val(val) {;}
+
+		inline int getWidth() const {return -1;}
+		inline int getHeight() const {return -1;}
+		inline float eval(const int idx) const {(void) idx; return val;}
+
+	};
+
+	/** expression applying a unary function to another expression */
+	template <typename E, typename Func> class ImageExprUnary : public ImageExpr<ImageExprUnary<E, Func>> {
+
+	private:
+
+		E e;
+		Func func;
+
+	public:
+
+		ImageExprUnary(const E& e, Func func) : e(e), func(func) {;}
+
+		inline int getWidth() const {return e.getWidth();}
+		inline int getHeight() const {return e.getHeight();}
+		inline float eval(const int idx) const {return func(e.eval(idx));}
+
+	};
+
+	/** expression combining two other expressions */
+	template <typename L, typename R, typename Op> class ImageExprBinary : public ImageExpr<ImageExprBinary<L, R, Op>> {
+
+	private:
+
+		L l;
+		R r;
+
+	public:
+
+		ImageExprBinary(const L& l, const R& r) : l(l), r(r) {
+			_assertTrue(l.getWidth() < 0 || r.getWidth() < 0 || l.getWidth() == r.getWidth(), "width of both operands differs");
+			_assertTrue(l.getHeight() < 0 || r.getHeight() < 0 || l.getHeight() == r.getHeight(), "height of both operands differs");
+		}
+
+		inline int getWidth() const {return (l.getWidth() < 0) ? (r.getWidth()) : (l.getWidth());}
+		inline int getHeight() const {return (l.getHeight() < 0) ? (r.getHeight()) : (l.getHeight());}
+		inline float eval(const int idx) const {return Op::get(l.eval(idx), r.eval(idx));}
+
+	};
+
+	struct ImageExprAdd {static inline float get(const float a, const float b) {return a + b;}};
+	struct ImageExprSub {static inline float get(const float a, const float b) {return a - b;}};
+	struct ImageExprMul {static inline float get(const float a, const float b) {return a * b;}};
+	struct ImageExprDiv {static inline float get(const float a, const float b) {return a / b;}};
+
+	struct ImageExprNeg {inline float operator () (const float v) const {return -v;}};
+	struct ImageExprAbs {inline float operator () (const float v) const {return std::abs(v);}};
+	struct ImageExprSqrt {inline float operator () (const float v) const {return std::sqrt(v);}};
+
+
+	/** map operands (images, expressions, scalars) to their expression type */
+	template <typename T, typename Enable = void> struct ImageExprOf {
+		static const bool valid = false;
+		static const bool image = false;
+	};
+
+	template <> struct ImageExprOf<ImageChannel> {
+		static const bool valid = true;
+		static const bool image = true;
+		typedef ImageExprRef type;
+		static inline type get(const DataMatrix<float>& img) {return type(img);}
+	};
+
+	template <typename T> struct ImageExprOf<T, typename std::enable_if<std::is_base_of<ImageExprBase, T>::value>::type> {
+		static const bool valid = true;
+		static const bool image = true;
+		typedef T type;
+		static inline const T& get(const T& e) {return e;}
+	};
+
+	template <typename T> struct ImageExprOf<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+		static const bool valid = true;
+		static const bool image = false;
+		typedef ImageExprScalar type;
+		static inline type get(const T val) {return type((float)val);}
+	};
+
+	/** the result-type of binary operators, only defined if both operands are images/expressions/scalars and at least one is no scalar */
+	template <bool Enable, typename A, typename B, typename Op> struct ImageExprBinaryOfImpl {};
+	template <typename A, typename B, typename Op> struct ImageExprBinaryOfImpl<true, A, B, Op> {
+		typedef ImageExprBinary<typename ImageExprOf<A>::type, typename ImageExprOf<B>::type, Op> type;
+	};
+	template <typename A, typename B, typename Op> struct ImageExprBinaryOf : ImageExprBinaryOfImpl<
+		ImageExprOf<A>::valid && ImageExprOf<B>::valid && (ImageExprOf<A>::image || ImageExprOf<B>::image), A, B, Op
+	> {};
+
+	/** the result-type of unary operators, only defined for images/expressions */
+	template <bool Enable, typename E, typename Func> struct ImageExprUnaryOfImpl {};
+	template <typename E, typename Func> struct ImageExprUnaryOfImpl<true, E, Func> {
+		typedef ImageExprUnary<typename ImageExprOf<E>::type, Func> type;
+	};
+	template <typename E, typename Func> struct ImageExprUnaryOf : ImageExprUnaryOfImpl<ImageExprOf<E>::image, E, Func> {};
+
+
+	template <typename A, typename B> typename ImageExprBinaryOf<A, B, ImageExprAdd>::type operator + (const A& a, const B& b) {
+		return typename ImageExprBinaryOf<A, B, ImageExprAdd>::type(ImageExprOf<A>::get(a), ImageExprOf<B>::get(b));
+	}
+
+	template <typename A, typename B> typename ImageExprBinaryOf<A, B, ImageExprSub>::type operator - (const A& a, const B& b) {
+		return typename ImageExprBinaryOf<A, B, ImageExprSub>::type(ImageExprOf<A>::get(a), ImageExprOf<B>::get(b));
+	}
+
+	template <typename A, typename B> typename ImageExprBinaryOf<A, B, ImageExprMul>::type operator * (const A& a, const B& b) {
+		return typename ImageExprBinaryOf<A, B, ImageExprMul>::type(ImageExprOf<A>::get(a), ImageExprOf<B>::get(b));
+	}
+
+	template <typename A, typename B> typename ImageExprBinaryOf<A, B, ImageExprDiv>::type operator / (const A& a, const B& b) {
+		return typename ImageExprBinaryOf<A, B, ImageExprDiv>::type(ImageExprOf<A>::get(a), ImageExprOf<B>::get(b));
+	}
+
+	template <typename E> typename ImageExprUnaryOf<E, ImageExprNeg>::type operator - (const E& e) {
+		return typename ImageExprUnaryOf<E, ImageExprNeg>::type(ImageExprOf<E>::get(e), ImageExprNeg());
+	}
+
+}
+
+#endif // K_CV_IMAGEEXPRESSION_H
@@ -2,11 +2,27 @@
 #define IMAGEPYRAMID_H
 
 #include <vector>
+#include <algorithm>
 #include "ImageChannel.h"
-#include "KernelFactory.h"
+#include "DataMatrixView.h"
+#include "../Assertions.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 namespace K {
 
+	/**
+	 * gaussian image pyramid.
+	 *
+	 * each layer is the previous one, blurred by the separable [1 4 6 4 1] / 16
+	 * binomial kernel and decimated by 2. at the edges, only the kernel values
+	 * within the image are used (and normalized).
+	 *
+	 * all layers are allocated once. update() refreshes the pyramid for a new
+	 * image (e.g. the next video frame) of the same size, without reallocating.
+	 */
 	class ImagePyramid {
 
 	private:
@@ -14,12 +30,32 @@ namespace K {
 		/** all layers of the pyramid */
 		std::vector<ImageChannel> layers;
 
+		/** the maximum number of layers (0 = until the layers' size drops below 1x1) */
+		int maxLayers;
+
 	public:
 
+		/** empty ctor */
+		explicit ImagePyramid(const int maxLayers = 0) : maxLayers(maxLayers) {;}
+
 		/** ctor */
-		ImagePyramid(ImageChannel& img) {
-			layers.push_back(img);
-			create();
+		ImagePyramid(const ImageChannel& img, const int maxLayers = 0) : maxLayers(maxLayers) {
+			update(img);
+		}
+
+		/** (re-)build the pyramid for the given image. existing layers are reused if the image's size did not change */
+		void update(const ImageChannel& img) {
+
+			allocate(img.getWidth(), img.getHeight());
+
+			// layer 0 is a copy of the input
+			std::copy(img.getData(), img.getData() + img.getWidth()*img.getHeight(), layers[0].getData());
+
+			// all other layers are derived from their predecessor
+			for (size_t i = 1; i < layers.size(); ++i) {
+				downsample(layers[i-1], layers[i]);
+			}
+
 		}
 
 		/** get the number of layers */
@@ -32,63 +68,220 @@ namespace K {
 			return layers[idx];
 		}
 
-	private:
+		/** get the idx-th layer */
+		const ImageChannel& get(const int idx) const {
+			return layers[idx];
+		}
 
-		void create() {
 
-			// start at layer 0
-			ImageChannel* prev = &layers[0];
+		/**
+		 * blur the src view with [1 4 6 4 1] / 16 and decimate it by 2 into dst.
+		 * dst must have the size (src.w/2) x (src.h/2) and must not overlap src.
+		 * dst(x,y) is centered at src(2x,2y)
+		 */
+		static void downsample(const ConstImageView& src, const ImageView& dst) {
 
-			const Kernel k = KernelFactory::gauss2D(1.0, 5);
+			const int sw = src.getWidth();
+			const int sh = src.getHeight();
+			const int dw = dst.getWidth();
+			const int dh = dst.getHeight();
 
-			while (true) {
+			_assertEqual(sw/2, dw, "dst must have half the width of src");
+			_assertEqual(sh/2, dh, "dst must have half the height of src");
 
-				// size for the current layer
-				const int curW = prev->getWidth() / 2;
-				const int curH = prev->getHeight() / 2;
+			#pragma omp parallel if (dw*dh > 128*128)
+			{
 
-				// done?
-				if (curW < 1 || curH < 1) {break;}
+				// per-thread buffers: vertically blurred source row, split into even and odd columns
+				std::vector<float> tmp(sw + 4);
+				std::vector<float> even((sw+1)/2 + 4);
+				std::vector<float> odd(sw/2 + 4);
 
-				// create the image for the next layer
-				ImageChannel cur(curW, curH);
+				#pragma omp for
+				for (int y = 0; y < dh; ++y) {
 
-				// render
-				for (int y = 0; y < curH; ++y) {
-					for (int x = 0; x < curW; ++x) {
+					// vertical pass: all source rows within the image, normalized
+					const int sy = 2*y;
+					const int j0 = std::max(0, 2 - sy);
+					const int j1 = std::min(5, sh - sy + 2);
+					float norm = 0;
+					for (int j = j0; j < j1; ++j) {norm += getWeight(j);}
 
-						float val = 0;	// convolved value
-						float sum = 0;	// sum of all used kernel values (for normalization)
-
-						auto lambda = [&] (const int kx, const int ky, const float kv) {
+					std::fill(tmp.begin(), tmp.begin() + sw, 0.0f);
+					for (int j = j0; j < j1; ++j) {
+						madd(tmp.data(), src.getRow(sy + j - 2), getWeight(j) / norm, sw);
+					}
 
-							const int ix = (x*2) + kx;			// translate between cur and previous layer (twice the size) + add window
-							const int iy = (y*2) + ky;			// translate between cur and previous layer (twice the size) + add window
+					// horizontal pass
+					deinterleave(tmp.data(), even.data(), odd.data(), sw);
+					float* dRow = dst.getRow(y);
 
-							// skip edges
-							if (ix < 0 || ix >= prev->getWidth())	{return;}
-							if (iy < 0 || iy >= prev->getHeight())	{return;}
+					// interior: all 5 taps within the row
+					const int x0 = std::min(dw, 1);
+					const int x1 = std::max(x0, (sw - 1) / 2);
+					for (int x = 0; x < x0; ++x) {dRow[x] = getEdgeH(tmp.data(), sw, x);}
+					blurDecimate(dRow, even.data(), odd.data(), x0, x1);
+					for (int x = x1; x < dw; ++x) {dRow[x] = getEdgeH(tmp.data(), sw, x);}
 
-							const float sv = prev->get(ix, iy);	// value from the current layer
-							val += kv*sv;						// update convolved value
-							sum += kv;							// update sum of used kernel values (for normalization)
+				}
 
-						};
+			}
 
-						// convolve
-						k.forEach(lambda);
+		}
 
-						// set
-						val /= sum;								// normalize
-						cur.set(x,y,val);
+		/**
+		 * expand the src view into the (larger) dst view using [1 4 6 4 1] / 16 (times 2 in each direction).
+		 * dst(2x,2y) is centered at src(x,y). at the edges, only values within src are used (and normalized).
+		 * this is the counterpart of downsample(), e.g. for laplacian pyramids.
+		 */
+		static void upsample(const ConstImageView& src, const ImageView& dst) {
+
+			const int sw = src.getWidth();
+			const int sh = src.getHeight();
+			const int dw = dst.getWidth();
+			const int dh = dst.getHeight();
+
+			_assertTrue(dw <= 2*sw+1 && dh <= 2*sh+1, "dst is too large for src");
+
+			#pragma omp parallel if (dw*dh > 128*128)
+			{
+
+				// per-thread buffer for the vertically expanded row
+				std::vector<float> tmp(sw);
+
+				#pragma omp for
+				for (int y = 0; y < dh; ++y) {
+
+					// vertical: source rows i with |2i - y| <= 2
+					std::fill(tmp.begin(), tmp.end(), 0.0f);
+					const int i0 = std::max(0, (y - 1) / 2);
+					const int i1 = std::min(sh - 1, (y + 2) / 2);
+					float norm = 0;
+					for (int i = i0; i <= i1; ++i) {norm += getWeight(2*i - y + 2);}
+					for (int i = i0; i <= i1; ++i) {
+						madd(tmp.data(), src.getRow(i), getWeight(2*i - y + 2) / norm, sw);
+					}
 
+					// horizontal
+					float* dRow = dst.getRow(y);
+					for (int x = 0; x < dw; ++x) {
+						const int k0 = std::max(0, (x - 1) / 2);
+						const int k1 = std::min(sw - 1, (x + 2) / 2);
+						float val = 0;
+						float sum = 0;
+						for (int k = k0; k <= k1; ++k) {
+							const float w = getWeight(2*k - x + 2);
+							val += w * tmp[k];
+							sum += w;
+						}
+						dRow[x] = val / sum;
 					}
+
 				}
 
-				// add and proceed
-				layers.push_back(cur);
-				prev = &layers[layers.size()-1];
+			}
+
+		}
+
+	private:
+
+		/** allocate all layers, if the size changed */
+		void allocate(const int w, const int h) {
+
+			if (!layers.empty() && layers[0].getWidth() == w && layers[0].getHeight() == h) {return;}
 
+			layers.clear();
+			layers.push_back(ImageChannel(w, h));
+
+			while (maxLayers <= 0 || (int) layers.size() < maxLayers) {
+				const int curW = layers.back().getWidth() / 2;
+				const int curH = layers.back().getHeight() / 2;
+				if (curW < 1 || curH < 1) {break;}
+				layers.push_back(ImageChannel(curW, curH));
+			}
+
+		}
+
+		/** the binomial kernel [1 4 6 4 1] / 16 */
+		static inline float getWeight(const int idx) {
+			static const float w[5] = {1.0f/16.0f, 4.0f/16.0f, 6.0f/16.0f, 4.0f/16.0f, 1.0f/16.0f};
+			return w[idx];
+		}
+
+		/** horizontal blur + decimation for one output pixel near the edges, normalized by the taps within the row */
+		static inline float getEdgeH(const float* row, const int sw, const int x) {
+			float val = 0;
+			float sum = 0;
+			for (int k = 0; k < 5; ++k) {
+				const int sx = 2*x + k - 2;
+				if (sx < 0 || sx >= sw) {continue;}
+				val += getWeight(k) * row[sx];
+				sum += getWeight(k);
+			}
+			return val / sum;
+		}
+
+		/** dst[i] += src[i] * f for i in [0:n[ */
+		static inline void madd(float* dst, const float* src, const float f, const int n) {
+
+			int i = 0;
+
+#if defined(__SSE2__)
+			const __m128 vf = _mm_set1_ps(f);
+			for (; i <= n - 4; i += 4) {
+				const __m128 vs = _mm_loadu_ps(src + i);
+				const __m128 vd = _mm_loadu_ps(dst + i);
+				_mm_storeu_ps(dst + i, _mm_add_ps(vd, _mm_mul_ps(vs, vf)));
+			}
+#endif
+
+			// remaining elements (or scalar fallback)
+			for (; i < n; ++i) {dst[i] += src[i] * f;}
+
+		}
+
+		/** split src[0:n[ into its even and odd elements */
+		static inline void deinterleave(const float* src, float* even, float* odd, const int n) {
+
+			int i = 0;
+
+#if defined(__SSE2__)
+			for (; i <= n - 8; i += 8) {
+				const __m128 a = _mm_loadu_ps(src + i);
+				const __m128 b = _mm_loadu_ps(src + i + 4);
+				_mm_storeu_ps(even + i/2, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0)));
+				_mm_storeu_ps(odd + i/2, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1)));
+			}
+#endif
+
+			// remaining elements (or scalar fallback)
+			for (; i < n; ++i) {
+				if (i % 2 == 0) {even[i/2] = src[i];} else {odd[i/2] = src[i];}
+			}
+
+		}
+
+		/** dst[x] = (e[x-1] + 4*o[x-1] + 6*e[x] + 4*o[x] + e[x+1]) / 16 for x in [x0:x1[ (branch-free interior) */
+		static inline void blurDecimate(float* dst, const float* e, const float* o, const int x0, const int x1) {
+
+			int x = x0;
+
+#if defined(__SSE2__)
+			const __m128 v4 = _mm_set1_ps(4.0f/16.0f);
+			const __m128 v6 = _mm_set1_ps(6.0f/16.0f);
+			const __m128 v1 = _mm_set1_ps(1.0f/16.0f);
+			for (; x <= x1 - 4; x += 4) {
+				const __m128 outer = _mm_add_ps(_mm_loadu_ps(e + x - 1), _mm_loadu_ps(e + x + 1));
+				const __m128 inner = _mm_add_ps(_mm_loadu_ps(o + x - 1), _mm_loadu_ps(o + x));
+				const __m128 center = _mm_loadu_ps(e + x);
+				const __m128 res = _mm_add_ps(_mm_add_ps(_mm_mul_ps(outer, v1), _mm_mul_ps(inner, v4)), _mm_mul_ps(center, v6));
+				_mm_storeu_ps(dst + x, res);
+			}
+#endif
+
+			// remaining elements (or scalar fallback)
+			for (; x < x1; ++x) {
+				dst[x] = (e[x-1] + e[x+1]) * (1.0f/16.0f) + (o[x-1] + o[x]) * (4.0f/16.0f) + e[x] * (6.0f/16.0f);
 			}
 
 		}
@@ -98,4 +291,3 @@ namespace K {
 }
 
 #endif // IMAGEPYRAMID_H
-
@@ -0,0 +1,132 @@
+#ifndef K_CV_INTEGRALHISTOGRAM_H
+#define K_CV_INTEGRALHISTOGRAM_H
+
+#include "../Assertions.h"
+
+#include <vector>
+#include <algorithm>
+
+namespace K {
+
+	/**
+	 * integral histogram: one integral image (see IntegralImage) per histogram-bin,
+	 * allowing to get the histogram of any rectangular window using 4 lookups per bin,
+	 * independent of the window's size.
+	 *
+	 * all bins of one entry are stored next to each other (interleaved),
+	 * thus the 4 lookups for a window touch 4 contiguous blocks of memory.
+	 *
+	 * memory: (width+1) * (height+1) * bins floats, e.g. 36 bytes per pixel for 9 bins.
+	 * sums are accumulated using double precision but stored as float, thus
+	 * the error of a window's bin is bound by ~4 * 2^-24 times the bin's sum over the whole image.
+	 */
+	class IntegralHistogram {
+
+	private:
+
+		/** the underlying image's width */
+		int width;
+
+		/** the underlying image's height */
+		int height;
+
+		/** the number of bins */
+		int bins;
+
+		/** (width+1) x (height+1) x bins sums. the first row and column are zero */
+		std::vector<float> data;
+
+	public:
+
+		/** empty ctor */
+		IntegralHistogram() : width(0), height(0), bins(0) {;}
+
+		/**
+		 * ctor.
+		 * func(y, double* votes) adds the votes of all pixels of row y to the (zeroed) votes,
+		 * where votes[x*bins + b] is bin b of pixel x. rows are processed in parallel
+		 */
+		template <typename Func> IntegralHistogram(const int width, const int height, const int bins, Func func) :
+			width(width), height(height), bins(bins), data((size_t)(width+1) * (height+1) * bins, 0.0f) {
+
+			const int rowLen = (width+1) * bins;
+
+			// 1st pass: prefix-sums within each row
+			#pragma omp parallel
+			{
+
+				std::vector<double> votes(rowLen);
+
+				#pragma omp for
+				for (int y = 0; y < height; ++y) {
+					std::fill(votes.begin(), votes.end(), 0.0);
+					func(y, votes.data() + bins);
+					for (int i = bins; i < rowLen; ++i) {votes[i] += votes[i - bins];}
+					float* row = data.data() + (size_t)(y+1) * rowLen;
+					for (int i = bins; i < rowLen; ++i) {row[i] = (float) votes[i];}
+				}
+
+			}
+
+			// 2nd pass: prefix-sums along the columns. each thread processes a chunk of columns for all rows
+			const int chunk = 1024;
+			const int numChunks = (rowLen + chunk - 1) / chunk;
+			#pragma omp parallel
+			{
+
+				std::vector<double> sums(chunk);
+
+				#pragma omp for
+				for (int c = 0; c < numChunks; ++c) {
+					const int i0 = c * chunk;
+					const int i1 = std::min(rowLen, i0 + chunk);
+					std::fill(sums.begin(), sums.end(), 0.0);
+					for (int y = 1; y <= height; ++y) {
+						float* row = data.data() + (size_t)y * rowLen;
+						for (int i = i0; i < i1; ++i) {
+							sums[i - i0] += row[i];
+							row[i] = (float) sums[i - i0];
+						}
+					}
+				}
+
+			}
+
+		}
+
+		/** the underlying image's width */
+		int getWidth() const {return width;}
+
+		/** the underlying image's height */
+		int getHeight() const {return height;}
+
+		/** the number of bins */
+		int getNumBins() const {return bins;}
+
+		/**
+		 * add the histogram of the window [x0:x1[ x [y0:y1[ to dst[0:bins[.
+		 * the window is clipped to the image
+		 */
+		inline void addHistogram(int x0, int y0, int x1, int y1, float* dst) const {
+
+			x0 = std::max(0, x0);	x1 = std::min(width, x1);
+			y0 = std::max(0, y0);	y1 = std::min(height, y1);
+			if (x0 >= x1 || y0 >= y1) {return;}
+
+			const int rowLen = (width+1) * bins;
+			const float* a = data.data() + (size_t)y0 * rowLen + x0 * bins;
+			const float* b = data.data() + (size_t)y0 * rowLen + x1 * bins;
+			const float* c = data.data() + (size_t)y1 * rowLen + x0 * bins;
+			const float* d = data.data() + (size_t)y1 * rowLen + x1 * bins;
+
+			for (int i = 0; i < bins; ++i) {
+				dst[i] += (d[i] - b[i]) - (c[i] - a[i]);
+			}
+
+		}
+
+	};
+
+}
+
+#endif // K_CV_INTEGRALHISTOGRAM_H
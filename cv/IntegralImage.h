@@ -0,0 +1,178 @@
+#ifndef K_CV_INTEGRALIMAGE_H
+#define K_CV_INTEGRALIMAGE_H
+
+#include "DataMatrix.h"
+#include "ImageChannel.h"
+#include "../Assertions.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace K {
+
+	/**
+	 * integral image (summed area table): each entry holds the sum of
+	 * all values above and left of it, allowing to get the sum of any
+	 * rectangular window using 4 lookups, independent of the window's size.
+	 *
+	 * sums are accumulated using double precision to prevent drift on large images.
+	 *
+	 * optionally, the image is padded by repeating its edge values (like ImageChannel::getClamped),
+	 * which allows windows reaching up to pad pixels beyond the image's edges.
+	 */
+	class IntegralImage : public DataMatrix<double> {
+
+	protected:
+
+		/** width of the underlying image */
+		int imgW;
+
+		/** height of the underlying image */
+		int imgH;
+
+		/** the number of (clamped) pixels around the image */
+		int pad;
+
+	public:
+
+		/** empty ctor */
+		IntegralImage() : imgW(0), imgH(0), pad(0) {;}
+
+		/** ctor. sum of the image's values, optionally padded by repeating the edges */
+		IntegralImage(const ImageChannel& img, const int pad = 0) : IntegralImage(img.getWidth(), img.getHeight(), pad, [&] (const int x, const int y) {return img.getClamped(x,y);}) {;}
+
+		/**
+		 * ctor. sum of func(x,y) for x in [-pad:w+pad[ and y in [-pad:h+pad[.
+		 * useful for summing values derived from one or more images (e.g. differences)
+		 */
+		template <typename Func> IntegralImage(const int w, const int h, const int pad, Func func) :
+			DataMatrix(w+2*pad+1, h+2*pad+1), imgW(w), imgH(h), pad(pad) {
+
+			_assertTrue(pad >= 0, "pad must not be negative");
+
+			const int iw = getWidth();
+			double* d = getData();
+
+			// first row and column are zero
+			std::fill(d, d + iw, 0.0);
+
+			for (int y = 1; y < getHeight(); ++y) {
+				double* row = d + y*iw;
+				const double* above = row - iw;
+				double rowSum = 0;
+				row[0] = 0;
+				for (int x = 1; x < iw; ++x) {
+					rowSum += (double) func(x-1-pad, y-1-pad);
+					row[x] = above[x] + rowSum;
+				}
+			}
+
+		}
+
+		/** width of the underlying image */
+		int getImageWidth() const {return imgW;}
+
+		/** height of the underlying image */
+		int getImageHeight() const {return imgH;}
+
+		/** the number of (clamped) pixels around the image */
+		int getPad() const {return pad;}
+
+		/** sum of all values within the window [x0:x1]x[y0:y1] (inclusive), which must be within the (padded) image */
+		inline double getSum(const int x0, const int y0, const int x1, const int y1) const {
+			_assertBetween(x0, -pad, x1, "window out of bounds");
+			_assertBetween(y0, -pad, y1, "window out of bounds");
+			_assertBetween(x1, x0, imgW+pad-1, "window out of bounds");
+			_assertBetween(y1, y0, imgH+pad-1, "window out of bounds");
+			const int w = getWidth();
+			const double* d = getData();
+			const int ix0 = x0+pad;
+			const int iy0 = y0+pad;
+			const int ix1 = x1+pad+1;
+			const int iy1 = y1+pad+1;
+			return d[iy1*w+ix1] - d[iy0*w+ix1] - d[iy1*w+ix0] + d[iy0*w+ix0];
+		}
+
+		/** sum of all values within the window of the given radius around (x,y) */
+		inline double getSum(const int x, const int y, const int radius) const {
+			return getSum(x-radius, y-radius, x+radius, y+radius);
+		}
+
+		/**
+		 * sum of all values within the window of the given radius around (x,y),
+		 * clipped to the image (and padding). cnt returns the number of summed values
+		 */
+		inline double getSumClipped(const int x, const int y, const int radius, int& cnt) const {
+			const int x0 = std::max(-pad, x-radius);
+			const int y0 = std::max(-pad, y-radius);
+			const int x1 = std::min(imgW+pad-1, x+radius);
+			const int y1 = std::min(imgH+pad-1, y+radius);
+			cnt = (x1-x0+1) * (y1-y0+1);
+			return getSum(x0, y0, x1, y1);
+		}
+
+		/** average of all values within the window of the given radius around (x,y) */
+		inline double getMean(const int x, const int y, const int radius) const {
+			const int size = 2*radius+1;
+			return getSum(x, y, radius) / (size*size);
+		}
+
+	};
+
+	/** integral image for the squared values (see IntegralImage) */
+	class IntegralImageSquared : public IntegralImage {
+
+	public:
+
+		/** empty ctor */
+		IntegralImageSquared() {;}
+
+		/** ctor. sum of the image's squared values, optionally padded by repeating the edges */
+		IntegralImageSquared(const ImageChannel& img, const int pad = 0) :
+			IntegralImage(img.getWidth(), img.getHeight(), pad, [&] (const int x, const int y) {const double v = img.getClamped(x,y); return v*v;}) {;}
+
+	};
+
+	/** O(1) mean and variance of arbitrary windows, using an integral image and a squared integral image */
+	class BoxStatistics {
+
+	private:
+
+		IntegralImage sum;
+		IntegralImageSquared sum2;
+
+	public:
+
+		/** ctor. windows may reach up to pad pixels beyond the image's edges (repeating the edge values) */
+		BoxStatistics(const ImageChannel& img, const int pad = 0) :
+			sum(img, pad), sum2(img, pad) {;}
+
+		/** average of all values within the window of the given radius around (x,y) */
+		inline double getMean(const int x, const int y, const int radius) const {
+			return sum.getMean(x, y, radius);
+		}
+
+		/** variance of all values within the window of the given radius around (x,y) */
+		inline double getVariance(const int x, const int y, const int radius) const {
+			const double cnt = (2*radius+1) * (2*radius+1);
+			const double avg = sum.getSum(x, y, radius) / cnt;
+			const double var = sum2.getSum(x, y, radius) / cnt - avg*avg;
+			return (var > 0) ? (var) : (0);			// prevent tiny negative values due to rounding
+		}
+
+		/** standard-deviation of all values within the window of the given radius around (x,y) */
+		inline double getStdDev(const int x, const int y, const int radius) const {
+			return std::sqrt(getVariance(x, y, radius));
+		}
+
+		/** the integral image */
+		const IntegralImage& getSums() const {return sum;}
+
+		/** the squared integral image */
+		const IntegralImageSquared& getSquaredSums() const {return sum2;}
+
+	};
+
+}
+
+#endif // K_CV_INTEGRALIMAGE_H
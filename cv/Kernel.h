@@ -6,6 +6,7 @@
 #include "DataMatrix.h"
 
 #include <functional>
+#include <cmath>
 
 namespace K {
 
@@ -52,8 +53,50 @@ namespace K {
 		}
 
 
+		/**
+		 * check whether this kernel can be separated into a horizontal (w x 1)
+		 * and a vertical (1 x h) kernel where kernel(x,y) = kH(x) * kV(y).
+		 * if so, both 1D kernels are returned and true is returned.
+		 */
+		bool separate(Kernel& kH, Kernel& kV, const float eps = 1e-5f) const {
+
+			// find the largest (absolute) value as pivot
+			int px = 0; int py = 0;
+			for (int y = 0; y < height; ++y) {
+				for (int x = 0; x < width; ++x) {
+					if (std::abs(get(x,y)) > std::abs(get(px,py))) {px = x; py = y;}
+				}
+			}
+			const float pivot = get(px,py);
+			if (pivot == 0) {return false;}
+
+			// the pivot's row and column (scaled) are the candidates
+			kH = Kernel(width, 1);
+			kV = Kernel(1, height);
+			for (int x = 0; x < width; ++x)		{kH.set(x, 0, get(x,py));}
+			for (int y = 0; y < height; ++y)	{kV.set(0, y, get(px,y) / pivot);}
+
+			// check whether kH*kV reproduces the kernel
+			for (int y = 0; y < height; ++y) {
+				for (int x = 0; x < width; ++x) {
+					const float err = get(x,y) - kH.get(x,0) * kV.get(0,y);
+					if (std::abs(err) > eps * std::abs(pivot)) {return false;}
+				}
+			}
+
+			return true;
+
+		}
+
+		/** is this kernel separable into two 1D kernels? */
+		bool isSeparable() const {
+			Kernel kH;
+			Kernel kV;
+			return separate(kH, kV);
+		}
+
 		/** call the given function for each of the kernel's values. (x,y) are centered around (0,0) */
-		void forEach(std::function<void(const int, const int, const float)> exec) const {
+		template <typename Func> void forEach(Func exec) const {
 
 			// center the kernel
 			const int dx = width/2;
@@ -0,0 +1,121 @@
+#ifndef K_CV_LAPLACIANPYRAMID_H
+#define K_CV_LAPLACIANPYRAMID_H
+
+#include <vector>
+#include "ImageChannel.h"
+#include "ImagePyramid.h"
+
+namespace K {
+
+	/**
+	 * laplacian image pyramid (band-pass layers).
+	 *
+	 * layer i is the difference between layer i of the gaussian pyramid
+	 * and the upsampled layer i+1. the last layer equals the smallest
+	 * gaussian layer, thus the original image can be reconstructed.
+	 *
+	 * like ImagePyramid, update() reuses all layers for images of the same size.
+	 */
+	class LaplacianPyramid {
+
+	private:
+
+		/** the underlying gaussian pyramid */
+		ImagePyramid gauss;
+
+		/** all layers of the pyramid */
+		std::vector<ImageChannel> layers;
+
+	public:
+
+		/** empty ctor */
+		LaplacianPyramid(const int maxLayers = 0) : gauss(maxLayers) {;}
+
+		/** ctor */
+		LaplacianPyramid(const ImageChannel& img, const int maxLayers = 0) : gauss(maxLayers) {
+			update(img);
+		}
+
+		/** (re-)build the pyramid for the given image. existing layers are reused if the image's size did not change */
+		void update(const ImageChannel& img) {
+
+			gauss.update(img);
+			allocate();
+
+			const int n = (int) layers.size();
+
+			// band-pass layers: G[i] - up(G[i+1])
+			for (int i = 0; i < n-1; ++i) {
+				ImageChannel& l = layers[i];
+				const ImageChannel& g = gauss.get(i);
+				ImagePyramid::upsample(gauss.get(i+1), l);
+				const float* src = g.getData();
+				float* dst = l.getData();
+				for (int j = 0; j < l.getWidth()*l.getHeight(); ++j) {dst[j] = src[j] - dst[j];}
+			}
+
+			// low-pass residual
+			const ImageChannel& top = gauss.get(n-1);
+			std::copy(top.getData(), top.getData() + top.getWidth()*top.getHeight(), layers[n-1].getData());
+
+		}
+
+		/** get the number of layers */
+		size_t size() const {
+			return layers.size();
+		}
+
+		/** get the idx-th layer */
+		ImageChannel& get(const int idx) {
+			return layers[idx];
+		}
+
+		/** get the idx-th layer */
+		const ImageChannel& get(const int idx) const {
+			return layers[idx];
+		}
+
+		/** get the underlying gaussian pyramid */
+		const ImagePyramid& getGaussian() const {
+			return gauss;
+		}
+
+		/** reconstruct the image from all layers (e.g. after modifying them) */
+		ImageChannel reconstruct() const {
+
+			const int n = (int) layers.size();
+			ImageChannel cur = layers[n-1];
+
+			for (int i = n-2; i >= 0; --i) {
+				const ImageChannel& l = layers[i];
+				ImageChannel up(l.getWidth(), l.getHeight());
+				ImagePyramid::upsample(cur, up);
+				const float* src = l.getData();
+				float* dst = up.getData();
+				for (int j = 0; j < l.getWidth()*l.getHeight(); ++j) {dst[j] += src[j];}
+				cur = std::move(up);
+			}
+
+			return cur;
+
+		}
+
+	private:
+
+		/** allocate all layers matching the gaussian pyramid, if the size changed */
+		void allocate() {
+
+			if (layers.size() == gauss.size() && layers[0].getWidth() == gauss.get(0).getWidth() && layers[0].getHeight() == gauss.get(0).getHeight()) {return;}
+
+			layers.clear();
+			for (size_t i = 0; i < gauss.size(); ++i) {
+				layers.push_back(ImageChannel(gauss.get((int)i).getWidth(), gauss.get((int)i).getHeight()));
+			}
+
+		}
+
+	};
+
+}
+
+#endif // K_CV_LAPLACIANPYRAMID_H
@@ -0,0 +1,162 @@
+#ifndef K_CV_SCALESPACE_H
+#define K_CV_SCALESPACE_H
+
+#include <vector>
+#include <cmath>
+#include "ImageChannel.h"
+#include "KernelFactory.h"
+#include "ConvolveSeparable.h"
+#include "../Assertions.h"
+
+namespace K {
+
+	/**
+	 * gaussian scale-space, organized in octaves (e.g. for SIFT-like detectors).
+	 *
+	 * each octave contains numScales+1 images with the (relative) sigmas
+	 * sigma0 * 2^(s/numScales), s in [0:numScales]. each image is derived
+	 * from its predecessor using the incremental blur. the first image of the
+	 * next octave is the last one (twice the sigma) decimated by 2.
+	 *
+	 * all images are allocated once. update() refreshes the scale-space for a new
+	 * image of the same size, without reallocating.
+	 */
+	class ScaleSpace {
+
+	private:
+
+		/** the number of scales per octave */
+		int numScales;
+
+		/** the sigma of the first scale */
+		float sigma0;
+
+		/** the maximum number of octaves (0 = until the images' size drops below minSize) */
+		int maxOctaves;
+
+		/** the images' minimal size */
+		int minSize;
+
+		/** blur for the first image of octave 0 and the incremental blurs between scales */
+		std::vector<ConvolveSeparable> blurs;
+
+		/** all octaves, each containing numScales+1 images */
+		std::vector<std::vector<ImageChannel>> octaves;
+
+	public:
+
+		/** ctor */
+		ScaleSpace(const int numScales = 3, const float sigma0 = 1.6f, const int maxOctaves = 0, const int minSize = 8) :
+			numScales(numScales), sigma0(sigma0), maxOctaves(maxOctaves), minSize(minSize) {
+
+			_assertTrue(numScales >= 1, "at least one scale per octave is needed");
+
+			blurs.push_back(getBlur(sigma0));
+			for (int s = 1; s <= numScales; ++s) {
+				const float prev = getSigma(0, s-1);
+				const float cur = getSigma(0, s);
+				blurs.push_back(getBlur(std::sqrt(cur*cur - prev*prev)));
+			}
+
+		}
+
+		/** ctor */
+		ScaleSpace(const ImageChannel& img, const int numScales = 3, const float sigma0 = 1.6f, const int maxOctaves = 0, const int minSize = 8) :
+			ScaleSpace(numScales, sigma0, maxOctaves, minSize) {
+			update(img);
+		}
+
+		/** (re-)build the scale-space for the given image. existing images are reused if the image's size did not change */
+		void update(const ImageChannel& img) {
+
+			allocate(img.getWidth(), img.getHeight());
+
+			for (size_t o = 0; o < octaves.size(); ++o) {
+
+				std::vector<ImageChannel>& oct = octaves[o];
+
+				// first scale: blur the input, or decimate the previous octave's last scale
+				if (o == 0) {
+					blurs[0].run(img, oct[0]);
+				} else {
+					decimate(octaves[o-1][numScales], oct[0]);
+				}
+
+				// incremental blur
+				for (int s = 1; s <= numScales; ++s) {
+					blurs[s].run(oct[s-1], oct[s]);
+				}
+
+			}
+
+		}
+
+		/** get the number of octaves */
+		size_t getNumOctaves() const {
+			return octaves.size();
+		}
+
+		/** get the number of scales per octave (without the additional last one, that equals the next octave's first scale) */
+		int getNumScales() const {
+			return numScales;
+		}
+
+		/** get the image for the given octave and scale [0:numScales] */
+		const ImageChannel& get(const int octave, const int scale) const {
+			return octaves[octave][scale];
+		}
+
+		/** get the sigma (relative to the octave's size) for the given scale [0:numScales] */
+		float getSigma(const int octave, const int scale) const {
+			(void) octave;
+			return sigma0 * std::pow(2.0f, (float) scale / (float) numScales);
+		}
+
+		/** get the sigma (relative to the input image) for the given octave and scale [0:numScales] */
+		float getAbsoluteSigma(const int octave, const int scale) const {
+			return getSigma(octave, scale) * (float) (1 << octave);
+		}
+
+	private:
+
+		/** allocate all images, if the size changed */
+		void allocate(const int w, const int h) {
+
+			if (!octaves.empty() && octaves[0][0].getWidth() == w && octaves[0][0].getHeight() == h) {return;}
+
+			octaves.clear();
+			int cw = w;
+			int ch = h;
+			while ((maxOctaves <= 0 || (int) octaves.size() < maxOctaves) && cw >= minSize && ch >= minSize) {
+				octaves.push_back(std::vector<ImageChannel>(numScales+1, ImageChannel(cw, ch)));
+				cw /= 2;
+				ch /= 2;
+			}
+
+			// ensure there is at least one octave
+			if (octaves.empty()) {octaves.push_back(std::vector<ImageChannel>(numScales+1, ImageChannel(w, h)));}
+
+		}
+
+		/** separable gauss for the given sigma */
+		static ConvolveSeparable getBlur(const float sigma) {
+			Kernel kV = KernelFactory::gauss1D(sigma);
+			kV.tilt();
+			return ConvolveSeparable(KernelFactory::gauss1D(sigma), kV);
+		}
+
+		/** take every second pixel (the source is already blurred) */
+		static void decimate(const ImageChannel& src, ImageChannel& dst) {
+			#pragma omp parallel for if (dst.getWidth()*dst.getHeight() > 128*128)
+			for (int y = 0; y < dst.getHeight(); ++y) {
+				const float* sRow = src.getData() + (2*y) * src.getWidth();
+				float* dRow = dst.getData() + y * dst.getWidth();
+				for (int x = 0; x < dst.getWidth(); ++x) {dRow[x] = sRow[2*x];}
+			}
+		}
+
+	};
+
+}
+
+#endif // K_CV_SCALESPACE_H
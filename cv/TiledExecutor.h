@@ -0,0 +1,147 @@
+#ifndef K_CV_TILEDEXECUTOR_H
+#define K_CV_TILEDEXECUTOR_H
+
+#include "ImageChannel.h"
+#include "DataMatrixView.h"
+#include "../Assertions.h"
+
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+namespace K {
+
+	/**
+	 * run a chain of filters on a (large) image tile-by-tile.
+	 *
+	 * each tile is extended by a halo (the sum of all stages' radii), copied
+	 * into a small per-thread buffer and processed by all stages before
+	 * moving on to the next tile. this way each pixel is (nearly) always
+	 * read from and written to the cache, instead of passing the whole image
+	 * through the memory once per stage.
+	 *
+	 * halos are clamped at the image's edges, so each stage sees the real edges
+	 * there and the result equals running the stages on the whole image, as long
+	 * as each stage only depends on the pixels within its given radius.
+	 * stages that depend on global values (e.g. Normalize without min/max) must not be used.
+	 *
+	 *	TiledExecutor exec;
+	 *	exec.add(gauss.getRadius(), [&] (const ConstImageView& src, const ImageView& dst) {gauss.filter(src, dst);});
+	 *	exec.add(0, [] (const ConstImageView& src, const ImageView& dst) {Threshold::run(src, dst, 0.5f);});
+	 *	exec.run(img, out);
+	 */
+	class TiledExecutor {
+
+	public:
+
+		/** one processing stage: read the src view and write the dst view of the same size */
+		typedef std::function<void(const ConstImageView& src, const ImageView& dst)> Stage;
+
+	private:
+
+		struct Entry {
+			int radius;
+			Stage stage;
+			Entry(const int radius, Stage stage) : radius(radius), stage(stage) {;}
+		};
+
+		/** all stages to run */
+		std::vector<Entry> stages;
+
+		/** the tile's width (without halo) */
+		int tileW;
+
+		/** the tile's height (without halo) */
+		int tileH;
+
+	public:
+
+		/** ctor. the default tile-size (+halo) fits into the L2 cache (2 x 256x256 floats) */
+		TiledExecutor(const int tileW = 256, const int tileH = 256) : tileW(tileW), tileH(tileH) {
+			_assertTrue(tileW > 0 && tileH > 0, "invalid tile size");
+		}
+
+		/** append a stage depending on pixels within the given radius */
+		TiledExecutor& add(const int radius, Stage stage) {
+			_assertTrue(radius >= 0, "radius must not be negative");
+			stages.push_back(Entry(radius, stage));
+			return *this;
+		}
+
+		/** the halo needed around each tile */
+		int getHalo() const {
+			int halo = 0;
+			for (const Entry& e : stages) {halo += e.radius;}
+			return halo;
+		}
+
+		/** run all stages on src, returning a newly created image */
+		ImageChannel run(const ImageChannel& src) const {
+			ImageChannel dst(src.getWidth(), src.getHeight());
+			run(src, dst);
+			return dst;
+		}
+
+		/** run all stages on the src view, writing into the dst view of the same size */
+		void run(const ConstImageView& src, const ImageView& dst) const {
+
+			_assertEqual(src.getWidth(), dst.getWidth(), "width of src and dst differs");
+			_assertEqual(src.getHeight(), dst.getHeight(), "height of src and dst differs");
+
+			const int w = src.getWidth();
+			const int h = src.getHeight();
+			const int halo = getHalo();
+			const int tilesX = (w + tileW - 1) / tileW;
+			const int tilesY = (h + tileH - 1) / tileH;
+
+			// nothing to do?
+			if (stages.empty()) {src.copyTo(dst); return;}
+
+			#pragma omp parallel
+			{
+
+				// per-thread ping-pong buffers for tile + halo
+				const int bufW = tileW + 2*halo;
+				const int bufH = tileH + 2*halo;
+				std::vector<float> buf1(bufW * bufH);
+				std::vector<float> buf2(bufW * bufH);
+
+				#pragma omp for schedule(dynamic)
+				for (int t = 0; t < tilesX * tilesY; ++t) {
+
+					// the tile
+					const int x0 = (t % tilesX) * tileW;
+					const int y0 = (t / tilesX) * tileH;
+					const int x1 = std::min(w, x0 + tileW);
+					const int y1 = std::min(h, y0 + tileH);
+
+					// the tile + halo (clamped to the image)
+					const int hx0 = std::max(0, x0 - halo);
+					const int hy0 = std::max(0, y0 - halo);
+					const int hx1 = std::min(w, x1 + halo);
+					const int hy1 = std::min(h, y1 + halo);
+
+					ImageView cur(buf1.data(), hx1-hx0, hy1-hy0, bufW);
+					ImageView nxt(buf2.data(), hx1-hx0, hy1-hy0, bufW);
+					src.getView(hx0, hy0, hx1-hx0, hy1-hy0).copyTo(cur);
+
+					// run all stages
+					for (const Entry& e : stages) {
+						e.stage(cur, nxt);
+						std::swap(cur, nxt);
+					}
+
+					// copy the tile (without halo) into the destination
+					cur.getView(x0-hx0, y0-hy0, x1-x0, y1-y0).copyTo(dst.getView(x0, y0, x1-x0, y1-y0));
+
+				}
+
+			}
+
+		}
+
+	};
+
+}
+
+#endif // K_CV_TILEDEXECUTOR_H
@@ -5,6 +5,7 @@
 #include "../ImageChannel.h"
 #include "../Derivative.h"
 #include "../filter/Gauss.h"
+#include "../filter/Box.h"
 #include "../ImageFactory.h"
 #include "../LocalMaxima.h"
 #include "../segmentation/Segmentation.h"
@@ -39,6 +40,7 @@ namespace K {
 
 		float threshold;
 		float sigma;
+		bool boxWindow;
 
 		LocalMaxima lMax;
 
@@ -47,7 +49,7 @@ namespace K {
 
 
 		/** ctor */
-		CornerDetectorHarris() : threshold(0.001f), sigma(1.0f), lMax( int(sigma*2), 0.00001f ) {
+		CornerDetectorHarris() : threshold(0.001f), sigma(1.0f), boxWindow(false), lMax( int(sigma*2), 0.00001f ) {
 			;
 		}
 
@@ -62,6 +64,14 @@ namespace K {
 			this->sigma = sigma;
 		}
 
+		/**
+		 * use a box-window (via integral images) instead of the gaussian for the structure tensor.
+		 * the box's radius is chosen to match the blur-sigma's variance. default: false
+		 */
+		void setUseBoxWindow(const bool use) {
+			this->boxWindow = use;
+		}
+
 		/** set the size of the neighborhood to examine when searching for local maxima. default: 2*sigma */
 		void setNeighborhoodSize(const int size) {
 			this->lMax.setSize(size);
@@ -88,10 +98,18 @@ namespace K {
 			imgY.forEachModify(lambda);
 
 			// apply guassian to the derived images (blend possible edges together)
-			Gauss g2(sigma);
-			imgX = g2.filter(imgX);
-			imgY = g2.filter(imgY);
-			imgXY = g2.filter(imgXY);
+			if (boxWindow) {
+				// box of radius r has the variance r(r+1)/3
+				const int r = std::max(1, (int) std::round(sigma * std::sqrt(3.0f)));
+				imgX = Box::apply(imgX, r);
+				imgY = Box::apply(imgY, r);
+				imgXY = Box::apply(imgXY, r);
+			} else {
+				Gauss g2(sigma);
+				imgX = g2.filter(imgX);
+				imgY = g2.filter(imgY);
+				imgXY = g2.filter(imgXY);
+			}
 
 			// calculate R image
 			ImageChannel imgR(imgX.getWidth(), imgX.getHeight());
@@ -0,0 +1,290 @@
+#ifndef K_CV_FEATURES_HOGDENSE_H
+#define K_CV_FEATURES_HOGDENSE_H
+
+#include "../../Assertions.h"
+#include "../../geo/Point2.h"
+#include "../ImageChannel.h"
+#include "../DataMatrix.h"
+#include "../IntegralHistogram.h"
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace K {
+
+	/**
+	 * dense histogram-of-oriented-gradients (HOG) descriptors.
+	 *
+	 * contrary to HOG, which derives the gradients for each query point,
+	 * magnitude and orientation of all gradients are calculated once per image
+	 * (vectorized, using an atan2 approximation) and accumulated into an
+	 * integral histogram. the histogram of any cell is thus available using
+	 * 4 lookups per bin, independent of the cell's size or the overlap between
+	 * neighboring descriptors.
+	 *
+	 * each descriptor consists of blockCells x blockCells cells (cellSize x cellSize pixels each)
+	 * around the query point, with one histogram of unsigned orientations [0:pi[ per cell.
+	 * each gradient votes for its two nearest bins (linear interpolation), weighted by its magnitude.
+	 * descriptors are L2-normalized, clipped at 0.2 and re-normalized (L2-Hys).
+	 */
+	class HOGDense {
+
+	private:
+
+		/** the size (in pixels) of each cell */
+		int cellSize;
+
+		/** the number of cells (per direction) within each descriptor */
+		int blockCells;
+
+		/** the number of orientation bins per cell */
+		int bins;
+
+		/** all gradients' histograms */
+		IntegralHistogram hist;
+
+	public:
+
+		/** ctor. calculates the gradients for the whole image */
+		HOGDense(const ImageChannel& img, const int cellSize = 8, const int blockCells = 2, const int bins = 9) :
+			cellSize(cellSize), blockCells(blockCells), bins(bins) {
+
+			_assertTrue(cellSize > 0 && blockCells > 0 && bins > 1, "invalid HOG parameters");
+
+			const int w = img.getWidth();
+			const int h = img.getHeight();
+
+			// magnitude and (continuous) bin-position for each pixel
+			std::vector<float> mag(w*h);
+			std::vector<float> pos(w*h);
+
+			#pragma omp parallel
+			{
+
+				std::vector<float> dx(w);
+				std::vector<float> dy(w);
+
+				#pragma omp for
+				for (int y = 0; y < h; ++y) {
+					getDerivatives(img, y, dx.data(), dy.data());
+					getMagnitudeAndBin(dx.data(), dy.data(), w, (float) bins / (float) M_PI, &mag[y*w], &pos[y*w]);
+				}
+
+			}
+
+			// vote into the two nearest bins
+			const int numBins = bins;
+			auto vote = [&] (const int y, double* votes) {
+				const float* m = &mag[y*w];
+				const float* p = &pos[y*w];
+				for (int x = 0; x < w; ++x) {
+					const float bp = p[x] - 0.5f;						// bin-centers are at 0.5, 1.5, ...
+					const float fl = std::floor(bp);
+					const float frac = bp - fl;
+					int b0 = (int) fl;
+					if (b0 < 0) {b0 += numBins;}
+					const int b1 = (b0 + 1 == numBins) ? (0) : (b0 + 1);
+					votes[x*numBins + b0] += m[x] * (1.0f - frac);
+					votes[x*numBins + b1] += m[x] * frac;
+				}
+			};
+			hist = IntegralHistogram(w, h, bins, vote);
+
+		}
+
+		/** the number of floats per descriptor */
+		int getDescriptorSize() const {
+			return blockCells * blockCells * bins;
+		}
+
+		/** the size (in pixels) of each descriptor's window */
+		int getWindowSize() const {
+			return blockCells * cellSize;
+		}
+
+		/** get the descriptor centered at (x,y) into dst[0:getDescriptorSize()[. cells beyond the image's edges are clipped */
+		void getDescriptor(const int x, const int y, float* dst) const {
+
+			const int win = getWindowSize();
+			const int x0 = x - win/2;
+			const int y0 = y - win/2;
+
+			std::fill(dst, dst + getDescriptorSize(), 0.0f);
+
+			float* cur = dst;
+			for (int cy = 0; cy < blockCells; ++cy) {
+				for (int cx = 0; cx < blockCells; ++cx) {
+					const int cx0 = x0 + cx*cellSize;
+					const int cy0 = y0 + cy*cellSize;
+					hist.addHistogram(cx0, cy0, cx0 + cellSize, cy0 + cellSize, cur);
+					cur += bins;
+				}
+			}
+
+			normalize(dst, getDescriptorSize());
+
+		}
+
+		/** get the descriptors for all given points. each row of the returned matrix is one descriptor */
+		DataMatrix<float> getDescriptors(const std::vector<Point2i>& points) const {
+
+			DataMatrix<float> res(getDescriptorSize(), (int) points.size());
+
+			#pragma omp parallel for
+			for (int i = 0; i < (int) points.size(); ++i) {
+				getDescriptor(points[i].x, points[i].y, res.getData() + i * getDescriptorSize());
+			}
+
+			return res;
+
+		}
+
+		/** get all points of a regular grid (with the given step) whose descriptors are completely within the image */
+		std::vector<Point2i> getGrid(const int step) const {
+			_assertTrue(step > 0, "invalid step");
+			std::vector<Point2i> points;
+			const int win = getWindowSize();
+			for (int y = win/2; y - win/2 + win <= hist.getHeight(); y += step) {
+				for (int x = win/2; x - win/2 + win <= hist.getWidth(); x += step) {
+					points.push_back(Point2i(x,y));
+				}
+			}
+			return points;
+		}
+
+		/** get the descriptors for all points of a regular grid (see getGrid()). each row of the returned matrix is one descriptor */
+		DataMatrix<float> getDescriptors(const int step) const {
+			return getDescriptors(getGrid(step));
+		}
+
+		/** approximation of atan2(y,x) in [-pi:+pi]. max error ~1e-5 rad */
+		static inline float atan2Approx(const float y, const float x) {
+			const float ax = std::abs(x);
+			const float ay = std::abs(y);
+			const float mx = std::max(ax, ay);
+			const float a = (mx == 0) ? (0) : (std::min(ax, ay) / mx);
+			const float s = a*a;
+			float r = ((((0.0208351f * s - 0.085133f) * s + 0.180141f) * s - 0.3302995f) * s + 0.999866f) * a;
+			if (ay > ax)	{r = 1.57079637f - r;}
+			if (x < 0)		{r = 3.14159274f - r;}
+			if (y < 0)		{r = -r;}
+			return r;
+		}
+
+	private:
+
+		/** centered derivatives of row y (like Derivative::getXcen/getYcen: zero at the edges) */
+		static void getDerivatives(const ImageChannel& img, const int y, float* dx, float* dy) {
+
+			const int w = img.getWidth();
+			const int h = img.getHeight();
+			const float* row = img.getData() + y*w;
+
+			dx[0] = 0;
+			dx[w-1] = 0;
+			for (int x = 1; x < w-1; ++x) {dx[x] = (row[x+1] - row[x-1]) / 2.0f;}
+
+			if (y == 0 || y == h-1) {
+				std::fill(dy, dy + w, 0.0f);
+			} else {
+				const float* above = row - w;
+				const float* below = row + w;
+				for (int x = 0; x < w; ++x) {dy[x] = (below[x] - above[x]) / 2.0f;}
+			}
+
+		}
+
+		/** magnitude and unsigned orientation [0:pi[ (scaled by binScale) for n gradients */
+		static void getMagnitudeAndBin(const float* dx, const float* dy, const int n, const float binScale, float* mag, float* pos) {
+
+			int i = 0;
+
+#if defined(__SSE2__)
+			const __m128 signMask = _mm_set1_ps(-0.0f);
+			const __m128 c0 = _mm_set1_ps(0.999866f);
+			const __m128 c1 = _mm_set1_ps(-0.3302995f);
+			const __m128 c2 = _mm_set1_ps(0.180141f);
+			const __m128 c3 = _mm_set1_ps(-0.085133f);
+			const __m128 c4 = _mm_set1_ps(0.0208351f);
+			const __m128 halfPi = _mm_set1_ps(1.57079637f);
+			const __m128 pi = _mm_set1_ps(3.14159274f);
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 scale = _mm_set1_ps(binScale);
+			const __m128 maxPos = _mm_set1_ps((float) M_PI * binScale);
+
+			for (; i <= n - 4; i += 4) {
+
+				const __m128 x = _mm_loadu_ps(dx + i);
+				const __m128 y = _mm_loadu_ps(dy + i);
+
+				// magnitude
+				_mm_storeu_ps(mag + i, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y))));
+
+				// atan2 approximation (see atan2Approx)
+				const __m128 ax = _mm_andnot_ps(signMask, x);
+				const __m128 ay = _mm_andnot_ps(signMask, y);
+				const __m128 mx = _mm_max_ps(ax, ay);
+				const __m128 mn = _mm_min_ps(ax, ay);
+				const __m128 valid = _mm_cmpgt_ps(mx, zero);
+				const __m128 a = _mm_and_ps(valid, _mm_div_ps(mn, _mm_or_ps(mx, _mm_andnot_ps(valid, _mm_set1_ps(1.0f)))));
+				const __m128 s = _mm_mul_ps(a, a);
+				__m128 r = _mm_add_ps(_mm_mul_ps(c4, s), c3);
+				r = _mm_add_ps(_mm_mul_ps(r, s), c2);
+				r = _mm_add_ps(_mm_mul_ps(r, s), c1);
+				r = _mm_add_ps(_mm_mul_ps(r, s), c0);
+				r = _mm_mul_ps(r, a);
+
+				const __m128 swap = _mm_cmpgt_ps(ay, ax);
+				r = _mm_or_ps(_mm_and_ps(swap, _mm_sub_ps(halfPi, r)), _mm_andnot_ps(swap, r));
+				const __m128 neg = _mm_cmplt_ps(x, zero);
+				r = _mm_or_ps(_mm_and_ps(neg, _mm_sub_ps(pi, r)), _mm_andnot_ps(neg, r));
+
+				// unsigned orientation: atan2 of (x,|y|) is within [0:pi], the sign of y mirrors it to pi - r
+				const __m128 negY = _mm_cmplt_ps(y, zero);
+				r = _mm_or_ps(_mm_and_ps(negY, _mm_sub_ps(pi, r)), _mm_andnot_ps(negY, r));
+
+				// scale to bins and ensure [0:bins[
+				__m128 p = _mm_mul_ps(r, scale);
+				p = _mm_andnot_ps(_mm_cmpge_ps(p, maxPos), p);
+				_mm_storeu_ps(pos + i, p);
+
+			}
+#endif
+
+			// remaining elements (or scalar fallback)
+			for (; i < n; ++i) {
+				mag[i] = std::sqrt(dx[i]*dx[i] + dy[i]*dy[i]);
+				float r = atan2Approx(dy[i], dx[i]);
+				if (r < 0) {r += 3.14159274f;}
+				float p = r * binScale;
+				if (p >= (float) M_PI * binScale) {p = 0;}
+				pos[i] = p;
+			}
+
+		}
+
+		/** L2-Hys normalization: L2-normalize, clip at 0.2, L2-normalize again */
+		static void normalize(float* v, const int n) {
+			scale(v, n);
+			for (int i = 0; i < n; ++i) {v[i] = std::min(0.2f, v[i]);}
+			scale(v, n);
+		}
+
+		/** scale v to unit length */
+		static void scale(float* v, const int n) {
+			float sum = 0;
+			for (int i = 0; i < n; ++i) {sum += v[i]*v[i];}
+			const float norm = 1.0f / std::sqrt(sum + 1e-10f);
+			for (int i = 0; i < n; ++i) {v[i] *= norm;}
+		}
+
+	};
+
+}
+
+#endif // K_CV_FEATURES_HOGDENSE_H
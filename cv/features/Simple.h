@@ -3,6 +3,7 @@
 
 #include "../DataMatrix.h"
 #include "../ImageChannel.h"
+#include "../IntegralImage.h"
 #include "../Derivative.h"
 #include "../filter/Gauss.h"
 #include "../filter/Normalize.h"
@@ -38,7 +39,13 @@ namespace K {
 
 	public:
 
-		static DataMatrix<FeatureVec> getFeatures(const ImageChannel& img, const int win = 9) {
+		/**
+		 * get the feature-vector for each pixel of the given image
+		 * @param img the image to get the features for
+		 * @param win the size of the window to examine around each pixel
+		 * @param useIntegral use integral images for the window's statistics (independent of the window's size)
+		 */
+		static DataMatrix<FeatureVec> getFeatures(const ImageChannel& img, const int win = 9, const bool useIntegral = false) {
 
 			Gauss g1(1.5f);
 			Gauss g2(win/2);
@@ -64,6 +71,30 @@ namespace K {
 			const int s = win/2;
 			DataMatrix<FeatureVec> dm(img.getWidth(), img.getHeight());
 
+			if (useIntegral) {
+
+				// window statistics in O(1) per pixel. padding by s equals the clamped access below
+				const BoxStatistics stats(img, s);
+				const BoxStatistics statsBlur1(imgBlur1, s);
+
+				#pragma omp parallel for
+				for (int y = 0; y < img.getHeight(); ++y) {
+					for (int x = 0; x < img.getWidth(); ++x) {
+						FeatureVec vec;
+						vec.avg2Value =	imgBlur2.get(x,y);
+						vec.avg1Value = imgBlur1.get(x,y);
+						vec.avg1GradX =	imgBlur1X.get(x, y);
+						vec.avg1GradY =	imgBlur1Y.get(x, y);
+						vec.avg1Sigma =	(float) statsBlur1.getStdDev(x, y, s);
+						vec.sigma =		(float) stats.getStdDev(x, y, s);
+						dm.set(x,y,vec);
+					}
+				}
+
+				return dm;
+
+			}
+
 			// process each pixel
 			for (int y = 0; y < img.getHeight(); ++y) {
 				for (int x = 0; x < img.getWidth(); ++x) {
@@ -0,0 +1,49 @@
+#ifndef K_CV_BOX_H
+#define K_CV_BOX_H
+
+#include "../ImageChannel.h"
+#include "../IntegralImage.h"
+
+namespace K {
+
+	/**
+	 * box filter (average within a square window) using an integral image.
+	 * the cost per pixel does not depend on the window's size.
+	 */
+	class Box {
+
+	public:
+
+		/**
+		 * average all values within the window of the given radius around each pixel.
+		 * at the edges, only the pixels within the image are averaged
+		 */
+		static ImageChannel apply(const ImageChannel& img, const int radius) {
+			ImageChannel out(img.getWidth(), img.getHeight());
+			apply(IntegralImage(img), radius, out);
+			return out;
+		}
+
+		/** average all values within the window of the given radius around each pixel, using the given integral image */
+		static void apply(const IntegralImage& ii, const int radius, ImageChannel& out) {
+
+			_assertEqual(ii.getImageWidth(), out.getWidth(), "width of integral image and output differs");
+			_assertEqual(ii.getImageHeight(), out.getHeight(), "height of integral image and output differs");
+
+			#pragma omp parallel for
+			for (int y = 0; y < out.getHeight(); ++y) {
+				float* dst = out.getData() + y*out.getWidth();
+				for (int x = 0; x < out.getWidth(); ++x) {
+					int cnt;
+					const double sum = ii.getSumClipped(x, y, radius, cnt);
+					dst[x] = (float) (sum / cnt);
+				}
+			}
+
+		}
+
+	};
+
+}
+
+#endif // K_CV_BOX_H
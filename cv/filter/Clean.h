@@ -2,6 +2,7 @@
 #define CLEAN_H
 
 #include "../ImageChannel.h"
+#include "../IntegralImage.h"
 
 namespace K {
 
@@ -15,9 +16,12 @@ namespace K {
 		 * @param img the black/white image to clear
 		 * @param radius half of the rectangular window size
 		 * @param threshold the threshold to use for the average
+		 * @param useIntegral use an integral image to calculate the window's average (independent of the radius)
 		 * @return the filtered image
 		 */
-		static K::ImageChannel avgThreshold(const K::ImageChannel& img, const int radius, const float threshold) {
+		static K::ImageChannel avgThreshold(const K::ImageChannel& img, const int radius, const float threshold, const bool useIntegral = false) {
+
+			if (useIntegral) {return avgThresholdIntegral(img, radius, threshold);}
 
 			K::ImageChannel out(img.getWidth(), img.getHeight());
 
@@ -47,6 +51,32 @@ namespace K {
 
 		}
 
+	private:
+
+		/** avgThreshold() using an integral image */
+		static K::ImageChannel avgThresholdIntegral(const K::ImageChannel& img, const int radius, const float threshold) {
+
+			K::ImageChannel out(img.getWidth(), img.getHeight());
+			const IntegralImage ii(img);
+
+			#pragma omp parallel for
+			for (int y = radius; y < img.getHeight()-radius; ++y) {
+				for (int x = radius; x < img.getWidth()-radius; ++x) {
+
+					const float val = img.get(x,y);
+					if (val < threshold) {out.set(x,y,0.0f); continue;}
+
+					const float avg = (float) ii.getMean(x, y, radius);
+					const float res = (avg > threshold) ? (1.0f) : (0.0f);
+					out.set(x,y,res);
+
+				}
+			}
+
+			return out;
+
+		}
+
 	};
 
 }
@@ -2,6 +2,9 @@
 #define K_CV_DILATE_H
 
 #include "../ImageChannel.h"
+#include "../BitmapPacked.h"
+
+#include <vector>
 
 namespace K {
 
@@ -123,6 +126,46 @@ namespace K {
 
 		}
 
+		/**
+		 * @brief apply dilation to the given bitmap, enlarging all set pixels using the given shape.
+		 * processes 64 pixels at once. contrary to the image version, pixels near the edges are dilated as well
+		 * @param bmp the bitmap to dilate
+		 * @param radius the radius [1:3] to use for "enlarging" set pixels
+		 * @return the dilated bitmap
+		 */
+		static BitmapPacked apply(const BitmapPacked& bmp, const int radius = 1, const Shape shape = Shape::SQUARE_45) {
+			return bmp.dilate(getExtents(radius, shape));
+		}
+
+		/**
+		 * @brief apply erosion to the given bitmap, shrinking all set pixels using the given shape.
+		 * @param bmp the bitmap to erode
+		 * @param radius the radius [1:3] to use for "shrinking" set pixels
+		 * @return the eroded bitmap
+		 */
+		static BitmapPacked erode(const BitmapPacked& bmp, const int radius = 1, const Shape shape = Shape::SQUARE_45) {
+			return bmp.erode(getExtents(radius, shape));
+		}
+
+	private:
+
+		/** the horizontal half-width of the given shape per row-offset [-radius:+radius] (see BitmapPacked::dilate) */
+		static std::vector<int> getExtents(const int radius, const Shape shape) {
+
+			_assertBetween(radius, 1, 3, "invalid radius given");
+
+			if (shape == CIRCLE) {
+				if (radius == 2) {return {1, 2, 2, 2, 1};}
+				if (radius == 3) {return {0, 2, 2, 3, 2, 2, 0};}
+			}
+
+			// 45 degree rotated square (and the radius 1 circle)
+			std::vector<int> ext(2*radius+1);
+			for (int dy = -radius; dy <= radius; ++dy) {ext[dy+radius] = radius - std::abs(dy);}
+			return ext;
+
+		}
+
 	};
 
 }
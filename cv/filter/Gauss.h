@@ -3,7 +3,7 @@
 
 #include "../ImageChannel.h"
 #include "../KernelFactory.h"
-#include "../Convolve.h"
+#include "../ConvolveSeparable.h"
 
 namespace K {
 
@@ -37,10 +37,25 @@ namespace K {
 		ImageChannel filter(const ImageChannel& src) const {
 
 			// 2 x 1D convolution
-			return Convolve::run(Convolve::run(src, kH), kV);
+			return ConvolveSeparable(kH, kV).run(src);
 
 		}
 
+		/** filter using 2x1D gauss, writing into the (already allocated) dst */
+		void filter(const ImageChannel& src, ImageChannel& dst) const {
+			ConvolveSeparable(kH, kV).run(src, dst);
+		}
+
+		/** filter the src view using 2x1D gauss, writing into the dst view of the same size */
+		void filter(const ConstImageView& src, const ImageView& dst) const {
+			ConvolveSeparable(kH, kV).run(src, dst);
+		}
+
+		/** the number of neighboring pixels (in each direction) that influence one pixel */
+		int getRadius() const {
+			return std::max(kH.getWidth(), kV.getHeight()) / 2;
+		}
+
 	};
 
 }
@@ -5,6 +5,11 @@
 #include "../../Assertions.h"
 #include "../../math/statistics/Median.h"
 
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
 namespace K {
 
 	/** median image filter */
@@ -12,18 +17,50 @@ namespace K {
 
 	public:
 
-		/** apply a median-filter to the given image */
+		/**
+		 * apply a median-filter to the given image.
+		 * windows up to 3x3 select the median per pixel. for larger ones, images containing at most
+		 * 256 integer levels (e.g. 8-bit data) use the constant-time histogram median, all others
+		 * a sliding sorted window. all are exact.
+		 */
 		static ImageChannel apply(const ImageChannel& img, const int sx = 3, const int sy = 3) {
 
-			K::ImageChannel res(img.getWidth(), img.getHeight());
+			// sanity checks
+			_assertTrue(sx % 2 == 1, "sx must be odd");
+			_assertTrue(sy % 2 == 1, "sy must be odd");
 
-			for (int y = 0; y < img.getHeight(); ++y) {
-				for (int x = 0; x < img.getWidth(); ++x) {
-					res.set(x,y, get(img,x,y,sx,sy));
-				}
+			// small windows: selection per pixel is faster than both sliding variants
+			if (sx <= 3 && sy <= 3) {return applySelect(img, sx, sy);}
+
+			float min = 0;
+			float max = 0;
+			getRange(img, min, max);
+
+			if (max - min < 256 && isInteger(img)) {
+				return applyHistogram(img, sx, sy, min, 1.0f, (int)(max - min) + 1);
+			} else {
+				return applySorted(img, sx, sy);
 			}
 
-			return res;
+		}
+
+		/**
+		 * apply a median-filter to the given image after quantizing its values
+		 * into the given number of levels (<= 256) between the image's min and max.
+		 * the cost is independent of (sx,sy) but the result contains only quantized values.
+		 */
+		static ImageChannel applyQuantized(const ImageChannel& img, const int sx = 3, const int sy = 3, const int levels = 256) {
+
+			// sanity checks
+			_assertTrue(sx % 2 == 1, "sx must be odd");
+			_assertTrue(sy % 2 == 1, "sy must be odd");
+			_assertBetween(levels, 2, 256, "levels out of range");
+
+			float min = 0;
+			float max = 0;
+			getRange(img, min, max);
+			const float step = (max > min) ? ((max - min) / (float)(levels-1)) : (1.0f);
+			return applyHistogram(img, sx, sy, min, step, levels);
 
 		}
 
@@ -58,6 +95,318 @@ namespace K {
 
 		}
 
+	private:
+
+		/** number of rows processed by one thread for the histogram median */
+		static inline int getBandHeight(const int sy) {return std::max(64, 4*sy);}
+
+		/** get the image's value range */
+		static void getRange(const ImageChannel& img, float& min, float& max) {
+			const float* data = img.getData();
+			const int cnt = img.getWidth() * img.getHeight();
+			if (cnt == 0) {min = 0; max = 0; return;}
+			min = data[0];
+			max = data[0];
+			for (int i = 1; i < cnt; ++i) {
+				if (data[i] < min) {min = data[i];}
+				if (data[i] > max) {max = data[i];}
+			}
+		}
+
+		/** does the image contain only integer values? */
+		static bool isInteger(const ImageChannel& img) {
+			const float* data = img.getData();
+			const int cnt = img.getWidth() * img.getHeight();
+			for (int i = 0; i < cnt; ++i) {
+				if (data[i] != std::floor(data[i])) {return false;}
+			}
+			return true;
+		}
+
+		/** the median of a window with cnt entries, given a function returning the entry with the given rank */
+		template <typename RankFunc> static inline float getMedian(const int cnt, RankFunc rank) {
+			if (cnt % 2 == 1) {
+				return rank(cnt/2);
+			} else {
+				return (rank(cnt/2-1) + rank(cnt/2)) / 2;
+			}
+		}
+
+		/**
+		 * exact median for small windows by selecting the median among the window's
+		 * values for every pixel. cheaper than maintaining a sorted window or histograms.
+		 * full 3x3 windows use a (branchless) selection network.
+		 */
+		static ImageChannel applySelect(const ImageChannel& img, const int sx, const int sy) {
+
+			const int w = img.getWidth();
+			const int h = img.getHeight();
+			const int rx = sx/2;
+			const int ry = sy/2;
+			const float* data = img.getData();
+			ImageChannel res(w, h);
+
+			#pragma omp parallel
+			{
+
+				std::vector<float> window(sx*sy);
+
+				#pragma omp for
+				for (int y = 0; y < h; ++y) {
+
+					const int y1 = img.clampY(y-ry);
+					const int y2 = img.clampY(y+ry);
+					const bool fullY = (y2 - y1 + 1 == sy);
+
+					for (int x = 0; x < w; ++x) {
+
+						const int x1 = img.clampX(x-rx);
+						const int x2 = img.clampX(x+rx);
+
+						if (sx == 3 && sy == 3 && fullY && x2 - x1 == 2) {
+							const float* r0 = data + y1*w + x1;
+							const float* r1 = r0 + w;
+							const float* r2 = r1 + w;
+							res.set(x, y, getMedian9(r0[0], r0[1], r0[2], r1[0], r1[1], r1[2], r2[0], r2[1], r2[2]));
+							continue;
+						}
+
+						int cnt = 0;
+						for (int yy = y1; yy <= y2; ++yy) {
+							const float* row = data + yy*w;
+							for (int xx = x1; xx <= x2; ++xx) {window[cnt++] = row[xx];}
+						}
+
+						// select the upper median, the lower one is the max. of the values before it
+						float* mid = window.data() + cnt/2;
+						std::nth_element(window.data(), mid, window.data() + cnt);
+						if (cnt % 2 == 1) {
+							res.set(x, y, *mid);
+						} else {
+							res.set(x, y, (*std::max_element(window.data(), mid) + *mid) / 2);
+						}
+
+					}
+
+				}
+
+			}
+
+			return res;
+
+		}
+
+		/** sort two values */
+		static inline void sort2(float& a, float& b) {
+			const float t = std::min(a, b);
+			b = std::max(a, b);
+			a = t;
+		}
+
+		/** median of 9 values using a selection network (19 comparisons, Paeth) */
+		static inline float getMedian9(float p0, float p1, float p2, float p3, float p4, float p5, float p6, float p7, float p8) {
+			sort2(p1, p2); sort2(p4, p5); sort2(p7, p8);
+			sort2(p0, p1); sort2(p3, p4); sort2(p6, p7);
+			sort2(p1, p2); sort2(p4, p5); sort2(p7, p8);
+			sort2(p0, p3); sort2(p5, p8); sort2(p4, p7);
+			sort2(p3, p6); sort2(p1, p4); sort2(p2, p5);
+			sort2(p4, p7); sort2(p4, p2); sort2(p6, p4);
+			sort2(p4, p2);
+			return p4;
+		}
+
+		/**
+		 * exact median for arbitrary values by sliding a sorted window along each row.
+		 * moving the window removes and inserts one column instead of sorting the whole window.
+		 */
+		static ImageChannel applySorted(const ImageChannel& img, const int sx, const int sy) {
+
+			const int w = img.getWidth();
+			const int h = img.getHeight();
+			const int rx = sx/2;
+			const int ry = sy/2;
+			ImageChannel res(w, h);
+
+			#pragma omp parallel
+			{
+
+				std::vector<float> sorted;
+
+				#pragma omp for
+				for (int y = 0; y < h; ++y) {
+
+					const int y1 = img.clampY(y-ry);
+					const int y2 = img.clampY(y+ry);
+
+					// initial window
+					sorted.clear();
+					for (int yy = y1; yy <= y2; ++yy) {
+						for (int xx = 0; xx <= std::min(w-1, rx); ++xx) {sorted.push_back(img.get(xx,yy));}
+					}
+					std::sort(sorted.begin(), sorted.end());
+
+					for (int x = 0; x < w; ++x) {
+
+						res.set(x, y, getMedian((int)sorted.size(), [&sorted] (const int idx) {return sorted[idx];}));
+
+						// slide: remove the left column, add the right one
+						if (x-rx >= 0) {
+							for (int yy = y1; yy <= y2; ++yy) {
+								sorted.erase(std::lower_bound(sorted.begin(), sorted.end(), img.get(x-rx,yy)));
+							}
+						}
+						if (x+rx+1 < w) {
+							for (int yy = y1; yy <= y2; ++yy) {
+								const float val = img.get(x+rx+1,yy);
+								sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), val), val);
+							}
+						}
+
+					}
+
+				}
+
+			}
+
+			return res;
+
+		}
+
+		/**
+		 * constant-time median (Perreault and Hebert) using 256-bin histograms.
+		 * every value is mapped to bin round((v-min)/step) and back to min+bin*step.
+		 *
+		 * each column keeps a histogram of the rows within the window, which is moved
+		 * down by one row per line. moving the window right only updates the 16 coarse
+		 * bins of the window's histogram. the 16 fine bins below one coarse bin are
+		 * brought up to date lazily, only when the median falls into that coarse bin,
+		 * by adding/removing the columns that entered/left the window since the last
+		 * update (or by summing the whole window, whichever is cheaper).
+		 */
+		static ImageChannel applyHistogram(const ImageChannel& img, const int sx, const int sy, const float min, const float step, const int levels) {
+
+			_assertTrue(sy < 65536, "sy too large");
+
+			const int w = img.getWidth();
+			const int h = img.getHeight();
+			const int rx = sx/2;
+			const int ry = sy/2;
+			const int bandH = getBandHeight(sy);
+			ImageChannel res(w, h);
+
+			// quantize the image once
+			std::vector<uint8_t> bins(w*h);
+			const float* data = img.getData();
+			for (int i = 0; i < w*h; ++i) {
+				bins[i] = (uint8_t) std::min(levels-1, (int) std::lround((data[i] - min) / step));
+			}
+
+			#pragma omp parallel
+			{
+
+				std::vector<uint16_t> colFine(w * 256);
+				std::vector<uint16_t> colCoarse(w * 16);
+				int fine[256];
+				int coarse[16];
+
+				// the window columns [syncLo:syncHi] each coarse bin's fine bins currently belong to
+				int syncLo[16];
+				int syncHi[16];
+
+				// add or remove the value at (x,y) to/from its column histogram
+				auto updateCol = [&] (const int x, const int y, const int delta) {
+					const uint8_t b = bins[x + y*w];
+					colFine[x*256 + b] = (uint16_t) (colFine[x*256 + b] + delta);
+					colCoarse[x*16 + (b>>4)] = (uint16_t) (colCoarse[x*16 + (b>>4)] + delta);
+				};
+
+				// add or remove a column's coarse histogram to/from the window's histogram
+				auto updateCoarse = [&] (const int x, const int delta) {
+					const uint16_t* c = &colCoarse[x*16];
+					for (int i = 0; i < 16; ++i) {coarse[i] += delta * c[i];}
+				};
+
+				// add or remove the fine bins of one coarse bin of a column to/from the window's histogram
+				auto updateFine = [&] (const int x, const int c, const int delta) {
+					if (colCoarse[x*16 + c] == 0) {return;}
+					const uint16_t* f = &colFine[x*256 + c*16];
+					int* dst = &fine[c*16];
+					for (int i = 0; i < 16; ++i) {dst[i] += delta * f[i];}
+				};
+
+				// bring the fine bins of the given coarse bin up to date for the window [lo:hi]
+				auto syncFine = [&] (const int c, const int lo, const int hi) {
+					const int moved = (lo - syncLo[c]) + (hi - syncHi[c]);
+					if (syncHi[c] < lo || moved > hi - lo + 1) {
+						std::fill(fine + c*16, fine + c*16 + 16, 0);
+						for (int x = lo; x <= hi; ++x) {updateFine(x, c, +1);}
+					} else {
+						for (int x = syncLo[c]; x < lo; ++x) {updateFine(x, c, -1);}
+						for (int x = syncHi[c]+1; x <= hi; ++x) {updateFine(x, c, +1);}
+					}
+					syncLo[c] = lo;
+					syncHi[c] = hi;
+				};
+
+				// value with the given (0-based) rank within the window [lo:hi]
+				auto getRank = [&] (const int rank, const int lo, const int hi) {
+					int cnt = 0;
+					int c = 0;
+					while (cnt + coarse[c] <= rank) {cnt += coarse[c]; ++c;}
+					syncFine(c, lo, hi);
+					int b = c*16;
+					while (cnt + fine[b] <= rank) {cnt += fine[b]; ++b;}
+					return min + (float) b * step;
+				};
+
+				#pragma omp for
+				for (int yb = 0; yb < h; yb += bandH) {
+
+					// column histograms for the band's first row
+					std::fill(colFine.begin(), colFine.end(), 0);
+					std::fill(colCoarse.begin(), colCoarse.end(), 0);
+					for (int y = std::max(0, yb-ry); y <= std::min(h-1, yb+ry); ++y) {
+						for (int x = 0; x < w; ++x) {updateCol(x, y, +1);}
+					}
+
+					for (int y = yb; y < std::min(h, yb+bandH); ++y) {
+
+						// move the column histograms down
+						if (y > yb) {
+							if (y-ry-1 >= 0)	{for (int x = 0; x < w; ++x) {updateCol(x, y-ry-1, -1);}}
+							if (y+ry < h)		{for (int x = 0; x < w; ++x) {updateCol(x, y+ry, +1);}}
+						}
+
+						const int rows = std::min(h-1, y+ry) - std::max(0, y-ry) + 1;
+
+						// initial window. all fine bins are outdated
+						std::fill(coarse, coarse+16, 0);
+						std::fill(syncLo, syncLo+16, -1);
+						std::fill(syncHi, syncHi+16, -2);
+						for (int x = 0; x <= std::min(w-1, rx); ++x) {updateCoarse(x, +1);}
+
+						for (int x = 0; x < w; ++x) {
+
+							const int lo = std::max(0, x-rx);
+							const int hi = std::min(w-1, x+rx);
+							res.set(x, y, getMedian(rows*(hi-lo+1), [&] (const int rank) {return getRank(rank, lo, hi);}));
+
+							// slide: remove the left column, add the right one
+							if (x-rx >= 0)		{updateCoarse(x-rx, -1);}
+							if (x+rx+1 < w)		{updateCoarse(x+rx+1, +1);}
+
+						}
+
+					}
+
+				}
+
+			}
+
+			return res;
+
+		}
+
 	};
 
 }
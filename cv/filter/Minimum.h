@@ -3,6 +3,7 @@
 
 #include "../ImageChannel.h"
 #include "../../Assertions.h"
+#include "RegionExtremum.h"
 #include "../../math/statistics/Minimum.h"
 
 namespace K {
@@ -12,19 +13,12 @@ namespace K {
 
 	public:
 
-		/** apply a median-filter to the given image */
+		/**
+		 * apply a regional-minimum-filter to the given image.
+		 * uses running extrema, the cost does not depend on (sx,sy)
+		 */
 		static ImageChannel apply(const ImageChannel& img, const int sx = 3, const int sy = 3) {
-
-			K::ImageChannel res(img.getWidth(), img.getHeight());
-
-			for (int y = 0; y < img.getHeight(); ++y) {
-				for (int x = 0; x < img.getWidth(); ++x) {
-					res.set(x,y, get(img,x,y,sx,sy));
-				}
-			}
-
-			return res;
-
+			return RegionExtremum<RegionExtremumMin>::apply(img, sx, sy);
 		}
 
 		/** get the median for the given (x,y) by examining its neighborhood (default 3x3) */
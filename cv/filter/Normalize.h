@@ -2,6 +2,7 @@
 #define K_CV_FILTER_NORMALIZE_H
 
 #include "../ImageChannel.h"
+#include <cmath>
 
 namespace K {
 
@@ -35,6 +36,35 @@ namespace K {
 
 		}
 
+		/** normalize the view = set all values between [0.0:1.0]. min and max are autoamtically determined */
+		static void inplace(const ImageView& img) {
+			float min = +INFINITY;
+			float max = -INFINITY;
+			img.forEach([&] (const int x, const int y, const float val) {
+				(void) x; (void) y;
+				if (val < min) {min = val;}
+				if (val > max) {max = val;}
+			});
+			run(img, img, min, max);
+		}
+
+		/** normalize the view = set all values between [0.0:1.0] */
+		static void inplace(const ImageView& img, const float min, const float max) {
+			run(img, img, min, max);
+		}
+
+		/** normalize the src view into the dst view of the same size (may be the same) */
+		static void run(const ConstImageView& src, const ImageView& dst, const float min, const float max) {
+			_assertEqual(src.getWidth(), dst.getWidth(), "width of src and dst differs");
+			_assertEqual(src.getHeight(), dst.getHeight(), "height of src and dst differs");
+			const float diff = max - min;
+			for (int y = 0; y < src.getHeight(); ++y) {
+				const float* s = src.getRow(y);
+				float* d = dst.getRow(y);
+				for (int x = 0; x < src.getWidth(); ++x) {d[x] = clamp01((s[x] - min) / diff);}
+			}
+		}
+
 		/** normalize the image = set all values between [0.0:1.0] */
 		static ImageChannel run(const ImageChannel& img) {
 			ImageChannel out = img;
@@ -0,0 +1,152 @@
+#ifndef K_CV_REGIONEXTREMUM_H
+#define K_CV_REGIONEXTREMUM_H
+
+#include "../ImageChannel.h"
+#include "../../Assertions.h"
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+namespace K {
+
+	/** minimum of two values (for RegionExtremum) */
+	struct RegionExtremumMin {
+		static inline float identity() {return +std::numeric_limits<float>::infinity();}
+		static inline float get(const float a, const float b) {return (a < b) ? a : b;}
+	};
+
+	/** maximum of two values (for RegionExtremum) */
+	struct RegionExtremumMax {
+		static inline float identity() {return -std::numeric_limits<float>::infinity();}
+		static inline float get(const float a, const float b) {return (a > b) ? a : b;}
+	};
+
+	/**
+	 * regional minimum/maximum of an image using the van Herk/Gil-Werman algorithm.
+	 *
+	 * the region is separated into a horizontal and a vertical pass.
+	 * each pass splits the (padded) data into blocks of the window's size
+	 * and uses the prefix- and suffix-extremum within each block.
+	 * every window is the combination of one suffix and one prefix,
+	 * resulting in 3 comparisons per pixel and pass, independent of the window's size.
+	 *
+	 * the padding uses the operation's identity, so windows at the image's edges
+	 * shrink exactly as for MinimumRegion::get() / MaximumRegion::get().
+	 */
+	template <typename Op> class RegionExtremum {
+
+	public:
+
+		/** apply the regional extremum of size (sx,sy) to the given image */
+		static ImageChannel apply(const ImageChannel& img, const int sx, const int sy) {
+
+			// sanity checks
+			_assertTrue(sx % 2 == 1, "sx must be odd");
+			_assertTrue(sy % 2 == 1, "sy must be odd");
+
+			const int w = img.getWidth();
+			const int h = img.getHeight();
+
+			ImageChannel tmp(w, h);
+			ImageChannel res(w, h);
+			if (w == 0 || h == 0) {return res;}
+
+			// horizontal pass: each row is independent
+			#pragma omp parallel
+			{
+				std::vector<float> p, g, s;
+				#pragma omp for
+				for (int y = 0; y < h; ++y) {
+					runLine(img.getData() + y*w, tmp.getData() + y*w, w, sx, p, g, s);
+				}
+			}
+
+			// vertical pass: the blocks of sy rows are independent, as are all output rows
+			const int ry = sy / 2;
+			const int m = getPaddedSize(h, sy);
+			std::vector<float> g(m * w);
+			std::vector<float> s(m * w);
+
+			#pragma omp parallel for
+			for (int b = 0; b < m / sy; ++b) {
+
+				const int i0 = b * sy;
+				const int i1 = i0 + sy - 1;
+
+				// prefix-extremum within the block
+				for (int i = i0; i <= i1; ++i) {
+					float* gRow = &g[i*w];
+					const float* row = getRow(tmp, i - ry);
+					for (int x = 0; x < w; ++x) {
+						const float v = (row) ? (row[x]) : (Op::identity());
+						gRow[x] = (i == i0) ? (v) : (Op::get(gRow[x-w], v));
+					}
+				}
+
+				// suffix-extremum within the block
+				for (int i = i1; i >= i0; --i) {
+					float* sRow = &s[i*w];
+					const float* row = getRow(tmp, i - ry);
+					for (int x = 0; x < w; ++x) {
+						const float v = (row) ? (row[x]) : (Op::identity());
+						sRow[x] = (i == i1) ? (v) : (Op::get(sRow[x+w], v));
+					}
+				}
+
+			}
+
+			#pragma omp parallel for
+			for (int y = 0; y < h; ++y) {
+				const float* sRow = &s[y*w];
+				const float* gRow = &g[(y+sy-1)*w];
+				float* dst = res.getData() + y*w;
+				for (int x = 0; x < w; ++x) {dst[x] = Op::get(sRow[x], gRow[x]);}
+			}
+
+			return res;
+
+		}
+
+	private:
+
+		/** the padded (by the window's radius on both sides) size, rounded up to a multiple of the window's size */
+		static inline int getPaddedSize(const int n, const int k) {
+			const int m = n + (k-1);
+			return ((m + k - 1) / k) * k;
+		}
+
+		/** get the given row of the image, or nullptr if outside */
+		static inline const float* getRow(const ImageChannel& img, const int y) {
+			if (y < 0 || y >= img.getHeight()) {return nullptr;}
+			return img.getData() + y * img.getWidth();
+		}
+
+		/** 1D van Herk/Gil-Werman for one line using the provided scratch buffers */
+		static void runLine(const float* src, float* dst, const int n, const int k,
+							std::vector<float>& p, std::vector<float>& g, std::vector<float>& s) {
+
+			const int r = k / 2;
+			const int m = getPaddedSize(n, k);
+			p.assign(m, Op::identity());
+			g.resize(m);
+			s.resize(m);
+			std::copy(src, src+n, p.begin() + r);
+
+			for (int i = 0; i < m; ++i) {
+				g[i] = (i % k == 0) ? (p[i]) : (Op::get(g[i-1], p[i]));
+			}
+			for (int i = m-1; i >= 0; --i) {
+				s[i] = (i % k == k-1) ? (p[i]) : (Op::get(s[i+1], p[i]));
+			}
+			for (int x = 0; x < n; ++x) {
+				dst[x] = Op::get(s[x], g[x+k-1]);
+			}
+
+		}
+
+	};
+
+}
+
+#endif // K_CV_REGIONEXTREMUM_H
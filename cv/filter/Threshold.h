@@ -22,6 +22,22 @@ namespace K {
 
 		}
 
+		/** inplace convert the view to black/white */
+		static void inplace(const ImageView& img, const float threshold = 0.5f) {
+			run(img, img, threshold);
+		}
+
+		/** convert the src view to black/white, writing into the dst view of the same size (may be the same) */
+		static void run(const ConstImageView& src, const ImageView& dst, const float threshold = 0.5f) {
+			_assertEqual(src.getWidth(), dst.getWidth(), "width of src and dst differs");
+			_assertEqual(src.getHeight(), dst.getHeight(), "height of src and dst differs");
+			for (int y = 0; y < src.getHeight(); ++y) {
+				const float* s = src.getRow(y);
+				float* d = dst.getRow(y);
+				for (int x = 0; x < src.getWidth(); ++x) {d[x] = (s[x] > threshold) ? (1.0f) : (0.0f);}
+			}
+		}
+
 		/** inplace convert the image to black/white */
 		static ImageChannel get(ImageChannel& img, const float threshold = 0.5f) {
 
@@ -3,6 +3,9 @@
 
 #include "../../geo/Point2.h"
 #include "../ImageChannel.h"
+#include "../IntegralImage.h"
+
+#include <cmath>
 
 namespace K {
 
@@ -46,6 +49,34 @@ namespace K {
 
 		}
 
+		/**
+		 * get the error (see getError()) for each pixel p of the first image,
+		 * when matched against p+offset within the second image.
+		 * uses an integral image of the absolute differences, hence the cost
+		 * per pixel does not depend on the window-size
+		 */
+		ImageChannel getErrors(const Point2i offset) const {
+
+			const int w = img1.getWidth();
+			const int h = img1.getHeight();
+
+			// padding by the window-size equals the clamped access of getError()
+			auto diff = [&] (const int x, const int y) {
+				return std::abs(img1.getClamped(x, y) - img2.getClamped(x+offset.x, y+offset.y));
+			};
+			const IntegralImage ii(w, h, size, diff);
+
+			ImageChannel errors(w, h);
+			#pragma omp parallel for
+			for (int y = 0; y < h; ++y) {
+				for (int x = 0; x < w; ++x) {
+					errors.set(x, y, (float) ii.getSum(x, y, size));
+				}
+			}
+			return errors;
+
+		}
+
 	};
 
 }
@@ -4,6 +4,7 @@
 #include "../../geo/Point2.h"
 #include "../ImageChannel.h"
 #include "../Bitmap.h"
+#include "../BitmapPacked.h"
 
 #include "Segment.h"
 
@@ -23,11 +24,11 @@ namespace K {
 		 * get all other pixels beloging attached to the same seed.
 		 * pixels count as attached when their difference is below the given threshold.
 		 * @param seed the position to start searching
-		 * @parma used track which points already belong to a segment and are thus skipped
+		 * @parma used track which points already belong to a segment and are thus skipped (Bitmap or BitmapPacked)
 		 * @param threshold the difference threshold to use
 		 * @return
 		 */
-		static Segment<float> get(const ImageChannel& img, const Point2i& seed, Bitmap& used, const float threshold = 0.1f) {
+		template <typename UsedMap> static Segment<float> get(const ImageChannel& img, const Point2i& seed, UsedMap& used, const float threshold = 0.1f) {
 
 			// track all to-be-checked points
 			std::vector<Point2i> toCheck;
@@ -111,7 +112,7 @@ namespace K {
 		static Segment<float> get(const ImageChannel& img, const Point2i& seed, const float threshold = 0.1f) {
 
 			// track all visited points
-			Bitmap used(img.getWidth(), img.getHeight());
+			BitmapPacked used(img.getWidth(), img.getHeight());
 
 			// execute
 			return get(img, seed, used, threshold);
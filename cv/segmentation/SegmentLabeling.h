@@ -0,0 +1,319 @@
+#ifndef K_CV_SEGMENTLABELING_H
+#define K_CV_SEGMENTLABELING_H
+
+#include "Segment.h"
+#include "../ImageChannel.h"
+#include "../DataMatrix.h"
+#include "../../geo/Point2.h"
+#include "../../geo/BBox2.h"
+#include "../../Assertions.h"
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+namespace K {
+
+	/** statistics for one labeled segment */
+	struct SegmentStats {
+
+		/** number of pixels within the segment */
+		int count;
+
+		/** the average color-value for the segment */
+		float avg;
+
+		/** the segment's bounding-box */
+		BBox2i bbox;
+
+		/** ctor */
+		SegmentStats() : count(0), avg(NAN), bbox() {;}
+
+	};
+
+	/** the result of SegmentLabeling: a label for each pixel and statistics for each segment */
+	class SegmentLabels {
+
+		friend class SegmentLabeling;
+
+	private:
+
+		/** the segment [0:n[ each pixel belongs to */
+		DataMatrix<int> labels;
+
+		/** the statistics for each segment */
+		std::vector<SegmentStats> stats;
+
+	public:
+
+		/** get the number of segments */
+		int getNumSegments() const {return (int) stats.size();}
+
+		/** get the label-image */
+		const DataMatrix<int>& getLabels() const {return labels;}
+
+		/** get the segment the given pixel belongs to */
+		int getLabel(const int x, const int y) const {return labels.get(x,y);}
+
+		/** get the statistics for all segments */
+		const std::vector<SegmentStats>& getStats() const {return stats;}
+
+		/** get the statistics for the given segment */
+		const SegmentStats& getStats(const int label) const {return stats[label];}
+
+		/** get the given segment including all of its points (row by row) */
+		Segment<float> getSegment(const int label) const {
+			const SegmentStats& s = stats[label];
+			Segment<float> seg;
+			seg.avg = s.avg;
+			seg.points.reserve(s.count);
+			for (int y = s.bbox.getMin().y; y <= s.bbox.getMax().y; ++y) {
+				for (int x = s.bbox.getMin().x; x <= s.bbox.getMax().x; ++x) {
+					if (labels.get(x,y) == label) {seg.points.push_back(Point2i(x,y));}
+				}
+			}
+			return seg;
+		}
+
+		/**
+		 * get all segments including their points (row by row).
+		 * the segments are ordered like for Segmentation::getSegments(),
+		 * by their first pixel when scanning the image column by column
+		 */
+		std::vector<Segment<float>> getSegments() const {
+
+			const int w = labels.getWidth();
+			const int h = labels.getHeight();
+
+			// the first pixel of each segment (column by column)
+			std::vector<int> first(stats.size(), INT32_MAX);
+			for (int y = 0; y < h; ++y) {
+				for (int x = 0; x < w; ++x) {
+					int& f = first[labels.get(x,y)];
+					f = std::min(f, x*h + y);
+				}
+			}
+
+			std::vector<int> order(stats.size());
+			for (size_t i = 0; i < order.size(); ++i) {order[i] = (int) i;}
+			std::sort(order.begin(), order.end(), [&] (const int a, const int b) {return first[a] < first[b];});
+
+			// the position of each segment within the result
+			std::vector<int> pos(stats.size());
+			std::vector<Segment<float>> segments(stats.size());
+			for (size_t i = 0; i < order.size(); ++i) {
+				pos[order[i]] = (int) i;
+				segments[i].avg = stats[order[i]].avg;
+				segments[i].points.reserve(stats[order[i]].count);
+			}
+
+			// one pass over all pixels
+			for (int y = 0; y < h; ++y) {
+				for (int x = 0; x < w; ++x) {
+					segments[pos[labels.get(x,y)]].points.push_back(Point2i(x,y));
+				}
+			}
+
+			return segments;
+
+		}
+
+	};
+
+	/**
+	 * image segmentation by two-pass connected-component labeling.
+	 *
+	 * uses the same semantics as RegionGrowing/Segmentation: two 8-connected
+	 * pixels belong to the same segment if their difference is below the threshold.
+	 *
+	 * the first pass scans the image row by row and connects each pixel to its
+	 * already visited neighbors (W, NW, N, NE) using union-find. the second pass
+	 * resolves the final labels and accumulates the statistics. contrary to
+	 * flood-filling, no per-pixel stack or point-list is needed.
+	 *
+	 * the parallel version labels horizontal strips independently and merges
+	 * the seams between adjacent strips afterwards. the result is identical.
+	 */
+	class SegmentLabeling {
+
+	public:
+
+		/**
+		 * label all connected segments within the given image
+		 * @param img the image to segmentize
+		 * @param threshold the maximum difference to allow between two adjacent pixels
+		 * @return the label-image and the statistics for each segment
+		 */
+		static SegmentLabels run(const ImageChannel& img, const float threshold = 0.1f) {
+			return run(img, threshold, img.getHeight());
+		}
+
+		/**
+		 * label all connected segments within the given image, processing strips in parallel
+		 * @param img the image to segmentize
+		 * @param threshold the maximum difference to allow between two adjacent pixels
+		 * @param stripHeight the number of rows to label per (independent) strip
+		 * @return the label-image and the statistics for each segment
+		 */
+		static SegmentLabels runParallel(const ImageChannel& img, const float threshold = 0.1f, const int stripHeight = 64) {
+			return run(img, threshold, stripHeight);
+		}
+
+	private:
+
+		static SegmentLabels run(const ImageChannel& img, const float threshold, const int stripHeight) {
+
+			_assertTrue(stripHeight > 0, "invalid strip height");
+
+			const int w = img.getWidth();
+			const int h = img.getHeight();
+			const int numStrips = (h + stripHeight - 1) / stripHeight;
+
+			SegmentLabels res;
+			res.labels = DataMatrix<int>(w, h);
+
+			// union-find over provisional labels. strip s uses labels starting at its first pixel's index
+			std::vector<int> parent(w*h);
+
+			// number of provisional labels used by each strip
+			std::vector<int> used(numStrips);
+
+			// 1st pass: label each strip independently
+			#pragma omp parallel for schedule(dynamic)
+			for (int s = 0; s < numStrips; ++s) {
+				const int y0 = s * stripHeight;
+				const int y1 = std::min(h, y0 + stripHeight);
+				used[s] = labelStrip(img, threshold, y0, y1, res.labels, parent);
+			}
+
+			// merge the seams between adjacent strips
+			for (int s = 1; s < numStrips; ++s) {
+				const int y = s * stripHeight;
+				for (int x = 0; x < w; ++x) {
+					const float v = img.get(x,y);
+					const int l = res.labels.get(x,y);
+					if (x > 0	&& similar(v, img.get(x-1,y-1), threshold))	{unite(parent, l, res.labels.get(x-1,y-1));}
+								if (similar(v, img.get(x  ,y-1), threshold))	{unite(parent, l, res.labels.get(x  ,y-1));}
+					if (x < w-1	&& similar(v, img.get(x+1,y-1), threshold))	{unite(parent, l, res.labels.get(x+1,y-1));}
+				}
+			}
+
+			// flatten: each label's parent is smaller than the label itself, thus one ascending pass suffices.
+			// roots are numbered [0:n[ in ascending order, which equals a sequential row-by-row scan
+			int cnt = 0;
+			for (int s = 0; s < numStrips; ++s) {
+				const int l0 = s * stripHeight * w;
+				for (int l = l0; l < l0 + used[s]; ++l) {
+					if (parent[l] == l) {parent[l] = -1 - cnt++;}			// root: store the final label (negative)
+					else {parent[l] = parent[parent[l]];}					// parent already resolved
+				}
+			}
+
+			// 2nd pass: final labels and statistics
+			res.stats.resize(cnt);
+			std::vector<double> sums(cnt, 0.0);
+
+			#pragma omp parallel
+			{
+
+				std::vector<SegmentStats> locStats(cnt);
+				std::vector<double> locSums(cnt, 0.0);
+
+				#pragma omp for schedule(static)
+				for (int y = 0; y < h; ++y) {
+					int* row = res.labels.getData() + y*w;
+					const float* src = img.getData() + y*w;
+					for (int x = 0; x < w; ++x) {
+						const int l = -1 - parent[row[x]];
+						row[x] = l;
+						SegmentStats& st = locStats[l];
+						++st.count;
+						st.bbox.add(Point2i(x,y));
+						locSums[l] += src[x];
+					}
+				}
+
+				#pragma omp critical
+				{
+					for (int l = 0; l < cnt; ++l) {
+						if (locStats[l].count == 0) {continue;}
+						res.stats[l].count += locStats[l].count;
+						res.stats[l].bbox.add(locStats[l].bbox);
+						sums[l] += locSums[l];
+					}
+				}
+
+			}
+
+			for (int l = 0; l < cnt; ++l) {
+				res.stats[l].avg = (float) (sums[l] / res.stats[l].count);
+			}
+
+			return res;
+
+		}
+
+		/** label the rows [y0:y1[. returns the number of provisional labels used, starting at y0*w */
+		static int labelStrip(const ImageChannel& img, const float threshold, const int y0, const int y1, DataMatrix<int>& labels, std::vector<int>& parent) {
+
+			const int w = img.getWidth();
+			const int l0 = y0 * w;
+			int next = l0;
+
+			for (int y = y0; y < y1; ++y) {
+				for (int x = 0; x < w; ++x) {
+
+					const float v = img.get(x,y);
+					int l = -1;
+
+					// connect to all already visited neighbors within this strip
+					auto check = [&] (const int nx, const int ny) {
+						if (!similar(v, img.get(nx,ny), threshold)) {return;}
+						const int nl = labels.get(nx,ny);
+						if (l < 0) {l = nl;} else {unite(parent, l, nl);}
+					};
+
+					if (x > 0)				{check(x-1, y);}
+					if (y > y0) {
+						if (x > 0)			{check(x-1, y-1);}
+											{check(x  , y-1);}
+						if (x < w-1)		{check(x+1, y-1);}
+					}
+
+					// no neighbor? -> new label
+					if (l < 0) {l = next; parent[next] = next; ++next;}
+					labels.set(x, y, l);
+
+				}
+			}
+
+			return next - l0;
+
+		}
+
+		/** same segment? (see RegionGrowing) */
+		static inline bool similar(const float a, const float b, const float threshold) {
+			return std::abs(a - b) <= threshold;
+		}
+
+		static int find(std::vector<int>& parent, int i) {
+			while (parent[i] != i) {
+				parent[i] = parent[parent[i]];
+				i = parent[i];
+			}
+			return i;
+		}
+
+		/** unite both sets, the smaller label becomes the root */
+		static void unite(std::vector<int>& parent, const int a, const int b) {
+			const int ra = find(parent, a);
+			const int rb = find(parent, b);
+			if (ra < rb) {parent[rb] = ra;} else if (rb < ra) {parent[ra] = rb;}
+		}
+
+	};
+
+}
+
+#endif // K_CV_SEGMENTLABELING_H
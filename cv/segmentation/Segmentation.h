@@ -4,6 +4,12 @@
 #include "Segment.h"
 #include "../ImageChannel.h"
 #include "RegionGrowing.h"
+#include "SegmentLabeling.h"
+#include "../BitmapPacked.h"
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
 
 #include "unordered_set"
 
@@ -24,11 +30,59 @@ namespace K {
 
 		static std::vector<Segment<float>> getSegments(const ImageChannel& img, const float threshold = 0.1f) {
 
-			// track whether a pixel already belongs to a segment
-			Bitmap used(img.getWidth(), img.getHeight());
+			// binary images (0/1 only) are labeled using runs of the packed bitmap instead of flood-filling.
+			// only valid if equal pixels are joined and 0/1 are not (negative thresholds join nothing)
+			if (threshold >= 0.0f && threshold < 1.0f && isBinary(img)) {
+				return getSegments(BitmapPacked(img, 0.5f));
+			}
 
-			// run
-			return getSegments(img, used, threshold);
+			// label all pixels in one pass (instead of flood-filling each segment) and collect the points afterwards
+			return SegmentLabeling::runParallel(img, threshold).getSegments();
+
+		}
+
+		/**
+		 * get all 8-connected segments of set (avg = 1) and cleared (avg = 0) pixels within the given bitmap.
+		 * the segments are ordered like for getSegments(ImageChannel) using the first pixel of each segment
+		 * (column by column), the points within each segment are ordered row by row.
+		 * @param bmp the bitmap to segmentize
+		 * @return
+		 */
+		static std::vector<Segment<float>> getSegments(const BitmapPacked& bmp) {
+
+			const int h = bmp.getHeight();
+
+			// components of set and of cleared pixels
+			BitmapPacked inv = bmp;
+			inv.invert();
+			std::vector<BitmapRun> runsSet;
+			std::vector<BitmapRun> runsClear;
+			const int numSet = bmp.getComponents(runsSet);
+			const int numClear = inv.getComponents(runsClear);
+
+			std::vector<Segment<float>> segments(numSet + numClear);
+			std::vector<int> first(segments.size(), INT32_MAX);
+
+			auto add = [&] (const std::vector<BitmapRun>& runs, const int offset, const float avg) {
+				for (const BitmapRun& r : runs) {
+					Segment<float>& seg = segments[offset + r.label];
+					seg.avg = avg;
+					for (int x = r.x0; x < r.x1; ++x) {seg.points.push_back(Point2i(x, r.y));}
+					first[offset + r.label] = std::min(first[offset + r.label], r.x0 * h + r.y);
+				}
+			};
+			add(runsSet, 0, 1.0f);
+			add(runsClear, numSet, 0.0f);
+
+			// order by the first pixel (scanning column by column)
+			std::vector<int> order(segments.size());
+			for (size_t i = 0; i < order.size(); ++i) {order[i] = (int) i;}
+			std::sort(order.begin(), order.end(), [&] (const int a, const int b) {return first[a] < first[b];});
+
+			std::vector<Segment<float>> res;
+			res.reserve(segments.size());
+			for (const int i : order) {res.push_back(std::move(segments[i]));}
+			return res;
 
 		}
 
@@ -40,9 +94,15 @@ namespace K {
 		 * @return
 		 */
 		static std::vector<Segment<float>> getSegments(const ImageChannel& img, Bitmap& used, const float threshold = 0.1f) {
-
-			// all detected segments
 			std::vector<Segment<float>> segments;
+			getSegments(img, used, threshold, segments);
+			return segments;
+		}
+
+	private:
+
+		/** append all segments not yet marked as used */
+		static void getSegments(const ImageChannel& img, Bitmap& used, const float threshold, std::vector<Segment<float>>& segments) {
 
 			// process all points of the image
 			Point2i p(0,0);
@@ -59,9 +119,15 @@ namespace K {
 				}
 			}
 
-			// done
-			return segments;
+		}
 
+		/** does the image only contain 0 and 1? */
+		static bool isBinary(const ImageChannel& img) {
+			const float* data = img.getData();
+			for (int i = 0; i < img.getWidth()*img.getHeight(); ++i) {
+				if (data[i] != 0.0f && data[i] != 1.0f) {return false;}
+			}
+			return true;
 		}
 
 
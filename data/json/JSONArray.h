@@ -14,6 +14,7 @@ namespace K {
 	private:
 
 		friend class JSONWriter;
+		friend class JSONStreamWriter;
 
 		/** all entries within the array */
 		std::vector<JSONValue> entries;
@@ -100,7 +101,7 @@ namespace K {
  * dunno why i need to add this one here instead of JSONValue.h.
  * putting it there fails to declare JSONArray.h somehow...
  */
-K::JSONValue::~JSONValue() {
+inline K::JSONValue::~JSONValue() {
 	switch(type) {
 		case JSONValueType::EMPTY:
 		case JSONValueType::BOOLEAN:
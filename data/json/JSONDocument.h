@@ -0,0 +1,649 @@
+#ifndef K_DATA_JSON_JSONDOCUMENT_H
+#define K_DATA_JSON_JSONDOCUMENT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+
+#include "JSONTypes.h"
+#include "JSONStructuralIndex.h"
+#include "JSONArray.h"
+#include "JSONObject.h"
+#include "../../string/NumberParser.h"
+
+namespace K {
+
+	/** a string within the parsed input (not copied, not unescaped) */
+	struct JSONStringView {
+
+		/** the first char */
+		const char* data;
+
+		/** the number of chars */
+		size_t len;
+
+		/** ctor */
+		JSONStringView() : data(nullptr), len(0) {;}
+
+		/** ctor */
+		JSONStringView(const char* data, const size_t len) : data(data), len(len) {;}
+
+		/** get a copy as string */
+		std::string str() const {return std::string(data, len);}
+
+		/** compare with the given string */
+		bool operator == (const std::string& s) const {return s.length() == len && memcmp(s.data(), data, len) == 0;}
+
+	};
+
+	/**
+	 * one value within the document's tape.
+	 * containers are followed by their children, objects by key/value pairs
+	 */
+	struct JSONTapeEntry {
+
+		/** the value's first byte within the input (strings: after the quote) */
+		uint32_t pos;
+
+		/** strings and scalars: number of bytes. objects and arrays: number of children */
+		uint32_t len;
+
+		/** the tape index after this value (and all of its children) */
+		uint32_t next;
+
+		/** the value's type */
+		JSONValueType type;
+
+	};
+
+	class JSONDocument;
+
+	/**
+	 * @brief lazy view of one value within a parsed JSONDocument.
+	 *
+	 * nothing is converted until accessed: strings are unescaped and
+	 * numbers are parsed (NumberParser) on request. object-members are
+	 * found by a linear search over the keys. valid as long as the
+	 * document and its input are.
+	 */
+	class JSONElement {
+
+	private:
+
+		friend class JSONDocument;
+
+		const JSONDocument* doc;
+		uint32_t idx;
+
+	public:
+
+		/** iterate over the values of an array or the key/value pairs of an object */
+		class Iterator {
+			const JSONDocument* doc;
+			uint32_t idx;
+			bool isObject;
+		public:
+			Iterator(const JSONDocument* doc, const uint32_t idx, const bool isObject) : doc(doc), idx(idx), isObject(isObject) {;}
+			/** the current value */
+			JSONElement operator * () const {return JSONElement(doc, (isObject) ? (idx + 1) : (idx));}
+			/** the current key (objects only) */
+			JSONStringView key() const;
+			/** proceed with the next value */
+			Iterator& operator ++ ();
+			bool operator != (const Iterator& o) const {return idx != o.idx;}
+		};
+
+		/** empty ctor */
+		JSONElement() : doc(nullptr), idx(0) {;}
+
+		/** ctor */
+		JSONElement(const JSONDocument* doc, const uint32_t idx) : doc(doc), idx(idx) {;}
+
+		/** the value's type */
+		JSONValueType getType() const {return entry().type;}
+
+		/** is this a null value? */
+		bool isNull() const {return getType() == JSONValueType::EMPTY;}
+
+		/** get the boolean value */
+		bool asBool() const;
+
+		/** get the integer value. doubles are truncated */
+		int64_t asInt() const;
+
+		/** get the double value. integers are converted */
+		double asDouble() const;
+
+		/** get the (unescaped) string value */
+		std::string asString() const;
+
+		/** get the string value as it is within the input (still escaped) */
+		JSONStringView asRawString() const;
+
+		/** number of values within an array or key/value pairs within an object */
+		size_t size() const {return isContainer() ? entry().len : 0;}
+
+		/** get the idx-th value of an array. throws if out of bounds */
+		JSONElement operator [] (const int idx) const;
+
+		/** get the value of an object for the given key. throws if not present */
+		JSONElement operator [] (const std::string& key) const;
+
+		/** find the value of an object for the given key. returns false if not present */
+		bool find(const std::string& key, JSONElement& out) const;
+
+		/** does the object contain a value for the given key? */
+		bool containsValue(const std::string& key) const {JSONElement tmp; return find(key, tmp);}
+
+		/** iterate over an array or object */
+		Iterator begin() const {return Iterator(doc, (isContainer()) ? (idx + 1) : (idx), getType() == JSONValueType::JSON_OBJECT);}
+		Iterator end() const {return Iterator(doc, entry().next, getType() == JSONValueType::JSON_OBJECT);}
+
+		/** convert this value (and all of its children) into a JSONValue */
+		JSONValue toValue() const;
+
+	private:
+
+		inline const JSONTapeEntry& entry() const;
+		inline const char* text() const;
+
+		bool isContainer() const {
+			return getType() == JSONValueType::JSON_OBJECT || getType() == JSONValueType::JSON_ARRAY;
+		}
+
+		void expect(const JSONValueType type, const char* what) const {
+			if (getType() != type) {throw JSONReaderException(std::string("value is not ") + what);}
+		}
+
+		static void unescape(const char* str, const size_t len, std::string& res);
+		static uint32_t parseHex4(const char* str);
+		static void appendUTF8(uint32_t cp, std::string& res);
+
+	};
+
+	/**
+	 * @brief JSON parser creating a flat tape instead of a tree of objects.
+	 *
+	 * stage 1 (JSONStructuralIndex) finds all structural chars using SIMD,
+	 * stage 2 walks them once, validates the grammar and appends one
+	 * JSONTapeEntry per value. strings and numbers are not copied, the
+	 * tape refers to the input. the document's buffers are reused for
+	 * every parse, thus parsing does not allocate once they are large
+	 * enough.
+	 *
+	 * the input must stay valid (and unchanged) while the document is used.
+	 */
+	class JSONDocument {
+
+	private:
+
+		friend class JSONElement;
+
+		/** the parsed input */
+		const char* data;
+		size_t len;
+
+		/** stage 1: the position of every structural char */
+		std::vector<uint32_t> structurals;
+
+		/** stage 2: all values */
+		std::vector<JSONTapeEntry> tape;
+
+		/** stage 2: the open containers */
+		std::vector<uint32_t> stack;
+
+		/** the top-level values of parse() */
+		std::vector<uint32_t> roots;
+
+	public:
+
+		/** ctor */
+		JSONDocument() : data(nullptr), len(0) {;}
+
+		/** parse the given input (exactly one value). the input must outlive the document */
+		JSONElement parse(const char* data, const size_t len) {
+			parseMany(data, len, roots);
+			if (roots.size() != 1) {throw JSONReaderException((roots.empty()) ? ("found no value") : ("found unexpected trailing data"));}
+			return JSONElement(this, roots[0]);
+		}
+
+		/** parse the given input (exactly one value). the string must outlive the document */
+		JSONElement parse(const std::string& str) {
+			return parse(str.data(), str.length());
+		}
+
+		/** parse the given null-terminated input (exactly one value) */
+		JSONElement parse(const char* str) {
+			return parse(str, strlen(str));
+		}
+
+		/** temporaries would not outlive the document */
+		JSONElement parse(std::string&& str) = delete;
+
+		/**
+		 * parse a sequence of values (e.g. newline delimited JSON).
+		 * the tape index of every top-level value is appended to roots
+		 */
+		void parseMany(const char* data, const size_t len, std::vector<uint32_t>& roots) {
+
+			if (len > 0xFFFFFFFFu) {throw JSONReaderException("input exceeds 4 GB");}
+			this->data = data;
+			this->len = len;
+
+			JSONStructuralIndex::build(data, len, structurals);
+
+			tape.clear();
+			roots.clear();
+			size_t i = 0;
+			while (i < structurals.size()) {
+				roots.push_back((uint32_t) tape.size());
+				i = parseValue(i);
+			}
+
+		}
+
+		/** get the value at the given tape index (see parseMany) */
+		JSONElement get(const uint32_t tapeIdx) const {return JSONElement(this, tapeIdx);}
+
+		/** number of tape entries of the last parse */
+		size_t getTapeSize() const {return tape.size();}
+
+	private:
+
+		/** states of the stage 2 parser */
+		enum class State {
+			VALUE,
+			FIRST_KEY,
+			KEY,
+			FIRST_ELEMENT,
+			NEXT,
+		};
+
+		/** the char at the i-th structural position */
+		inline char at(const size_t i) const {
+			if (i >= structurals.size()) {throw JSONReaderException("found unexpected end of input");}
+			return data[structurals[i]];
+		}
+
+		/** error with the position and the surrounding input */
+		JSONReaderException error(const std::string& msg, const size_t i) const {
+			const size_t pos = (i < structurals.size()) ? (structurals[i]) : (len);
+			const size_t end = (pos + 32 < len) ? (pos + 32) : (len);
+			return JSONReaderException(msg + " at offset " + std::to_string(pos) + ":\n" + std::string(data + pos, end - pos));
+		}
+
+		/** append a tape entry */
+		inline uint32_t add(const JSONValueType type, const uint32_t pos, const uint32_t len) {
+			const uint32_t idx = (uint32_t) tape.size();
+			JSONTapeEntry e;
+			e.pos = pos;
+			e.len = len;
+			e.next = idx + 1;
+			e.type = type;
+			tape.push_back(e);
+			return idx;
+		}
+
+		/** parse one (top-level) value starting at the i-th structural. returns the index after the value */
+		size_t parseValue(size_t i) {
+
+			stack.clear();
+			State state = State::VALUE;
+
+			while (true) {
+
+				switch (state) {
+
+					case State::VALUE: {
+						const char c = at(i);
+						if (c == '{') {
+							stack.push_back(add(JSONValueType::JSON_OBJECT, structurals[i], 0));
+							++i; state = State::FIRST_KEY; continue;
+						}
+						if (c == '[') {
+							stack.push_back(add(JSONValueType::JSON_ARRAY, structurals[i], 0));
+							++i; state = State::FIRST_ELEMENT; continue;
+						}
+						if (c == '"') {
+							addString(i);
+							i += 2;
+						} else {
+							addScalar(i);
+							++i;
+						}
+						state = State::NEXT;
+						break;
+					}
+
+					case State::FIRST_KEY:
+						if (at(i) == '}') {close(); ++i; state = State::NEXT; break;}
+						// fall through
+
+					case State::KEY:
+						if (at(i) != '"') {throw error("expected a key", i);}
+						addString(i);
+						i += 2;
+						if (at(i) != ':') {throw error("expected ':'", i);}
+						++i;
+						++tape[stack.back()].len;
+						state = State::VALUE;
+						break;
+
+					case State::FIRST_ELEMENT:
+						if (at(i) == ']') {close(); ++i; state = State::NEXT; break;}
+						++tape[stack.back()].len;
+						state = State::VALUE;
+						break;
+
+					case State::NEXT: {
+						if (stack.empty()) {return i;}
+						const bool isObject = tape[stack.back()].type == JSONValueType::JSON_OBJECT;
+						const char c = at(i);
+						if (c == ',') {
+							++i;
+							if (isObject) {state = State::KEY;} else {++tape[stack.back()].len; state = State::VALUE;}
+						} else if (c == ((isObject) ? ('}') : (']'))) {
+							close(); ++i;
+						} else {
+							throw error((isObject) ? ("expected ',' or '}'") : ("expected ',' or ']'"), i);
+						}
+						break;
+					}
+
+				}
+
+			}
+
+		}
+
+		/** close the innermost container */
+		inline void close() {
+			tape[stack.back()].next = (uint32_t) tape.size();
+			stack.pop_back();
+		}
+
+		/** append the string starting at the i-th structural (its closing quote is the next one) */
+		inline void addString(const size_t i) {
+			if (i + 1 >= structurals.size()) {throw error("found unterminated string", i);}
+			const uint32_t start = structurals[i] + 1;
+			add(JSONValueType::STRING, start, structurals[i + 1] - start);
+		}
+
+		/** append the scalar (number, true, false, null) starting at the i-th structural */
+		void addScalar(const size_t i) {
+
+			const uint32_t start = structurals[i];
+			uint32_t end = (i + 1 < structurals.size()) ? (structurals[i + 1]) : ((uint32_t) len);
+			while (end > start && isWhitespace(data[end - 1])) {--end;}
+			const char* str = data + start;
+			const uint32_t n = end - start;
+
+			switch (str[0]) {
+				case 't':
+					if (n == 4 && memcmp(str, "true", 4) == 0) {add(JSONValueType::BOOLEAN, start, n); return;}
+					break;
+				case 'f':
+					if (n == 5 && memcmp(str, "false", 5) == 0) {add(JSONValueType::BOOLEAN, start, n); return;}
+					break;
+				case 'n':
+					if (n == 4 && memcmp(str, "null", 4) == 0) {add(JSONValueType::EMPTY, start, n); return;}
+					break;
+				default: {
+					const JSONValueType type = getNumberType(str, n);
+					if (type != JSONValueType::EMPTY) {add(type, start, n); return;}
+				}
+			}
+
+			throw error("expected one of boolean/int/double/string/object/array", i);
+
+		}
+
+		static inline bool isWhitespace(const char c) {
+			return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+		}
+
+		static inline bool isDigit(const char c) {
+			return c >= '0' && c <= '9';
+		}
+
+		/**
+		 * validate the number and get its type: INT, DOUBLE or EMPTY (invalid).
+		 * integers with more than 18 digits are treated as doubles
+		 */
+		static JSONValueType getNumberType(const char* str, const uint32_t n) {
+			uint32_t i = 0;
+			if (i < n && str[i] == '-') {++i;}
+			const uint32_t digits = i;
+			while (i < n && isDigit(str[i])) {++i;}
+			if (i == digits) {return JSONValueType::EMPTY;}
+			bool isDouble = (i - digits) > 18;
+			if (i < n && str[i] == '.') {
+				++i; isDouble = true;
+				const uint32_t frac = i;
+				while (i < n && isDigit(str[i])) {++i;}
+				if (i == frac) {return JSONValueType::EMPTY;}
+			}
+			if (i < n && (str[i] == 'e' || str[i] == 'E')) {
+				++i; isDouble = true;
+				if (i < n && (str[i] == '+' || str[i] == '-')) {++i;}
+				const uint32_t exp = i;
+				while (i < n && isDigit(str[i])) {++i;}
+				if (i == exp) {return JSONValueType::EMPTY;}
+			}
+			if (i != n) {return JSONValueType::EMPTY;}
+			return (isDouble) ? (JSONValueType::DOUBLE) : (JSONValueType::INT);
+		}
+
+	};
+
+
+
+	inline const JSONTapeEntry& JSONElement::entry() const {
+		return doc->tape[idx];
+	}
+
+	inline const char* JSONElement::text() const {
+		return doc->data + entry().pos;
+	}
+
+	inline JSONStringView JSONElement::Iterator::key() const {
+		return JSONElement(doc, idx).asRawString();
+	}
+
+	inline JSONElement::Iterator& JSONElement::Iterator::operator ++ () {
+		idx = doc->tape[(isObject) ? (idx + 1) : (idx)].next;
+		return *this;
+	}
+
+	inline bool JSONElement::asBool() const {
+		expect(JSONValueType::BOOLEAN, "a boolean");
+		return text()[0] == 't';
+	}
+
+	inline int64_t JSONElement::asInt() const {
+		if (getType() == JSONValueType::DOUBLE) {return (int64_t) asDouble();}
+		expect(JSONValueType::INT, "a number");
+		const char* str = text();
+		const char* end = str + entry().len;
+		const bool neg = (*str == '-');
+		if (neg) {++str;}
+		int64_t res = 0;
+		for (; str < end; ++str) {res = res * 10 + (*str - '0');}
+		return (neg) ? (-res) : (res);
+	}
+
+	inline double JSONElement::asDouble() const {
+		if (getType() == JSONValueType::INT) {return (double) asInt();}
+		expect(JSONValueType::DOUBLE, "a number");
+		double res = 0;
+		NumberParser::parse(text(), text() + entry().len, res);
+		return res;
+	}
+
+	inline std::string JSONElement::asString() const {
+		expect(JSONValueType::STRING, "a string");
+		const char* str = text();
+		const size_t len = entry().len;
+		if (!memchr(str, '\\', len)) {return std::string(str, len);}
+		std::string res;
+		unescape(str, len, res);
+		return res;
+	}
+
+	inline JSONStringView JSONElement::asRawString() const {
+		expect(JSONValueType::STRING, "a string");
+		return JSONStringView(text(), entry().len);
+	}
+
+	inline JSONElement JSONElement::operator [] (const int idx) const {
+		expect(JSONValueType::JSON_ARRAY, "an array");
+		if (idx < 0 || idx >= (int) size()) {throw JSONReaderException("array index out of bounds");}
+		Iterator it = begin();
+		for (int i = 0; i < idx; ++i) {++it;}
+		return *it;
+	}
+
+	inline JSONElement JSONElement::operator [] (const std::string& key) const {
+		JSONElement res;
+		if (!find(key, res)) {throw JSONReaderException("value for key not present: " + key);}
+		return res;
+	}
+
+	inline bool JSONElement::find(const std::string& key, JSONElement& out) const {
+		expect(JSONValueType::JSON_OBJECT, "an object");
+		std::string tmp;
+		for (Iterator it = begin(); it != end(); ++it) {
+			const JSONStringView k = it.key();
+			bool match;
+			if (memchr(k.data, '\\', k.len)) {
+				tmp.clear();
+				unescape(k.data, k.len, tmp);
+				match = (tmp == key);
+			} else {
+				match = (k == key);
+			}
+			if (match) {out = *it; return true;}
+		}
+		return false;
+	}
+
+	inline JSONValue JSONElement::toValue() const {
+		switch (getType()) {
+			case JSONValueType::EMPTY:		return JSONValue();
+			case JSONValueType::BOOLEAN:	return JSONValue(asBool());
+			case JSONValueType::INT:		return JSONValue(asInt());
+			case JSONValueType::DOUBLE:		return JSONValue(asDouble());
+			case JSONValueType::STRING:		return JSONValue(asString());
+			case JSONValueType::JSON_OBJECT: {
+				JSONObject* obj = new JSONObject();
+				try {
+					for (Iterator it = begin(); it != end(); ++it) {
+						const JSONStringView k = it.key();
+						std::string key;
+						unescape(k.data, k.len, key);
+						obj->put(key, (*it).toValue());
+					}
+				} catch (...) {
+					delete obj;
+					throw;
+				}
+				return JSONValue(obj);
+			}
+			case JSONValueType::JSON_ARRAY: {
+				JSONArray* arr = new JSONArray();
+				try {
+					for (Iterator it = begin(); it != end(); ++it) {arr->add((*it).toValue());}
+				} catch (...) {
+					delete arr;
+					throw;
+				}
+				return JSONValue(arr);
+			}
+		}
+		return JSONValue();
+	}
+
+	/** parse 4 hex digits. returns a value > 0xFFFF if invalid */
+	inline uint32_t JSONElement::parseHex4(const char* str) {
+		uint32_t res = 0;
+		for (int i = 0; i < 4; ++i) {
+			const char c = str[i];
+			res <<= 4;
+			if		(c >= '0' && c <= '9')	{res |= (uint32_t) (c - '0');}
+			else if	(c >= 'a' && c <= 'f')	{res |= (uint32_t) (c - 'a' + 10);}
+			else if	(c >= 'A' && c <= 'F')	{res |= (uint32_t) (c - 'A' + 10);}
+			else							{return 0xFFFFFFFF;}
+		}
+		return res;
+	}
+
+	/** append the given code point as UTF-8 */
+	inline void JSONElement::appendUTF8(const uint32_t cp, std::string& res) {
+		if (cp < 0x80) {
+			res += (char) cp;
+		} else if (cp < 0x800) {
+			res += (char) (0xC0 | (cp >> 6));
+			res += (char) (0x80 | (cp & 0x3F));
+		} else if (cp < 0x10000) {
+			res += (char) (0xE0 | (cp >> 12));
+			res += (char) (0x80 | ((cp >> 6) & 0x3F));
+			res += (char) (0x80 | (cp & 0x3F));
+		} else {
+			res += (char) (0xF0 | (cp >> 18));
+			res += (char) (0x80 | ((cp >> 12) & 0x3F));
+			res += (char) (0x80 | ((cp >> 6) & 0x3F));
+			res += (char) (0x80 | (cp & 0x3F));
+		}
+	}
+
+	/** append the unescaped version of the given string */
+	inline void JSONElement::unescape(const char* str, const size_t len, std::string& res) {
+
+		res.reserve(res.size() + len);
+		const char* end = str + len;
+
+		while (str < end) {
+
+			const char* bs = (const char*) memchr(str, '\\', (size_t) (end - str));
+			if (!bs) {res.append(str, (size_t) (end - str)); return;}
+			res.append(str, (size_t) (bs - str));
+			str = bs + 1;
+			if (str >= end) {throw JSONReaderException("found invalid escape sequence");}
+
+			switch (*str++) {
+				case '"':	res += '"'; break;
+				case '\\':	res += '\\'; break;
+				case '/':	res += '/'; break;
+				case 'b':	res += '\b'; break;
+				case 'f':	res += '\f'; break;
+				case 'n':	res += '\n'; break;
+				case 'r':	res += '\r'; break;
+				case 't':	res += '\t'; break;
+				case 'u': {
+					if (end - str < 4) {throw JSONReaderException("found invalid unicode escape");}
+					uint32_t cp = parseHex4(str);
+					str += 4;
+					if (cp > 0xFFFF) {throw JSONReaderException("found invalid unicode escape");}
+					// surrogate pair
+					if (cp >= 0xD800 && cp <= 0xDBFF) {
+						if (end - str < 6 || str[0] != '\\' || str[1] != 'u') {throw JSONReaderException("found invalid surrogate pair");}
+						const uint32_t low = parseHex4(str + 2);
+						if (low < 0xDC00 || low > 0xDFFF) {throw JSONReaderException("found invalid surrogate pair");}
+						cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+						str += 6;
+					}
+					appendUTF8(cp, res);
+					break;
+				}
+				default: throw JSONReaderException("found invalid escape sequence");
+			}
+
+		}
+
+	}
+
+}
+
+#endif // K_DATA_JSON_JSONDOCUMENT_H
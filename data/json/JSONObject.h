@@ -20,6 +20,7 @@ namespace K {
 	private:
 
 		friend class JSONWriter;
+		friend class JSONStreamWriter;
 
 		/** all key-value pairs within this object */
 		std::unordered_map<std::string, JSONValue> keyVal;
@@ -0,0 +1,21 @@
+#ifndef K_DATA_JSON_JSONREADEREXCEPTION_H
+#define K_DATA_JSON_JSONREADEREXCEPTION_H
+
+#include <string>
+#include <exception>
+
+namespace K {
+
+	/** exception handling within the reader */
+	class JSONReaderException : public std::exception {
+	private:
+		std::string msg;
+	public:
+		JSONReaderException(const std::string& msg) : msg(msg) {;}
+		JSONReaderException(const char* msg) : msg(msg) {;}
+		const char* what() const throw() {return msg.c_str();}
+	};
+
+}
+
+#endif // K_DATA_JSON_JSONREADEREXCEPTION_H
@@ -0,0 +1,130 @@
+#ifndef K_DATA_JSON_JSONSTREAMREADER_H
+#define K_DATA_JSON_JSONSTREAMREADER_H
+
+#include <vector>
+#include <cstring>
+
+#include "JSONDocument.h"
+#include "../../streams/InputStream.h"
+
+namespace K {
+
+	/**
+	 * @brief read newline delimited JSON (one value per line) from a stream.
+	 *
+	 * the input is read chunk-wise. every chunk is cut after its last
+	 * line-break and all of its values are parsed at once into one
+	 * JSONDocument, the rest is kept for the next chunk. memory usage
+	 * thus only depends on the chunk size (and the longest line),
+	 * not on the size of the input.
+	 */
+	class JSONStreamReader {
+
+	private:
+
+		/** the stream to read from */
+		InputStream* is;
+
+		/** the current chunk */
+		std::vector<char> buf;
+
+		/** number of bytes within buf */
+		size_t used;
+
+		/** number of bytes within buf that have been parsed */
+		size_t parsed;
+
+		/** end of stream reached? */
+		bool eof;
+
+		/** the values of the current chunk */
+		JSONDocument doc;
+		std::vector<uint32_t> roots;
+		size_t nextRoot;
+
+	public:
+
+		/**
+		 * ctor
+		 * @param is the stream to read from
+		 * @param chunkSize number of bytes to read and parse at once
+		 */
+		JSONStreamReader(InputStream* is, const size_t chunkSize = 1024*1024) :
+			is(is), buf(chunkSize), used(0), parsed(0), eof(false), nextRoot(0) {
+			;
+		}
+
+		/**
+		 * get the next value. it is valid until the next call.
+		 * returns false at the end of the stream
+		 */
+		bool next(JSONElement& out) {
+
+			while (nextRoot >= roots.size()) {
+				if (!nextChunk()) {return false;}
+			}
+
+			out = doc.get(roots[nextRoot++]);
+			return true;
+
+		}
+
+	private:
+
+		/** read and parse the next chunk. returns false if nothing is left */
+		bool nextChunk() {
+
+			// keep the unparsed rest
+			memmove(buf.data(), buf.data() + parsed, used - parsed);
+			used -= parsed;
+			parsed = 0;
+			roots.clear();
+			nextRoot = 0;
+
+			if (eof && used == 0) {return false;}
+
+			size_t scanned = 0;
+			while (true) {
+
+				// the chunk ends after the last complete line
+				const size_t end = findLastLineBreak(scanned);
+				if (end > 0) {parsed = end; break;}
+				scanned = used;
+
+				// the last line (without line-break)
+				if (eof) {parsed = used; break;}
+
+				// line longer than the buffer
+				if (used == buf.size()) {buf.resize(buf.size() * 2);}
+				fill();
+
+			}
+
+			doc.parseMany(buf.data(), parsed, roots);
+			return true;
+
+		}
+
+		/** read as many bytes as fit into the buffer */
+		void fill() {
+			while (used < buf.size()) {
+				const ssize_t read = is->read((uint8_t*) buf.data() + used, buf.size() - used);
+				if (read == InputStream::ERR_FAILED) {eof = true; return;}
+				if (read <= 0) {continue;}
+				used += (size_t) read;
+			}
+		}
+
+		/** get the position after the last line-break (searching [from:used)), 0 if none */
+		size_t findLastLineBreak(const size_t from) const {
+			for (size_t i = used; i > from; --i) {
+				if (buf[i - 1] == '\n') {return i;}
+			}
+			return 0;
+		}
+
+	};
+
+}
+
+#endif // K_DATA_JSON_JSONSTREAMREADER_H
@@ -0,0 +1,336 @@
+#ifndef K_DATA_JSON_JSONSTREAMWRITER_H
+#define K_DATA_JSON_JSONSTREAMWRITER_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+#include "JSONArray.h"
+#include "JSONObject.h"
+#include "../../streams/OutputStream.h"
+#include "../../string/NumberFormat.h"
+#include "../../Assertions.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace K {
+
+	/**
+	 * @brief SAX-style JSON writer emitting directly into an OutputStream.
+	 *
+	 * the document is written while it is described (begin/end, key, value)
+	 * using a small internal buffer. nothing is kept in memory besides the
+	 * nesting of the currently open objects/arrays.
+	 *
+	 *	writer.beginObject();
+	 *	writer.key("id").value(1337);
+	 *	writer.key("tags").beginArray().value("a").value("b").endArray();
+	 *	writer.endObject();
+	 *	writer.flush();
+	 *
+	 * doubles use the shortest representation that round-trips (NumberFormat),
+	 * NaN and infinity are written as null.
+	 */
+	class JSONStreamWriter {
+
+	private:
+
+		/** the stream to write to */
+		OutputStream& os;
+
+		/** whether to use pretty-printing */
+		const bool prettyPrint;
+
+		/** the char to use for indentation (pretty printing) */
+		const char indent;
+
+		/** the output buffer */
+		std::vector<char> buf;
+		size_t used;
+
+		/** one currently open object or array */
+		struct Level {
+			bool isObject;
+			bool empty;
+		};
+
+		/** all currently open objects/arrays */
+		std::vector<Level> levels;
+
+		/** a key has been written, its value is next */
+		bool afterKey;
+
+	public:
+
+		/** ctor. the buffer holds at least 64 bytes */
+		JSONStreamWriter(OutputStream& os, const bool prettyPrint = false, const char indent = '\t', const size_t bufferSize = 4096) :
+			os(os), prettyPrint(prettyPrint), indent(indent), buf(std::max<size_t>(bufferSize, 64)), used(0), afterKey(false) {
+			;
+		}
+
+		/** dtor. sends all buffered bytes */
+		~JSONStreamWriter() {
+			send();
+		}
+
+		/** start a new object */
+		JSONStreamWriter& beginObject() {
+			beginValue();
+			put('{');
+			levels.push_back(Level{true, true});
+			return *this;
+		}
+
+		/** end the current object */
+		JSONStreamWriter& endObject() {
+			_assertTrue(!levels.empty() && levels.back().isObject && !afterKey, "endObject() without matching beginObject()");
+			endLevel('}');
+			return *this;
+		}
+
+		/** start a new array */
+		JSONStreamWriter& beginArray() {
+			beginValue();
+			put('[');
+			levels.push_back(Level{false, true});
+			return *this;
+		}
+
+		/** end the current array */
+		JSONStreamWriter& endArray() {
+			_assertTrue(!levels.empty() && !levels.back().isObject, "endArray() without matching beginArray()");
+			endLevel(']');
+			return *this;
+		}
+
+		/** write the key for the next value (objects only) */
+		JSONStreamWriter& key(const char* str, const size_t len) {
+			_assertTrue(!levels.empty() && levels.back().isObject && !afterKey, "key() is only allowed within objects");
+			separate();
+			putString(str, len);
+			put(':');
+			if (prettyPrint) {put(' ');}
+			afterKey = true;
+			return *this;
+		}
+
+		/** write the key for the next value (objects only) */
+		JSONStreamWriter& key(const char* str) {return key(str, strlen(str));}
+
+		/** write the key for the next value (objects only) */
+		JSONStreamWriter& key(const std::string& str) {return key(str.data(), str.length());}
+
+		/** write a null value */
+		JSONStreamWriter& null() {
+			beginValue();
+			put("null", 4);
+			return *this;
+		}
+
+		/** write a boolean value */
+		JSONStreamWriter& value(const bool b) {
+			beginValue();
+			if (b) {put("true", 4);} else {put("false", 5);}
+			return *this;
+		}
+
+		/** write an integer value */
+		JSONStreamWriter& value(const int64_t i) {
+			beginValue();
+			reserve(NumberFormat::MAX_INT_LEN + 1);
+			used += NumberFormat::format(i, buf.data() + used);
+			return *this;
+		}
+
+		/** write an integer value */
+		JSONStreamWriter& value(const uint64_t i) {
+			beginValue();
+			reserve(NumberFormat::MAX_INT_LEN);
+			used += NumberFormat::format(i, buf.data() + used);
+			return *this;
+		}
+
+		/** write an integer value */
+		JSONStreamWriter& value(const int i) {return value((int64_t) i);}
+
+		/** write a double value */
+		JSONStreamWriter& value(const double d) {
+			if (!std::isfinite(d)) {return null();}
+			beginValue();
+			reserve(NumberFormat::MAX_DOUBLE_LEN);
+			used += NumberFormat::format(d, buf.data() + used);
+			return *this;
+		}
+
+		/** write a string value */
+		JSONStreamWriter& value(const char* str, const size_t len) {
+			beginValue();
+			putString(str, len);
+			return *this;
+		}
+
+		/** write a string value */
+		JSONStreamWriter& value(const char* str) {return value(str, strlen(str));}
+
+		/** write a string value */
+		JSONStreamWriter& value(const std::string& str) {return value(str.data(), str.length());}
+
+		/** write the given value (and all of its children) */
+		JSONStreamWriter& value(const JSONValue& v) {
+			switch (v.type) {
+				case JSONValueType::EMPTY:			return null();
+				case JSONValueType::BOOLEAN:		return value(v.b);
+				case JSONValueType::DOUBLE:			return value(v.d);
+				case JSONValueType::INT:			return value(v.i);
+				case JSONValueType::STRING:			return value(v.s);
+				case JSONValueType::JSON_OBJECT:	return value(*v.obj);
+				case JSONValueType::JSON_ARRAY:		return value(*v.arr);
+			}
+			return *this;
+		}
+
+		/** write the given object (and all of its children) */
+		JSONStreamWriter& value(const JSONObject& obj) {
+			beginObject();
+			for (const auto& it : obj.keyVal) {
+				key(it.first);
+				value(it.second);
+			}
+			return endObject();
+		}
+
+		/** write the given array (and all of its children) */
+		JSONStreamWriter& value(const JSONArray& arr) {
+			beginArray();
+			for (const JSONValue& v : arr.entries) {value(v);}
+			return endArray();
+		}
+
+		/** send all buffered bytes and flush the underlying stream */
+		void flush() {
+			send();
+			os.flush();
+		}
+
+	private:
+
+		/** comma, line-break and indentation before a new array value or object key */
+		inline void separate() {
+			if (levels.empty()) {return;}
+			Level& l = levels.back();
+			if (!l.empty) {put(',');}
+			l.empty = false;
+			if (prettyPrint) {put('\n'); putIndent(levels.size());}
+		}
+
+		/** prepare writing a value */
+		inline void beginValue() {
+			if (afterKey) {afterKey = false; return;}
+			_assertTrue(levels.empty() || !levels.back().isObject, "values within objects need a key()");
+			separate();
+		}
+
+		/** close the current object/array */
+		inline void endLevel(const char c) {
+			const bool empty = levels.back().empty;
+			levels.pop_back();
+			if (prettyPrint && !empty) {put('\n'); putIndent(levels.size());}
+			put(c);
+		}
+
+		inline void putIndent(const size_t lvl) {
+			for (size_t i = 0; i < lvl; ++i) {put(indent);}
+		}
+
+		/** send the buffer to the stream */
+		inline void send() {
+			if (used) {os.write((const uint8_t*) buf.data(), used); used = 0;}
+		}
+
+		/** ensure the buffer has space for the given number of chars */
+		inline void reserve(const size_t len) {
+			if (used + len > buf.size()) {send();}
+		}
+
+		inline void put(const char c) {
+			reserve(1);
+			buf[used++] = c;
+		}
+
+		/** append the given chars. large blocks bypass the buffer */
+		inline void put(const char* data, const size_t len) {
+			reserve(len);
+			if (len > buf.size()) {os.write((const uint8_t*) data, len); return;}
+			memcpy(buf.data() + used, data, len);
+			used += len;
+		}
+
+		/** write the given string quoted and escaped. unescaped runs are copied at once */
+		void putString(const char* str, const size_t len) {
+
+			put('"');
+
+			const char* end = str + len;
+			while (str < end) {
+				const char* esc = findEscape(str, end);
+				put(str, (size_t) (esc - str));
+				if (esc == end) {break;}
+				putEscaped((uint8_t) *esc);
+				str = esc + 1;
+			}
+
+			put('"');
+
+		}
+
+		/** write the escape sequence for the given char */
+		inline void putEscaped(const uint8_t c) {
+			switch (c) {
+				case '"':	put("\\\"", 2); break;
+				case '\\':	put("\\\\", 2); break;
+				case '\b':	put("\\b", 2); break;
+				case '\f':	put("\\f", 2); break;
+				case '\n':	put("\\n", 2); break;
+				case '\r':	put("\\r", 2); break;
+				case '\t':	put("\\t", 2); break;
+				default: {
+					static const char* hex = "0123456789abcdef";
+					const char tmp[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 15]};
+					put(tmp, 6);
+				}
+			}
+		}
+
+		static inline bool needsEscape(const uint8_t c) {
+			return c < 0x20 || c == '"' || c == '\\';
+		}
+
+		/** the first char needing an escape sequence, end if none */
+		static inline const char* findEscape(const char* str, const char* end) {
+#if defined(__SSE2__)
+			const __m128i quote = _mm_set1_epi8('"');
+			const __m128i bs = _mm_set1_epi8('\\');
+			const __m128i ctrl = _mm_set1_epi8(0x1F);
+			for (; end - str >= 16; str += 16) {
+				const __m128i v = _mm_loadu_si128((const __m128i*) str);
+				const __m128i isCtrl = _mm_cmpeq_epi8(_mm_max_epu8(v, ctrl), ctrl);
+				const __m128i m = _mm_or_si128(isCtrl, _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, bs)));
+				const int mask = _mm_movemask_epi8(m);
+				if (mask) {return str + __builtin_ctz((unsigned int) mask);}
+			}
+#endif
+			for (; str < end; ++str) {
+				if (needsEscape((uint8_t) *str)) {return str;}
+			}
+			return end;
+		}
+
+	};
+
+}
+
+#endif // K_DATA_JSON_JSONSTREAMWRITER_H
@@ -0,0 +1,181 @@
+#ifndef K_DATA_JSON_JSONSTRUCTURALINDEX_H
+#define K_DATA_JSON_JSONSTRUCTURALINDEX_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+#include "JSONReaderException.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace K {
+
+	/**
+	 * @brief stage 1 of the JSON parser: find the position of every structural char.
+	 *
+	 * the input is classified 64 bytes at once (SSE2) into bitmasks for
+	 * backslashes, quotes, whitespaces and operators ({}[]:,). escaped
+	 * quotes are removed using carry-propagation over backslash runs,
+	 * a prefix-xor of the remaining quotes masks everything within strings.
+	 *
+	 * the resulting positions are: all operators outside of strings,
+	 * the opening and closing quote of every string and the first char
+	 * of every scalar (number, true, false, null).
+	 */
+	class JSONStructuralIndex {
+
+	private:
+
+		/** the classification of 64 input bytes */
+		struct Masks {
+			uint64_t backslash;
+			uint64_t quote;
+			uint64_t ws;
+			uint64_t op;
+		};
+
+	public:
+
+		/** find all structural positions within data[0:len). throws for unterminated strings */
+		static void build(const char* data, const size_t len, std::vector<uint32_t>& out) {
+
+			out.clear();
+
+			uint64_t prevOddBackslash = 0;
+			uint64_t prevInString = 0;
+			uint64_t prevScalar = 0;
+			const uint8_t* src = (const uint8_t*) data;
+
+			for (size_t base = 0; base < len; base += 64) {
+
+				// the last block is padded with whitespaces
+				Masks m;
+				if (base + 64 <= len) {
+					classify(src + base, m);
+				} else {
+					uint8_t tmp[64];
+					memset(tmp, ' ', 64);
+					memcpy(tmp, src + base, len - base);
+					classify(tmp, m);
+				}
+
+				const uint64_t quote = m.quote & ~getEscaped(m.backslash, prevOddBackslash);
+
+				// from the opening quote (inclusive) until the closing one (exclusive)
+				const uint64_t inString = prefixXor(quote) ^ prevInString;
+				prevInString = (uint64_t) ((int64_t) inString >> 63);
+
+				// the first char of every scalar
+				const uint64_t scalar = ~(m.op | m.ws | quote | inString);
+				const uint64_t scalarStart = scalar & ~((scalar << 1) | prevScalar);
+				prevScalar = scalar >> 63;
+
+				flatten((m.op & ~inString) | quote | scalarStart, (uint32_t) base, out);
+
+			}
+
+			if (prevInString) {throw JSONReaderException("found unterminated string");}
+
+		}
+
+	private:
+
+		/** get all chars that follow an odd number of backslashes */
+		static inline uint64_t getEscaped(const uint64_t backslash, uint64_t& prevOddBackslash) {
+
+			const uint64_t evenBits = 0x5555555555555555ULL;
+			const uint64_t oddBits = ~evenBits;
+
+			// a run continuing an odd run of the previous block starts at an "odd" position
+			const uint64_t starts = backslash & ~(backslash << 1);
+			const uint64_t evenStartMask = evenBits ^ prevOddBackslash;
+			const uint64_t evenStarts = starts & evenStartMask;
+			const uint64_t oddStarts = starts & ~evenStartMask;
+
+			// adding the start of a run to the run carries one past its end
+			const uint64_t evenCarries = backslash + evenStarts;
+			uint64_t oddCarries = backslash + oddStarts;
+			const bool endsOdd = oddCarries < backslash;
+			oddCarries |= prevOddBackslash;
+			prevOddBackslash = (endsOdd) ? (1) : (0);
+
+			// odd length = started on an even position and ended on an odd one (or vice versa)
+			const uint64_t evenCarryEnds = evenCarries & ~backslash;
+			const uint64_t oddCarryEnds = oddCarries & ~backslash;
+			return (evenCarryEnds & oddBits) | (oddCarryEnds & evenBits);
+
+		}
+
+		/** bit i = xor of all bits [0:i] */
+		static inline uint64_t prefixXor(uint64_t x) {
+#if defined(__PCLMUL__)
+			const __m128i res = _mm_clmulepi64_si128(_mm_set_epi64x(0, (int64_t) x), _mm_set1_epi8((char) 0xFF), 0);
+			return (uint64_t) _mm_cvtsi128_si64(res);
+#else
+			x ^= x << 1;
+			x ^= x << 2;
+			x ^= x << 4;
+			x ^= x << 8;
+			x ^= x << 16;
+			x ^= x << 32;
+			return x;
+#endif
+		}
+
+		/** append the position of every set bit */
+		static inline void flatten(uint64_t bits, const uint32_t base, std::vector<uint32_t>& out) {
+			while (bits) {
+				out.push_back(base + (uint32_t) __builtin_ctzll(bits));
+				bits &= bits - 1;
+			}
+		}
+
+#if defined(__SSE2__)
+
+		/** compare 16 bytes against the given char */
+		static inline uint64_t eq(const __m128i v, const char c) {
+			return (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c)));
+		}
+
+		/** classify 64 bytes, 16 at once */
+		static inline void classify(const uint8_t* p, Masks& m) {
+			m.backslash = m.quote = m.ws = m.op = 0;
+			for (int i = 0; i < 4; ++i) {
+				const __m128i v = _mm_loadu_si128((const __m128i*) (p + 16 * i));
+				const int shift = 16 * i;
+				m.backslash |= eq(v, '\\') << shift;
+				m.quote |= eq(v, '"') << shift;
+				m.ws |= (eq(v, ' ') | eq(v, '\t') | eq(v, '\n') | eq(v, '\r')) << shift;
+				m.op |= (eq(v, '{') | eq(v, '}') | eq(v, '[') | eq(v, ']') | eq(v, ':') | eq(v, ',')) << shift;
+			}
+		}
+
+#else
+
+		/** classify 64 bytes */
+		static inline void classify(const uint8_t* p, Masks& m) {
+			m.backslash = m.quote = m.ws = m.op = 0;
+			for (int i = 0; i < 64; ++i) {
+				const uint64_t bit = 1ULL << i;
+				switch (p[i]) {
+					case '\\':	m.backslash |= bit; break;
+					case '"':	m.quote |= bit; break;
+					case ' ': case '\t': case '\n': case '\r':
+						m.ws |= bit; break;
+					case '{': case '}': case '[': case ']': case ':': case ',':
+						m.op |= bit; break;
+					default: break;
+				}
+			}
+		}
+
+#endif
+
+	};
+
+}
+
+#endif // K_DATA_JSON_JSONSTRUCTURALINDEX_H
@@ -18,6 +18,7 @@ namespace K {
 	class JSONValue {
 
 		friend class JSONWriter;
+		friend class JSONStreamWriter;
 
 		/** the type of contained value (variant) */
 		JSONValueType type;
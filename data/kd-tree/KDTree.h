@@ -122,6 +122,46 @@ namespace K {
 
 		}
 
+		/**
+		 * bulk-build the tree for all elements [0:cnt-1] from the DataSource.
+		 * every level partitions its elements in place (O(n) per level, see KDTreeSplit::Median
+		 * and KDTreeSplit::SlidingMidpoint), both halfs are built in parallel as OpenMP tasks.
+		 * using this method will destroy the current tree index!
+		 */
+		template <typename BulkSplitter = KDTreeSplit::Median> void build(const KDIdx cnt) {
+
+			// sanity checks
+			_assertNotNull(source, "call setDataSource() first!");
+
+			// any previous data?
+			cleanup();
+
+			if (cnt == 0) {root = new _KDTreeLeaf(nullptr); return;}
+
+			// all elements and their bounding box (the root's cell)
+			std::vector<KDTreeSplitEntry<Scalar>> entries(cnt);
+			Scalar cellMin[Dimensions];
+			Scalar cellMax[Dimensions];
+			for (int ax = 0; ax < Dimensions; ++ax) {cellMin[ax] = cellMax[ax] = getValue(0, ax);}
+			for (KDIdx i = 0; i < cnt; ++i) {
+				entries[i].idx = i;
+				for (int ax = 0; ax < Dimensions; ++ax) {
+					const Scalar v = getValue(i, ax);
+					if (v < cellMin[ax]) {cellMin[ax] = v;}
+					if (v > cellMax[ax]) {cellMax[ax] = v;}
+				}
+			}
+
+			_KDTreeElem* res = nullptr;
+			#pragma omp parallel
+			{
+				#pragma omp single
+				res = buildRange<BulkSplitter>(entries.data(), cnt, nullptr, 0, cellMin, cellMax);
+			}
+			root = res;
+
+		}
+
 		/** add a new entry by its id/idx within the DataSource */
 		void addByID(const KDIdx idx, const bool balance = false) {
 
@@ -135,13 +175,15 @@ namespace K {
 			leaf->entries.add(idx);
 
 			// split the leaf (if needed)
-			const int axis = (!leaf->parent) ? (0) : (nextAxis(leaf->parent->asNode()->splitAxis));
+			_KDTreeNode* parent = leaf->getParent();
+			const bool isRoot = (leaf == root);
+			const int axis = (!parent) ? (0) : (nextAxis(parent->splitAxis));
 			_KDTreeElem* elem = (_KDTreeNode*) splitIfNeeded(leaf, axis, 0);
 
 			// changed? (leaf is deleted by now!)
 			if (elem != leaf) {
-				if (leaf == root)	{root = elem;}									// new root
-				if (leaf->parent)	{leaf->getParent()->switchChild(leaf, elem);}	// update association
+				if (isRoot)		{root = elem;}							// new root
+				if (parent)		{parent->switchChild(leaf, elem);}		// update association
 			}
 
 			// perform balancing?
@@ -343,6 +385,46 @@ namespace K {
 		}
 
 
+		/** smaller ranges are built by the current task */
+		static constexpr KDIdx BUILD_TASK_SIZE = 16*1024;
+
+		/** bulk-build the subtree for the given range of elements within the given cell */
+		template <typename BulkSplitter> _KDTreeElem* buildRange(KDTreeSplitEntry<Scalar>* entries, const KDIdx cnt, _KDTreeElem* parent, const int depth, const Scalar* cellMin, const Scalar* cellMax) {
+
+			KDTreeSplitResult<Scalar> split;
+			if (cnt > maxPerLeaf && depth <= maxDepth && BulkSplitter::partition(source, entries, cnt, cellMin, cellMax, split, Config())) {
+
+				_KDTreeNode* node = new _KDTreeNode(split.value, split.axis, parent);
+				_KDTreeElem* left = nullptr;
+				_KDTreeElem* right = nullptr;
+
+				// the children's cells
+				Scalar leftMax[Dimensions];
+				Scalar rightMin[Dimensions];
+				std::copy(cellMax, cellMax + Dimensions, leftMax);
+				std::copy(cellMin, cellMin + Dimensions, rightMin);
+				leftMax[split.axis] = split.value;
+				rightMin[split.axis] = split.value;
+
+				#pragma omp task shared(left, leftMax) if (cnt > BUILD_TASK_SIZE)
+				left = buildRange<BulkSplitter>(entries, split.numLeft, node, depth + 1, cellMin, leftMax);
+
+				right = buildRange<BulkSplitter>(entries + split.numLeft, cnt - split.numLeft, node, depth + 1, rightMin, cellMax);
+
+				#pragma omp taskwait
+				node->attach(left, right);
+				return node;
+
+			}
+
+			// leaf
+			_KDTreeLeaf* leaf = new _KDTreeLeaf(parent);
+			leaf->entries.reserve(cnt);
+			for (KDIdx i = 0; i < cnt; ++i) {leaf->entries.add(entries[i].idx);}
+			return leaf;
+
+		}
+
 		/** is the given element in balance? */
 		inline bool isBalanced(const _KDTreeElem* elem) const {
 
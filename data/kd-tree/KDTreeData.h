@@ -62,7 +62,7 @@ namespace K {
 
 
 		/** ctor */
-		KDTreeNode(const float splitValue, const int splitAxis, KDTreeElem<Scalar>* parent) :
+		KDTreeNode(const Scalar splitValue, const int splitAxis, KDTreeElem<Scalar>* parent) :
 			KDTreeElem<Scalar>(false, parent), splitValue(splitValue), splitAxis(splitAxis), left(nullptr), right(nullptr) {;}
 
 		/** dtor */
@@ -200,7 +200,7 @@ namespace K {
 		}
 
 		/** get the difference between numLeft and numRight as absolute value */
-		KDIdx getAbsDiff() const {return std::abs(numLeft - numRight);}
+		KDIdx getAbsDiff() const {return (numLeft > numRight) ? (numLeft - numRight) : (numRight - numLeft);}
 
 		/** get the number of elements (left + right) */
 		KDIdx numElements() const {return numLeft + numRight;}
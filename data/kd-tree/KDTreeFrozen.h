@@ -0,0 +1,484 @@
+#ifndef K_DATA_KDTREE_KDTREEFROZEN_H
+#define K_DATA_KDTREE_KDTREEFROZEN_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+
+#include "KDTree.h"
+#include "KDTreeKNN.h"
+#include "../../fs/MemoryMappedFile.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace K {
+
+	/**
+	 * @brief immutable, flattened copy of a KDTree for read-mostly workloads.
+	 *
+	 * all nodes are stored within one array in depth-first order: the left
+	 * child directly follows its parent, the parent stores the right child's
+	 * index. the points are copied into the leaf order, one array per axis
+	 * (SoA), thus a leaf is scanned without the DataSource and, for float,
+	 * four points at once using SSE.
+	 *
+	 * the in-memory layout equals the file format (native endianness), thus
+	 * a saved tree is memory-mapped on load instead of being rebuilt:
+	 *
+	 *	header		magic, version, dimensions, scalar type, counts, offsets
+	 *	nodes		Node[numNodes]
+	 *	coords		Scalar[numPoints] per dimension
+	 *	ids			KDIdx[numPoints], the DataSource's index of every point
+	 *
+	 * each section starts at a multiple of 16 bytes.
+	 */
+	template <typename Scalar, int Dimensions> class KDTreeFrozen {
+
+		static_assert(std::is_arithmetic<Scalar>::value, "Scalar must be an arithmetic type");
+
+	public:
+
+		/** squared distances are accumulated using this type (int64 for integer coordinates) */
+		using Dist = typename KDTreeKNNScratch<Scalar>::Dist;
+
+		/** one node (or leaf) */
+		struct Node {
+
+			/** inner nodes: the splitting value (< = left / > = right) */
+			Scalar splitValue;
+
+			/** inner nodes: the splitting axis, -1 for leafs */
+			int32_t axis;
+
+			/** inner nodes: index of the right child. leafs: index of the first point */
+			uint32_t first;
+
+			/** leafs: number of points */
+			uint32_t count;
+
+			inline bool isLeaf() const {return axis < 0;}
+
+		};
+
+		/** reusable memory for queries, one instance per thread */
+		struct Scratch {
+
+			struct Candidate {
+				Dist dist2;
+				KDIdx idx;
+				Candidate(const Dist dist2, const KDIdx idx) : dist2(dist2), idx(idx) {;}
+				inline bool operator < (const Candidate& o) const {return dist2 < o.dist2;}
+			};
+
+			struct Branch {
+				uint32_t node;
+				Dist bound2;
+				Branch(const uint32_t node, const Dist bound2) : node(node), bound2(bound2) {;}
+				inline bool operator < (const Branch& o) const {return bound2 > o.bound2;}
+			};
+
+			/** max-heap of the best k candidates so far */
+			std::vector<Candidate> heap;
+
+			/** min-heap of branches still to visit (best-bin-first) */
+			std::vector<Branch> branches;
+
+			/** squared distances of one leaf's points */
+			std::vector<Dist> dist2;
+
+		};
+
+	private:
+
+		static constexpr uint32_t MAGIC = 0x4654444B;		// "KDTF"
+		static constexpr uint32_t VERSION = 1;
+
+		/** file header */
+		struct Header {
+			uint32_t magic;
+			uint32_t version;
+			uint32_t dimensions;
+			uint32_t scalarSize;
+			uint32_t scalarFloat;
+			uint32_t numNodes;
+			uint32_t numPoints;
+			uint32_t maxLeafSize;
+			uint64_t offsetNodes;
+			uint64_t offsetCoords;
+			uint64_t offsetIDs;
+			uint64_t size;
+		};
+
+		/** the data, when frozen in memory */
+		std::vector<uint8_t> blob;
+
+		/** the data, when loaded from a file */
+		std::unique_ptr<MemoryMappedFile> file;
+
+		/** views into blob or file */
+		const Header* header;
+		const Node* nodes;
+		const Scalar* coords[Dimensions];
+		const KDIdx* ids;
+
+	public:
+
+		/** empty tree */
+		KDTreeFrozen() {
+			build(std::vector<Node>(), std::vector<KDIdx>(), std::vector<Scalar>(), 0);
+		}
+
+		/** map a tree saved by save() */
+		explicit KDTreeFrozen(const std::string& fileName) : file(new MemoryMappedFile(fileName)) {
+			setup(file->data(), file->size());
+		}
+
+		/** no copies */
+		KDTreeFrozen(const KDTreeFrozen&) = delete;
+		KDTreeFrozen& operator = (const KDTreeFrozen&) = delete;
+
+		/** move (the views remain valid) */
+		KDTreeFrozen(KDTreeFrozen&&) = default;
+		KDTreeFrozen& operator = (KDTreeFrozen&&) = default;
+
+		/** create a flattened copy of the given tree */
+		template <typename CFG> static KDTreeFrozen freeze(const KDTree<CFG>& tree) {
+
+			static_assert(std::is_same<typename CFG::Scalar, Scalar>::value, "scalar type mismatch");
+			static_assert(CFG::Dimensions == Dimensions, "dimension mismatch");
+
+			std::vector<Node> nodes;
+			std::vector<KDIdx> ids;
+			uint32_t maxLeafSize = 0;
+			flatten(tree.getRoot(), nodes, ids, maxLeafSize);
+
+			// SoA copy of all points, in leaf order
+			std::vector<Scalar> coords(ids.size() * Dimensions);
+			for (int ax = 0; ax < Dimensions; ++ax) {
+				Scalar* dst = coords.data() + ax * ids.size();
+				for (size_t i = 0; i < ids.size(); ++i) {dst[i] = tree.getValue(ids[i], ax);}
+			}
+
+			KDTreeFrozen res;
+			res.build(nodes, ids, coords, maxLeafSize);
+			return res;
+
+		}
+
+		/** write the tree to the given file (to be mapped later on) */
+		void save(const std::string& fileName) const {
+			FILE* fp = fopen(fileName.c_str(), "wb");
+			if (!fp) {throw FileException("could not open file for writing: " + fileName);}
+			const size_t written = fwrite(header, 1, (size_t) header->size, fp);
+			const bool ok = (fclose(fp) == 0) && (written == header->size);
+			if (!ok) {throw FileException("could not write file: " + fileName);}
+		}
+
+		/** number of nodes (inner nodes and leafs) */
+		uint32_t getNumNodes() const {return header->numNodes;}
+
+		/** number of points */
+		uint32_t getNumPoints() const {return header->numPoints;}
+
+		/** all nodes, depth-first. the root is the first one */
+		const Node* getNodes() const {return nodes;}
+
+		/** the given axis' coordinate of all points, in leaf order */
+		const Scalar* getCoordinates(const int axis) const {return coords[axis];}
+
+		/** the DataSource's index of all points, in leaf order */
+		const KDIdx* getIDs() const {return ids;}
+
+		/** get the exact k nearest neighbors for the given coordinates, sorted by distance */
+		std::vector<KDTreeNeighbor<Scalar>> getNeighbors(const std::initializer_list<Scalar> search, const KDIdx k) const {
+			Scratch scratch;
+			std::vector<KDTreeNeighbor<Scalar>> out;
+			getNeighbors(search.begin(), k, scratch, out);
+			return out;
+		}
+
+		/**
+		 * get the exact k nearest neighbors for the given coordinates, sorted by distance.
+		 * reusing scratch and out prevents allocations.
+		 * out contains fewer than k entries if the tree is smaller.
+		 */
+		void getNeighbors(const Scalar search[Dimensions], const KDIdx k, Scratch& scratch, std::vector<KDTreeNeighbor<Scalar>>& out) const {
+			findNearest(search, k, scratch);
+			std::sort_heap(scratch.heap.begin(), scratch.heap.end());
+			out.resize(scratch.heap.size());
+			for (size_t i = 0; i < out.size(); ++i) {out[i] = toNeighbor(scratch.heap[i]);}
+		}
+
+		/**
+		 * get the exact k nearest neighbors for many queries, in parallel.
+		 * @param queries numQueries * Dimensions coordinates
+		 * @param out the result: k entries per query. missing neighbors (tree smaller than k) have idx -1
+		 */
+		void getNeighbors(const Scalar* queries, const size_t numQueries, const KDIdx k, std::vector<KDTreeNeighbor<Scalar>>& out) const {
+
+			out.resize(numQueries * k);
+			const int64_t num = (int64_t) numQueries;
+
+			#pragma omp parallel
+			{
+
+				// per thread
+				Scratch scratch;
+
+				#pragma omp for schedule(dynamic, 256)
+				for (int64_t q = 0; q < num; ++q) {
+					findNearest(queries + q * Dimensions, k, scratch);
+					std::sort_heap(scratch.heap.begin(), scratch.heap.end());
+					KDTreeNeighbor<Scalar>* dst = out.data() + q * k;
+					const size_t cnt = scratch.heap.size();
+					for (size_t i = 0; i < cnt; ++i) {dst[i] = toNeighbor(scratch.heap[i]);}
+					for (size_t i = cnt; i < k; ++i) {dst[i] = KDTreeNeighbor<Scalar>();}
+				}
+
+			}
+
+		}
+
+		/** fetch all points within the given (euclidean) radius, unsorted. reusing scratch and out prevents allocations */
+		void getNeighborsWithinRadius(const Scalar search[Dimensions], const Scalar radius, Scratch& scratch, std::vector<KDTreeNeighbor<Scalar>>& out) const {
+
+			out.clear();
+			const Dist r2 = (Dist) radius * (Dist) radius;
+			scratch.branches.clear();
+			scratch.branches.push_back(typename Scratch::Branch(0, 0));
+
+			while (!scratch.branches.empty()) {
+
+				const uint32_t n = scratch.branches.back().node;
+				scratch.branches.pop_back();
+				const Node& node = nodes[n];
+
+				if (node.isLeaf()) {
+					scanLeaf(node, search, scratch);
+					for (uint32_t i = 0; i < node.count; ++i) {
+						if (scratch.dist2[i] <= r2) {out.push_back(toNeighbor(typename Scratch::Candidate(scratch.dist2[i], ids[node.first + i])));}
+					}
+					continue;
+				}
+
+				const Dist diff = (Dist) search[node.axis] - (Dist) node.splitValue;
+				const bool left = search[node.axis] <= node.splitValue;
+				if (diff * diff <= r2) {scratch.branches.push_back(typename Scratch::Branch((left) ? (node.first) : (n + 1), 0));}
+				scratch.branches.push_back(typename Scratch::Branch((left) ? (n + 1) : (node.first), 0));
+
+			}
+
+		}
+
+	private:
+
+		/** append the given element (depth-first) */
+		template <typename S> static void flatten(const KDTreeElem<S>* elem, std::vector<Node>& nodes, std::vector<KDIdx>& ids, uint32_t& maxLeafSize) {
+
+			Node n;
+			n.splitValue = 0;
+			n.axis = -1;
+			n.first = (uint32_t) ids.size();
+			n.count = 0;
+
+			// empty branch: empty leaf
+			if (!elem) {nodes.push_back(n); return;}
+
+			if (elem->isLeaf()) {
+				const KDTreeLeaf<S>* leaf = elem->asLeaf();
+				n.count = (uint32_t) leaf->entries.size();
+				ids.insert(ids.end(), leaf->entries.data(), leaf->entries.data() + n.count);
+				maxLeafSize = std::max(maxLeafSize, n.count);
+				nodes.push_back(n);
+				return;
+			}
+
+			const KDTreeNode<S>* node = elem->asNode();
+			const size_t idx = nodes.size();
+			n.splitValue = node->splitValue;
+			n.axis = node->splitAxis;
+			nodes.push_back(n);
+			flatten(node->left, nodes, ids, maxLeafSize);
+			nodes[idx].first = (uint32_t) nodes.size();
+			flatten(node->right, nodes, ids, maxLeafSize);
+
+		}
+
+		static inline size_t align16(const size_t v) {return (v + 15) & ~((size_t) 15);}
+
+		/** pack everything into the blob (file layout) */
+		void build(const std::vector<Node>& srcNodes, const std::vector<KDIdx>& srcIDs, const std::vector<Scalar>& srcCoords, const uint32_t maxLeafSize) {
+
+			// an empty tree still has one (empty) leaf
+			std::vector<Node> tmp;
+			const std::vector<Node>& n = (srcNodes.empty()) ? (tmp) : (srcNodes);
+			if (srcNodes.empty()) {Node leaf; leaf.splitValue = 0; leaf.axis = -1; leaf.first = 0; leaf.count = 0; tmp.push_back(leaf);}
+
+			Header h;
+			memset(&h, 0, sizeof(h));
+			h.magic = MAGIC;
+			h.version = VERSION;
+			h.dimensions = Dimensions;
+			h.scalarSize = sizeof(Scalar);
+			h.scalarFloat = std::is_floating_point<Scalar>::value;
+			h.numNodes = (uint32_t) n.size();
+			h.numPoints = (uint32_t) srcIDs.size();
+			h.maxLeafSize = maxLeafSize;
+			h.offsetNodes = align16(sizeof(Header));
+			h.offsetCoords = align16(h.offsetNodes + n.size() * sizeof(Node));
+			h.offsetIDs = align16(h.offsetCoords + srcCoords.size() * sizeof(Scalar));
+			h.size = align16(h.offsetIDs + srcIDs.size() * sizeof(KDIdx));
+
+			blob.assign((size_t) h.size, 0);
+			memcpy(blob.data(), &h, sizeof(h));
+			memcpy(blob.data() + h.offsetNodes, n.data(), n.size() * sizeof(Node));
+			if (!srcCoords.empty()) {memcpy(blob.data() + h.offsetCoords, srcCoords.data(), srcCoords.size() * sizeof(Scalar));}
+			if (!srcIDs.empty()) {memcpy(blob.data() + h.offsetIDs, srcIDs.data(), srcIDs.size() * sizeof(KDIdx));}
+
+			setup(blob.data(), blob.size());
+
+		}
+
+		/** validate the given data and set the views */
+		void setup(const uint8_t* data, const size_t size) {
+
+			if (size < sizeof(Header)) {throw FileException("KDTreeFrozen: file too small");}
+			const Header* h = (const Header*) data;
+			if (h->magic != MAGIC)						{throw FileException("KDTreeFrozen: invalid file");}
+			if (h->version != VERSION)					{throw FileException("KDTreeFrozen: unsupported version");}
+			if (h->dimensions != (uint32_t) Dimensions)	{throw FileException("KDTreeFrozen: dimension mismatch");}
+			if (h->scalarSize != sizeof(Scalar) || h->scalarFloat != (uint32_t) std::is_floating_point<Scalar>::value) {throw FileException("KDTreeFrozen: scalar type mismatch");}
+			if (h->size > size || h->numNodes == 0)		{throw FileException("KDTreeFrozen: truncated file");}
+
+			// every section must be aligned and lie within the file
+			checkSection(h, h->offsetNodes, (uint64_t) h->numNodes * sizeof(Node), alignof(Node));
+			checkSection(h, h->offsetCoords, (uint64_t) h->numPoints * Dimensions * sizeof(Scalar), alignof(Scalar));
+			checkSection(h, h->offsetIDs, (uint64_t) h->numPoints * sizeof(KDIdx), alignof(KDIdx));
+
+			// nodes must only refer to existing children (always behind the parent) and points
+			const Node* n = (const Node*) (data + h->offsetNodes);
+			for (uint32_t i = 0; i < h->numNodes; ++i) {
+				const Node& node = n[i];
+				if (node.isLeaf()) {
+					if (node.count > h->maxLeafSize || (uint64_t) node.first + node.count > h->numPoints) {throw FileException("KDTreeFrozen: invalid leaf");}
+				} else {
+					if (node.axis >= Dimensions || i + 1 >= h->numNodes || node.first <= i + 1 || node.first >= h->numNodes) {throw FileException("KDTreeFrozen: invalid node");}
+				}
+			}
+
+			header = h;
+			nodes = n;
+			for (int ax = 0; ax < Dimensions; ++ax) {coords[ax] = (const Scalar*) (data + h->offsetCoords) + (size_t) ax * h->numPoints;}
+			ids = (const KDIdx*) (data + h->offsetIDs);
+
+		}
+
+		/** the given section must be aligned and end within the file */
+		static void checkSection(const Header* h, const uint64_t offset, const uint64_t bytes, const size_t alignment) {
+			if (offset % alignment != 0 || offset < sizeof(Header) || offset > h->size || bytes > h->size - offset) {
+				throw FileException("KDTreeFrozen: invalid section");
+			}
+		}
+
+		/** squared distance of every point within the leaf into scratch.dist2 */
+		inline void scanLeaf(const Node& leaf, const Scalar search[Dimensions], Scratch& scratch) const {
+
+			if (scratch.dist2.size() < header->maxLeafSize) {scratch.dist2.resize(header->maxLeafSize);}
+			Dist* dst = scratch.dist2.data();
+			uint32_t i = 0;
+
+#if defined(__SSE2__)
+			if (std::is_same<Scalar, float>::value) {
+				__m128 q[Dimensions];
+				for (int ax = 0; ax < Dimensions; ++ax) {q[ax] = _mm_set1_ps((float) search[ax]);}
+				for (; i + 4 <= leaf.count; i += 4) {
+					__m128 sum = _mm_setzero_ps();
+					for (int ax = 0; ax < Dimensions; ++ax) {
+						const __m128 d = _mm_sub_ps(_mm_loadu_ps((const float*) coords[ax] + leaf.first + i), q[ax]);
+						sum = _mm_add_ps(sum, _mm_mul_ps(d, d));
+					}
+					_mm_storeu_ps((float*) dst + i, sum);
+				}
+			}
+#endif
+
+			for (; i < leaf.count; ++i) {
+				Dist sum = 0;
+				for (int ax = 0; ax < Dimensions; ++ax) {
+					const Dist d = (Dist) coords[ax][leaf.first + i] - (Dist) search[ax];
+					sum += d * d;
+				}
+				dst[i] = sum;
+			}
+
+		}
+
+		/** best-bin-first search. afterwards scratch.heap holds the best (max. k) candidates */
+		void findNearest(const Scalar search[Dimensions], const KDIdx k, Scratch& scratch) const {
+
+			using Branch = typename Scratch::Branch;
+			using Candidate = typename Scratch::Candidate;
+
+			scratch.heap.clear();
+			scratch.branches.clear();
+			if (k == 0) {return;}
+			scratch.heap.reserve(k);
+			scratch.branches.push_back(Branch(0, 0));
+
+			while (!scratch.branches.empty()) {
+
+				// the branch nearest to the search coordinates
+				std::pop_heap(scratch.branches.begin(), scratch.branches.end());
+				const Branch b = scratch.branches.back();
+				scratch.branches.pop_back();
+				if (scratch.heap.size() == k && b.bound2 >= scratch.heap.front().dist2) {continue;}
+
+				// descend to the leaf, remembering the opposite halfs
+				uint32_t n = b.node;
+				while (!nodes[n].isLeaf()) {
+					const Node& node = nodes[n];
+					const Dist diff = (Dist) search[node.axis] - (Dist) node.splitValue;
+					const Dist bound2 = std::max(b.bound2, diff * diff);
+					const bool left = search[node.axis] <= node.splitValue;
+					if (scratch.heap.size() < k || bound2 < scratch.heap.front().dist2) {
+						scratch.branches.push_back(Branch((left) ? (node.first) : (n + 1), bound2));
+						std::push_heap(scratch.branches.begin(), scratch.branches.end());
+					}
+					n = (left) ? (n + 1) : (node.first);
+				}
+
+				// all distances at once, then update the k best
+				const Node& leaf = nodes[n];
+				scanLeaf(leaf, search, scratch);
+				for (uint32_t i = 0; i < leaf.count; ++i) {
+					const Dist d2 = scratch.dist2[i];
+					if (scratch.heap.size() == k) {
+						if (d2 >= scratch.heap.front().dist2) {continue;}
+						std::pop_heap(scratch.heap.begin(), scratch.heap.end());
+						scratch.heap.pop_back();
+					}
+					scratch.heap.push_back(Candidate(d2, ids[leaf.first + i]));
+					std::push_heap(scratch.heap.begin(), scratch.heap.end());
+				}
+
+			}
+
+		}
+
+		static inline KDTreeNeighbor<Scalar> toNeighbor(const typename Scratch::Candidate& c) {
+			return KDTreeNeighbor<Scalar>(c.idx, (Scalar) std::sqrt((double) c.dist2));
+		}
+
+	};
+
+}
+
+#endif // K_DATA_KDTREE_KDTREEFROZEN_H
@@ -2,13 +2,49 @@
 #define K_DATA_KDTREE_KDTREEKNN_H
 
 #include <vector>
-#include <set>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include <cmath>
 
 #include "KDTree.h"
 #include "KDTreeHelper.h"
 
 namespace K {
 
+	/**
+	 * reusable memory for k-NN queries.
+	 * one instance per thread avoids all allocations after the first query
+	 */
+	template <typename Scalar> struct KDTreeKNNScratch {
+
+		/** squared distances are accumulated using this type (int64 for integer coordinates) */
+		using Dist = typename std::conditional<std::is_floating_point<Scalar>::value, Scalar, int64_t>::type;
+
+		/** one candidate within the result heap */
+		struct Candidate {
+			Dist dist2;
+			KDIdx idx;
+			Candidate(const Dist dist2, const KDIdx idx) : dist2(dist2), idx(idx) {;}
+			inline bool operator < (const Candidate& o) const {return dist2 < o.dist2;}
+		};
+
+		/** one pending branch and the lower bound for the (squared) distance of its elements */
+		struct Branch {
+			const KDTreeElem<Scalar>* elem;
+			Dist bound2;
+			Branch(const KDTreeElem<Scalar>* elem, const Dist bound2) : elem(elem), bound2(bound2) {;}
+			inline bool operator < (const Branch& o) const {return bound2 > o.bound2;}	// min-heap
+		};
+
+		/** max-heap of the best k candidates so far */
+		std::vector<Candidate> heap;
+
+		/** min-heap of branches still to visit (best-bin-first) */
+		std::vector<Branch> branches;
+
+	};
+
 	/**
 	 * k-nearest-neighbor search within KD-Trees
 	 */
@@ -22,35 +58,87 @@ namespace K {
 			return getNeighborsApx(tree, values.begin(), num);
 		}
 
-		/** get approximate nearest neighbors for the given coordinates */
+		/**
+		 * get approximate nearest neighbors for the given coordinates.
+		 * only the leaf containing the coordinates is searched, see getNeighbors() for exact results
+		 */
 		template <typename CFG>
 		static std::vector<KDTreeNeighbor<typename CFG::Scalar>> getNeighborsApx(const KDTree<CFG>& tree, const typename CFG::Scalar search[CFG::Dimensions], const KDIdx num) {
 
 			using Scalar = typename CFG::Scalar;
 
-			// neighbors sorted by distance
-			std::set<KDTreeNeighbor<Scalar>> neighbors;
+			KDTreeKNNScratch<Scalar> scratch;
+			scratch.heap.clear();
+			scratch.heap.reserve(num);
 
-			// get the leaf-node "elem" would belong to
+			// get the leaf-node "elem" would belong to and keep its best elements
 			const KDTreeLeaf<Scalar>* leaf = tree.getLeafFor(search);
+			if (num > 0) {visitLeaf(tree, leaf, search, num, scratch);}
 
-			// add all elements
-			for (int i = 0; i < leaf->indices.size(); ++i) {
-				const KDIdx idx = leaf->indices[i];
-				KDTreeNeighbor<Scalar> knn(idx, tree.getDistance(idx, search));
-				neighbors.insert(knn);
-			}
-
-			// limit
+			// done
 			std::vector<KDTreeNeighbor<Scalar>> out;
-			for (auto it : neighbors) {
-				out.push_back(it);
-				if ((KDIdx) out.size() >= num)		{break;}
-				if (out.size() >= neighbors.size())	{break;}
-			}
+			toNeighbors(scratch, out);
+			return out;
 
-			// done
+		}
+
+		/** get the exact k nearest neighbors for the given coordinates, sorted by distance */
+		template <typename CFG>
+		static std::vector<KDTreeNeighbor<typename CFG::Scalar>> getNeighbors(const KDTree<CFG>& tree, const std::initializer_list<typename CFG::Scalar> values, const KDIdx k) {
+			return getNeighbors(tree, values.begin(), k);
+		}
+
+		/** get the exact k nearest neighbors for the given coordinates, sorted by distance */
+		template <typename CFG>
+		static std::vector<KDTreeNeighbor<typename CFG::Scalar>> getNeighbors(const KDTree<CFG>& tree, const typename CFG::Scalar search[CFG::Dimensions], const KDIdx k) {
+			KDTreeKNNScratch<typename CFG::Scalar> scratch;
+			std::vector<KDTreeNeighbor<typename CFG::Scalar>> out;
+			getNeighbors(tree, search, k, scratch, out);
 			return out;
+		}
+
+		/**
+		 * get the exact k nearest neighbors for the given coordinates, sorted by distance.
+		 * the distances are euclidean, calculated from the DataSource's values.
+		 * reusing scratch and out prevents allocations.
+		 * out contains fewer than k entries if the tree is smaller.
+		 */
+		template <typename CFG>
+		static void getNeighbors(const KDTree<CFG>& tree, const typename CFG::Scalar search[CFG::Dimensions], const KDIdx k,
+								 KDTreeKNNScratch<typename CFG::Scalar>& scratch, std::vector<KDTreeNeighbor<typename CFG::Scalar>>& out) {
+			findNearest(tree, search, k, scratch);
+			toNeighbors(scratch, out);
+		}
+
+		/**
+		 * get the exact k nearest neighbors for many queries, in parallel.
+		 * @param queries numQueries * Dimensions coordinates
+		 * @param out the result: k entries per query. missing neighbors (tree smaller than k) have idx -1
+		 */
+		template <typename CFG>
+		static void getNeighbors(const KDTree<CFG>& tree, const typename CFG::Scalar* queries, const size_t numQueries, const KDIdx k,
+								 std::vector<KDTreeNeighbor<typename CFG::Scalar>>& out) {
+
+			using Scalar = typename CFG::Scalar;
+			out.resize(numQueries * k);
+			const int64_t num = (int64_t) numQueries;
+
+			#pragma omp parallel
+			{
+
+				// per thread
+				KDTreeKNNScratch<Scalar> scratch;
+
+				#pragma omp for schedule(dynamic, 256)
+				for (int64_t q = 0; q < num; ++q) {
+					findNearest(tree, queries + q * CFG::Dimensions, k, scratch);
+					KDTreeNeighbor<Scalar>* dst = out.data() + q * k;
+					const size_t cnt = toSorted(scratch);
+					for (size_t i = 0; i < cnt; ++i) {dst[i] = toNeighbor<Scalar>(scratch.heap[i]);}
+					for (size_t i = cnt; i < k; ++i) {dst[i] = KDTreeNeighbor<Scalar>();}
+				}
+
+			}
 
 		}
 
@@ -63,6 +151,14 @@ namespace K {
 		/** fetch all neighbors near elem within the given radius */
 		template <typename CFG>
 		static std::vector<KDTreeNeighbor<typename CFG::Scalar>> getNeighborsWithinRadius(const KDTree<CFG>& tree, const typename CFG::Scalar search[CFG::Dimensions], const typename CFG::Scalar radius) {
+			std::vector<KDTreeNeighbor<typename CFG::Scalar>> nn;
+			getNeighborsWithinRadius(tree, search, radius, nn);
+			return nn;
+		}
+
+		/** fetch all neighbors near elem within the given radius. reusing nn prevents allocations */
+		template <typename CFG>
+		static void getNeighborsWithinRadius(const KDTree<CFG>& tree, const typename CFG::Scalar search[CFG::Dimensions], const typename CFG::Scalar radius, std::vector<KDTreeNeighbor<typename CFG::Scalar>>& nn) {
 
 			using Scalar = typename CFG::Scalar;
 
@@ -73,19 +169,112 @@ namespace K {
 			// start
 			const KDTreeElem<Scalar>* root = tree.getRoot();
 
-			// output
-			std::vector<KDTreeNeighbor<Scalar>> nn;
-
 			// run
+			nn.clear();
 			visit(tree, root, search, radius, nn);
 
-			// done
-			return nn;
-
 		}
 
 	private:
 
+		/** best-bin-first search. afterwards scratch.heap holds the best (max. k) candidates */
+		template <typename CFG>
+		static void findNearest(const KDTree<CFG>& tree, const typename CFG::Scalar search[CFG::Dimensions], const KDIdx k, KDTreeKNNScratch<typename CFG::Scalar>& scratch) {
+
+			using Scalar = typename CFG::Scalar;
+			using Scratch = KDTreeKNNScratch<Scalar>;
+			using Dist = typename Scratch::Dist;
+			using Branch = typename Scratch::Branch;
+
+			scratch.heap.clear();
+			scratch.branches.clear();
+			if (k == 0) {return;}
+			scratch.heap.reserve(k);
+
+			scratch.branches.push_back(Branch(tree.getRoot(), 0));
+
+			while (!scratch.branches.empty()) {
+
+				// the branch nearest to the search coordinates
+				std::pop_heap(scratch.branches.begin(), scratch.branches.end());
+				const Branch b = scratch.branches.back();
+				scratch.branches.pop_back();
+
+				// can not contain anything better than the current k-th neighbor?
+				if (scratch.heap.size() == k && b.bound2 >= scratch.heap.front().dist2) {continue;}
+
+				// descend to the leaf, remembering the opposite halfs
+				const KDTreeElem<Scalar>* elem = b.elem;
+				while (elem->isNode()) {
+					const KDTreeNode<Scalar>* node = elem->asNode();
+					const Dist diff = (Dist) search[node->splitAxis] - (Dist) node->splitValue;
+					const Dist bound2 = std::max(b.bound2, diff * diff);
+					const bool left = KDTreeHelper::leftOf(node, search);
+					const KDTreeElem<Scalar>* far = (left) ? (node->right) : (node->left);
+					if (far && (scratch.heap.size() < k || bound2 < scratch.heap.front().dist2)) {
+						scratch.branches.push_back(Branch(far, bound2));
+						std::push_heap(scratch.branches.begin(), scratch.branches.end());
+					}
+					elem = (left) ? (node->left) : (node->right);
+					if (!elem) {break;}
+				}
+
+				if (elem && elem->isLeaf()) {visitLeaf(tree, elem->asLeaf(), search, k, scratch);}
+
+			}
+
+		}
+
+		/** add all elements of the leaf that are better than the current k-th neighbor */
+		template <typename CFG>
+		static inline void visitLeaf(const KDTree<CFG>& tree, const KDTreeLeaf<typename CFG::Scalar>* leaf, const typename CFG::Scalar search[CFG::Dimensions], const KDIdx k, KDTreeKNNScratch<typename CFG::Scalar>& scratch) {
+
+			using Scratch = KDTreeKNNScratch<typename CFG::Scalar>;
+			using Dist = typename Scratch::Dist;
+			using Candidate = typename Scratch::Candidate;
+
+			for (int i = 0; i < leaf->entries.size(); ++i) {
+
+				const KDIdx idx = leaf->entries[i];
+				const bool full = scratch.heap.size() == k;
+				const Dist worst = (full) ? (scratch.heap.front().dist2) : (0);
+
+				// squared distance
+				Dist dist2 = 0;
+				for (int ax = 0; ax < CFG::Dimensions; ++ax) {
+					const Dist d = (Dist) tree.getValue(idx, ax) - (Dist) search[ax];
+					dist2 += d * d;
+				}
+				if (full && dist2 >= worst) {continue;}
+
+				// replace the current k-th neighbor
+				if (full) {std::pop_heap(scratch.heap.begin(), scratch.heap.end()); scratch.heap.pop_back();}
+				scratch.heap.push_back(Candidate(dist2, idx));
+				std::push_heap(scratch.heap.begin(), scratch.heap.end());
+
+			}
+
+		}
+
+		/** sort the heap by distance (ascending). returns the number of candidates */
+		template <typename Scalar>
+		static inline size_t toSorted(KDTreeKNNScratch<Scalar>& scratch) {
+			std::sort_heap(scratch.heap.begin(), scratch.heap.end());
+			return scratch.heap.size();
+		}
+
+		template <typename Scalar>
+		static inline KDTreeNeighbor<Scalar> toNeighbor(const typename KDTreeKNNScratch<Scalar>::Candidate& c) {
+			return KDTreeNeighbor<Scalar>(c.idx, (Scalar) std::sqrt((double) c.dist2));
+		}
+
+		template <typename Scalar>
+		static inline void toNeighbors(KDTreeKNNScratch<Scalar>& scratch, std::vector<KDTreeNeighbor<Scalar>>& out) {
+			const size_t cnt = toSorted(scratch);
+			out.resize(cnt);
+			for (size_t i = 0; i < cnt; ++i) {out[i] = toNeighbor<Scalar>(scratch.heap[i]);}
+		}
+
 		/** helper method for k-NN above */
 		template <typename CFG>
 		static inline void visit(const KDTree<CFG>& tree, const KDTreeElem<typename CFG::Scalar>* elem, const typename CFG::Scalar search[CFG::Dimensions], const typename CFG::Scalar radius, std::vector<KDTreeNeighbor<typename CFG::Scalar>>& nn) {
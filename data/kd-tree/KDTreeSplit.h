@@ -3,11 +3,33 @@
 
 #include <vector>
 #include <set>
+#include <algorithm>
 
 #include "KDTreeData.h"
 
 namespace K {
 
+	/** one element while bulk-building: its index and its value along the current axis */
+	template <typename Scalar> struct KDTreeSplitEntry {
+		Scalar value;
+		KDIdx idx;
+		inline bool operator < (const KDTreeSplitEntry& o) const {return value < o.value;}
+	};
+
+	/** the result of splitting a range of elements (bulk-building) */
+	template <typename Scalar> struct KDTreeSplitResult {
+
+		/** the splitting axis */
+		int axis;
+
+		/** the splitting value (<= left / > right) */
+		Scalar value;
+
+		/** the number of elements on the left side */
+		KDIdx numLeft;
+
+	};
+
 	/** splitting methods */
 	struct KDTreeSplit {
 
@@ -48,21 +70,114 @@ namespace K {
 		/** use a dimension's median value for splitting */
 		struct Median {
 
-			/** center ist the approximate average for the given dimension */
-			template <typename CFG> static inline typename CFG::Scalar getCenter(const typename CFG::DataSource* ds, const KDTreeLeafEntries& indices, const int dim) {
+			/** center is the median value for the given dimension */
+			template <typename CFG> static inline typename CFG::Scalar getCenter(const typename CFG::DataSource* ds, const KDTreeLeafEntries& indices, const int dim, CFG c) {
 
 				using Scalar = typename CFG::Scalar;
 
-				std::multiset<Scalar> set;
-				for (int i = 0; i < indices.size(); ++i) {
-					const auto val = ds->kdGetValue(indices[i], dim);
-					set.insert(val);
-				}
+				std::vector<Scalar> values(indices.size());
+				for (int i = 0; i < indices.size(); ++i) {values[i] = ds->kdGetValue(indices[i], dim);}
+				std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+				return values[values.size() / 2];
+
+			}
+
+			/**
+			 * bulk-building: split the elements along the cell's widest axis at their median (nth_element).
+			 * afterwards [0:numLeft) are <= value and [numLeft:cnt) are > value.
+			 * returns false if all elements are equal
+			 */
+			template <typename CFG> static inline bool partition(const typename CFG::DataSource* ds, KDTreeSplitEntry<typename CFG::Scalar>* entries, const KDIdx cnt,
+																 const typename CFG::Scalar* cellMin, const typename CFG::Scalar* cellMax, KDTreeSplitResult<typename CFG::Scalar>& res, CFG c) {
+
+				using Scalar = typename CFG::Scalar;
+
+				Scalar min, max;
+				if (!loadAxis(ds, entries, cnt, cellMin, cellMax, res.axis, min, max, c)) {return false;}
+
+				// [0:mid) <= median <= [mid+1:cnt). move the elements equal to the median to the left
+				const KDIdx mid = cnt / 2;
+				std::nth_element(entries, entries + mid, entries + cnt);
+				res.value = entries[mid].value;
+				const Scalar value = res.value;
+				res.numLeft = (KDIdx) (std::partition(entries + mid + 1, entries + cnt, [value] (const KDTreeSplitEntry<Scalar>& e) {return e.value <= value;}) - entries);
+
+				// the median equals the max. value: use the largest value below
+				if (res.numLeft == cnt) {moveBelow(entries, cnt, max, res);}
+				return true;
 
 			}
 
 		};
 
+		/** split the cell's widest axis at its midpoint, slide the plane onto the nearest element if one side is empty */
+		struct SlidingMidpoint {
+
+			/**
+			 * bulk-building: split the elements.
+			 * afterwards [0:numLeft) are <= value and [numLeft:cnt) are > value.
+			 * returns false if all elements are equal
+			 */
+			template <typename CFG> static inline bool partition(const typename CFG::DataSource* ds, KDTreeSplitEntry<typename CFG::Scalar>* entries, const KDIdx cnt,
+																 const typename CFG::Scalar* cellMin, const typename CFG::Scalar* cellMax, KDTreeSplitResult<typename CFG::Scalar>& res, CFG c) {
+
+				using Scalar = typename CFG::Scalar;
+
+				Scalar min, max;
+				if (!loadAxis(ds, entries, cnt, cellMin, cellMax, res.axis, min, max, c)) {return false;}
+
+				// the cell's midpoint. slide onto the elements if all are on one side
+				res.value = cellMin[res.axis] + (cellMax[res.axis] - cellMin[res.axis]) / 2;
+				if (res.value < min) {res.value = min;}
+				if (res.value >= max) {moveBelow(entries, cnt, max, res); return true;}
+
+				const Scalar value = res.value;
+				res.numLeft = (KDIdx) (std::partition(entries, entries + cnt, [value] (const KDTreeSplitEntry<Scalar>& e) {return e.value <= value;}) - entries);
+				return true;
+
+			}
+
+		};
+
+	private:
+
+		/**
+		 * load the values of the cell's widest axis where the elements are not all equal.
+		 * returns false if the elements are equal along all axes
+		 */
+		template <typename CFG> static inline bool loadAxis(const typename CFG::DataSource* ds, KDTreeSplitEntry<typename CFG::Scalar>* entries, const KDIdx cnt,
+															const typename CFG::Scalar* cellMin, const typename CFG::Scalar* cellMax,
+															int& axis, typename CFG::Scalar& min, typename CFG::Scalar& max, CFG c) {
+
+			(void) c;
+
+			// axes by the cell's extent, widest first
+			int axes[CFG::Dimensions];
+			for (int ax = 0; ax < CFG::Dimensions; ++ax) {axes[ax] = ax;}
+			std::sort(axes, axes + CFG::Dimensions, [cellMin, cellMax] (const int a, const int b) {return cellMax[a] - cellMin[a] > cellMax[b] - cellMin[b];});
+
+			for (int i = 0; i < CFG::Dimensions; ++i) {
+				axis = axes[i];
+				min = max = ds->kdGetValue(entries[0].idx, axis);
+				for (KDIdx j = 0; j < cnt; ++j) {
+					const auto v = ds->kdGetValue(entries[j].idx, axis);
+					entries[j].value = v;
+					if (v < min) {min = v;}
+					if (v > max) {max = v;}
+				}
+				if (min < max) {return true;}
+			}
+			return false;
+
+		}
+
+		/** all elements are <= max: split between the elements below max and those equal to max */
+		template <typename Scalar> static inline void moveBelow(KDTreeSplitEntry<Scalar>* entries, const KDIdx cnt, const Scalar max, KDTreeSplitResult<Scalar>& res) {
+			res.numLeft = (KDIdx) (std::partition(entries, entries + cnt, [max] (const KDTreeSplitEntry<Scalar>& e) {return e.value < max;}) - entries);
+			res.value = entries[0].value;
+			for (KDIdx i = 1; i < res.numLeft; ++i) {res.value = std::max(res.value, entries[i].value);}
+		}
+
 	};
 }
 
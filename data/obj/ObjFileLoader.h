@@ -0,0 +1,333 @@
+#ifndef K_DATA_OBJ_OBJFILELOADER_H
+#define K_DATA_OBJ_OBJFILELOADER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+
+#include "../../fs/MemoryMappedFile.h"
+#include "../../fs/LineChunks.h"
+#include "../../fs/BinaryCacheFile.h"
+#include "../../string/NumberParser.h"
+
+namespace K {
+
+	/**
+	 * @brief fast loader for large .obj files.
+	 *
+	 * the file is memory-mapped and split into chunks of complete lines.
+	 * all chunks are processed in parallel, twice: the first pass counts
+	 * the vertices, normals, texture-coordinates and triangles per chunk,
+	 * the second pass parses every chunk directly into its part of the
+	 * preallocated arrays. numbers are parsed in place (NumberParser).
+	 *
+	 * faces are stored as indices (polygons are triangulated as fan).
+	 * optionally, the result is kept within a binary cache file, which is
+	 * used instead of parsing as long as the .obj file does not change.
+	 */
+	class ObjFileLoader {
+
+	public:
+
+		struct Vec2 {
+			float x;
+			float y;
+			Vec2() {;}
+			Vec2(const float x, const float y) : x(x), y(y) {;}
+		};
+
+		struct Vec3 {
+			float x;
+			float y;
+			float z;
+			Vec3() {;}
+			Vec3(const float x, const float y, const float z) : x(x), y(y), z(z) {;}
+			bool operator == (const Vec3& o) const {return x==o.x && y==o.y && z==o.z;}
+		};
+
+		/** one triangle. 0-based indices, -1 if not given */
+		struct Face {
+			int32_t vertex[3];
+			int32_t texture[3];
+			int32_t normal[3];
+		};
+
+		/** all loaded data */
+		struct Data {
+			std::vector<Vec3> vertices;
+			std::vector<Vec2> texCoords;
+			std::vector<Vec3> normals;
+			std::vector<Face> faces;
+		};
+
+	private:
+
+		static constexpr uint32_t CACHE_MAGIC = 0x4A424F4B;		// "KOBJ"
+		static constexpr uint32_t CACHE_VERSION = 1;
+
+		/** the number of entries within one chunk (pass 1) or the chunk's offsets (pass 2) */
+		struct Counts {
+			size_t vertices;
+			size_t texCoords;
+			size_t normals;
+			size_t faces;
+		};
+
+		/** the kind of a line */
+		enum class Line {
+			OTHER,
+			VERTEX,
+			TEX_COORD,
+			NORMAL,
+			FACE,
+		};
+
+		Data data;
+
+		bool swapYZ;
+
+	public:
+
+		/**
+		 * ctor with the file to load.
+		 * if a cache file is given, it is used if it belongs to the current state of the file, else it is (re)written
+		 */
+		ObjFileLoader(const std::string& file, const bool swapYZ = false, const std::string& cacheFile = "") : swapYZ(swapYZ) {
+
+			const BinaryCacheFile::Source src = BinaryCacheFile::getSource(file);
+
+			if (!cacheFile.empty()) {
+				std::unique_ptr<BinaryCacheFile> cache = BinaryCacheFile::open(cacheFile, CACHE_MAGIC, CACHE_VERSION, swapYZ, src);
+				if (cache && cache->getNumSections() == 4) {
+					cache->read(0, data.vertices);
+					cache->read(1, data.texCoords);
+					cache->read(2, data.normals);
+					cache->read(3, data.faces);
+					return;
+				}
+			}
+
+			parse(file);
+
+			if (!cacheFile.empty()) {
+				BinaryCacheFile::write(cacheFile, CACHE_MAGIC, CACHE_VERSION, swapYZ, src, {
+					BinaryCacheFile::block(data.vertices), BinaryCacheFile::block(data.texCoords),
+					BinaryCacheFile::block(data.normals), BinaryCacheFile::block(data.faces)
+				});
+			}
+
+		}
+
+		/** get the loaded data */
+		const Data& getData() const {return data;}
+
+	private:
+
+		/** parse the .obj file */
+		void parse(const std::string& file) {
+
+			MemoryMappedFile mmf(file);
+			mmf.adviseSequential();
+			const char* text = (const char*) mmf.data();
+			const std::vector<LineChunk> chunks = LineChunks::splitForThreads(text, mmf.size());
+			const int num = (int) chunks.size();
+
+			// pass 1: count
+			std::vector<Counts> counts(num);
+			#pragma omp parallel for schedule(dynamic)
+			for (int i = 0; i < num; ++i) {
+				counts[i] = count(chunks[i]);
+			}
+
+			// the range of every chunk within the results: [offsets[i]:offsets[i+1])
+			std::vector<Counts> offsets(num + 1);
+			offsets[0] = Counts{0, 0, 0, 0};
+			for (int i = 0; i < num; ++i) {
+				offsets[i+1].vertices = offsets[i].vertices + counts[i].vertices;
+				offsets[i+1].texCoords = offsets[i].texCoords + counts[i].texCoords;
+				offsets[i+1].normals = offsets[i].normals + counts[i].normals;
+				offsets[i+1].faces = offsets[i].faces + counts[i].faces;
+			}
+			const Counts& total = offsets[num];
+			data.vertices.resize(total.vertices);
+			data.texCoords.resize(total.texCoords);
+			data.normals.resize(total.normals);
+			data.faces.resize(total.faces);
+
+			// pass 2: parse. exceptions must not leave the parallel region
+			std::vector<std::string> errors(num);
+			#pragma omp parallel for schedule(dynamic)
+			for (int i = 0; i < num; ++i) {
+				try {
+					parse(chunks[i], offsets[i], offsets[i+1]);
+				} catch (const std::exception& e) {
+					errors[i] = e.what();
+				}
+			}
+			for (const std::string& err : errors) {
+				if (!err.empty()) {throw FileException("ObjFileLoader: " + err + " in " + file);}
+			}
+
+			checkIndices();
+
+		}
+
+		/** pass 1: count the entries within the given chunk */
+		static Counts count(const LineChunk& chunk) {
+			Counts cnt = {0, 0, 0, 0};
+			LineChunks::forEachLine(chunk, [&cnt] (const char* p, const char* end) {
+				switch (getLineType(p, end)) {
+					case Line::VERTEX:		++cnt.vertices; break;
+					case Line::TEX_COORD:	++cnt.texCoords; break;
+					case Line::NORMAL:		++cnt.normals; break;
+					case Line::FACE: {
+						const size_t corners = countTokens(p, end);
+						if (corners >= 3) {cnt.faces += corners - 2;}
+						break;
+					}
+					case Line::OTHER:		break;
+				}
+			});
+			return cnt;
+		}
+
+		/** pass 2: parse the given chunk into the results, starting at the given offsets, never reaching the given limits */
+		void parse(const LineChunk& chunk, Counts pos, const Counts& limit) {
+			LineChunks::forEachLine(chunk, [this, &pos, &limit] (const char* p, const char* end) {
+				switch (getLineType(p, end)) {
+					case Line::VERTEX: {
+						float v[3];
+						parseFloats(p, end, v, 3, 3);
+						data.vertices[pos.vertices++] = (swapYZ) ? (Vec3(v[0], v[2], v[1])) : (Vec3(v[0], v[1], v[2]));
+						break;
+					}
+					case Line::TEX_COORD: {
+						float v[2] = {0, 0};
+						parseFloats(p, end, v, 1, 2);
+						data.texCoords[pos.texCoords++] = Vec2(v[0], -v[1]);
+						break;
+					}
+					case Line::NORMAL: {
+						float v[3];
+						parseFloats(p, end, v, 3, 3);
+						data.normals[pos.normals++] = (swapYZ) ? (Vec3(v[0], v[2], v[1])) : (Vec3(v[0], v[1], v[2]));
+						break;
+					}
+					case Line::FACE:
+						parseFace(p, end, pos, limit.faces);
+						break;
+					case Line::OTHER:
+						break;
+				}
+			});
+		}
+
+		/** parse "f v[/[t][/n]] ..." (relative indices refer to the entries parsed so far) */
+		void parseFace(const char* p, const char* end, Counts& pos, const size_t maxFaces) {
+
+			int32_t first[3] = {-1, -1, -1};
+			int32_t prev[3] = {-1, -1, -1};
+			int corners = 0;
+
+			while ((p = skipSpaces(p, end)) < end) {
+
+				int32_t cur[3] = {-1, -1, -1};
+				p = parseIndex(p, end, pos.vertices, cur[0]);
+				if (p < end && *p == '/') {
+					++p;
+					if (p < end && *p != '/' && !isSpace(*p)) {p = parseIndex(p, end, pos.texCoords, cur[1]);}
+					if (p < end && *p == '/') {p = parseIndex(p + 1, end, pos.normals, cur[2]);}
+				}
+
+				// triangle fan
+				if (corners == 0) {
+					memcpy(first, cur, sizeof(cur));
+				} else if (corners >= 2) {
+					if (pos.faces >= maxFaces) {throw FileException("face does not match the counted ones");}
+					Face& f = data.faces[pos.faces++];
+					for (int i = 0; i < 3; ++i) {
+						f.vertex[i] = (i == 0) ? (first[0]) : (i == 1) ? (prev[0]) : (cur[0]);
+						f.texture[i] = (i == 0) ? (first[1]) : (i == 1) ? (prev[1]) : (cur[1]);
+						f.normal[i] = (i == 0) ? (first[2]) : (i == 1) ? (prev[2]) : (cur[2]);
+					}
+				}
+				memcpy(prev, cur, sizeof(cur));
+				++corners;
+
+			}
+
+			if (corners < 3) {throw FileException("face with less than 3 vertices");}
+
+		}
+
+		/** parse one (1-based or negative = relative) index into a 0-based one. it must be followed by '/', a space or the line's end */
+		static const char* parseIndex(const char* p, const char* end, const size_t numSoFar, int32_t& res) {
+			int64_t idx;
+			p = NumberParser::parse(p, end, idx);
+			if (!p || idx == 0 || (p < end && *p != '/' && !isSpace(*p))) {throw FileException("invalid face index");}
+			res = (int32_t) ((idx > 0) ? (idx - 1) : ((int64_t) numSoFar + idx));
+			return p;
+		}
+
+		/** all face indices must refer to existing entries */
+		void checkIndices() const {
+			const int32_t nv = (int32_t) data.vertices.size();
+			const int32_t nt = (int32_t) data.texCoords.size();
+			const int32_t nn = (int32_t) data.normals.size();
+			for (const Face& f : data.faces) {
+				for (int i = 0; i < 3; ++i) {
+					if (f.vertex[i] < 0 || f.vertex[i] >= nv)	{throw FileException("ObjFileLoader: face refers to a missing vertex");}
+					if (f.texture[i] < -1 || f.texture[i] >= nt)	{throw FileException("ObjFileLoader: face refers to a missing texture-coordinate");}
+					if (f.normal[i] < -1 || f.normal[i] >= nn)		{throw FileException("ObjFileLoader: face refers to a missing normal");}
+				}
+			}
+		}
+
+		/** get the line's type and move p behind the keyword */
+		static Line getLineType(const char*& p, const char* end) {
+			p = skipSpaces(p, end);
+			if (end - p < 2) {return Line::OTHER;}
+			if (p[0] == 'f' && isSpace(p[1])) {p += 2; return Line::FACE;}
+			if (p[0] != 'v') {return Line::OTHER;}
+			if (isSpace(p[1])) {p += 2; return Line::VERTEX;}
+			if (end - p < 3 || !isSpace(p[2])) {return Line::OTHER;}
+			if (p[1] == 't') {p += 3; return Line::TEX_COORD;}
+			if (p[1] == 'n') {p += 3; return Line::NORMAL;}
+			return Line::OTHER;
+		}
+
+		/** parse between min and max space-separated floats */
+		static void parseFloats(const char* p, const char* end, float* dst, const int min, const int max) {
+			for (int i = 0; i < max; ++i) {
+				p = skipSpaces(p, end);
+				if (p == end && i >= min) {return;}
+				p = NumberParser::parse(p, end, dst[i]);
+				if (!p) {throw FileException("invalid number");}
+			}
+		}
+
+		/** number of space-separated tokens */
+		static size_t countTokens(const char* p, const char* end) {
+			size_t cnt = 0;
+			while ((p = skipSpaces(p, end)) < end) {
+				++cnt;
+				while (p < end && !isSpace(*p)) {++p;}
+			}
+			return cnt;
+		}
+
+		static inline bool isSpace(const char c) {
+			return c == ' ' || c == '\t';
+		}
+
+		static inline const char* skipSpaces(const char* p, const char* end) {
+			while (p < end && isSpace(*p)) {++p;}
+			return p;
+		}
+
+	};
+
+}
+
+#endif // K_DATA_OBJ_OBJFILELOADER_H
@@ -0,0 +1,187 @@
+#ifndef K_DATA_XYZ_XYZFILELOADER_H
+#define K_DATA_XYZ_XYZFILELOADER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "../../fs/MemoryMappedFile.h"
+#include "../../fs/LineChunks.h"
+#include "../../fs/BinaryCacheFile.h"
+#include "../../string/NumberParser.h"
+
+namespace K {
+
+	/**
+	 * @brief fast loader for large xyz point-clouds.
+	 *
+	 * same results as XYZFileReader: every line with at least 3 values is a
+	 * vertex, lines with at least 6 values also provide a normal.
+	 *
+	 * the memory-mapped file is processed as chunks of complete lines in
+	 * parallel: one pass counts the entries per chunk, the second one parses
+	 * every chunk directly into its part of the preallocated arrays.
+	 * optionally, the result is kept within a binary cache file.
+	 */
+	class XYZFileLoader {
+
+	public:
+
+		struct Vec3 {
+			float x;
+			float y;
+			float z;
+			Vec3() {;}
+			Vec3(const float x, const float y, const float z) : x(x), y(y), z(z) {;}
+			bool operator == (const Vec3& o) const {return x==o.x && y==o.y && z==o.z;}
+		};
+
+		struct Data {
+			std::vector<Vec3> vertices;
+			std::vector<Vec3> normals;
+		};
+
+	private:
+
+		static constexpr uint32_t CACHE_MAGIC = 0x5A59584B;		// "KXYZ"
+		static constexpr uint32_t CACHE_VERSION = 1;
+
+		/** the number of entries within one chunk (pass 1) or the chunk's offsets (pass 2) */
+		struct Counts {
+			size_t vertices;
+			size_t normals;
+		};
+
+		Data data;
+
+		bool swapXY;
+
+	public:
+
+		/**
+		 * ctor with the file to load.
+		 * if a cache file is given, it is used if it belongs to the current state of the file, else it is (re)written
+		 */
+		XYZFileLoader(const std::string& file, const bool swapXY = false, const std::string& cacheFile = "") : swapXY(swapXY) {
+
+			const BinaryCacheFile::Source src = BinaryCacheFile::getSource(file);
+
+			if (!cacheFile.empty()) {
+				std::unique_ptr<BinaryCacheFile> cache = BinaryCacheFile::open(cacheFile, CACHE_MAGIC, CACHE_VERSION, swapXY, src);
+				if (cache && cache->getNumSections() == 2) {
+					cache->read(0, data.vertices);
+					cache->read(1, data.normals);
+					return;
+				}
+			}
+
+			parse(file);
+
+			if (!cacheFile.empty()) {
+				BinaryCacheFile::write(cacheFile, CACHE_MAGIC, CACHE_VERSION, swapXY, src, {
+					BinaryCacheFile::block(data.vertices), BinaryCacheFile::block(data.normals)
+				});
+			}
+
+		}
+
+		/** get the loaded data */
+		const Data& getData() const {return data;}
+
+	private:
+
+		/** parse the .xyz file */
+		void parse(const std::string& file) {
+
+			MemoryMappedFile mmf(file);
+			mmf.adviseSequential();
+			const char* text = (const char*) mmf.data();
+			const std::vector<LineChunk> chunks = LineChunks::splitForThreads(text, mmf.size());
+			const int num = (int) chunks.size();
+
+			// pass 1: count
+			std::vector<Counts> counts(num);
+			#pragma omp parallel for schedule(dynamic)
+			for (int i = 0; i < num; ++i) {
+				Counts& cnt = counts[i];
+				cnt = Counts{0, 0};
+				LineChunks::forEachLine(chunks[i], [&cnt] (const char* p, const char* end) {
+					const int values = countTokens(p, end, 6);
+					if (values >= 3) {++cnt.vertices;}
+					if (values >= 6) {++cnt.normals;}
+				});
+			}
+
+			// the offset of every chunk within the results
+			Counts total = {0, 0};
+			for (Counts& c : counts) {
+				const Counts cnt = c;
+				c = total;
+				total.vertices += cnt.vertices;
+				total.normals += cnt.normals;
+			}
+			data.vertices.resize(total.vertices);
+			data.normals.resize(total.normals);
+
+			// pass 2: parse. exceptions must not leave the parallel region
+			std::vector<std::string> errors(num);
+			#pragma omp parallel for schedule(dynamic)
+			for (int i = 0; i < num; ++i) {
+				try {
+					parse(chunks[i], counts[i]);
+				} catch (const std::exception& e) {
+					errors[i] = e.what();
+				}
+			}
+			for (const std::string& err : errors) {
+				if (!err.empty()) {throw FileException("XYZFileLoader: " + err + " in " + file);}
+			}
+
+		}
+
+		/** pass 2: parse the given chunk into the results, starting at the given offsets */
+		void parse(const LineChunk& chunk, Counts pos) {
+			LineChunks::forEachLine(chunk, [this, &pos] (const char* p, const char* end) {
+
+				float tmp[6];
+				int cnt = 0;
+				while (cnt < 6 && (p = skipSpaces(p, end)) < end) {
+					p = NumberParser::parse(p, end, tmp[cnt]);
+					if (!p || (p < end && !isSpace(*p))) {throw FileException("invalid number");}
+					++cnt;
+				}
+
+				if (cnt >= 3) {
+					data.vertices[pos.vertices++] = (swapXY) ? (Vec3(tmp[0], tmp[2], tmp[1])) : (Vec3(tmp[0], tmp[1], tmp[2]));
+				}
+				if (cnt >= 6) {
+					data.normals[pos.normals++] = Vec3(tmp[3], tmp[4], tmp[5]);
+				}
+
+			});
+		}
+
+		/** number of space-separated tokens, up to the given maximum */
+		static int countTokens(const char* p, const char* end, const int max) {
+			int cnt = 0;
+			while (cnt < max && (p = skipSpaces(p, end)) < end) {
+				++cnt;
+				while (p < end && !isSpace(*p)) {++p;}
+			}
+			return cnt;
+		}
+
+		static inline bool isSpace(const char c) {
+			return c == ' ' || c == '\t';
+		}
+
+		static inline const char* skipSpaces(const char* p, const char* end) {
+			while (p < end && isSpace(*p)) {++p;}
+			return p;
+		}
+
+	};
+
+}
+
+#endif // K_DATA_XYZ_XYZFILELOADER_H
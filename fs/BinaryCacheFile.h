@@ -0,0 +1,178 @@
+#ifndef K_FS_BINARYCACHEFILE_H
+#define K_FS_BINARYCACHEFILE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <sys/stat.h>
+
+#include "File.h"
+#include "MemoryMappedFile.h"
+
+namespace K {
+
+	/**
+	 * @brief binary cache for data derived from a (slow to parse) source file.
+	 *
+	 * the cache holds several raw sections (e.g. the contents of std::vectors)
+	 * and remembers the source's size and modification time. loading is one
+	 * mapped, sequential read per section. native endianness.
+	 *
+	 *	header		magic, version, flags, number of sections, source size and time
+	 *	sections	offset and size of every section
+	 *	data		every section starts at a multiple of 16 bytes
+	 */
+	class BinaryCacheFile {
+
+	public:
+
+		/** identifies the state of a source file (size and modification time) */
+		struct Source {
+			uint64_t size;
+			int64_t time;
+		};
+
+		/** one section to write */
+		struct Block {
+			const void* data;
+			uint64_t bytes;
+		};
+
+	private:
+
+		struct Header {
+			uint32_t magic;
+			uint32_t version;
+			uint32_t flags;
+			uint32_t numSections;
+			uint64_t sourceSize;
+			int64_t sourceTime;
+		};
+
+		struct Section {
+			uint64_t offset;
+			uint64_t bytes;
+		};
+
+		std::unique_ptr<MemoryMappedFile> file;
+		const Section* sections;
+		uint32_t numSections;
+
+		BinaryCacheFile() : sections(nullptr), numSections(0) {;}
+
+	public:
+
+		/** get the size and modification time of the given file. throws if it does not exist */
+		static Source getSource(const std::string& fileName) {
+			struct stat st;
+			if (stat(fileName.c_str(), &st) != 0) {throw FileException("could not stat file: " + fileName);}
+#if defined(__linux__)
+			return Source{(uint64_t) st.st_size, (int64_t) st.st_mtim.tv_sec * 1000000000 + (int64_t) st.st_mtim.tv_nsec};
+#else
+			return Source{(uint64_t) st.st_size, (int64_t) st.st_mtime};
+#endif
+		}
+
+		/** a section for the contents of the given vector */
+		template <typename T> static Block block(const std::vector<T>& vec) {
+			return Block{vec.data(), (uint64_t) (vec.size() * sizeof(T))};
+		}
+
+		/** write a cache file */
+		static void write(const std::string& fileName, const uint32_t magic, const uint32_t version, const uint32_t flags,
+						  const Source& src, const std::vector<Block>& blocks) {
+
+			Header h;
+			memset(&h, 0, sizeof(h));
+			h.magic = magic;
+			h.version = version;
+			h.flags = flags;
+			h.numSections = (uint32_t) blocks.size();
+			h.sourceSize = src.size;
+			h.sourceTime = src.time;
+
+			std::vector<Section> sections(blocks.size());
+			uint64_t offset = align(sizeof(Header) + sizeof(Section) * blocks.size());
+			for (size_t i = 0; i < blocks.size(); ++i) {
+				sections[i].offset = offset;
+				sections[i].bytes = blocks[i].bytes;
+				offset = align(offset + blocks[i].bytes);
+			}
+
+			FILE* fp = fopen(fileName.c_str(), "wb");
+			if (!fp) {throw FileException("could not create file: " + fileName);}
+
+			static const uint8_t zeros[16] = {0};
+			bool ok = fwrite(&h, sizeof(h), 1, fp) == 1;
+			if (!sections.empty()) {ok &= fwrite(sections.data(), sizeof(Section), sections.size(), fp) == sections.size();}
+			uint64_t pos = sizeof(Header) + sizeof(Section) * blocks.size();
+			for (size_t i = 0; i < blocks.size() && ok; ++i) {
+				ok &= fwrite(zeros, 1, (size_t) (sections[i].offset - pos), fp) == sections[i].offset - pos;
+				if (blocks[i].bytes) {ok &= fwrite(blocks[i].data, 1, (size_t) blocks[i].bytes, fp) == blocks[i].bytes;}
+				pos = sections[i].offset + blocks[i].bytes;
+			}
+
+			ok &= fclose(fp) == 0;
+			if (!ok) {throw FileException("could not write file: " + fileName);}
+
+		}
+
+		/**
+		 * map the given cache file.
+		 * returns nullptr if it does not exist, has another format, version or flags, or belongs to another state of the source
+		 */
+		static std::unique_ptr<BinaryCacheFile> open(const std::string& fileName, const uint32_t magic, const uint32_t version,
+													 const uint32_t flags, const Source& src) {
+
+			struct stat st;
+			if (stat(fileName.c_str(), &st) != 0) {return nullptr;}
+
+			std::unique_ptr<BinaryCacheFile> res(new BinaryCacheFile());
+			res->file.reset(new MemoryMappedFile(fileName));
+			const uint8_t* data = res->file->data();
+			const size_t size = res->file->size();
+
+			if (size < sizeof(Header)) {return nullptr;}
+			const Header* h = (const Header*) data;
+			if (h->magic != magic || h->version != version || h->flags != flags) {return nullptr;}
+			if (h->sourceSize != src.size || h->sourceTime != src.time) {return nullptr;}
+			if (size < sizeof(Header) + sizeof(Section) * (uint64_t) h->numSections) {return nullptr;}
+
+			res->numSections = h->numSections;
+			res->sections = (const Section*) (data + sizeof(Header));
+			for (uint32_t i = 0; i < res->numSections; ++i) {
+				const Section& s = res->sections[i];
+				if (s.offset > size || s.bytes > size - s.offset) {return nullptr;}
+			}
+
+			res->file->adviseSequential();
+			return res;
+
+		}
+
+		/** number of sections */
+		uint32_t getNumSections() const {return numSections;}
+
+		/** copy the idx-th section into the given vector */
+		template <typename T> void read(const uint32_t idx, std::vector<T>& out) const {
+			if (idx >= numSections) {throw FileException("BinaryCacheFile: section out of bounds");}
+			const Section& s = sections[idx];
+			if (s.bytes % sizeof(T) != 0) {throw FileException("BinaryCacheFile: section does not match the type");}
+			out.resize((size_t) (s.bytes / sizeof(T)));
+			if (s.bytes) {memcpy((void*) out.data(), file->data() + s.offset, (size_t) s.bytes);}
+		}
+
+	private:
+
+		static inline uint64_t align(const uint64_t v) {
+			return (v + 15) & ~((uint64_t) 15);
+		}
+
+	};
+
+}
+
+#endif // K_FS_BINARYCACHEFILE_H
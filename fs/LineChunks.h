@@ -0,0 +1,77 @@
+#ifndef K_FS_LINECHUNKS_H
+#define K_FS_LINECHUNKS_H
+
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace K {
+
+	/** a range of complete lines within a text buffer */
+	struct LineChunk {
+		const char* begin;
+		const char* end;
+	};
+
+	/**
+	 * @brief split a text buffer (e.g. a MemoryMappedFile) into chunks of complete lines.
+	 * every chunk (but the last) ends directly after a line-break, thus the chunks can be parsed independently.
+	 */
+	class LineChunks {
+
+	public:
+
+		/** split the buffer into (at most) the given number of chunks of about the same size */
+		static std::vector<LineChunk> split(const char* data, const size_t len, const size_t num) {
+
+			std::vector<LineChunk> res;
+			const char* end = data + len;
+			const char* pos = data;
+			const size_t chunkSize = std::max<size_t>(1, len / std::max<size_t>(1, num));
+
+			while (pos < end) {
+				const char* cut = pos + std::min<size_t>(chunkSize, (size_t) (end - pos));
+				if (cut < end) {
+					const char* lb = (const char*) memchr(cut, '\n', (size_t) (end - cut));
+					cut = (lb) ? (lb + 1) : (end);
+				}
+				res.push_back(LineChunk{pos, cut});
+				pos = cut;
+			}
+
+			return res;
+
+		}
+
+		/** split the buffer for parallel parsing: a few chunks per thread, each at least minChunkSize bytes */
+		static std::vector<LineChunk> splitForThreads(const char* data, const size_t len, const size_t minChunkSize = 1024*1024) {
+#ifdef _OPENMP
+			const size_t threads = (size_t) omp_get_max_threads();
+#else
+			const size_t threads = 1;
+#endif
+			const size_t num = std::max<size_t>(1, std::min<size_t>(len / minChunkSize, 4 * threads));
+			return split(data, len, num);
+		}
+
+		/** call func(begin, end) for every line within the chunk. the line-break (\n or \r\n) is excluded */
+		template <typename Func> static void forEachLine(const LineChunk& chunk, Func func) {
+			const char* p = chunk.begin;
+			while (p < chunk.end) {
+				const char* eol = (const char*) memchr(p, '\n', (size_t) (chunk.end - p));
+				if (!eol) {eol = chunk.end;}
+				const char* end = (eol > p && eol[-1] == '\r') ? (eol - 1) : (eol);
+				func(p, end);
+				p = eol + 1;
+			}
+		}
+
+	};
+
+}
+
+#endif // K_FS_LINECHUNKS_H
@@ -0,0 +1,105 @@
+#ifndef K_FS_MEMORYMAPPEDFILE_H
+#define K_FS_MEMORYMAPPEDFILE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+
+#include "File.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define K_MMAP
+#endif
+
+namespace K {
+
+	/**
+	 * @brief read-only view of a whole file.
+	 *
+	 * the file is mapped into memory (no copy, pages are loaded on demand)
+	 * or read completely on platforms without mmap().
+	 */
+	class MemoryMappedFile {
+
+	private:
+
+		/** the file's contents */
+		const uint8_t* ptr;
+
+		/** the file's size */
+		size_t len;
+
+#ifndef K_MMAP
+		/** fallback: the file's contents */
+		std::vector<uint8_t> buf;
+#endif
+
+	public:
+
+		/** ctor. map the given file */
+		explicit MemoryMappedFile(const std::string& file) : ptr(nullptr), len(0) {
+
+#ifdef K_MMAP
+			const int fd = ::open(file.c_str(), O_RDONLY);
+			if (fd < 0) {throw FileException("could not open file: " + file);}
+			struct stat st;
+			if (fstat(fd, &st) != 0) {::close(fd); throw FileException("could not stat file: " + file);}
+			len = (size_t) st.st_size;
+			if (len > 0) {
+				void* res = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (res == MAP_FAILED) {::close(fd); throw FileException("could not map file: " + file);}
+				ptr = (const uint8_t*) res;
+			}
+			::close(fd);
+#else
+			FILE* fp = fopen(file.c_str(), "rb");
+			if (!fp) {throw FileException("could not open file: " + file);}
+			fseek(fp, 0, SEEK_END);
+			len = (size_t) ftell(fp);
+			fseek(fp, 0, SEEK_SET);
+			buf.resize(len);
+			const size_t read = fread(buf.data(), 1, len, fp);
+			fclose(fp);
+			if (read != len) {throw FileException("could not read file: " + file);}
+			ptr = buf.data();
+#endif
+
+		}
+
+		/** dtor */
+		~MemoryMappedFile() {
+#ifdef K_MMAP
+			if (ptr) {munmap((void*) ptr, len);}
+#endif
+		}
+
+		/** no copies */
+		MemoryMappedFile(const MemoryMappedFile&) = delete;
+		MemoryMappedFile& operator = (const MemoryMappedFile&) = delete;
+
+		/** hint: the file will be read sequentially */
+		void adviseSequential() const {
+#ifdef K_MMAP
+			if (ptr) {madvise((void*) ptr, len, MADV_SEQUENTIAL);}
+#endif
+		}
+
+		/** the file's contents */
+		const uint8_t* data() const {return ptr;}
+
+		/** the file's size in bytes */
+		size_t size() const {return len;}
+
+		/** is the file empty? */
+		bool empty() const {return len == 0;}
+
+	};
+
+}
+
+#endif // K_FS_MEMORYMAPPEDFILE_H
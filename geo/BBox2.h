@@ -3,6 +3,8 @@
 
 #include "../geo/Point2.h"
 
+#include <limits>
+
 /**
  * this class represents an axis-aligned 2D bounding box
  */
@@ -0,0 +1,194 @@
+#ifndef K_MATH_DSP_CONV_DSPCONVOLUTIONNONUNIFORM_H
+#define K_MATH_DSP_CONV_DSPCONVOLUTIONNONUNIFORM_H
+
+#include <vector>
+#include <memory>
+
+#include "DSPConvolutionPartitioned.h"
+
+namespace K {
+
+	/**
+	 * @brief streaming convolution for long impulse responses using
+	 * non-uniform partitions.
+	 *
+	 * the start of the impulse response is handled by a uniformly partitioned
+	 * convolution using the (small) blockSize, which determines the latency.
+	 * later parts are handled by stages with 4x, 16x, ... larger blocks (up to
+	 * maxBlockSize) which need far less FFTs and multiply-adds per sample.
+	 *
+	 * stage k (block size B_k) covers the impulse response starting at
+	 * B_k - blockSize. its output for a complete input block is therefore
+	 * needed exactly at the block it is computed in, and the overall latency
+	 * stays at blockSize. the larger stages are computed synchronously,
+	 * every B_k/blockSize blocks.
+	 */
+	template <typename type> class DSPConvolutionNonUniform {
+
+	private:
+
+		/** one stage of the convolution */
+		struct Stage {
+
+			/** uniform convolution for this part of the impulse response */
+			std::unique_ptr<DSPConvolutionPartitioned<type>> conv;
+
+			/** accumulated input until one block is complete */
+			std::vector<type> in;
+
+			/** the last output block of this stage */
+			std::vector<type> out;
+
+			/** number of samples within "in" and the read position within "out" */
+			unsigned int pos;
+
+		};
+
+		/** the smallest block size */
+		unsigned int blockSize;
+
+		/** the largest block size to use */
+		unsigned int maxBlockSize;
+
+		/** all stages, the first one uses blockSize */
+		std::vector<Stage> stages;
+
+		/** process(): pending input samples */
+		std::vector<type> inFifo;
+
+		/** process(): the last output block */
+		std::vector<type> outFifo;
+
+		/** process(): position within inFifo and outFifo */
+		unsigned int fifoPos;
+
+	public:
+
+		/**
+		 * ctor
+		 * @param blockSize the smallest block size, determines the latency
+		 * @param maxBlockSize the largest block size to use for later parts of the impulse response
+		 */
+		DSPConvolutionNonUniform(const unsigned int blockSize, const unsigned int maxBlockSize) :
+			blockSize(blockSize), maxBlockSize(std::max(blockSize, maxBlockSize)),
+			inFifo(blockSize), outFifo(blockSize), fifoPos(0) {
+			;
+		}
+
+		/** set the impulse response to convolve the input with. precomputes all partition spectra and resets the state */
+		void setImpulseResponse(const type* data, const unsigned int len) {
+
+			stages.clear();
+
+			unsigned int bs = blockSize;
+			unsigned int start = 0;
+
+			while (start < len || stages.empty()) {
+
+				// the next (4x larger) stage starts at its block size - blockSize
+				const unsigned int nextBS = bs * 4;
+				const bool last = (nextBS > maxBlockSize);
+				const unsigned int end = (last) ? (len) : (std::min(len, nextBS - blockSize));
+
+				Stage st;
+				st.conv.reset(new DSPConvolutionPartitioned<type>(bs));
+				st.conv->setImpulseResponse(data + start, end - start);
+				st.in.assign(bs, (type) 0);
+				st.out.assign(bs, (type) 0);
+				st.pos = 0;
+				stages.push_back(std::move(st));
+
+				start = end;
+				bs = nextBS;
+				if (last) {break;}
+
+			}
+
+			reset();
+
+		}
+
+		/** clear all previous input. the impulse response is kept */
+		void reset() {
+			for (Stage& st : stages) {
+				st.conv->reset();
+				std::fill(st.in.begin(), st.in.end(), (type) 0);
+				std::fill(st.out.begin(), st.out.end(), (type) 0);
+				st.pos = 0;
+			}
+			std::fill(inFifo.begin(), inFifo.end(), (type) 0);
+			std::fill(outFifo.begin(), outFifo.end(), (type) 0);
+			fifoPos = 0;
+		}
+
+		/** get the number of stages (different block sizes) in use */
+		unsigned int getNumStages() const {return (unsigned int) stages.size();}
+
+		/** get the latency of process() in samples */
+		unsigned int getLatency() const {return blockSize;}
+
+		/**
+		 * @brief convolve exactly blockSize input samples.
+		 * "out" receives the corresponding blockSize output samples (no latency).
+		 * in and out must not be the same buffer.
+		 */
+		void processBlock(const type* in, type* out) {
+
+			_assertFalse(stages.empty(), "impulse response not set");
+
+			// first stage: uniform, without latency
+			stages[0].conv->processBlock(in, out);
+
+			// larger stages: compute once their block is complete, add the pending output
+			for (size_t s = 1; s < stages.size(); ++s) {
+
+				Stage& st = stages[s];
+				const unsigned int bs = st.conv->getBlockSize();
+
+				std::copy(in, in + blockSize, st.in.begin() + st.pos);
+				st.pos += blockSize;
+				if (st.pos == bs) {
+					st.conv->processBlock(st.in.data(), st.out.data());
+					st.pos = 0;
+				}
+
+				// the computed block belongs to the output starting at the block it was computed in
+				const type* src = st.out.data() + st.pos;
+				for (unsigned int i = 0; i < blockSize; ++i) {out[i] += src[i];}
+
+			}
+
+		}
+
+		/**
+		 * @brief convolve any number of input samples.
+		 * the output is delayed by getLatency() samples.
+		 * in and out may be the same buffer.
+		 */
+		void process(const type* in, type* out, const unsigned int len) {
+
+			for (unsigned int i = 0; i < len; ) {
+
+				const unsigned int cnt = std::min(len - i, blockSize - fifoPos);
+				for (unsigned int j = 0; j < cnt; ++j) {
+					const type v = in[i+j];
+					out[i+j] = outFifo[fifoPos + j];
+					inFifo[fifoPos + j] = v;
+				}
+				fifoPos += cnt;
+				i += cnt;
+
+				if (fifoPos == blockSize) {
+					processBlock(inFifo.data(), outFifo.data());
+					fifoPos = 0;
+				}
+
+			}
+
+		}
+
+	};
+
+}
+
+#endif // K_MATH_DSP_CONV_DSPCONVOLUTIONNONUNIFORM_H
@@ -0,0 +1,201 @@
+#ifndef K_MATH_DSP_CONV_DSPCONVOLUTIONPARTITIONED_H
+#define K_MATH_DSP_CONV_DSPCONVOLUTIONPARTITIONED_H
+
+#include <vector>
+#include <algorithm>
+
+#include "../dft/FFTPlan.h"
+#include "../../../Assertions.h"
+
+namespace K {
+
+	/**
+	 * @brief streaming convolution using uniformly partitioned overlap-save.
+	 *
+	 * the impulse response is split into partitions of blockSize samples.
+	 * the spectra of all partitions (FFT size 2*blockSize) are computed once
+	 * within setImpulseResponse(). every block of input is transformed once
+	 * and kept within a frequency-domain delay line. the output block is the
+	 * inverse transform of sum_p(input[now-p] * partition[p]).
+	 *
+	 * thus, the cost per block is constant (one real FFT, one inverse real FFT
+	 * and #partitions complex multiply-adds) and process() does not allocate.
+	 *
+	 * processBlock() works on exactly blockSize samples without latency.
+	 * process() accepts any number of samples and has a latency of blockSize.
+	 */
+	template <typename type> class DSPConvolutionPartitioned {
+
+	private:
+
+		typedef Complex<type> Cplx;
+
+		/** the number of samples per partition / block */
+		unsigned int blockSize;
+
+		/** the number of bins per spectrum */
+		unsigned int bins;
+
+		/** number of partitions of the impulse response */
+		unsigned int numParts;
+
+		/** real FFT of size 2*blockSize */
+		FFTPlan<type> fft;
+
+		/** work buffer for the FFT */
+		std::vector<Cplx> work;
+
+		/** spectra of all partitions of the impulse response. numParts * bins */
+		std::vector<Cplx> irSpectra;
+
+		/** frequency-domain delay line: the spectra of the last numParts input windows. numParts * bins */
+		std::vector<Cplx> fdl;
+
+		/** the fdl-slot containing the most recent input spectrum */
+		unsigned int fdlPos;
+
+		/** the last 2*blockSize input samples */
+		std::vector<type> window;
+
+		/** accumulated spectrum of the current output block */
+		std::vector<Cplx> acc;
+
+		/** time-domain result of the inverse FFT */
+		std::vector<type> result;
+
+		/** process(): pending input samples */
+		std::vector<type> inFifo;
+
+		/** process(): the last output block */
+		std::vector<type> outFifo;
+
+		/** process(): position within inFifo and outFifo */
+		unsigned int fifoPos;
+
+	public:
+
+		/** ctor with the number of samples per block (and partition) */
+		DSPConvolutionPartitioned(const unsigned int blockSize) :
+			blockSize(blockSize), bins(blockSize+1), numParts(0), fft(2*blockSize), work(fft.getWorkSize()),
+			fdlPos(0), window(2*blockSize), acc(blockSize+1), result(2*blockSize),
+			inFifo(blockSize), outFifo(blockSize), fifoPos(0) {
+
+			_assertTrue(blockSize > 0, "block size must be > 0");
+
+		}
+
+		/** no copy */
+		DSPConvolutionPartitioned(const DSPConvolutionPartitioned&) = delete;
+		DSPConvolutionPartitioned& operator = (const DSPConvolutionPartitioned&) = delete;
+
+		/** set the impulse response to convolve the input with. precomputes all partition spectra and resets the state */
+		void setImpulseResponse(const type* data, const unsigned int len) {
+
+			numParts = std::max(1u, (len + blockSize - 1) / blockSize);
+			irSpectra.assign(numParts * bins, Cplx());
+			fdl.assign(numParts * bins, Cplx());
+
+			std::vector<type> padded(2*blockSize);
+			for (unsigned int p = 0; p < numParts; ++p) {
+				const unsigned int start = p * blockSize;
+				const unsigned int cnt = (start < len) ? (std::min(blockSize, len - start)) : (0);
+				std::fill(padded.begin(), padded.end(), (type) 0);
+				std::copy(data + start, data + start + cnt, padded.begin());
+				fft.forwardReal(padded.data(), &irSpectra[p * bins], work.data());
+			}
+
+			reset();
+
+		}
+
+		/** clear all previous input. the impulse response is kept */
+		void reset() {
+			std::fill(fdl.begin(), fdl.end(), Cplx());
+			std::fill(window.begin(), window.end(), (type) 0);
+			std::fill(inFifo.begin(), inFifo.end(), (type) 0);
+			std::fill(outFifo.begin(), outFifo.end(), (type) 0);
+			fdlPos = 0;
+			fifoPos = 0;
+		}
+
+		/** get the number of samples per block */
+		unsigned int getBlockSize() const {return blockSize;}
+
+		/** get the number of partitions the impulse response is split into */
+		unsigned int getNumPartitions() const {return numParts;}
+
+		/** get the latency of process() in samples */
+		unsigned int getLatency() const {return blockSize;}
+
+		/**
+		 * @brief convolve exactly blockSize input samples.
+		 * "out" receives the corresponding blockSize output samples (no latency).
+		 * in and out may be the same buffer.
+		 */
+		void processBlock(const type* in, type* out) {
+
+			_assertTrue(numParts > 0, "impulse response not set");
+
+			// slide the input window and add the new block
+			std::copy(window.begin() + blockSize, window.end(), window.begin());
+			std::copy(in, in + blockSize, window.begin() + blockSize);
+
+			// spectrum of the current window into the delay line
+			fdlPos = (fdlPos + 1) % numParts;
+			fft.forwardReal(window.data(), &fdl[fdlPos * bins], work.data());
+
+			// sum of the delayed input spectra, multiplied with the corresponding partition
+			std::fill(acc.begin(), acc.end(), Cplx());
+			for (unsigned int p = 0; p < numParts; ++p) {
+				const unsigned int slot = (fdlPos + numParts - p) % numParts;
+				mulAdd(acc.data(), &fdl[slot * bins], &irSpectra[p * bins], bins);
+			}
+
+			// back to time domain. the first half is circular garbage (overlap-save)
+			fft.inverseReal(acc.data(), result.data(), work.data());
+			std::copy(result.begin() + blockSize, result.end(), out);
+
+		}
+
+		/**
+		 * @brief convolve any number of input samples.
+		 * the output is delayed by getLatency() samples.
+		 * in and out may be the same buffer.
+		 */
+		void process(const type* in, type* out, const unsigned int len) {
+
+			for (unsigned int i = 0; i < len; ) {
+
+				const unsigned int cnt = std::min(len - i, blockSize - fifoPos);
+				for (unsigned int j = 0; j < cnt; ++j) {
+					const type v = in[i+j];
+					out[i+j] = outFifo[fifoPos + j];
+					inFifo[fifoPos + j] = v;
+				}
+				fifoPos += cnt;
+				i += cnt;
+
+				if (fifoPos == blockSize) {
+					processBlock(inFifo.data(), outFifo.data());
+					fifoPos = 0;
+				}
+
+			}
+
+		}
+
+	private:
+
+		/** acc[i] += a[i] * b[i] */
+		static inline void mulAdd(Cplx* acc, const Cplx* a, const Cplx* b, const unsigned int n) {
+			for (unsigned int i = 0; i < n; ++i) {
+				acc[i].r += a[i].r * b[i].r - a[i].i * b[i].i;
+				acc[i].i += a[i].r * b[i].i + a[i].i * b[i].r;
+			}
+		}
+
+	};
+
+}
+
+#endif // K_MATH_DSP_CONV_DSPCONVOLUTIONPARTITIONED_H
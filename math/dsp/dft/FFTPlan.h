@@ -0,0 +1,654 @@
+#ifndef K_MATH_DSP_FFTPLAN_H
+#define K_MATH_DSP_FFTPLAN_H
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include "Complex.h"
+#include "../../../Assertions.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace K {
+
+	/**
+	 * lanes of complex values used by the FFT butterflies.
+	 * the generic version holds exactly one complex value.
+	 * (SSE2 specializations below process several values at once)
+	 */
+	template <typename type> struct FFTLanes {
+
+		static const unsigned int width = 1;
+
+		Complex<type> v;
+
+		FFTLanes() {;}
+		FFTLanes(const Complex<type>& v) : v(v) {;}
+
+		static inline FFTLanes load(const Complex<type>* src) {return FFTLanes(*src);}
+		inline void store(Complex<type>* dst) const {*dst = v;}
+
+		inline FFTLanes operator + (const FFTLanes& o) const {return FFTLanes(v + o.v);}
+		inline FFTLanes operator - (const FFTLanes& o) const {return FFTLanes(v - o.v);}
+
+		/** complex multiplication of all lanes with the same (twiddle) value */
+		inline FFTLanes operator * (const Complex<type>& w) const {return FFTLanes(v * w);}
+
+		/** multiply all lanes by -j */
+		inline FFTLanes mulNegJ() const {return FFTLanes(Complex<type>(v.i, -v.r));}
+
+	};
+
+#if defined(__SSE2__)
+
+	/** one double-precision complex value per SSE register */
+	template <> struct FFTLanes<double> {
+
+		static const unsigned int width = 1;
+
+		__m128d v;
+
+		FFTLanes() {;}
+		FFTLanes(const __m128d v) : v(v) {;}
+
+		static inline FFTLanes load(const Complex<double>* src) {return FFTLanes(_mm_loadu_pd(&src->r));}
+		inline void store(Complex<double>* dst) const {_mm_storeu_pd(&dst->r, v);}
+
+		inline FFTLanes operator + (const FFTLanes& o) const {return FFTLanes(_mm_add_pd(v, o.v));}
+		inline FFTLanes operator - (const FFTLanes& o) const {return FFTLanes(_mm_sub_pd(v, o.v));}
+
+		inline FFTLanes operator * (const Complex<double>& w) const {
+			const __m128d t1 = _mm_mul_pd(v, _mm_set1_pd(w.r));								// (r*wr, i*wr)
+			const __m128d t2 = _mm_mul_pd(_mm_shuffle_pd(v, v, 1), _mm_set1_pd(w.i));		// (i*wi, r*wi)
+			return FFTLanes(_mm_add_pd(t1, _mm_xor_pd(t2, _mm_set_pd(0.0, -0.0))));
+		}
+
+		inline FFTLanes mulNegJ() const {
+			return FFTLanes(_mm_xor_pd(_mm_shuffle_pd(v, v, 1), _mm_set_pd(-0.0, 0.0)));	// (i, -r)
+		}
+
+	};
+
+	/** two single-precision complex values per SSE register */
+	struct FFTLanesFloat2 {
+
+		static const unsigned int width = 2;
+
+		__m128 v;
+
+		FFTLanesFloat2() {;}
+		FFTLanesFloat2(const __m128 v) : v(v) {;}
+
+		static inline FFTLanesFloat2 load(const Complex<float>* src) {return FFTLanesFloat2(_mm_loadu_ps(&src->r));}
+		inline void store(Complex<float>* dst) const {_mm_storeu_ps(&dst->r, v);}
+
+		inline FFTLanesFloat2 operator + (const FFTLanesFloat2& o) const {return FFTLanesFloat2(_mm_add_ps(v, o.v));}
+		inline FFTLanesFloat2 operator - (const FFTLanesFloat2& o) const {return FFTLanesFloat2(_mm_sub_ps(v, o.v));}
+
+		inline FFTLanesFloat2 operator * (const Complex<float>& w) const {
+			const __m128 t1 = _mm_mul_ps(v, _mm_set1_ps(w.r));
+			const __m128 t2 = _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2,3,0,1)), _mm_set1_ps(w.i));
+			return FFTLanesFloat2(_mm_add_ps(t1, _mm_xor_ps(t2, _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f))));
+		}
+
+		inline FFTLanesFloat2 mulNegJ() const {
+			return FFTLanesFloat2(_mm_xor_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2,3,0,1)), _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f)));
+		}
+
+	};
+
+	/** the widest lanes available for the given type */
+	template <typename type> struct FFTLanesWide {typedef FFTLanes<type> Lanes;};
+	template <> struct FFTLanesWide<float> {typedef FFTLanesFloat2 Lanes;};
+
+#else
+
+	template <typename type> struct FFTLanesWide {typedef FFTLanes<type> Lanes;};
+
+#endif
+
+
+
+	/**
+	 * @brief precomputed FFT plan for an arbitrary size.
+	 *
+	 * the size is factorized into radix-4, -2, -3, -5 and -7 stages that
+	 * are executed as self-sorting (Stockham) passes, so no bit-reverse
+	 * LUT is needed and the size is not limited to 64k. all twiddles
+	 * are computed once within the ctor. sizes containing larger prime
+	 * factors are computed using Bluestein's algorithm on top of a
+	 * power-of-2 plan.
+	 *
+	 * the radix-4 and radix-2 butterflies run on SSE2 when available,
+	 * all passes of large transforms are split among OpenMP threads.
+	 *
+	 * the plan itself is never modified after construction. all methods
+	 * taking a "work" buffer (getWorkSize() entries) are thread-safe, the
+	 * convenience versions use an internal buffer and are not.
+	 *
+	 * the forward transform is unscaled, the inverse is scaled by 1/size.
+	 */
+	template <typename type> class FFTPlan {
+
+	private:
+
+		typedef Complex<type> Cplx;
+
+		/** one Stockham pass */
+		struct Stage {
+
+			/** radix of this pass */
+			unsigned int radix;
+
+			/** length of the sub-sequences to transform */
+			unsigned int n;
+
+			/** stride between the elements of one sub-sequence */
+			unsigned int s;
+
+			/** offset of this pass' twiddles within "twiddles": (n/radix) * (radix-1) entries */
+			unsigned int twOffset;
+
+			/** odd radices: offset of the radix' roots of unity within "twiddles": radix entries */
+			unsigned int rootOffset;
+
+		};
+
+		/** the size of the transform */
+		unsigned int size;
+
+		/** all passes to execute. empty when using bluestein */
+		std::vector<Stage> stages;
+
+		/** the twiddles for all passes */
+		std::vector<Cplx> twiddles;
+
+		/** bluestein: power-of-2 plan for the convolution */
+		FFTPlan* conv;
+
+		/** bluestein: chirp exp(-j*pi*k^2/size) */
+		std::vector<Cplx> chirp;
+
+		/** bluestein: FFT of the conjugate chirp, already scaled by 1/conv.size */
+		std::vector<Cplx> chirpFFT;
+
+		/** buffer for the non-thread-safe convenience methods */
+		std::vector<Cplx> work;
+
+		/** real-input transforms: half-size complex plan */
+		FFTPlan* half;
+
+		/** real-input transforms: exp(-j*2*pi*k/size) for k in [0:size/2[ */
+		std::vector<Cplx> realTwiddles;
+
+		/** whether this plan supports the real-input transforms */
+		bool withReal;
+
+		/** transforms with less elements are always executed single-threaded */
+		static inline unsigned int getParallelMinSize() {return 1 << 16;}
+
+		/** ctor. internal plans (half-size, bluestein) do not need the real-input support */
+		FFTPlan(const unsigned int size, const bool withReal) : size(size), conv(nullptr), half(nullptr), withReal(withReal) {
+
+			_assertTrue(size > 0, "FFT size must be > 0");
+
+			if (!factorize()) {initBluestein();}
+			if (withReal) {initReal();}
+			work.resize(getWorkSize());
+
+		}
+
+	public:
+
+		/** ctor for a transform of the given size (any size >= 1) */
+		FFTPlan(const unsigned int size) : FFTPlan(size, true) {
+			;
+		}
+
+		/** dtor */
+		~FFTPlan() {
+			delete conv;	conv = nullptr;
+			delete half;	half = nullptr;
+		}
+
+		/** no copy */
+		FFTPlan(const FFTPlan&) = delete;
+		FFTPlan& operator = (const FFTPlan&) = delete;
+
+		/** get the size of the transform */
+		unsigned int getSize() const {return size;}
+
+		/** whether the transform uses Bluestein's algorithm (size has prime factors > 7) */
+		bool isBluestein() const {return conv != nullptr;}
+
+		/** number of complex entries needed for the "work" buffer of all thread-safe methods */
+		unsigned int getWorkSize() const {
+			const unsigned int cws = (conv) ? (conv->getSize() + conv->getWorkSize()) : (size);
+			if (!withReal) {return cws;}
+			const unsigned int rws = (half) ? (half->getSize() + half->getWorkSize()) : (size + cws);
+			return std::max(cws, rws);
+		}
+
+
+		/** inplace, forward complex FFT. uses the internal buffer (not thread-safe) */
+		void forward(Cplx* data) {forward(data, work.data());}
+
+		/** inplace, inverse complex FFT (scaled by 1/size). uses the internal buffer (not thread-safe) */
+		void inverse(Cplx* data) {inverse(data, work.data());}
+
+		/** inplace, forward complex FFT using the given work buffer of getWorkSize() entries */
+		void forward(Cplx* data, Cplx* work) const {
+			execute(data, work);
+		}
+
+		/** inplace, inverse complex FFT (scaled by 1/size) using the given work buffer of getWorkSize() entries */
+		void inverse(Cplx* data, Cplx* work) const {
+			for (unsigned int i = 0; i < size; ++i) {data[i].i = -data[i].i;}
+			execute(data, work);
+			const type scale = (type) 1 / (type) size;
+			for (unsigned int i = 0; i < size; ++i) {
+				data[i].r *=  scale;
+				data[i].i *= -scale;
+			}
+		}
+
+
+		/**
+		 * @brief forward FFT of size real values.
+		 * "out" receives the size/2+1 non-redundant complex bins.
+		 * uses the internal buffer (not thread-safe)
+		 */
+		void forwardReal(const type* in, Cplx* out) {forwardReal(in, out, work.data());}
+
+		/** inverse of forwardReal(): size/2+1 complex bins to size real values. uses the internal buffer (not thread-safe) */
+		void inverseReal(const Cplx* in, type* out) {inverseReal(in, out, work.data());}
+
+		/**
+		 * @brief forward FFT of size real values using the given work buffer.
+		 * for even sizes this packs the input into a complex signal of half the
+		 * size, transforms it and splits the result into the real spectrum.
+		 */
+		void forwardReal(const type* in, Cplx* out, Cplx* work) const {
+
+			_assertTrue(withReal, "plan does not support real-input transforms");
+
+			// odd sizes: plain complex transform
+			if (!half) {
+				for (unsigned int i = 0; i < size; ++i) {work[i] = Cplx(in[i], 0);}
+				forward(work, work + size);
+				std::copy(work, work + size/2 + 1, out);
+				return;
+			}
+
+			// pack even/odd samples as real/imag and transform
+			const unsigned int h = size / 2;
+			Cplx* z = work;
+			std::memcpy((void*) z, in, sizeof(type) * size);
+			half->forward(z, work + h);
+
+			// split: X[k] = (Z[k] + Z*[h-k])/2 - j/2 * W^k * (Z[k] - Z*[h-k])
+			out[0] = Cplx(z[0].r + z[0].i, 0);
+			out[h] = Cplx(z[0].r - z[0].i, 0);
+			for (unsigned int k = 1; k < h; ++k) {
+				const Cplx a = z[k];
+				const Cplx b(z[h-k].r, -z[h-k].i);
+				const Cplx e = (a + b) * (type) 0.5;
+				const Cplx o = (a - b) * realTwiddles[k];
+				out[k] = Cplx(e.r + o.i * (type) 0.5, e.i - o.r * (type) 0.5);
+			}
+
+		}
+
+		/** inverse of forwardReal() using the given work buffer (scaled by 1/size) */
+		void inverseReal(const Cplx* in, type* out, Cplx* work) const {
+
+			_assertTrue(withReal, "plan does not support real-input transforms");
+
+			// odd sizes: rebuild the hermitian spectrum and use the complex transform
+			if (!half) {
+				for (unsigned int k = 0; k <= size/2; ++k) {work[k] = in[k];}
+				for (unsigned int k = size/2+1; k < size; ++k) {work[k] = Cplx(in[size-k].r, -in[size-k].i);}
+				inverse(work, work + size);
+				for (unsigned int i = 0; i < size; ++i) {out[i] = work[i].r;}
+				return;
+			}
+
+			// merge: Z[k] = Fe[k] + j*Fo[k]
+			const unsigned int h = size / 2;
+			Cplx* z = work;
+			for (unsigned int k = 0; k < h; ++k) {
+				const Cplx a = in[k];
+				const Cplx b(in[h-k].r, -in[h-k].i);
+				const Cplx e = (a + b) * (type) 0.5;
+				const Cplx w(realTwiddles[k].r, -realTwiddles[k].i);
+				const Cplx o = ((a - b) * (type) 0.5) * w;
+				z[k] = Cplx(e.r - o.i, e.i + o.r);
+			}
+
+			half->inverse(z, work + h);
+			std::memcpy(out, (const void*) z, sizeof(type) * size);
+
+		}
+
+
+		/**
+		 * @brief inplace forward FFT of "count" signals of this plan's size,
+		 * stored back to back within "data". the signals are distributed among
+		 * all OpenMP threads, each using its own work buffer.
+		 */
+		void forwardBatch(Cplx* data, const unsigned int count) const {
+			#pragma omp parallel
+			{
+				std::vector<Cplx> work(getWorkSize());
+				#pragma omp for schedule(dynamic)
+				for (int i = 0; i < (int) count; ++i) {
+					execute(data + (size_t) i * size, work.data());
+				}
+			}
+		}
+
+		/** inplace inverse FFT of "count" back-to-back signals. see forwardBatch() */
+		void inverseBatch(Cplx* data, const unsigned int count) const {
+			#pragma omp parallel
+			{
+				std::vector<Cplx> work(getWorkSize());
+				#pragma omp for schedule(dynamic)
+				for (int i = 0; i < (int) count; ++i) {
+					inverse(data + (size_t) i * size, work.data());
+				}
+			}
+		}
+
+		/**
+		 * @brief forward real FFT of "count" signals of this plan's size, stored back to back within "in".
+		 * the size/2+1 bins of each signal are stored back to back within "out".
+		 */
+		void forwardRealBatch(const type* in, Cplx* out, const unsigned int count) const {
+			const size_t bins = size/2 + 1;
+			#pragma omp parallel
+			{
+				std::vector<Cplx> work(getWorkSize());
+				#pragma omp for schedule(dynamic)
+				for (int i = 0; i < (int) count; ++i) {
+					forwardReal(in + (size_t) i * size, out + (size_t) i * bins, work.data());
+				}
+			}
+		}
+
+		/** inverse of forwardRealBatch() */
+		void inverseRealBatch(const Cplx* in, type* out, const unsigned int count) const {
+			const size_t bins = size/2 + 1;
+			#pragma omp parallel
+			{
+				std::vector<Cplx> work(getWorkSize());
+				#pragma omp for schedule(dynamic)
+				for (int i = 0; i < (int) count; ++i) {
+					inverseReal(in + (size_t) i * bins, out + (size_t) i * size, work.data());
+				}
+			}
+		}
+
+	private:
+
+		/** split the size into supported radices and precompute all twiddles. false if not possible */
+		bool factorize() {
+
+			std::vector<unsigned int> radices;
+			unsigned int rem = size;
+			while (rem % 4 == 0) {radices.push_back(4); rem /= 4;}
+			while (rem % 2 == 0) {radices.push_back(2); rem /= 2;}
+			for (unsigned int r = 3; r <= 7; r += 2) {
+				while (rem % r == 0) {radices.push_back(r); rem /= r;}
+			}
+			if (rem != 1) {return false;}
+
+			unsigned int n = size;
+			unsigned int s = 1;
+			for (const unsigned int r : radices) {
+				Stage st;
+				st.radix = r;
+				st.n = n;
+				st.s = s;
+				st.twOffset = (unsigned int) twiddles.size();
+				const unsigned int m = n / r;
+				for (unsigned int p = 0; p < m; ++p) {
+					for (unsigned int j = 1; j < r; ++j) {
+						twiddles.push_back(getRoot((unsigned long long) p * j, n));
+					}
+				}
+				st.rootOffset = (unsigned int) twiddles.size();
+				if (r != 2 && r != 4) {
+					for (unsigned int i = 0; i < r; ++i) {twiddles.push_back(getRoot(i, r));}
+				}
+				stages.push_back(st);
+				n /= r;
+				s *= r;
+			}
+
+			return true;
+
+		}
+
+		/** setup bluestein's algorithm using a power-of-2 plan >= 2*size-1 */
+		void initBluestein() {
+
+			unsigned int m = 1;
+			while (m < 2*size - 1) {m <<= 1;}
+			conv = new FFTPlan(m, false);
+
+			// chirp. k^2 is taken modulo 2*size to keep the angle small and exact
+			chirp.resize(size);
+			for (unsigned int k = 0; k < size; ++k) {
+				const unsigned long long k2 = ((unsigned long long) k * k) % (2ull * size);
+				chirp[k] = getRoot(k2, 2ull * size);
+			}
+
+			// FFT of the conjugate chirp, wrapped around
+			chirpFFT.assign(m, Cplx());
+			chirpFFT[0] = Cplx(chirp[0].r, -chirp[0].i);
+			for (unsigned int k = 1; k < size; ++k) {
+				chirpFFT[k] = chirpFFT[m-k] = Cplx(chirp[k].r, -chirp[k].i);
+			}
+			std::vector<Cplx> tmp(conv->getWorkSize());
+			conv->forward(chirpFFT.data(), tmp.data());
+			const type scale = (type) 1 / (type) m;
+			for (Cplx& c : chirpFFT) {c *= scale;}
+
+		}
+
+		/** setup the half-size plan for real-input transforms */
+		void initReal() {
+			if (size % 2 != 0 || size < 2) {return;}
+			half = new FFTPlan(size / 2, false);
+			realTwiddles.resize(size / 2);
+			for (unsigned int k = 0; k < size / 2; ++k) {realTwiddles[k] = getRoot(k, size);}
+		}
+
+		/** exp(-j*2*pi*k/n) */
+		static Cplx getRoot(const unsigned long long k, const unsigned long long n) {
+			const double a = -2.0 * M_PI * (double) (k % n) / (double) n;
+			return Cplx((type) std::cos(a), (type) std::sin(a));
+		}
+
+		/** inplace forward transform of "data" */
+		void execute(Cplx* data, Cplx* work) const {
+
+			if (conv) {executeBluestein(data, work); return;}
+
+			Cplx* x = data;
+			Cplx* y = work;
+			for (const Stage& st : stages) {
+				executeStage(st, x, y);
+				std::swap(x, y);
+			}
+			if (x != data) {std::copy(x, x + size, data);}
+
+		}
+
+		/** bluestein: X[k] = c[k] * sum_n (x[n]*c[n]) * c*[k-n] as circular convolution of power-of-2 size */
+		void executeBluestein(Cplx* data, Cplx* work) const {
+
+			const unsigned int m = conv->getSize();
+			Cplx* a = work;
+			Cplx* cWork = work + m;
+
+			for (unsigned int k = 0; k < size; ++k) {a[k] = data[k] * chirp[k];}
+			std::fill(a + size, a + m, Cplx());
+
+			conv->forward(a, cWork);
+			for (unsigned int k = 0; k < m; ++k) {
+				a[k] = Cplx(a[k].r, -a[k].i) * Cplx(chirpFFT[k].r, -chirpFFT[k].i);
+			}
+
+			// inverse via conjugation. the scaling is already part of chirpFFT
+			conv->forward(a, cWork);
+			for (unsigned int k = 0; k < size; ++k) {data[k] = Cplx(a[k].r, -a[k].i) * chirp[k];}
+
+		}
+
+		/** execute one Stockham pass from x into y, split among threads for large transforms */
+		void executeStage(const Stage& st, const Cplx* x, Cplx* y) const {
+
+			const int m = (int) (st.n / st.radix);
+			const int s = (int) st.s;
+
+			if (size < getParallelMinSize()) {
+				runStage(st, x, y, 0, m, 0, s);
+			} else if (m >= s) {
+				#pragma omp parallel for schedule(static)
+				for (int p = 0; p < m; ++p) {runStage(st, x, y, p, p+1, 0, s);}
+			} else {
+				const int blk = 256;
+				#pragma omp parallel for schedule(static)
+				for (int q0 = 0; q0 < s; q0 += blk) {runStage(st, x, y, 0, m, q0, std::min(s, q0+blk));}
+			}
+
+		}
+
+		/** run the pass for p in [p0:p1[ and q in [q0:q1[ */
+		void runStage(const Stage& st, const Cplx* x, Cplx* y, const int p0, const int p1, const int q0, const int q1) const {
+
+			typedef typename FFTLanesWide<type>::Lanes Wide;
+			typedef FFTLanes<type> Narrow;
+
+			switch (st.radix) {
+				case 4:		radix4<Wide, Narrow>(st, x, y, p0, p1, q0, q1); break;
+				case 2:		radix2<Wide, Narrow>(st, x, y, p0, p1, q0, q1); break;
+				default:	radixN(st, x, y, p0, p1, q0, q1); break;
+			}
+
+		}
+
+		/** radix-4 pass. the q-loop is contiguous and runs on the widest lanes available */
+		template <typename Wide, typename Narrow> void radix4(const Stage& st, const Cplx* x, Cplx* y, const int p0, const int p1, const int q0, const int q1) const {
+
+			const unsigned int s = st.s;
+			const unsigned int m = st.n / 4;
+
+			for (int p = p0; p < p1; ++p) {
+
+				const Cplx* w = &twiddles[st.twOffset + p*3];
+				const Cplx* xa = x + s*p;
+				const Cplx* xb = x + s*(p + m);
+				const Cplx* xc = x + s*(p + 2*m);
+				const Cplx* xd = x + s*(p + 3*m);
+				Cplx* yy = y + s*4*p;
+
+				int q = q0;
+				for (; q + (int) Wide::width <= q1; q += Wide::width) {butterfly4<Wide>(xa+q, xb+q, xc+q, xd+q, yy+q, s, w, p == 0);}
+				for (; q < q1; ++q) {butterfly4<Narrow>(xa+q, xb+q, xc+q, xd+q, yy+q, s, w, p == 0);}
+
+			}
+
+		}
+
+		template <typename L> static inline void butterfly4(const Cplx* xa, const Cplx* xb, const Cplx* xc, const Cplx* xd, Cplx* y, const unsigned int s, const Cplx* w, const bool noTwiddle) {
+
+			const L a = L::load(xa);
+			const L b = L::load(xb);
+			const L c = L::load(xc);
+			const L d = L::load(xd);
+
+			const L apc = a + c;
+			const L amc = a - c;
+			const L bpd = b + d;
+			const L jbmd = (b - d).mulNegJ();
+
+			(apc + bpd).store(y);
+			if (noTwiddle) {
+				(amc + jbmd).store(y + s);
+				(apc - bpd).store(y + 2*s);
+				(amc - jbmd).store(y + 3*s);
+			} else {
+				((amc + jbmd) * w[0]).store(y + s);
+				((apc - bpd) * w[1]).store(y + 2*s);
+				((amc - jbmd) * w[2]).store(y + 3*s);
+			}
+
+		}
+
+		/** radix-2 pass */
+		template <typename Wide, typename Narrow> void radix2(const Stage& st, const Cplx* x, Cplx* y, const int p0, const int p1, const int q0, const int q1) const {
+
+			const unsigned int s = st.s;
+			const unsigned int m = st.n / 2;
+
+			for (int p = p0; p < p1; ++p) {
+
+				const Cplx w = twiddles[st.twOffset + p];
+				const Cplx* xa = x + s*p;
+				const Cplx* xb = x + s*(p + m);
+				Cplx* yy = y + s*2*p;
+
+				int q = q0;
+				for (; q + (int) Wide::width <= q1; q += Wide::width) {
+					const Wide a = Wide::load(xa+q);
+					const Wide b = Wide::load(xb+q);
+					(a + b).store(yy+q);
+					((a - b) * w).store(yy+q+s);
+				}
+				for (; q < q1; ++q) {
+					const Narrow a = Narrow::load(xa+q);
+					const Narrow b = Narrow::load(xb+q);
+					(a + b).store(yy+q);
+					((a - b) * w).store(yy+q+s);
+				}
+
+			}
+
+		}
+
+		/** generic (scalar) pass for the small odd radices */
+		void radixN(const Stage& st, const Cplx* x, Cplx* y, const int p0, const int p1, const int q0, const int q1) const {
+
+			const unsigned int r = st.radix;
+			const unsigned int s = st.s;
+			const unsigned int m = st.n / r;
+
+			// roots of unity for the radix' DFT
+			const Cplx* roots = &twiddles[st.rootOffset];
+
+			Cplx in[7];
+			for (int p = p0; p < p1; ++p) {
+				const Cplx* w = &twiddles[st.twOffset + p*(r-1)];
+				for (int q = q0; q < q1; ++q) {
+					for (unsigned int k = 0; k < r; ++k) {in[k] = x[q + s*(p + k*m)];}
+					for (unsigned int j = 0; j < r; ++j) {
+						Cplx sum = in[0];
+						for (unsigned int k = 1; k < r; ++k) {sum += in[k] * roots[(j*k) % r];}
+						y[q + s*(r*p + j)] = (j == 0) ? (sum) : (sum * w[j-1]);
+					}
+				}
+			}
+
+		}
+
+	};
+
+}
+
+#endif // K_MATH_DSP_FFTPLAN_H
@@ -0,0 +1,194 @@
+#ifndef K_MATH_DSP_ISTFT_H
+#define K_MATH_DSP_ISTFT_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+#include "STFT.h"
+
+namespace K {
+
+	/**
+	 * @brief inverse short-time Fourier transform (weighted overlap-add)
+	 *
+	 * every frame of magnitudes and phases is transformed back, multiplied
+	 * with the synthesis window and added to the output at its position.
+	 * the output is divided by the sum of the squared windows of all frames
+	 * covering each sample. for the same window and hop as the analysis
+	 * this yields a perfect reconstruction whenever the windows overlap
+	 * (constant overlap-add normalization).
+	 *
+	 * the signal's edges are only covered by the tails of a single window.
+	 * samples whose window sum is below epsilon can not be recovered and are
+	 * output as 0 (e.g. the first one for Hann, several for float), the next
+	 * few ones are less accurate as rounding errors are amplified.
+	 */
+	template <typename type> class ISTFT {
+
+	private:
+
+		typedef Complex<type> Cplx;
+
+		/** samples per frame */
+		unsigned int frameSize;
+
+		/** samples between the start of two frames */
+		unsigned int hop;
+
+		/** bins per frame */
+		unsigned int bins;
+
+		/** the cached synthesis window */
+		std::vector<type> window;
+
+		/** the FFT to use */
+		FFTPlan<type> fft;
+
+		/** streaming: overlap-add accumulator and the corresponding sum of squared windows */
+		std::vector<type> acc;
+		std::vector<type> norm;
+
+		/** streaming: spectrum, time-domain frame and FFT work buffer */
+		std::vector<Cplx> spectrum;
+		std::vector<type> frame;
+		std::vector<Cplx> work;
+
+	public:
+
+		/** ctor. use the same parameters as for the analysis */
+		ISTFT(const unsigned int frameSize, const unsigned int hop, DSPWindowFunc windowFunc = &DSPWindowHanning<type, 1>::getValue) :
+			frameSize(frameSize), hop(hop), bins(frameSize/2 + 1), window(frameSize), fft(frameSize),
+			acc(frameSize), norm(frameSize), spectrum(bins), frame(frameSize), work(fft.getWorkSize()) {
+
+			_assertTrue(hop > 0 && hop <= frameSize, "hop must be within [1:frameSize]");
+			for (unsigned int i = 0; i < frameSize; ++i) {window[i] = (type) windowFunc(i, frameSize);}
+
+		}
+
+		/** get the number of samples between two frames (= samples per pushed frame) */
+		unsigned int getHop() const {return hop;}
+
+		/** clear the overlap-add state */
+		void reset() {
+			std::fill(acc.begin(), acc.end(), (type) 0);
+			std::fill(norm.begin(), norm.end(), (type) 0);
+		}
+
+		/**
+		 * @brief add the next frame (bins magnitudes and phases).
+		 * "out" receives the next hop samples, which are complete now.
+		 * the first output sample belongs to the first input sample of the analysis.
+		 */
+		void pushFrame(const type* mag, const type* phase, type* out) {
+
+			inverse(mag, phase, frame.data(), spectrum.data(), work.data());
+			for (unsigned int i = 0; i < frameSize; ++i) {
+				acc[i] += frame[i];
+				norm[i] += window[i] * window[i];
+			}
+
+			for (unsigned int i = 0; i < hop; ++i) {out[i] = getNormalized(acc[i], norm[i]);}
+
+			// shift by one hop
+			std::copy(acc.begin() + hop, acc.end(), acc.begin());
+			std::copy(norm.begin() + hop, norm.end(), norm.begin());
+			std::fill(acc.end() - hop, acc.end(), (type) 0);
+			std::fill(norm.end() - hop, norm.end(), (type) 0);
+
+		}
+
+		/**
+		 * @brief get the remaining frameSize-hop samples after the last frame was pushed.
+		 * resets the state afterwards.
+		 */
+		void flush(type* out) {
+			for (unsigned int i = 0; i < frameSize - hop; ++i) {out[i] = getNormalized(acc[i], norm[i]);}
+			reset();
+		}
+
+		/**
+		 * @brief reconstruct a whole signal of (frames-1)*hop+frameSize samples from
+		 * frames * bins magnitudes and phases (e.g. from STFT::analyze()).
+		 * the inverse FFTs are computed in parallel, chunk by chunk.
+		 */
+		void synthesize(const type* mag, const type* phase, const size_t frames, type* out) const {
+
+			if (frames == 0) {return;}
+			const size_t len = (frames - 1) * hop + frameSize;
+			std::fill(out, out + len, (type) 0);
+
+			// inverse transforms of one chunk in parallel, then overlap-add
+			const long long CHUNK = 256;
+			std::vector<type> chunk(CHUNK * frameSize);
+
+			for (long long f0 = 0; f0 < (long long) frames; f0 += CHUNK) {
+
+				const long long cnt = std::min(CHUNK, (long long) frames - f0);
+
+				#pragma omp parallel
+				{
+					std::vector<Cplx> spectrum(bins);
+					std::vector<Cplx> work(fft.getWorkSize());
+
+					#pragma omp for schedule(static)
+					for (long long f = 0; f < cnt; ++f) {
+						inverse(mag + (f0+f) * bins, phase + (f0+f) * bins, &chunk[f * frameSize], spectrum.data(), work.data());
+					}
+				}
+
+				for (long long f = 0; f < cnt; ++f) {
+					type* dst = out + (f0 + f) * hop;
+					const type* src = &chunk[f * frameSize];
+					for (unsigned int i = 0; i < frameSize; ++i) {dst[i] += src[i];}
+				}
+
+			}
+
+			// normalization: the sum of squared windows is periodic with the hop, except for the edges
+			std::vector<type> wsum(hop, (type) 0);
+			for (unsigned int i = 0; i < frameSize; ++i) {wsum[i % hop] += window[i] * window[i];}
+			const size_t edge = std::min(len, (size_t) frameSize);
+			for (size_t i = 0; i < len; ++i) {
+				if (i >= edge && i < len - edge) {
+					out[i] = getNormalized(out[i], wsum[i % hop]);
+				} else {
+					out[i] = getNormalized(out[i], getWindowSum(i, frames));
+				}
+			}
+
+		}
+
+	private:
+
+		/** sum of squared windows of all frames covering sample i */
+		type getWindowSum(const size_t i, const size_t frames) const {
+			type sum = 0;
+			const size_t fMax = std::min(frames - 1, i / hop);
+			for (size_t f = (i < frameSize) ? (0) : ((i - frameSize) / hop + 1); f <= fMax; ++f) {
+				const size_t j = i - f * hop;
+				if (j < frameSize) {sum += window[j] * window[j];}
+			}
+			return sum;
+		}
+
+		/** divide by the window sum. samples not covered by any window are set to 0 */
+		static inline type getNormalized(const type v, const type wsum) {
+			return (wsum > std::numeric_limits<type>::epsilon()) ? (v / wsum) : ((type) 0);
+		}
+
+		/** polar to complex, inverse real FFT and synthesis window */
+		void inverse(const type* mag, const type* phase, type* frame, Cplx* spectrum, Cplx* work) const {
+			for (unsigned int k = 0; k < bins; ++k) {
+				spectrum[k] = Cplx(mag[k] * std::cos(phase[k]), mag[k] * std::sin(phase[k]));
+			}
+			fft.inverseReal(spectrum, frame, work);
+			for (unsigned int i = 0; i < frameSize; ++i) {frame[i] *= window[i];}
+		}
+
+	};
+
+}
+
+#endif // K_MATH_DSP_ISTFT_H
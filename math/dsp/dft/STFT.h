@@ -0,0 +1,208 @@
+#ifndef K_MATH_DSP_STFT_H
+#define K_MATH_DSP_STFT_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "FFTPlan.h"
+#include "../window/DSPWindowHanning.h"
+#include "../../../Assertions.h"
+
+namespace K {
+
+	/**
+	 * @brief short-time Fourier transform (analysis)
+	 *
+	 * splits a stream of samples into overlapping frames of frameSize samples,
+	 * one frame every hop samples. each frame is multiplied with the (cached)
+	 * window and transformed with a real FFT. the frameSize/2+1 magnitudes
+	 * and phases of each frame are written into a ring buffer of frames that
+	 * is read using popFrame(). once the ring is full, the oldest frame is
+	 * overwritten.
+	 *
+	 * analyze() transforms a whole recording, distributing the frames among
+	 * all OpenMP threads.
+	 */
+	template <typename type> class STFT {
+
+	private:
+
+		typedef Complex<type> Cplx;
+
+		/** samples per frame */
+		unsigned int frameSize;
+
+		/** samples between the start of two frames */
+		unsigned int hop;
+
+		/** bins per frame */
+		unsigned int bins;
+
+		/** the cached window */
+		std::vector<type> window;
+
+		/** the FFT to use */
+		FFTPlan<type> fft;
+
+		/** streaming: the last frameSize input samples */
+		std::vector<type> input;
+
+		/** streaming: number of valid samples within "input" */
+		unsigned int inputFill;
+
+		/** streaming: windowed frame, spectrum and FFT work buffer */
+		std::vector<type> frame;
+		std::vector<Cplx> spectrum;
+		std::vector<Cplx> work;
+
+		/** ring of frames: capacity * bins magnitudes and phases */
+		std::vector<type> ringMag;
+		std::vector<type> ringPhase;
+
+		/** ring: capacity in frames, first used frame and number of used frames */
+		unsigned int capacity;
+		unsigned int ringHead;
+		unsigned int ringUsed;
+
+		/** number of frames that were overwritten before being read */
+		unsigned long long dropped;
+
+	public:
+
+		/**
+		 * ctor
+		 * @param frameSize the number of samples per frame
+		 * @param hop the number of samples between two frames (<= frameSize)
+		 * @param capacity the number of frames the ring buffer holds
+		 * @param windowFunc the window to apply to each frame
+		 */
+		STFT(const unsigned int frameSize, const unsigned int hop, const unsigned int capacity = 64, DSPWindowFunc windowFunc = &DSPWindowHanning<type, 1>::getValue) :
+			frameSize(frameSize), hop(hop), bins(frameSize/2 + 1), window(frameSize), fft(frameSize),
+			input(frameSize), inputFill(0), frame(frameSize), spectrum(bins), work(fft.getWorkSize()),
+			ringMag(capacity * bins), ringPhase(capacity * bins), capacity(capacity), ringHead(0), ringUsed(0), dropped(0) {
+
+			_assertTrue(hop > 0 && hop <= frameSize, "hop must be within [1:frameSize]");
+			_assertTrue(capacity > 0, "capacity must be > 0");
+			for (unsigned int i = 0; i < frameSize; ++i) {window[i] = (type) windowFunc(i, frameSize);}
+
+		}
+
+		/** get the number of samples per frame */
+		unsigned int getFrameSize() const {return frameSize;}
+
+		/** get the number of samples between two frames */
+		unsigned int getHop() const {return hop;}
+
+		/** get the number of magnitude/phase values per frame */
+		unsigned int getNumBins() const {return bins;}
+
+		/** get the window applied to each frame */
+		const std::vector<type>& getWindow() const {return window;}
+
+		/** get the number of frames that are ready to be read */
+		unsigned int getNumFrames() const {return ringUsed;}
+
+		/** get the number of frames that were overwritten before being read */
+		unsigned long long getNumDropped() const {return dropped;}
+
+		/** clear all pending input and frames */
+		void reset() {
+			inputFill = 0;
+			ringHead = 0;
+			ringUsed = 0;
+			dropped = 0;
+		}
+
+		/**
+		 * @brief append len samples to the stream.
+		 * every hop samples (once frameSize samples are available) a new
+		 * frame is appended to the ring buffer. returns the number of new frames
+		 */
+		unsigned int push(const type* samples, const unsigned int len) {
+
+			unsigned int created = 0;
+
+			for (unsigned int i = 0; i < len; ) {
+
+				const unsigned int cnt = std::min(len - i, frameSize - inputFill);
+				std::copy(samples + i, samples + i + cnt, input.begin() + inputFill);
+				inputFill += cnt;
+				i += cnt;
+
+				if (inputFill == frameSize) {
+
+					// transform into the next ring slot
+					if (ringUsed == capacity) {ringHead = (ringHead + 1) % capacity; --ringUsed; ++dropped;}
+					const unsigned int slot = (ringHead + ringUsed) % capacity;
+					transform(input.data(), &ringMag[slot * bins], &ringPhase[slot * bins], frame.data(), spectrum.data(), work.data());
+					++ringUsed;
+					++created;
+
+					// keep the overlapping part
+					std::copy(input.begin() + hop, input.end(), input.begin());
+					inputFill -= hop;
+
+				}
+
+			}
+
+			return created;
+
+		}
+
+		/** read (and remove) the oldest frame: bins magnitudes and phases. false if no frame is available */
+		bool popFrame(type* mag, type* phase) {
+			if (ringUsed == 0) {return false;}
+			std::copy(&ringMag[ringHead * bins], &ringMag[ringHead * bins] + bins, mag);
+			std::copy(&ringPhase[ringHead * bins], &ringPhase[ringHead * bins] + bins, phase);
+			ringHead = (ringHead + 1) % capacity;
+			--ringUsed;
+			return true;
+		}
+
+		/** get the number of frames analyze() produces for a signal of the given length */
+		size_t getNumFrames(const size_t len) const {
+			return (len < frameSize) ? (0) : (1 + (len - frameSize) / hop);
+		}
+
+		/**
+		 * @brief transform a whole signal (independent of the streaming state).
+		 * "mag" and "phase" receive getNumFrames(len) * getNumBins() values each.
+		 * the frames are computed in parallel.
+		 */
+		void analyze(const type* signal, const size_t len, type* mag, type* phase) const {
+
+			const long long frames = (long long) getNumFrames(len);
+
+			#pragma omp parallel
+			{
+				std::vector<type> frame(frameSize);
+				std::vector<Cplx> spectrum(bins);
+				std::vector<Cplx> work(fft.getWorkSize());
+
+				#pragma omp for schedule(static)
+				for (long long f = 0; f < frames; ++f) {
+					transform(signal + f * hop, mag + f * bins, phase + f * bins, frame.data(), spectrum.data(), work.data());
+				}
+			}
+
+		}
+
+	private:
+
+		/** window frameSize samples, transform and split into magnitude and phase */
+		void transform(const type* src, type* mag, type* phase, type* frame, Cplx* spectrum, Cplx* work) const {
+			for (unsigned int i = 0; i < frameSize; ++i) {frame[i] = src[i] * window[i];}
+			fft.forwardReal(frame, spectrum, work);
+			for (unsigned int k = 0; k < bins; ++k) {
+				mag[k] = std::sqrt(spectrum[k].r * spectrum[k].r + spectrum[k].i * spectrum[k].i);
+				phase[k] = std::atan2(spectrum[k].i, spectrum[k].r);
+			}
+		}
+
+	};
+
+}
+
+#endif // K_MATH_DSP_STFT_H
@@ -0,0 +1,49 @@
+#ifndef K_MATH_DSP_FILTER_IIRBIQUAD_H
+#define K_MATH_DSP_FILTER_IIRBIQUAD_H
+
+#include <cmath>
+#include <complex>
+
+namespace K {
+
+	/**
+	 * @brief coefficients of one second-order section (biquad)
+	 *
+	 * H(z) = (b0 + b1*z^-1 + b2*z^-2) / (1 + a1*z^-1 + a2*z^-2)
+	 *
+	 * first-order sections simply use b2 = a2 = 0.
+	 */
+	struct IIRBiquad {
+
+		double b0;
+		double b1;
+		double b2;
+		double a1;
+		double a2;
+
+		/** ctor. pass-through */
+		IIRBiquad() : b0(1), b1(0), b2(0), a1(0), a2(0) {;}
+
+		/** ctor */
+		IIRBiquad(const double b0, const double b1, const double b2, const double a1, const double a2) :
+			b0(b0), b1(b1), b2(b2), a1(a1), a2(a2) {;}
+
+		/** get the complex response at the normalized frequency w (radians per sample, [0:pi]) */
+		std::complex<double> getResponse(const double w) const {
+			const std::complex<double> z1 = std::polar(1.0, -w);
+			const std::complex<double> z2 = z1 * z1;
+			return (b0 + b1*z1 + b2*z2) / (1.0 + a1*z1 + a2*z2);
+		}
+
+		/** scale the numerator (the section's gain) */
+		void scale(const double f) {
+			b0 *= f;
+			b1 *= f;
+			b2 *= f;
+		}
+
+	};
+
+}
+
+#endif // K_MATH_DSP_FILTER_IIRBIQUAD_H
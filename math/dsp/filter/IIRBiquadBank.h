@@ -0,0 +1,232 @@
+#ifndef K_MATH_DSP_FILTER_IIRBIQUADBANK_H
+#define K_MATH_DSP_FILTER_IIRBIQUADBANK_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "IIRBiquad.h"
+#include "../../../Assertions.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace K {
+
+	/**
+	 * @brief cascade of second-order sections for several channels at once.
+	 *
+	 * every channel runs through the same number of sections, but each
+	 * channel may use its own coefficients. channels are processed in groups
+	 * of 4, one SSE lane per channel, so a group costs the same as a single
+	 * scalar channel. coefficients and states are stored lane-wise:
+	 * [section][group][lane].
+	 *
+	 * samples are either interleaved (frame by frame) or planar (one pointer per channel).
+	 * denormals are prevented by adding a tiny constant to the input and by
+	 * flushing the states after each block.
+	 */
+	class IIRBiquadBank {
+
+	private:
+
+		/** channels per group (SIMD width) */
+		static const int W = 4;
+
+		/** coefficients and states for W channels of one section */
+		struct Lanes {
+			float b0[W], b1[W], b2[W], a1[W], a2[W];
+			float z1[W], z2[W];
+		};
+
+		/** the number of channels */
+		int channels;
+
+		/** the number of channel groups */
+		int groups;
+
+		/** the number of sections per channel */
+		int numSections;
+
+		/** all sections: [section * groups + group] */
+		std::vector<Lanes> lanes;
+
+	public:
+
+		/** ctor for the given number of channels, each using the given sections */
+		IIRBiquadBank(const int channels, const std::vector<IIRBiquad>& sos) :
+			channels(channels), groups((channels + W - 1) / W), numSections((int) sos.size()) {
+
+			_assertTrue(channels > 0, "number of channels must be > 0");
+			lanes.resize(numSections * groups);
+			for (int c = 0; c < channels; ++c) {setSections(c, sos);}
+			for (int i = groups * W - 1; i >= channels; --i) {setSections(i, sos);}		// unused lanes
+			reset();
+
+		}
+
+		/** use different sections for one channel. must have the same number of sections */
+		void setSections(const int channel, const std::vector<IIRBiquad>& sos) {
+			_assertEqual((int) sos.size(), numSections, "number of sections must not change");
+			const int g = channel / W;
+			const int l = channel % W;
+			for (int s = 0; s < numSections; ++s) {
+				Lanes& ln = lanes[s * groups + g];
+				ln.b0[l] = (float) sos[s].b0;
+				ln.b1[l] = (float) sos[s].b1;
+				ln.b2[l] = (float) sos[s].b2;
+				ln.a1[l] = (float) sos[s].a1;
+				ln.a2[l] = (float) sos[s].a2;
+			}
+		}
+
+		/** clear all states */
+		void reset() {
+			for (Lanes& ln : lanes) {
+				std::fill(ln.z1, ln.z1 + W, 0.0f);
+				std::fill(ln.z2, ln.z2 + W, 0.0f);
+			}
+		}
+
+		/** get the number of channels */
+		int getNumChannels() const {return channels;}
+
+		/**
+		 * @brief filter "frames" interleaved frames: in[frame * channels + channel].
+		 * in and out may be the same buffer.
+		 */
+		void processInterleaved(const float* in, float* out, const int frames) {
+			forEachGroupPair([&] (const int c, const int f) {return in[f * channels + c];},
+							 [&] (const int c, const int f, const float v) {out[f * channels + c] = v;}, frames);
+		}
+
+		/**
+		 * @brief filter "frames" samples for each channel: in[channel][frame].
+		 * in and out may be the same buffers.
+		 */
+		void processPlanar(const float* const* in, float* const* out, const int frames) {
+			forEachGroupPair([&] (const int c, const int f) {return in[c][f];},
+							 [&] (const int c, const int f, const float v) {out[c][f] = v;}, frames);
+		}
+
+	private:
+
+		/** tiny offset added to the input of the first section */
+		static inline float getAntiDenormal() {return 1e-20f;}
+
+		/**
+		 * process the groups two at a time. the two groups are independent
+		 * and interleaving them hides the latency of each section's recursion.
+		 */
+		template <typename Load, typename Store> void forEachGroupPair(Load load, Store store, const int frames) {
+			int g = 0;
+			for (; g + 2 <= groups; g += 2) {processGroups<2>(g, frames, load, store);}
+			for (; g < groups; ++g) {processGroups<1>(g, frames, load, store);}
+		}
+
+		/**
+		 * run all sections for G groups of channels starting at g0.
+		 * the frames are processed in chunks: gather the lanes per frame,
+		 * run the chunk through all sections, scatter the result.
+		 */
+		template <int G, typename Load, typename Store> void processGroups(const int g0, const int frames, Load load, Store store) {
+
+			const int CHUNK = 64;
+			const int LW = G * W;
+			alignas(16) float buf[CHUNK * LW];
+
+			const int c0 = g0 * W;
+			const int cnt = std::min(LW, channels - c0);
+
+			for (int f0 = 0; f0 < frames; f0 += CHUNK) {
+
+				const int n = std::min(CHUNK, frames - f0);
+				std::fill(buf, buf + CHUNK * LW, getAntiDenormal());
+				for (int f = 0; f < n; ++f) {
+					for (int l = 0; l < cnt; ++l) {buf[f * LW + l] += load(c0 + l, f0 + f);}
+				}
+
+				for (int s = 0; s < numSections; ++s) {
+					runSection<G>(&lanes[s * groups + g0], buf, n);
+				}
+
+				for (int f = 0; f < n; ++f) {
+					for (int l = 0; l < cnt; ++l) {store(c0 + l, f0 + f, buf[f * LW + l]);}
+				}
+
+			}
+
+			// flush states close to denormal
+			for (int s = 0; s < numSections; ++s) {
+				for (int gi = 0; gi < G; ++gi) {
+					Lanes& ln = lanes[s * groups + g0 + gi];
+					for (int l = 0; l < W; ++l) {
+						if (std::abs(ln.z1[l]) < 1e-25f) {ln.z1[l] = 0;}
+						if (std::abs(ln.z2[l]) < 1e-25f) {ln.z2[l] = 0;}
+					}
+				}
+			}
+
+		}
+
+		/** run one section for G consecutive groups inplace over n frames of buf (G*W lanes per frame) */
+		template <int G> static inline void runSection(Lanes* ln, float* buf, const int n) {
+
+#if defined(__SSE2__)
+
+			__m128 b0[G], b1[G], b2[G], a1[G], a2[G], z1[G], z2[G];
+			for (int g = 0; g < G; ++g) {
+				b0[g] = _mm_loadu_ps(ln[g].b0);
+				b1[g] = _mm_loadu_ps(ln[g].b1);
+				b2[g] = _mm_loadu_ps(ln[g].b2);
+				a1[g] = _mm_loadu_ps(ln[g].a1);
+				a2[g] = _mm_loadu_ps(ln[g].a2);
+				z1[g] = _mm_loadu_ps(ln[g].z1);
+				z2[g] = _mm_loadu_ps(ln[g].z2);
+			}
+
+			for (int f = 0; f < n; ++f) {
+				for (int g = 0; g < G; ++g) {
+					float* ptr = buf + (f * G + g) * W;
+					const __m128 x = _mm_load_ps(ptr);
+					const __m128 y = _mm_add_ps(_mm_mul_ps(b0[g], x), z1[g]);
+					z1[g] = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1[g], x), _mm_mul_ps(a1[g], y)), z2[g]);
+					z2[g] = _mm_sub_ps(_mm_mul_ps(b2[g], x), _mm_mul_ps(a2[g], y));
+					_mm_store_ps(ptr, y);
+				}
+			}
+
+			for (int g = 0; g < G; ++g) {
+				_mm_storeu_ps(ln[g].z1, z1[g]);
+				_mm_storeu_ps(ln[g].z2, z2[g]);
+			}
+
+#else
+
+			for (int g = 0; g < G; ++g) {
+				for (int l = 0; l < W; ++l) {
+					float z1 = ln[g].z1[l];
+					float z2 = ln[g].z2[l];
+					for (int f = 0; f < n; ++f) {
+						float& v = buf[(f * G + g) * W + l];
+						const float x = v;
+						const float y = ln[g].b0[l] * x + z1;
+						z1 = ln[g].b1[l] * x - ln[g].a1[l] * y + z2;
+						z2 = ln[g].b2[l] * x - ln[g].a2[l] * y;
+						v = y;
+					}
+					ln[g].z1[l] = z1;
+					ln[g].z2[l] = z2;
+				}
+			}
+
+#endif
+
+		}
+
+	};
+
+}
+
+#endif // K_MATH_DSP_FILTER_IIRBIQUADBANK_H
@@ -0,0 +1,126 @@
+#ifndef K_MATH_DSP_FILTER_IIRBIQUADCASCADE_H
+#define K_MATH_DSP_FILTER_IIRBIQUADCASCADE_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "IIRBiquad.h"
+
+namespace K {
+
+	/**
+	 * @brief single-channel cascade of second-order sections
+	 * using the transposed direct form II.
+	 *
+	 * processes single samples or whole blocks. to prevent denormals when the
+	 * input decays to silence, a tiny constant (far below the audible /
+	 * measurable range) is added to the input and the states are flushed
+	 * (after each sample or block).
+	 */
+	template <typename type> class IIRBiquadCascade {
+
+	private:
+
+		/** coefficients and states of one section */
+		struct Section {
+			type b0, b1, b2, a1, a2;
+			type z1, z2;
+		};
+
+		/** all sections */
+		std::vector<Section> sections;
+
+	public:
+
+		/** ctor. empty (pass-through) cascade */
+		IIRBiquadCascade() {;}
+
+		/** ctor with the given sections */
+		IIRBiquadCascade(const std::vector<IIRBiquad>& sos) {
+			setSections(sos);
+		}
+
+		/** set the sections to use. resets the state */
+		void setSections(const std::vector<IIRBiquad>& sos) {
+			sections.resize(sos.size());
+			for (size_t i = 0; i < sos.size(); ++i) {
+				Section& s = sections[i];
+				s.b0 = (type) sos[i].b0;
+				s.b1 = (type) sos[i].b1;
+				s.b2 = (type) sos[i].b2;
+				s.a1 = (type) sos[i].a1;
+				s.a2 = (type) sos[i].a2;
+			}
+			reset();
+		}
+
+		/** get the number of sections */
+		size_t getNumSections() const {return sections.size();}
+
+		/** clear the filter's state */
+		void reset() {
+			for (Section& s : sections) {s.z1 = 0; s.z2 = 0;}
+		}
+
+		/** filter one sample. uses the same anti-denormal measures as process() */
+		type filter(const type in) {
+			if (sections.empty()) {return in;}
+			type x = in + getAntiDenormal();
+			for (Section& s : sections) {
+				x = run(s, x);
+				s.z1 = flush(s.z1);
+				s.z2 = flush(s.z2);
+			}
+			return x;
+		}
+
+		/** filter len samples from "in" into "out". in and out may be the same buffer */
+		void process(const type* in, type* out, const unsigned int len) {
+
+			if (sections.empty()) {
+				if (in != out) {std::copy(in, in + len, out);}
+				return;
+			}
+
+			// section by section, keeping the state within registers
+			const type* src = in;
+			for (Section& s : sections) {
+				const Section c = s;
+				type z1 = s.z1;
+				type z2 = s.z2;
+				const type dc = (&s == &sections[0]) ? (getAntiDenormal()) : ((type) 0);
+				for (unsigned int i = 0; i < len; ++i) {
+					const type x = src[i] + dc;
+					const type y = c.b0 * x + z1;
+					z1 = c.b1 * x - c.a1 * y + z2;
+					z2 = c.b2 * x - c.a2 * y;
+					out[i] = y;
+				}
+				s.z1 = flush(z1);
+				s.z2 = flush(z2);
+				src = out;
+			}
+
+		}
+
+	private:
+
+		static inline type run(Section& s, const type x) {
+			const type y = s.b0 * x + s.z1;
+			s.z1 = s.b1 * x - s.a1 * y + s.z2;
+			s.z2 = s.b2 * x - s.a2 * y;
+			return y;
+		}
+
+		/** tiny offset added to the input of the first section */
+		static inline type getAntiDenormal() {return (type) 1e-20;}
+
+		/** flush states that are close to denormal */
+		static inline type flush(const type v) {return (std::abs(v) < (type) 1e-25) ? ((type) 0) : (v);}
+
+	};
+
+}
+
+#endif // K_MATH_DSP_FILTER_IIRBIQUADCASCADE_H
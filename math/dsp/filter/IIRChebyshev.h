@@ -1,9 +1,33 @@
 #ifndef K_MATH_DSP_CHEBYSHEV_H
 #define K_MATH_DSP_CHEBYSHEV_H
 
+#include "IIRBiquadCascade.h"
+#include "IIRDesign.h"
+
 namespace K {
 
-	class IIRChebyshev {
+	/**
+	 * @brief Chebyshev (type I) low-/high-pass filter of arbitrary order,
+	 * running as a cascade of second-order sections.
+	 */
+	template <typename type> class IIRChebyshev : public IIRBiquadCascade<type> {
+
+	public:
+
+		/** ctor. "disabled" filter */
+		IIRChebyshev() {
+			;
+		}
+
+		/** configure as low-pass with the given order and passband ripple (dB), depending on the sample-rate */
+		void setLowPass(const int order, const double rippleDB, const double freq, const double sampleRate) {
+			this->setSections(IIRDesign::chebyshev1LowPass(order, rippleDB, freq, sampleRate));
+		}
+
+		/** configure as high-pass with the given order and passband ripple (dB), depending on the sample-rate */
+		void setHighPass(const int order, const double rippleDB, const double freq, const double sampleRate) {
+			this->setSections(IIRDesign::chebyshev1HighPass(order, rippleDB, freq, sampleRate));
+		}
 
 	};
 
@@ -0,0 +1,238 @@
+#ifndef K_MATH_DSP_FILTER_IIRDESIGN_H
+#define K_MATH_DSP_FILTER_IIRDESIGN_H
+
+#include <vector>
+#include <complex>
+#include <cmath>
+
+#include "IIRBiquad.h"
+#include "../../../Assertions.h"
+
+namespace K {
+
+	/**
+	 * @brief design IIR filters as cascades of second-order sections.
+	 *
+	 * Butterworth and Chebyshev filters are designed as analog low-pass
+	 * prototypes, transformed to low- or high-pass and mapped to the
+	 * z-plane using the (pre-warped) bilinear transform. conjugate
+	 * pole/zero pairs are combined into one biquad each, odd orders
+	 * add one first-order section.
+	 *
+	 * the overall gain is applied to the first section, normalized to 1
+	 * within the passband (Chebyshev I: maximum of the ripple).
+	 */
+	class IIRDesign {
+
+	private:
+
+		typedef std::complex<double> Cplx;
+
+		/** analog prototype: poles and zeros with positive imaginary part (+ real ones), normalized cutoff 1 rad/s */
+		struct Prototype {
+			std::vector<Cplx> poles;
+			std::vector<Cplx> zeros;
+		};
+
+	public:
+
+		/** Butterworth low-pass of the given order */
+		static std::vector<IIRBiquad> butterworthLowPass(const int order, const double freq, const double sampleRate) {
+			return transform(getButterworth(order), freq, sampleRate, false, 1.0);
+		}
+
+		/** Butterworth high-pass of the given order */
+		static std::vector<IIRBiquad> butterworthHighPass(const int order, const double freq, const double sampleRate) {
+			return transform(getButterworth(order), freq, sampleRate, true, 1.0);
+		}
+
+		/** Chebyshev type I low-pass with the given passband ripple (in dB). freq is the passband edge */
+		static std::vector<IIRBiquad> chebyshev1LowPass(const int order, const double rippleDB, const double freq, const double sampleRate) {
+			return transform(getChebyshev1(order, rippleDB), freq, sampleRate, false, getChebyshev1Gain(order, rippleDB));
+		}
+
+		/** Chebyshev type I high-pass with the given passband ripple (in dB). freq is the passband edge */
+		static std::vector<IIRBiquad> chebyshev1HighPass(const int order, const double rippleDB, const double freq, const double sampleRate) {
+			return transform(getChebyshev1(order, rippleDB), freq, sampleRate, true, getChebyshev1Gain(order, rippleDB));
+		}
+
+		/** Chebyshev type II low-pass with the given stopband attenuation (in dB). freq is the stopband edge */
+		static std::vector<IIRBiquad> chebyshev2LowPass(const int order, const double attenuationDB, const double freq, const double sampleRate) {
+			return transform(getChebyshev2(order, attenuationDB), freq, sampleRate, false, 1.0);
+		}
+
+		/** Chebyshev type II high-pass with the given stopband attenuation (in dB). freq is the stopband edge */
+		static std::vector<IIRBiquad> chebyshev2HighPass(const int order, const double attenuationDB, const double freq, const double sampleRate) {
+			return transform(getChebyshev2(order, attenuationDB), freq, sampleRate, true, 1.0);
+		}
+
+		/** low-shelf (RBJ cookbook) boosting/cutting everything below freq by gainDB */
+		static IIRBiquad lowShelf(const double freq, const double sampleRate, const double gainDB, const double q = M_SQRT1_2) {
+			const double A = std::pow(10.0, gainDB / 40.0);
+			const double w = 2.0 * M_PI * freq / sampleRate;
+			const double cw = std::cos(w);
+			const double alpha = std::sin(w) / (2.0 * q);
+			const double sa = 2.0 * std::sqrt(A) * alpha;
+			const double a0 =       (A+1) + (A-1)*cw + sa;
+			return IIRBiquad(
+				(    A*((A+1) - (A-1)*cw + sa)) / a0,
+				(2.0*A*((A-1) - (A+1)*cw     )) / a0,
+				(    A*((A+1) - (A-1)*cw - sa)) / a0,
+				(  -2.0*((A-1) + (A+1)*cw    )) / a0,
+				(       (A+1) + (A-1)*cw - sa ) / a0
+			);
+		}
+
+		/** high-shelf (RBJ cookbook) boosting/cutting everything above freq by gainDB */
+		static IIRBiquad highShelf(const double freq, const double sampleRate, const double gainDB, const double q = M_SQRT1_2) {
+			const double A = std::pow(10.0, gainDB / 40.0);
+			const double w = 2.0 * M_PI * freq / sampleRate;
+			const double cw = std::cos(w);
+			const double alpha = std::sin(w) / (2.0 * q);
+			const double sa = 2.0 * std::sqrt(A) * alpha;
+			const double a0 =        (A+1) - (A-1)*cw + sa;
+			return IIRBiquad(
+				(     A*((A+1) + (A-1)*cw + sa)) / a0,
+				(-2.0*A*((A-1) + (A+1)*cw     )) / a0,
+				(     A*((A+1) + (A-1)*cw - sa)) / a0,
+				(    2.0*((A-1) - (A+1)*cw    )) / a0,
+				(        (A+1) - (A-1)*cw - sa ) / a0
+			);
+		}
+
+		/** peaking EQ (RBJ cookbook) at freq with the given gain and quality */
+		static IIRBiquad peak(const double freq, const double sampleRate, const double gainDB, const double q) {
+			const double A = std::pow(10.0, gainDB / 40.0);
+			const double w = 2.0 * M_PI * freq / sampleRate;
+			const double alpha = std::sin(w) / (2.0 * q);
+			const double a0 = 1 + alpha / A;
+			return IIRBiquad(
+				(1 + alpha*A) / a0,
+				(-2.0 * std::cos(w)) / a0,
+				(1 - alpha*A) / a0,
+				(-2.0 * std::cos(w)) / a0,
+				(1 - alpha/A) / a0
+			);
+		}
+
+		/** get the magnitude of the cascade's response at the given frequency */
+		static double getMagnitude(const std::vector<IIRBiquad>& sos, const double freq, const double sampleRate) {
+			const double w = 2.0 * M_PI * freq / sampleRate;
+			Cplx h(1, 0);
+			for (const IIRBiquad& bq : sos) {h *= bq.getResponse(w);}
+			return std::abs(h);
+		}
+
+	private:
+
+		static Prototype getButterworth(const int order) {
+			_assertTrue(order > 0, "order must be > 0");
+			Prototype p;
+			for (int k = 0; k < order/2; ++k) {
+				const double theta = M_PI * (2.0*k + 1.0) / (2.0 * order);
+				p.poles.push_back(Cplx(-std::sin(theta), std::cos(theta)));
+			}
+			if (order % 2) {p.poles.push_back(Cplx(-1, 0));}
+			return p;
+		}
+
+		static Prototype getChebyshev1(const int order, const double rippleDB) {
+			_assertTrue(order > 0, "order must be > 0");
+			_assertTrue(rippleDB > 0, "ripple must be > 0 dB");
+			const double eps = std::sqrt(std::pow(10.0, rippleDB / 10.0) - 1.0);
+			const double mu = std::asinh(1.0 / eps) / order;
+			Prototype p;
+			for (int k = 0; k < order/2; ++k) {
+				const double theta = M_PI * (2.0*k + 1.0) / (2.0 * order);
+				p.poles.push_back(Cplx(-std::sinh(mu) * std::sin(theta), std::cosh(mu) * std::cos(theta)));
+			}
+			if (order % 2) {p.poles.push_back(Cplx(-std::sinh(mu), 0));}
+			return p;
+		}
+
+		/** even orders start at the lower end of the passband ripple */
+		static double getChebyshev1Gain(const int order, const double rippleDB) {
+			return (order % 2) ? (1.0) : (std::pow(10.0, -rippleDB / 20.0));
+		}
+
+		static Prototype getChebyshev2(const int order, const double attenuationDB) {
+			_assertTrue(order > 0, "order must be > 0");
+			_assertTrue(attenuationDB > 0, "attenuation must be > 0 dB");
+			const double eps = 1.0 / std::sqrt(std::pow(10.0, attenuationDB / 10.0) - 1.0);
+			const double mu = std::asinh(1.0 / eps) / order;
+			Prototype p;
+			for (int k = 0; k < order/2; ++k) {
+				const double theta = M_PI * (2.0*k + 1.0) / (2.0 * order);
+				const Cplx pole(-std::sinh(mu) * std::sin(theta), std::cosh(mu) * std::cos(theta));
+				p.poles.push_back(1.0 / pole);
+				p.zeros.push_back(Cplx(0, 1.0 / std::cos(theta)));
+			}
+			if (order % 2) {p.poles.push_back(Cplx(-1.0 / std::sinh(mu), 0));}
+			return p;
+		}
+
+		/** bilinear transform of s into the z-plane */
+		static Cplx bilinear(const Cplx s, const double fs2) {
+			return (fs2 + s) / (fs2 - s);
+		}
+
+		/**
+		 * transform the normalized prototype to the requested cutoff (and to high-pass),
+		 * map it into the z-plane and normalize the passband gain.
+		 */
+		static std::vector<IIRBiquad> transform(const Prototype& p, const double freq, const double sampleRate, const bool highPass, const double gain) {
+
+			_assertTrue(freq > 0 && freq < sampleRate / 2, "frequency must be within ]0:sampleRate/2[");
+
+			// pre-warped analog cutoff
+			const double fs2 = 2.0 * sampleRate;
+			const double wc = fs2 * std::tan(M_PI * freq / sampleRate);
+
+			// zeros at infinity map to z = -1 (low-pass) or z = +1 (high-pass, zeros at s = 0)
+			const double infZero = (highPass) ? (1.0) : (-1.0);
+
+			std::vector<IIRBiquad> sos;
+			size_t zi = 0;
+			for (const Cplx& pole : p.poles) {
+
+				const Cplx sp = (highPass) ? (wc / pole) : (pole * wc);
+				const Cplx zp = bilinear(sp, fs2);
+
+				if (pole.imag() == 0) {
+
+					// first-order section
+					sos.push_back(IIRBiquad(1.0, -infZero, 0.0, -zp.real(), 0.0));
+
+				} else {
+
+					// second-order section: conjugate pole pair + conjugate zero pair (or two "infinite" zeros)
+					double b1 = -2.0 * infZero;
+					double b2 = 1.0;
+					if (zi < p.zeros.size()) {
+						const Cplx z = p.zeros[zi++];
+						const Cplx sz = (highPass) ? (wc / z) : (z * wc);
+						const Cplx zz = bilinear(sz, fs2);
+						b1 = -2.0 * zz.real();
+						b2 = std::norm(zz);
+					}
+					sos.push_back(IIRBiquad(1.0, b1, b2, -2.0 * zp.real(), std::norm(zp)));
+
+				}
+
+			}
+
+			// normalize the gain at DC (low-pass) or nyquist (high-pass)
+			const double w = (highPass) ? (M_PI) : (0.0);
+			Cplx h(1, 0);
+			for (const IIRBiquad& bq : sos) {h *= bq.getResponse(w);}
+			sos[0].scale(gain / std::abs(h));
+
+			return sos;
+
+		}
+
+	};
+
+}
+
+#endif // K_MATH_DSP_FILTER_IIRDESIGN_H
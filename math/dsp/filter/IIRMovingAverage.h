@@ -1,14 +1,132 @@
 #ifndef K_MATH_DSP_IIRMOVINGAVERAGE_H
 #define K_MATH_DSP_IIRMOVINGAVERAGE_H
 
+#include <cstdint>
+#include <algorithm>
+
+#include "../../../Assertions.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 namespace K {
 
+	/**
+	 * @brief running-sum kernels for IIRMovingAverage.
+	 *
+	 * the sum is kept within a wider accumulator: exact for integers
+	 * (int16_t -> int32_t, int32_t -> int64_t) and double for float, to
+	 * prevent the running sum from drifting.
+	 * run() updates the sum by in[i] - old[i] for each of the n samples
+	 * and writes sum / size to out[i].
+	 */
+	template <typename type> struct IIRMovingAverageKernel {
+		typedef type Acc;
+		template <int size> static inline void run(const type* in, const type* old, type* out, const unsigned int n, Acc& sum) {
+			for (unsigned int i = 0; i < n; ++i) {
+				sum += in[i] - old[i];
+				out[i] = sum / size;
+			}
+		}
+	};
+
+	template <> struct IIRMovingAverageKernel<float> {
+		typedef double Acc;
+		template <int size> static inline void run(const float* in, const float* old, float* out, const unsigned int n, Acc& sum) {
+			unsigned int i = 0;
+#if defined(__SSE2__)
+			// 2 lanes per step: differences, prefix sum within the lanes, add the carry
+			const __m128d scale = _mm_set1_pd(1.0 / size);
+			__m128d carry = _mm_set1_pd(sum);
+			for (; i + 2 <= n; i += 2) {
+				const __m128d x = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*) (in + i))));
+				const __m128d o = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*) (old + i))));
+				__m128d d = _mm_sub_pd(x, o);
+				d = _mm_add_pd(d, _mm_castsi128_pd(_mm_slli_si128(_mm_castpd_si128(d), 8)));
+				const __m128d s = _mm_add_pd(d, carry);
+				_mm_storel_epi64((__m128i*) (out + i), _mm_castps_si128(_mm_cvtpd_ps(_mm_mul_pd(s, scale))));
+				carry = _mm_unpackhi_pd(s, s);
+			}
+			sum = _mm_cvtsd_f64(carry);
+#endif
+			for (; i < n; ++i) {
+				sum += (double) in[i] - (double) old[i];
+				out[i] = (float) (sum / size);
+			}
+		}
+	};
+
+	template <> struct IIRMovingAverageKernel<int16_t> {
+		typedef int32_t Acc;
+		template <int size> static inline void run(const int16_t* in, const int16_t* old, int16_t* out, const unsigned int n, Acc& sum) {
+			static_assert(size <= 65536, "int16_t moving average is limited to 65536 samples");
+			unsigned int i = 0;
+#if defined(__SSE2__)
+			// 4 lanes per step: differences, prefix sum within the lanes, add the carry
+			alignas(16) int32_t tmp[4];
+			__m128i carry = _mm_set1_epi32(sum);
+			for (; i + 4 <= n; i += 4) {
+				const __m128i x = _mm_srai_epi32(_mm_unpacklo_epi16(_mm_setzero_si128(), _mm_loadl_epi64((const __m128i*) (in + i))), 16);
+				const __m128i o = _mm_srai_epi32(_mm_unpacklo_epi16(_mm_setzero_si128(), _mm_loadl_epi64((const __m128i*) (old + i))), 16);
+				__m128i d = _mm_sub_epi32(x, o);
+				d = _mm_add_epi32(d, _mm_slli_si128(d, 4));
+				d = _mm_add_epi32(d, _mm_slli_si128(d, 8));
+				const __m128i s = _mm_add_epi32(d, carry);
+				_mm_store_si128((__m128i*) tmp, s);
+				for (int j = 0; j < 4; ++j) {out[i + j] = (int16_t) (tmp[j] / size);}
+				carry = _mm_shuffle_epi32(s, _MM_SHUFFLE(3,3,3,3));
+			}
+			sum = _mm_cvtsi128_si32(carry);
+#endif
+			for (; i < n; ++i) {
+				sum += in[i] - old[i];
+				out[i] = (int16_t) (sum / size);
+			}
+		}
+	};
+
+	template <> struct IIRMovingAverageKernel<int32_t> {
+		typedef int64_t Acc;
+		template <int size> static inline void run(const int32_t* in, const int32_t* old, int32_t* out, const unsigned int n, Acc& sum) {
+			unsigned int i = 0;
+#if defined(__SSE2__)
+			// 2 lanes (64 bit) per step: sign-extend, differences, prefix sum, add the carry
+			alignas(16) int64_t tmp[2];
+			__m128i carry = _mm_set1_epi64x(sum);
+			for (; i + 2 <= n; i += 2) {
+				const __m128i x32 = _mm_loadl_epi64((const __m128i*) (in + i));
+				const __m128i o32 = _mm_loadl_epi64((const __m128i*) (old + i));
+				const __m128i x = _mm_unpacklo_epi32(x32, _mm_srai_epi32(x32, 31));
+				const __m128i o = _mm_unpacklo_epi32(o32, _mm_srai_epi32(o32, 31));
+				__m128i d = _mm_sub_epi64(x, o);
+				d = _mm_add_epi64(d, _mm_slli_si128(d, 8));
+				const __m128i s = _mm_add_epi64(d, carry);
+				_mm_store_si128((__m128i*) tmp, s);
+				out[i + 0] = (int32_t) (tmp[0] / size);
+				out[i + 1] = (int32_t) (tmp[1] / size);
+				carry = _mm_unpackhi_epi64(s, s);
+			}
+			_mm_store_si128((__m128i*) tmp, carry);
+			sum = tmp[0];
+#endif
+			for (; i < n; ++i) {
+				sum += (Acc) in[i] - (Acc) old[i];
+				out[i] = (int32_t) (sum / size);
+			}
+		}
+	};
+
 	/**
 	 * @brief provides an IIR-like filter using moving average
 	 * of a given size
 	 */
 	template <typename type, int size> class IIRMovingAverage {
 
+	private:
+
+		typedef typename IIRMovingAverageKernel<type>::Acc Acc;
+
 	public:
 
 		/** ctor */
@@ -19,21 +137,57 @@ namespace K {
 		/** filter the given input value */
 		type filter(type in) {
 
-			movingSum += in;
-			movingSum -= values[oldest];
+			movingSum += (Acc) in - (Acc) values[oldest];
 
 			values[oldest] = in;
 			++oldest;
 			oldest %= size;
 
-			return movingSum / size;
+			return (type) (movingSum / size);
+
+		}
+
+		/**
+		 * @brief filter n samples from "in" into "out" (same result as calling filter() n times).
+		 * uses SIMD for float, int16_t and int32_t. in and out must not be the same buffer.
+		 */
+		void process(const type* in, type* out, const unsigned int n) {
+
+			_assertTrue(in != out, "in and out must not be the same buffer");
+
+			// the oldest values come from the history (two contiguous parts), the rest from the input itself
+			const unsigned int n1 = std::min(n, (unsigned int) (size - oldest));
+			const unsigned int n2 = std::min(n, (unsigned int) size) - n1;
+			IIRMovingAverageKernel<type>::template run<size>(in, values + oldest, out, n1, movingSum);
+			IIRMovingAverageKernel<type>::template run<size>(in + n1, values, out + n1, n2, movingSum);
+			if (n > (unsigned int) size) {
+				IIRMovingAverageKernel<type>::template run<size>(in + size, in, out + size, n - size, movingSum);
+			}
+
+			// update the history
+			if (n >= (unsigned int) size) {
+				std::copy(in + n - size, in + n, values);
+				oldest = 0;
+			} else {
+				for (unsigned int i = 0; i < n; ++i) {
+					values[oldest] = in[i];
+					if (++oldest == size) {oldest = 0;}
+				}
+			}
+
+		}
 
+		/** clear the history */
+		void reset() {
+			movingSum = 0;
+			std::fill(values, values + size, (type) 0);
+			oldest = 0;
 		}
 
 	private:
 
-		/** current sum of all inserted values */
-		type movingSum;
+		/** current sum of all inserted values (wider than type for integers) */
+		Acc movingSum;
 
 		/** store old values to adjust the moving sum */
 		type values[size];
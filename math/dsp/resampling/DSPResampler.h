@@ -0,0 +1,304 @@
+#ifndef K_MATH_DSP_RESAMPLING_DSPRESAMPLER_H
+#define K_MATH_DSP_RESAMPLING_DSPRESAMPLER_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "../window/DSPWindowBlackman.h"
+#include "../../../Assertions.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace K {
+
+	/**
+	 * @brief polyphase FIR sample-rate conversion.
+	 *
+	 * rational mode (inRate/outRate reduced to M/L with L <= getMaxPhases()):
+	 * conceptually upsample by L, low-pass filter and keep every M-th sample.
+	 * the prototype filter is split into L phases of K taps each, so every
+	 * output sample costs exactly one K-tap inner product. this covers
+	 * 44.1k <-> 48k (147/160) as well as integer interpolation (1/L) and
+	 * decimation (M/1).
+	 *
+	 * arbitrary mode (any ratio): the prototype is split into a fixed number
+	 * of phases and the output is linearly interpolated between the two
+	 * phases adjacent to the exact fractional position.
+	 *
+	 * the prototype is a windowed sinc, using any window function
+	 * (e.g. DSPWindowBlackman, DSPWindowHanning). the cutoff is the lower of
+	 * both Nyquist frequencies (times the rolloff), and every phase is
+	 * normalized to unity DC gain.
+	 *
+	 * process() works on blocks without allocation, the inner products use SSE.
+	 * the output is delayed by getDelay() input samples.
+	 */
+	template <typename type> class DSPResampler {
+
+	private:
+
+		/** number of input samples per output sample: M/L */
+		unsigned int L;
+		unsigned int M;
+
+		/** arbitrary mode: input samples per output sample */
+		double step;
+
+		/** whether to use the arbitrary mode */
+		bool arbitrary;
+
+		/** number of phases (L or the fixed number for arbitrary ratios) */
+		unsigned int phases;
+
+		/** taps per phase */
+		unsigned int K;
+
+		/** coefficients: (phases+1) * K, each phase reversed for contiguous inner products */
+		std::vector<type> coeffs;
+
+		/** history (K-1 samples) followed by the current input block */
+		std::vector<type> buffer;
+
+		/** max. number of input samples per internal block */
+		unsigned int blockSize;
+
+		/** rational: current phase. both: buffer index of the newest sample for the next output */
+		unsigned int phase;
+		unsigned int pos;
+
+		/** arbitrary: fractional position of the next output, in input samples after "pos" */
+		double frac;
+
+	public:
+
+		/** max. number of phases for the rational mode. larger L use the arbitrary mode */
+		static inline unsigned int getMaxPhases() {return 1024;}
+
+		/** number of phases for the arbitrary mode */
+		static inline unsigned int getArbitraryPhases() {return 256;}
+
+		/**
+		 * ctor for rational ratios
+		 * @param inRate the input sample rate (e.g. 44100)
+		 * @param outRate the output sample rate (e.g. 48000)
+		 * @param taps the number of taps per phase (without decimation). more taps = steeper transition
+		 * @param rolloff the cutoff relative to the lower Nyquist frequency
+		 * @param window the window to apply to the sinc
+		 * @param blockSize max. number of input samples processed at once (no effect on the result)
+		 */
+		DSPResampler(const unsigned int inRate, const unsigned int outRate, const unsigned int taps = 32, const double rolloff = 0.9,
+					 DSPWindowFunc window = &DSPWindowBlackman<type, 1>::getValue, const unsigned int blockSize = 4096) : blockSize(blockSize) {
+
+			_assertTrue(inRate > 0 && outRate > 0, "sample rates must be > 0");
+			const unsigned int g = gcd(inRate, outRate);
+			L = outRate / g;
+			M = inRate / g;
+			step = (double) M / (double) L;
+			arbitrary = (L > getMaxPhases());
+			init(taps, rolloff, window);
+
+		}
+
+		/**
+		 * get a resampler for arbitrary ratios (outRate / inRate), e.g. for drifting clocks
+		 * @param ratio the output rate divided by the input rate
+		 * (see ctor for the other parameters)
+		 */
+		static DSPResampler getArbitrary(const double ratio, const unsigned int taps = 32, const double rolloff = 0.9,
+										 DSPWindowFunc window = &DSPWindowBlackman<type, 1>::getValue, const unsigned int blockSize = 4096) {
+			_assertTrue(ratio > 0, "ratio must be > 0");
+			return DSPResampler(1.0 / ratio, taps, rolloff, window, blockSize);
+		}
+
+		/** get the number of taps per phase */
+		unsigned int getTapsPerPhase() const {return K;}
+
+		/** get the number of phases */
+		unsigned int getNumPhases() const {return phases;}
+
+		/** whether the arbitrary (interpolating) mode is used */
+		bool isArbitrary() const {return arbitrary;}
+
+		/** get the delay of the output, in input samples */
+		double getDelay() const {return K / 2.0;}
+
+		/** get the max. number of output samples for the given number of input samples */
+		unsigned int getMaxOutput(const unsigned int inputs) const {
+			return (unsigned int) std::ceil((double) inputs / step) + 1;
+		}
+
+		/** clear the history */
+		void reset() {
+			std::fill(buffer.begin(), buffer.end(), (type) 0);
+			phase = 0;
+			pos = K - 1;
+			frac = 0;
+		}
+
+		/**
+		 * @brief resample len input samples.
+		 * "out" must provide getMaxOutput(len) entries.
+		 * returns the number of output samples written.
+		 */
+		unsigned int process(const type* in, const unsigned int len, type* out) {
+
+			unsigned int written = 0;
+
+			for (unsigned int i = 0; i < len; i += blockSize) {
+
+				const unsigned int cnt = std::min(blockSize, len - i);
+				std::copy(in + i, in + i + cnt, buffer.begin() + (K - 1));
+				const unsigned int end = K - 1 + cnt;
+
+				written += (arbitrary) ? (runArbitrary(end, out + written)) : (runRational(end, out + written));
+
+				// keep the last K-1 samples as history for the next block
+				std::copy(buffer.begin() + cnt, buffer.begin() + end, buffer.begin());
+
+			}
+
+			return written;
+
+		}
+
+	private:
+
+		/** ctor for the arbitrary mode */
+		DSPResampler(const double step, const unsigned int taps, const double rolloff, DSPWindowFunc window, const unsigned int blockSize) :
+			L(0), M(0), step(step), arbitrary(true), blockSize(blockSize) {
+			init(taps, rolloff, window);
+		}
+
+		static unsigned int gcd(unsigned int a, unsigned int b) {
+			while (b) {const unsigned int t = a % b; a = b; b = t;}
+			return a;
+		}
+
+		/** build the polyphase prototype */
+		void init(const unsigned int taps, const double rolloff, DSPWindowFunc window) {
+
+			_assertTrue(taps >= 2, "at least 2 taps per phase");
+
+			// the filter gets narrower when decimating: more taps to keep the transition band
+			const double ratio = 1.0 / step;
+			K = (unsigned int) std::ceil(taps / std::min(1.0, ratio));
+			phases = (arbitrary) ? (getArbitraryPhases()) : (L);
+
+			// windowed sinc on the fine grid of phases*K samples, centered at phases*K/2
+			const unsigned int n = phases * K;
+			const double fc = 0.5 * rolloff * std::min(1.0, ratio) / phases;
+			std::vector<double> h(n + 1);
+			for (unsigned int i = 0; i <= n; ++i) {
+				const double t = (double) i - n / 2.0;
+				const double x = 2.0 * M_PI * fc * t;
+				const double sinc = (t == 0) ? (1.0) : (std::sin(x) / x);
+				h[i] = sinc * window(i, n);
+			}
+
+			// split into phases (one extra phase for the interpolation), reverse and normalize
+			coeffs.resize((phases + 1) * K);
+			for (unsigned int p = 0; p <= phases; ++p) {
+				double sum = 0;
+				for (unsigned int k = 0; k < K; ++k) {
+					const unsigned int idx = p + k * phases;
+					sum += (idx <= n) ? (h[idx]) : (0.0);
+				}
+				for (unsigned int k = 0; k < K; ++k) {
+					const unsigned int idx = p + k * phases;
+					coeffs[p * K + (K - 1 - k)] = (type) (((idx <= n) ? (h[idx]) : (0.0)) / sum);
+				}
+			}
+
+			buffer.resize(K - 1 + blockSize);
+			reset();
+
+		}
+
+		/** rational mode: produce all outputs whose newest input sample is within the buffer */
+		unsigned int runRational(const unsigned int end, type* out) {
+			unsigned int cnt = 0;
+			while (pos < end) {
+				out[cnt++] = dot(&coeffs[phase * K], &buffer[pos + 1 - K], K);
+				phase += M;
+				pos += phase / L;
+				phase %= L;
+			}
+			pos -= (end - (K - 1));
+			return cnt;
+		}
+
+		/** arbitrary mode: interpolate between the two phases adjacent to the fractional position */
+		unsigned int runArbitrary(const unsigned int end, type* out) {
+			unsigned int cnt = 0;
+			while (pos < end) {
+				const double fp = frac * phases;
+				const unsigned int p = (unsigned int) fp;
+				const type a = (type) (fp - p);
+				const type* src = &buffer[pos + 1 - K];
+				const type y0 = dot(&coeffs[p * K], src, K);
+				const type y1 = dot(&coeffs[(p+1) * K], src, K);
+				out[cnt++] = y0 + (y1 - y0) * a;
+				// integer and fractional part are kept apart: independent of the block boundaries
+				frac += step;
+				const double whole = std::floor(frac);
+				pos += (unsigned int) whole;
+				frac -= whole;
+			}
+			pos -= (end - (K - 1));
+			return cnt;
+		}
+
+		/** inner product of n values */
+		static inline type dot(const type* a, const type* b, const unsigned int n) {
+			type sum = 0;
+			for (unsigned int i = 0; i < n; ++i) {sum += a[i] * b[i];}
+			return sum;
+		}
+
+	};
+
+#if defined(__SSE2__)
+
+	/** SSE inner product for float, using 2 independent accumulators */
+	template <> inline float DSPResampler<float>::dot(const float* a, const float* b, const unsigned int n) {
+		__m128 s0 = _mm_setzero_ps();
+		__m128 s1 = _mm_setzero_ps();
+		unsigned int i = 0;
+		for (; i + 8 <= n; i += 8) {
+			s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+			s1 = _mm_add_ps(s1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+		}
+		for (; i + 4 <= n; i += 4) {
+			s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+		}
+		s0 = _mm_add_ps(s0, s1);
+		s0 = _mm_add_ps(s0, _mm_movehl_ps(s0, s0));
+		s0 = _mm_add_ss(s0, _mm_shuffle_ps(s0, s0, 1));
+		float sum = _mm_cvtss_f32(s0);
+		for (; i < n; ++i) {sum += a[i] * b[i];}
+		return sum;
+	}
+
+	/** SSE2 inner product for double */
+	template <> inline double DSPResampler<double>::dot(const double* a, const double* b, const unsigned int n) {
+		__m128d s0 = _mm_setzero_pd();
+		__m128d s1 = _mm_setzero_pd();
+		unsigned int i = 0;
+		for (; i + 4 <= n; i += 4) {
+			s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+			s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+		}
+		s0 = _mm_add_pd(s0, s1);
+		double sum = _mm_cvtsd_f64(_mm_add_sd(s0, _mm_unpackhi_pd(s0, s0)));
+		for (; i < n; ++i) {sum += a[i] * b[i];}
+		return sum;
+	}
+
+#endif
+
+}
+
+#endif // K_MATH_DSP_RESAMPLING_DSPRESAMPLER_H
@@ -1,8 +1,14 @@
 #ifndef K_MATH_DSP_WINDOW_H_
 #define K_MATH_DSP_WINDOW_H_
 
+#include "DSPWindowKernel.h"
+#include "../../../Assertions.h"
+
 namespace K {
 
+	/** function providing the value at index i for a window of length len (e.g. DSPWindowHanning<T,n>::getValue) */
+	typedef double (*DSPWindowFunc)(const unsigned int i, const unsigned int len);
+
 	/**
 	 * the base class for all DSP windowing functions
 	 */
@@ -10,14 +16,37 @@ namespace K {
 
 	public:
 
-		/** apply the window to the given data array */
+		/** apply the window to the given data array. fixed-point results are truncated */
 		virtual void apply(type* data) = 0;
 
+		/**
+		 * @brief apply the first n window values to "in" and write the result to "out".
+		 * uses SIMD for float and fixed-point (int16_t, int32_t, Q15 window) samples.
+		 * unlike apply(), fixed-point results are rounded.
+		 * in and out may be the same buffer.
+		 */
+		void process(const type* in, type* out, const unsigned int n = size) const {
+			_assertTrue(n <= (unsigned int) size, "n exceeds the window's size");
+			DSPWindowKernel::apply(window, windowQ15, in, out, n);
+		}
+
 	protected:
 
+		/** precompute the window function (float and Q15) using the given function */
+		void init(DSPWindowFunc func) {
+			for (unsigned int i = 0; i < (unsigned int) size; ++i) {
+				const double v = func(i, size);
+				window[i] = (float) v;
+				windowQ15[i] = DSPWindowKernel::toQ15(v);
+			}
+		}
+
 		/** subclasses precompute the window function here once */
 		float window[size];
 
+		/** the same window in Q15 for fixed-point samples */
+		int16_t windowQ15[size];
+
 	};
 
 }
@@ -13,21 +13,22 @@ namespace K {
 	 * be aware that the size of the given array is NOT checked.
 	 *
 	 */
-	template <typename T, int size> class DSPWindowBartlett : DSPWindow<T, size> {
+	template <typename T, int size> class DSPWindowBartlett : public DSPWindow<T, size> {
 
 	public:
 
 		/** ctor. setup the window array */
 		DSPWindowBartlett() {
-			for (unsigned int i = 0; i < size; ++i) {
-				this->window[i] = (2.0/(size-1)) * ( ((size-1)/2.0) - std::abs( i-((size-1)/2.0) ) );
-			}
+			this->init(&getValue);
+		}
+
+		/** get the window's value at index i for a window of the given (runtime) length */
+		static double getValue(const unsigned int i, const unsigned int len) {
+			return (2.0/(len-1)) * ( ((len-1)/2.0) - std::abs( i-((len-1)/2.0) ) );
 		}
 
 		void apply(T* data) override {
-			for (unsigned int i = 0; i < size; ++i) {
-				data[i] = data[i] * this->window[i];
-			}
+			DSPWindowKernel::applyTruncated(this->window, data, data, size);
 		}
 
 
@@ -13,21 +13,22 @@ namespace K {
 	 * be aware that the size of the given array is NOT checked.
 	 *
 	 */
-	template <typename type, int size> class DSPWindowBlackman : DSPWindow<type, size> {
+	template <typename type, int size> class DSPWindowBlackman : public DSPWindow<type, size> {
 
 	public:
 
 		/** ctor. setup the window array */
 		DSPWindowBlackman() {
-			for (unsigned int i = 0; i < size; ++i) {
-				this->window[i] = ( 0.42 - 0.5 * cos(2 * K::PI * i / size) + 0.08 * cos(4 * K::PI * i / size) );
-			}
+			this->init(&getValue);
+		}
+
+		/** get the window's value at index i for a window of the given (runtime) length */
+		static double getValue(const unsigned int i, const unsigned int len) {
+			return ( 0.42 - 0.5 * cos(2 * K::PI * i / len) + 0.08 * cos(4 * K::PI * i / len) );
 		}
 
 		void apply(type* data) override {
-			for (unsigned int i = 0; i < size; ++i) {
-				data[i] = data[i] * this->window[i];
-			}
+			DSPWindowKernel::applyTruncated(this->window, data, data, size);
 		}
 
 
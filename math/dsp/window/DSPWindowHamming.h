@@ -13,21 +13,22 @@ namespace K {
 	 * be aware that the size of the given array is NOT checked.
 	 *
 	 */
-	template <typename T, int size> class DSPWindowHamming : DSPWindow<T, size> {
+	template <typename T, int size> class DSPWindowHamming : public DSPWindow<T, size> {
 
 	public:
 
 		/** ctor. setup the window array */
 		DSPWindowHamming() {
-			for (unsigned int i = 0; i < size; ++i) {
-				this->window[i] = 0.54 - 0.46 * cos(2 * K::PI * i / size);
-			}
+			this->init(&getValue);
+		}
+
+		/** get the window's value at index i for a window of the given (runtime) length */
+		static double getValue(const unsigned int i, const unsigned int len) {
+			return 0.54 - 0.46 * cos(2 * K::PI * i / len);
 		}
 
 		void apply(T* data) override {
-			for (unsigned int i = 0; i < size; ++i) {
-				data[i] = data[i] * this->window[i];
-			}
+			DSPWindowKernel::applyTruncated(this->window, data, data, size);
 		}
 
 
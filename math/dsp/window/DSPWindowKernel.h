@@ -0,0 +1,112 @@
+#ifndef K_MATH_DSP_WINDOW_KERNEL_H_
+#define K_MATH_DSP_WINDOW_KERNEL_H_
+
+#include <cstdint>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace K {
+
+	/**
+	 * @brief block kernels multiplying samples with a precomputed window.
+	 *
+	 * float samples use the float table, fixed-point samples (int16_t, int32_t)
+	 * use the same window in Q15 format: out = round(in * w / 32768).
+	 * applyTruncated() keeps the conversion of DSPWindow::apply() instead:
+	 * out = (type) (in * w), using the float table for all types.
+	 * all kernels allow in == out.
+	 */
+	struct DSPWindowKernel {
+
+		/** convert a window value within [0:1] to Q15. 1.0 is clamped to 32767 */
+		static inline int16_t toQ15(const double v) {
+			const long q = std::lround(v * 32768.0);
+			return (int16_t) ((q > 32767) ? (32767) : ((q < -32768) ? (-32768) : (q)));
+		}
+
+		/** any other type: scalar, using the float table */
+		template <typename type> static inline void apply(const float* w, const int16_t* wq, const type* in, type* out, const unsigned int n) {
+			(void) wq;
+			for (unsigned int i = 0; i < n; ++i) {out[i] = (type) (in[i] * w[i]);}
+		}
+
+		/** any type: scalar, converting the float product (fixed-point results are truncated) */
+		template <typename type> static inline void applyTruncated(const float* w, const type* in, type* out, const unsigned int n) {
+			for (unsigned int i = 0; i < n; ++i) {out[i] = (type) (in[i] * w[i]);}
+		}
+
+		/** float: nothing to truncate, same as apply() */
+		static inline void applyTruncated(const float* w, const float* in, float* out, const unsigned int n) {
+			apply(w, nullptr, in, out, n);
+		}
+
+		/** float: 8 samples per iteration */
+		static inline void apply(const float* w, const int16_t* wq, const float* in, float* out, const unsigned int n) {
+			(void) wq;
+			unsigned int i = 0;
+#if defined(__SSE2__)
+			for (; i + 8 <= n; i += 8) {
+				const __m128 a = _mm_mul_ps(_mm_loadu_ps(in + i), _mm_loadu_ps(w + i));
+				const __m128 b = _mm_mul_ps(_mm_loadu_ps(in + i + 4), _mm_loadu_ps(w + i + 4));
+				_mm_storeu_ps(out + i, a);
+				_mm_storeu_ps(out + i + 4, b);
+			}
+#endif
+			for (; i < n; ++i) {out[i] = in[i] * w[i];}
+		}
+
+		/** int16_t (e.g. Q15 samples): 16x16 -> 32 bit products, rounded and saturated */
+		static inline void apply(const float* w, const int16_t* wq, const int16_t* in, int16_t* out, const unsigned int n) {
+			(void) w;
+			unsigned int i = 0;
+#if defined(__SSE2__)
+			const __m128i round = _mm_set1_epi32(1 << 14);
+			for (; i + 8 <= n; i += 8) {
+				const __m128i x = _mm_loadu_si128((const __m128i*) (in + i));
+				const __m128i c = _mm_loadu_si128((const __m128i*) (wq + i));
+				const __m128i lo = _mm_mullo_epi16(x, c);
+				const __m128i hi = _mm_mulhi_epi16(x, c);
+				const __m128i p0 = _mm_srai_epi32(_mm_add_epi32(_mm_unpacklo_epi16(lo, hi), round), 15);
+				const __m128i p1 = _mm_srai_epi32(_mm_add_epi32(_mm_unpackhi_epi16(lo, hi), round), 15);
+				_mm_storeu_si128((__m128i*) (out + i), _mm_packs_epi32(p0, p1));
+			}
+#endif
+			for (; i < n; ++i) {out[i] = (int16_t) ((in[i] * wq[i] + (1 << 14)) >> 15);}
+		}
+
+		/** int32_t: 32x16 -> 64 bit products, rounded */
+		static inline void apply(const float* w, const int16_t* wq, const int32_t* in, int32_t* out, const unsigned int n) {
+			(void) w;
+			unsigned int i = 0;
+#if defined(__SSE2__)
+			// SSE2 only provides unsigned 32x32 -> 64 bit products: correct them for negative operands.
+			// as |w| <= 1, the result fits into 32 bits and a logical shift suffices
+			const __m128i round = _mm_set1_epi64x(1 << 14);
+			const __m128i lowMask = _mm_set1_epi64x(0xFFFFFFFFLL);
+			for (; i + 4 <= n; i += 4) {
+				const __m128i x = _mm_loadu_si128((const __m128i*) (in + i));
+				const __m128i cs = _mm_srai_epi32(_mm_unpacklo_epi16(_mm_setzero_si128(), _mm_loadl_epi64((const __m128i*) (wq + i))), 16);
+				const __m128i neg = _mm_add_epi32(_mm_and_si128(_mm_srai_epi32(x, 31), cs), _mm_and_si128(_mm_srai_epi32(cs, 31), x));
+				const __m128i xo = _mm_srli_epi64(x, 32);
+				const __m128i co = _mm_srli_epi64(cs, 32);
+				const __m128i no = _mm_srli_epi64(neg, 32);
+				__m128i pe = _mm_mul_epu32(x, cs);
+				__m128i po = _mm_mul_epu32(xo, co);
+				pe = _mm_sub_epi64(pe, _mm_slli_epi64(neg, 32));
+				po = _mm_sub_epi64(po, _mm_slli_epi64(no, 32));
+				pe = _mm_srli_epi64(_mm_add_epi64(pe, round), 15);
+				po = _mm_srli_epi64(_mm_add_epi64(po, round), 15);
+				_mm_storeu_si128((__m128i*) (out + i), _mm_or_si128(_mm_and_si128(pe, lowMask), _mm_slli_epi64(po, 32)));
+			}
+#endif
+			for (; i < n; ++i) {out[i] = (int32_t) (((int64_t) in[i] * wq[i] + (1 << 14)) >> 15);}
+		}
+
+	};
+
+}
+
+#endif // K_MATH_DSP_WINDOW_KERNEL_H_
@@ -111,12 +111,16 @@ namespace K {
 		/** parse a complete HTTP-header from the given line-input-stream */
 		void parse(LineInputStream* lis) {
 
+			// one string for all lines (no allocation per line)
+			std::string line;
+
 			// read request line
-			parseFirstLine(lis->readLine());
+			if (!lis->readLine(line)) {throw IOException("error while reading next line from stream");}
+			parseFirstLine(line);
 
 			// read the HTTP header
 			while (true) {
-				const std::string line = lis->readLine();
+				if (!lis->readLine(line)) {throw IOException("error while reading next line from stream");}
 				if (line.empty()) {break;}
 				header.addLine(line);
 			}
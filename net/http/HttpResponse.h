@@ -38,12 +38,16 @@ namespace K {
 		/** ctor: from input-stream */
 		HttpResponse(LineInputStream& lis) {
 
+			// one string for all lines (no allocation per line)
+			std::string line;
+
 			// read request line
-			parseFirstLine(lis.readLine());
+			if (!lis.readLine(line)) {throw IOException("error while reading next line from stream");}
+			parseFirstLine(line);
 
 			// read the HTTP header
 			while (true) {
-				const std::string line = lis.readLine();
+				if (!lis.readLine(line)) {throw IOException("error while reading next line from stream");}
 				if (line.empty()) {break;}
 				header.addLine(line);
 			}
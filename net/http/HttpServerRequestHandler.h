@@ -47,6 +47,9 @@ namespace K {
 		static constexpr const char* logName = "HTTPh";
 		static constexpr int BUF_SIZE = 16*1024;
 
+		/** the max. length of the request line and each header line */
+		static constexpr int MAX_LINE_LENGTH = 8*1024;
+
 	public:
 
 		/**
@@ -56,7 +59,7 @@ namespace K {
 		HttpServerRequestHandler(Socket* sck, HttpServerListener* listener, Logger* log) :
 			sck(sck), listener(listener), is(sck->getInputStream()), os(sck->getOutputStream()), log(log) {
 			bis = new BufferedInputStream(is);
-			lis = new LineInputStream(bis);
+			lis = new LineInputStream(bis, MAX_LINE_LENGTH);
 		}
 
 		/** dtor */
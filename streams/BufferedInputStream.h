@@ -12,21 +12,30 @@
 #include <cstdint>
 #include <cstring>
 #include "InputStreamPeek.h"
-#include "Buffer.h"
+#include "RingBuffer.h"
 #include "StreamException.h"
 
 namespace K {
 
 /**
- * adds additional buffering to an input stream
+ * adds additional buffering to an input stream.
+ *
+ * the underlying stream reads directly into a ring buffer. consumers may
+ * either copy from it via read() or work on the buffered bytes without
+ * copying them, using getAvailable() and consume().
  */
 class BufferedInputStream : public InputStreamPeek {
 
 public:
 
-	/** ctor */
-	BufferedInputStream(InputStream* is, const unsigned int blockSize = 4096) :
-		is(is), blockSize(blockSize), eof(false) {
+	/**
+	 * ctor
+	 * @param is the stream to buffer
+	 * @param blockSize the number of bytes to fetch from the underlying stream at once
+	 * @param mirror use a mirrored ring buffer (see RingBuffer)
+	 */
+	BufferedInputStream(InputStream* is, const unsigned int blockSize = 4096, const bool mirror = false) :
+		is(is), buffer(2 * blockSize, mirror), blockSize(blockSize), eof(false) {
 		;
 	}
 
@@ -94,11 +103,29 @@ public:
 		}
 
 		// everything fine
-		const size_t toRead = (len < buffer.getNumUsed()) ? (len) : (buffer.getNumUsed());
-		memcpy(data, &buffer[0], toRead);
-		buffer.remove(toRead);
-		return toRead;
+		return buffer.read(data, len);
+
+	}
+
+	/**
+	 * get a contiguous view of (at least minLen, if available) buffered bytes without copying them.
+	 * the view is valid until the next call to any other method.
+	 * use consume() to remove the bytes that were used.
+	 * an empty view means: nothing available (isEOF() or try again later)
+	 */
+	RingBufferSpan<const uint8_t> getAvailable(const size_t minLen = 1) {
+		fillBuffer(minLen);
+		return buffer.getReadable(minLen);
+	}
 
+	/** remove the given number of bytes that were returned by getAvailable() */
+	void consume(const size_t n) {
+		buffer.consume(n);
+	}
+
+	/** did the underlying stream report EOF? (there might still be buffered bytes) */
+	bool isEOF() const {
+		return eof;
 	}
 
 	void close() override {
@@ -106,8 +133,9 @@ public:
 	}
 
 	void skip(const uint64_t n) override {
-		(void) n;
-		throw StreamException("BufferedInputStream.skip() not yet implemented");
+		const size_t buffered = (n < buffer.getNumUsed()) ? ((size_t) n) : (buffer.getNumUsed());
+		buffer.consume(buffered);
+		if (n > buffered) {is->skip(n - buffered);}
 	}
 
 private:
@@ -118,19 +146,21 @@ private:
 		// buffer already contains enough bytes? -> nothing to do
 		if (buffer.getNumUsed() >= needed) {return;}
 
-		// how many bytes to fetch
-		const size_t toFetch = (needed < blockSize) ? (blockSize) : (needed);
+		// EOF already detected? -> nothing to fetch
+		if (eof) {return;}
 
-		// make space for those bytes
-		buffer.resize(buffer.getNumUsed() + toFetch);
+		// how many bytes to fetch
+		const size_t missing = needed - buffer.getNumUsed();
+		const size_t toFetch = (missing < blockSize) ? (blockSize) : (missing);
 
-		// try to fetch from underlying layer
-		const ssize_t fetched = is->read(buffer.getFirstFree(), toFetch);
+		// let the underlying layer write directly into the buffer's free space
+		const RingBufferSpan<uint8_t> span = buffer.getWritable(toFetch);
+		const ssize_t fetched = is->read(span.data, toFetch);
 		if (fetched == ERR_FAILED)		{eof = true; return;}
 		if (fetched == ERR_TRY_AGAIN)	{return;}
 
 		// everything fine
-		buffer.setNumUsed(buffer.getNumUsed() + fetched);
+		buffer.commit((size_t) fetched);
 
 	}
 
@@ -138,7 +168,7 @@ private:
 	InputStream* is;
 
 	/** the internal buffer */
-	Buffer<uint8_t> buffer;
+	RingBuffer<uint8_t> buffer;
 
 	/** the number of bytes to read every time */
 	const unsigned int blockSize;
@@ -0,0 +1,185 @@
+#ifndef K_STREAMS_LZ4FRAME_H
+#define K_STREAMS_LZ4FRAME_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#include "lz4/lz4.h"
+#include "StreamException.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace K {
+
+	/**
+	 * @brief helpers for the LZ4 frame format.
+	 *
+	 * a frame consists of a header (magic, flags, max. block size), independent
+	 * blocks (4 byte size, highest bit set for uncompressed blocks, optionally
+	 * followed by the block's xxHash32) and an end-mark (size 0).
+	 *
+	 * LZ4FrameOutputStream appends a skippable frame holding the block index:
+	 * the offset of every block within the file and within the uncompressed
+	 * data. it ends with the number of blocks and a tag, thus it can be found
+	 * from the end of the file. other LZ4 tools simply skip it.
+	 */
+	struct LZ4Frame {
+
+		/** magic number of a frame */
+		static constexpr uint32_t MAGIC = 0x184D2204;
+
+		/** magic number of the skippable frame holding the block index */
+		static constexpr uint32_t MAGIC_INDEX = 0x184D2A5B;
+
+		/** the last 4 bytes of the index */
+		static constexpr uint32_t INDEX_TAG = 0x5844494B;
+
+		/** magic numbers 0x184D2A50 - 0x184D2A5F denote skippable frames */
+		static inline bool isSkippable(const uint32_t magic) {return (magic & 0xFFFFFFF0) == 0x184D2A50;}
+
+		/** highest bit of a block's size: the block is stored uncompressed */
+		static constexpr uint32_t UNCOMPRESSED = 0x80000000;
+
+		/** FLG: version 01 */
+		static constexpr uint8_t FLG_VERSION = 0x40;
+
+		/** FLG: blocks are independent */
+		static constexpr uint8_t FLG_BLOCK_INDEPENDENT = 0x20;
+
+		/** FLG: every block is followed by its checksum */
+		static constexpr uint8_t FLG_BLOCK_CHECKSUM = 0x10;
+
+		/** FLG: the header contains the content size */
+		static constexpr uint8_t FLG_CONTENT_SIZE = 0x08;
+
+		/** FLG: the end-mark is followed by the content's checksum */
+		static constexpr uint8_t FLG_CONTENT_CHECKSUM = 0x04;
+
+		/** FLG: the header contains a dictionary ID */
+		static constexpr uint8_t FLG_DICT_ID = 0x01;
+
+		/** one entry of the block index */
+		struct IndexEntry {
+
+			/** offset of the block's size field within the file */
+			uint64_t compressedOffset;
+
+			/** offset of the block's first byte within the uncompressed data */
+			uint64_t uncompressedOffset;
+
+			/** ctor */
+			IndexEntry(const uint64_t compressedOffset, const uint64_t uncompressedOffset) :
+				compressedOffset(compressedOffset), uncompressedOffset(uncompressedOffset) {;}
+
+		};
+
+		/** get the max. block size for the given BD byte */
+		static size_t getBlockSize(const uint8_t bd) {
+			const int id = (bd >> 4) & 0x07;
+			if (id < 4) {throw StreamException("LZ4: invalid block size in frame header");}
+			return (size_t) 1 << (8 + 2 * id);
+		}
+
+		/** get the BD byte for the given max. block size (64 KiB, 256 KiB, 1 MiB or 4 MiB) */
+		static uint8_t getBD(const size_t blockSize) {
+			for (int id = 4; id <= 7; ++id) {
+				if (((size_t) 1 << (8 + 2 * id)) == blockSize) {return (uint8_t) (id << 4);}
+			}
+			throw StreamException("LZ4: block size must be 64 KiB, 256 KiB, 1 MiB or 4 MiB");
+		}
+
+		/** the number of blocks to process at once (per thread two blocks) */
+		static int getBatchSize() {
+#ifdef _OPENMP
+			return 2 * omp_get_max_threads();
+#else
+			return 1;
+#endif
+		}
+
+		static inline void write32(uint8_t* dst, const uint32_t v) {
+			dst[0] = (uint8_t) v; dst[1] = (uint8_t) (v >> 8); dst[2] = (uint8_t) (v >> 16); dst[3] = (uint8_t) (v >> 24);
+		}
+
+		static inline void write64(uint8_t* dst, const uint64_t v) {
+			write32(dst, (uint32_t) v); write32(dst + 4, (uint32_t) (v >> 32));
+		}
+
+		static inline uint32_t read32(const uint8_t* src) {
+			return (uint32_t) src[0] | ((uint32_t) src[1] << 8) | ((uint32_t) src[2] << 16) | ((uint32_t) src[3] << 24);
+		}
+
+		static inline uint64_t read64(const uint8_t* src) {
+			return (uint64_t) read32(src) | ((uint64_t) read32(src + 4) << 32);
+		}
+
+		/** xxHash32 of the given data, as used by the frame format */
+		static uint32_t xxh32(const void* data, const size_t len, const uint32_t seed = 0) {
+
+			const uint32_t P1 = 2654435761U;
+			const uint32_t P2 = 2246822519U;
+			const uint32_t P3 = 3266489917U;
+			const uint32_t P4 = 668265263U;
+			const uint32_t P5 = 374761393U;
+
+			const uint8_t* p = (const uint8_t*) data;
+			const uint8_t* end = p + len;
+			uint32_t h;
+
+			if (len >= 16) {
+				uint32_t v1 = seed + P1 + P2;
+				uint32_t v2 = seed + P2;
+				uint32_t v3 = seed;
+				uint32_t v4 = seed - P1;
+				for (; p + 16 <= end; p += 16) {
+					v1 = rotl(v1 + read32(p + 0) * P2, 13) * P1;
+					v2 = rotl(v2 + read32(p + 4) * P2, 13) * P1;
+					v3 = rotl(v3 + read32(p + 8) * P2, 13) * P1;
+					v4 = rotl(v4 + read32(p + 12) * P2, 13) * P1;
+				}
+				h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+			} else {
+				h = seed + P5;
+			}
+
+			h += (uint32_t) len;
+			for (; p + 4 <= end; p += 4) {h = rotl(h + read32(p) * P3, 17) * P4;}
+			for (; p < end; ++p) {h = rotl(h + (*p) * P5, 11) * P1;}
+
+			h ^= h >> 15; h *= P2;
+			h ^= h >> 13; h *= P3;
+			h ^= h >> 16;
+			return h;
+
+		}
+
+		/**
+		 * decode one block (compressed or not) into dst (max. dstLen bytes).
+		 * verifies the checksum, if given. returns the number of decoded bytes
+		 */
+		static size_t decodeBlock(const uint8_t* src, const uint32_t sizeField, const bool hasChecksum, const uint32_t checksum, uint8_t* dst, const size_t dstLen) {
+			const uint32_t len = sizeField & ~UNCOMPRESSED;
+			if (hasChecksum && xxh32(src, len) != checksum) {throw StreamException("LZ4: block checksum mismatch");}
+			if (sizeField & UNCOMPRESSED) {
+				if (len > dstLen) {throw StreamException("LZ4: block exceeds the max. block size");}
+				memcpy(dst, src, len);
+				return len;
+			}
+			const int res = LZ4_decompress_safe((const char*) src, (char*) dst, (int) len, (int) dstLen);
+			if (res < 0) {throw StreamException("LZ4: corrupted block");}
+			return (size_t) res;
+		}
+
+	private:
+
+		static inline uint32_t rotl(const uint32_t v, const int r) {return (v << r) | (v >> (32 - r));}
+
+	};
+
+}
+
+#endif // K_STREAMS_LZ4FRAME_H
@@ -0,0 +1,207 @@
+#ifndef K_STREAMS_LZ4FRAMEFILEREADER_H
+#define K_STREAMS_LZ4FRAMEFILEREADER_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#include "lz4/lz4.hc"
+#include "LZ4Frame.h"
+
+namespace K {
+
+	/**
+	 * @brief random access to a file written by LZ4FrameOutputStream (with index).
+	 *
+	 * the block index is read from the end of the file. read() only loads and
+	 * decompresses the blocks covering the requested range, in parallel.
+	 * the frame must start at the beginning of the file.
+	 */
+	class LZ4FrameFileReader {
+
+	private:
+
+		/** the file */
+		FILE* fp;
+
+		/** the block index */
+		std::vector<LZ4Frame::IndexEntry> index;
+
+		/** offset of the end-mark (= end of the last block) */
+		uint64_t blocksEnd;
+
+		/** uncompressed size */
+		uint64_t size;
+
+		/** max. block size and whether blocks carry checksums */
+		size_t blockSize;
+		bool hasBlockChecksum;
+
+	public:
+
+		/** ctor. open the given file and read its index */
+		LZ4FrameFileReader(const std::string& file) : fp(nullptr), blocksEnd(0), size(0), blockSize(0), hasBlockChecksum(false) {
+			fp = fopen(file.c_str(), "rb");
+			if (!fp) {throw StreamException("could not open file: " + file);}
+			try {
+				readHeader();
+				readIndex();
+			} catch (...) {
+				fclose(fp);
+				throw;
+			}
+		}
+
+		/** dtor */
+		~LZ4FrameFileReader() {
+			if (fp) {fclose(fp); fp = nullptr;}
+		}
+
+		/** no copies */
+		LZ4FrameFileReader(const LZ4FrameFileReader&) = delete;
+		LZ4FrameFileReader& operator = (const LZ4FrameFileReader&) = delete;
+
+		/** get the uncompressed size */
+		uint64_t getSize() const {return size;}
+
+		/** get the number of blocks */
+		size_t getNumBlocks() const {return index.size();}
+
+		/** get the index */
+		const std::vector<LZ4Frame::IndexEntry>& getIndex() const {return index;}
+
+		/**
+		 * @brief read len uncompressed bytes starting at the given offset.
+		 * returns the number of bytes read (less than len at the end of the data)
+		 */
+		size_t read(const uint64_t offset, uint8_t* dst, const size_t len) {
+
+			if (offset >= size || len == 0) {return 0;}
+			const uint64_t end = std::min(size, offset + len);
+
+			// blocks covering [offset:end)
+			const size_t first = getBlock(offset);
+			const size_t last = getBlock(end - 1);
+			const int cnt = (int) (last - first + 1);
+
+			// load the compressed data of all blocks at once (they are contiguous)
+			const uint64_t cStart = index[first].compressedOffset;
+			const uint64_t cEnd = (last + 1 < index.size()) ? (index[last + 1].compressedOffset) : (blocksEnd);
+			std::vector<uint8_t> comp((size_t) (cEnd - cStart));
+			readAt(cStart, comp.data(), comp.size());
+
+			// decompress in parallel, copy the requested part
+			volatile bool failed = false;
+			#pragma omp parallel for schedule(dynamic) if (cnt > 1)
+			for (int i = 0; i < cnt; ++i) {
+				const size_t b = first + (size_t) i;
+				const uint64_t avail = cEnd - index[b].compressedOffset;
+				const uint8_t* src = comp.data() + (index[b].compressedOffset - cStart);
+				if (avail < 4) {failed = true; continue;}
+				const uint32_t sizeField = LZ4Frame::read32(src);
+				const uint32_t cLen = sizeField & ~LZ4Frame::UNCOMPRESSED;
+				if (4 + (uint64_t) cLen + ((hasBlockChecksum) ? (4) : (0)) > avail) {failed = true; continue;}
+				const uint32_t checksum = (hasBlockChecksum) ? (LZ4Frame::read32(src + 4 + cLen)) : (0);
+				std::vector<uint8_t> tmp(blockSize);
+				try {
+					const size_t dLen = LZ4Frame::decodeBlock(src + 4, sizeField, hasBlockChecksum, checksum, tmp.data(), blockSize);
+					const uint64_t bStart = index[b].uncompressedOffset;
+					if (dLen != getBlockEnd(b) - bStart) {failed = true; continue;}
+					const uint64_t from = std::max(offset, bStart);
+					const uint64_t to = std::min(end, bStart + dLen);
+					if (to > from) {memcpy(dst + (from - offset), tmp.data() + (from - bStart), (size_t) (to - from));}
+				} catch (...) {
+					failed = true;
+				}
+			}
+			if (failed) {throw StreamException("LZ4: corrupted block (checksum mismatch or invalid data)");}
+
+			return (size_t) (end - offset);
+
+		}
+
+	private:
+
+		/** the block containing the given uncompressed offset */
+		size_t getBlock(const uint64_t offset) const {
+			const auto it = std::upper_bound(index.begin(), index.end(), offset,
+				[] (const uint64_t o, const LZ4Frame::IndexEntry& e) {return o < e.uncompressedOffset;});
+			return (size_t) (it - index.begin()) - 1;
+		}
+
+		/** the uncompressed offset behind the given block */
+		uint64_t getBlockEnd(const size_t b) const {
+			return (b + 1 < index.size()) ? (index[b + 1].uncompressedOffset) : (size);
+		}
+
+		void readAt(const uint64_t pos, uint8_t* dst, const size_t len) {
+			if (fseeko(fp, (off_t) pos, SEEK_SET) != 0) {throw StreamException("LZ4: seek failed");}
+			if (fread(dst, 1, len, fp) != len) {throw StreamException("LZ4: unexpected end of file");}
+		}
+
+		void readHeader() {
+			uint8_t hdr[7];
+			readAt(0, hdr, 7);
+			if (LZ4Frame::read32(hdr) != LZ4Frame::MAGIC) {throw StreamException("LZ4: invalid frame magic");}
+			const uint8_t flg = hdr[4];
+			if (flg & (LZ4Frame::FLG_CONTENT_SIZE | LZ4Frame::FLG_DICT_ID)) {throw StreamException("LZ4: unsupported frame header");}
+			if (((LZ4Frame::xxh32(hdr + 4, 2) >> 8) & 0xFF) != hdr[6]) {throw StreamException("LZ4: frame header checksum mismatch");}
+			hasBlockChecksum = (flg & LZ4Frame::FLG_BLOCK_CHECKSUM) != 0;
+			blockSize = LZ4Frame::getBlockSize(hdr[5]);
+		}
+
+		void readIndex() {
+
+			// trailer: total size, number of entries, tag
+			if (fseeko(fp, 0, SEEK_END) != 0) {throw StreamException("LZ4: seek failed");}
+			const uint64_t fileSize = (uint64_t) ftello(fp);
+			if (fileSize < 7 + 4 + 8 + 16) {throw StreamException("LZ4: file has no block index");}
+			uint8_t trailer[16];
+			readAt(fileSize - 16, trailer, 16);
+			if (LZ4Frame::read32(trailer + 12) != LZ4Frame::INDEX_TAG) {throw StreamException("LZ4: file has no block index");}
+			size = LZ4Frame::read64(trailer);
+			const uint64_t num = LZ4Frame::read32(trailer + 8);
+
+			// the skippable frame
+			const uint64_t payload = num * 16 + 16;
+			if (fileSize < 8 + payload + 11) {throw StreamException("LZ4: invalid block index");}
+			const uint64_t start = fileSize - payload - 8;
+			std::vector<uint8_t> buf((size_t) (payload + 8));
+			readAt(start, buf.data(), buf.size());
+			if (LZ4Frame::read32(&buf[0]) != LZ4Frame::MAGIC_INDEX || LZ4Frame::read32(&buf[4]) != payload) {throw StreamException("LZ4: invalid block index");}
+
+			index.clear();
+			index.reserve((size_t) num);
+			for (uint64_t i = 0; i < num; ++i) {
+				const uint8_t* e = &buf[8 + i * 16];
+				index.push_back(LZ4Frame::IndexEntry(LZ4Frame::read64(e), LZ4Frame::read64(e + 8)));
+			}
+			blocksEnd = start - 4;
+			checkIndex();
+
+		}
+
+		/** the index must describe contiguous blocks within the frame, covering the whole uncompressed size */
+		void checkIndex() const {
+			if (index.empty()) {
+				if (size != 0) {throw StreamException("LZ4: invalid block index");}
+				return;
+			}
+			if (index[0].compressedOffset != 7 || index[0].uncompressedOffset != 0) {throw StreamException("LZ4: invalid block index");}
+			const uint64_t maxCompressed = 4 + (uint64_t) blockSize + ((hasBlockChecksum) ? (4) : (0));
+			for (size_t i = 0; i < index.size(); ++i) {
+				const LZ4Frame::IndexEntry& e = index[i];
+				const uint64_t cNext = (i + 1 < index.size()) ? (index[i + 1].compressedOffset) : (blocksEnd);
+				const uint64_t uNext = getBlockEnd(i);
+				if (e.compressedOffset >= cNext || cNext - e.compressedOffset > maxCompressed) {throw StreamException("LZ4: invalid block index");}
+				if (e.uncompressedOffset >= uNext || uNext - e.uncompressedOffset > blockSize) {throw StreamException("LZ4: invalid block index");}
+			}
+		}
+
+	};
+
+}
+
+#endif // K_STREAMS_LZ4FRAMEFILEREADER_H
@@ -0,0 +1,210 @@
+#ifndef K_STREAMS_LZ4FRAMEINPUTSTREAM_H
+#define K_STREAMS_LZ4FRAMEINPUTSTREAM_H
+
+#include <vector>
+#include <cstring>
+
+#include "lz4/lz4.hc"
+#include "LZ4Frame.h"
+#include "InputStream.h"
+
+namespace K {
+
+	/**
+	 * @brief decompress LZ4 frames using all threads.
+	 *
+	 * reads a batch of blocks (two per thread) from the underlying stream,
+	 * decompresses and verifies them in parallel and returns their contents
+	 * in order. concatenated frames are supported, skippable frames
+	 * (e.g. the block index) are skipped. content checksums are not verified.
+	 */
+	class LZ4FrameInputStream : public InputStream {
+
+	private:
+
+		/** one block: its compressed data and its decompressed contents */
+		struct Block {
+			std::vector<uint8_t> comp;
+			uint32_t sizeField;
+			uint32_t checksum;
+			bool hasChecksum;
+			size_t maxLen;
+			std::vector<uint8_t> data;
+			size_t len;
+			Block() : sizeField(0), checksum(0), hasChecksum(false), maxLen(0), len(0) {;}
+		};
+
+		/** the stream to read from */
+		InputStream& is;
+
+		/** the current batch */
+		std::vector<Block> blocks;
+
+		/** number of blocks within the batch, the current block, and the position within it */
+		size_t numBlocks;
+		size_t curBlock;
+		size_t curPos;
+
+		/** settings of the current frame */
+		bool inFrame;
+		bool hasBlockChecksum;
+		bool hasContentChecksum;
+		size_t blockSize;
+
+		/** no more frames */
+		bool eof;
+
+	public:
+
+		/** ctor */
+		LZ4FrameInputStream(InputStream& is) :
+			is(is), blocks(LZ4Frame::getBatchSize()), numBlocks(0), curBlock(0), curPos(0),
+			inFrame(false), hasBlockChecksum(false), hasContentChecksum(false), blockSize(0), eof(false) {
+			;
+		}
+
+		int read() override {
+			if (!ensureData()) {return ERR_FAILED;}
+			const Block& b = blocks[curBlock];
+			const int ret = b.data[curPos++];
+			if (curPos == b.len) {++curBlock; curPos = 0;}
+			return ret;
+		}
+
+		ssize_t read(uint8_t* data, const size_t len) override {
+			if (!ensureData()) {return ERR_FAILED;}
+			size_t done = 0;
+			while (done < len && curBlock < numBlocks) {
+				const Block& b = blocks[curBlock];
+				const size_t cnt = std::min(len - done, b.len - curPos);
+				memcpy(data + done, b.data.data() + curPos, cnt);
+				done += cnt;
+				curPos += cnt;
+				if (curPos == b.len) {++curBlock; curPos = 0;}
+				while (curBlock < numBlocks && blocks[curBlock].len == 0) {++curBlock;}
+			}
+			return (ssize_t) done;
+		}
+
+		void skip(const size_t n) override {
+			uint8_t buf[4096];
+			for (size_t done = 0; done < n; ) {
+				const ssize_t cnt = read(buf, std::min(n - done, sizeof(buf)));
+				if (cnt == ERR_FAILED) {throw StreamException("LZ4: skip() beyond the end of the stream");}
+				done += (size_t) cnt;
+			}
+		}
+
+		void close() override {
+			is.close();
+		}
+
+	private:
+
+		/** ensure the current batch has unread data. false on EOF */
+		bool ensureData() {
+			while (true) {
+				while (curBlock < numBlocks && blocks[curBlock].len == 0) {++curBlock;}
+				if (curBlock < numBlocks) {return true;}
+				if (eof) {return false;}
+				readBatch();
+			}
+		}
+
+		/** read the next batch of blocks and decompress them in parallel */
+		void readBatch() {
+
+			numBlocks = 0;
+			curBlock = 0;
+			curPos = 0;
+
+			// read the compressed blocks (sequential)
+			while (numBlocks < blocks.size()) {
+				if (!inFrame && !readFrameHeader()) {eof = true; break;}
+				uint8_t tmp[4];
+				readExactly(tmp, 4);
+				const uint32_t sizeField = LZ4Frame::read32(tmp);
+				if (sizeField == 0) {
+					inFrame = false;
+					if (hasContentChecksum) {readExactly(tmp, 4);}
+					continue;
+				}
+				Block& b = blocks[numBlocks++];
+				b.sizeField = sizeField;
+				b.maxLen = blockSize;
+				b.hasChecksum = hasBlockChecksum;
+				const size_t len = sizeField & ~LZ4Frame::UNCOMPRESSED;
+				if (len > (size_t) LZ4_compressBound((int) blockSize)) {throw StreamException("LZ4: invalid block size");}
+				b.comp.resize(len);
+				readExactly(b.comp.data(), len);
+				if (hasBlockChecksum) {readExactly(tmp, 4); b.checksum = LZ4Frame::read32(tmp);}
+			}
+
+			// decompress and verify (parallel)
+			const int cnt = (int) numBlocks;
+			volatile bool failed = false;
+			#pragma omp parallel for schedule(dynamic)
+			for (int i = 0; i < cnt; ++i) {
+				Block& b = blocks[i];
+				b.data.resize(b.maxLen);
+				try {
+					b.len = LZ4Frame::decodeBlock(b.comp.data(), b.sizeField, b.hasChecksum, b.checksum, b.data.data(), b.maxLen);
+				} catch (...) {
+					failed = true;
+				}
+			}
+			if (failed) {throw StreamException("LZ4: corrupted block (checksum mismatch or invalid data)");}
+
+		}
+
+		/** read the next frame header, skipping skippable frames. false on EOF */
+		bool readFrameHeader() {
+
+			while (true) {
+
+				uint8_t hdr[4];
+				const ssize_t res = is.readFully(hdr, 4);
+				if (res == ERR_FAILED || res == 0) {return false;}
+				const uint32_t magic = LZ4Frame::read32(hdr);
+
+				if (LZ4Frame::isSkippable(magic)) {
+					readExactly(hdr, 4);
+					is.skip(LZ4Frame::read32(hdr));
+					continue;
+				}
+				if (magic != LZ4Frame::MAGIC) {throw StreamException("LZ4: invalid frame magic");}
+
+				// FLG, BD, optional content size and dictionary id, header checksum
+				uint8_t desc[15];
+				readExactly(desc, 2);
+				const uint8_t flg = desc[0];
+				if ((flg & 0xC0) != LZ4Frame::FLG_VERSION) {throw StreamException("LZ4: unsupported frame version");}
+				if (!(flg & LZ4Frame::FLG_BLOCK_INDEPENDENT)) {throw StreamException("LZ4: linked blocks are not supported");}
+				size_t len = 2;
+				if (flg & LZ4Frame::FLG_CONTENT_SIZE) {readExactly(desc + len, 8); len += 8;}
+				if (flg & LZ4Frame::FLG_DICT_ID) {readExactly(desc + len, 4); len += 4;}
+				uint8_t hc;
+				readExactly(&hc, 1);
+				if (((LZ4Frame::xxh32(desc, len) >> 8) & 0xFF) != hc) {throw StreamException("LZ4: frame header checksum mismatch");}
+
+				hasBlockChecksum = (flg & LZ4Frame::FLG_BLOCK_CHECKSUM) != 0;
+				hasContentChecksum = (flg & LZ4Frame::FLG_CONTENT_CHECKSUM) != 0;
+				blockSize = LZ4Frame::getBlockSize(desc[1]);
+				inFrame = true;
+				return true;
+
+			}
+
+		}
+
+		/** read exactly len bytes or throw */
+		void readExactly(uint8_t* dst, const size_t len) {
+			if (len == 0) {return;}
+			if (is.readFully(dst, len) != (ssize_t) len) {throw StreamException("LZ4: unexpected end of stream");}
+		}
+
+	};
+
+}
+
+#endif // K_STREAMS_LZ4FRAMEINPUTSTREAM_H
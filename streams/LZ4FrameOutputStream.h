@@ -0,0 +1,246 @@
+#ifndef K_STREAMS_LZ4FRAMEOUTPUTSTREAM_H
+#define K_STREAMS_LZ4FRAMEOUTPUTSTREAM_H
+
+#include <vector>
+#include <cstring>
+
+#include "lz4/lz4.hc"
+#include "LZ4Frame.h"
+#include "OutputStream.h"
+
+namespace K {
+
+	/**
+	 * @brief compress data into the LZ4 frame format using all threads.
+	 *
+	 * the data is split into large, independent blocks. a batch of blocks
+	 * (two per thread) is compressed in parallel while one thread writes the
+	 * previous batch to the underlying stream. the output order is preserved.
+	 *
+	 * every block is followed by its xxHash32 (optional) and close() appends
+	 * the block index as skippable frame (optional, see LZ4Frame), which
+	 * allows random access via LZ4FrameFileReader.
+	 * the output can be decompressed by LZ4FrameInputStream or any LZ4 tool.
+	 */
+	class LZ4FrameOutputStream : public OutputStream {
+
+	private:
+
+		/** one compressed block */
+		struct Block {
+			std::vector<uint8_t> data;
+			size_t len;
+			size_t uncompressed;
+			Block() : len(0), uncompressed(0) {;}
+		};
+
+		/** the stream to write to */
+		OutputStream& os;
+
+		/** uncompressed bytes per block */
+		size_t blockSize;
+
+		/** append the checksum to every block? */
+		bool blockChecksums;
+
+		/** append the block index? */
+		bool writeIndex;
+
+		/** the uncompressed data of the current batch */
+		std::vector<uint8_t> pending;
+
+		/** number of used bytes within "pending" */
+		size_t pendingUsed;
+
+		/** the batch being compressed and the previous one (to be written) */
+		std::vector<Block> current;
+		std::vector<Block> previous;
+
+		/** the number of blocks within "previous" */
+		size_t numPrevious;
+
+		/** the block index */
+		std::vector<LZ4Frame::IndexEntry> index;
+
+		/** bytes written to "os" and uncompressed bytes (of all written blocks) */
+		uint64_t written;
+		uint64_t total;
+
+		bool headerWritten;
+		bool closed;
+
+	public:
+
+		/**
+		 * ctor
+		 * @param os the stream to write the frame to
+		 * @param blockSize uncompressed bytes per block: 64 KiB, 256 KiB, 1 MiB or 4 MiB
+		 * @param blockChecksums append an xxHash32 to every block
+		 * @param writeIndex append the block index on close()
+		 */
+		LZ4FrameOutputStream(OutputStream& os, const size_t blockSize = 4*1024*1024, const bool blockChecksums = true, const bool writeIndex = true) :
+			os(os), blockSize(blockSize), blockChecksums(blockChecksums), writeIndex(writeIndex),
+			pending(blockSize * LZ4Frame::getBatchSize()), pendingUsed(0),
+			current(LZ4Frame::getBatchSize()), previous(LZ4Frame::getBatchSize()), numPrevious(0),
+			written(0), total(0), headerWritten(false), closed(false) {
+			LZ4Frame::getBD(blockSize);		// validate
+		}
+
+		/** dtor */
+		~LZ4FrameOutputStream() {
+			close();
+		}
+
+		void write(uint8_t data) override {
+			if (pendingUsed == pending.size()) {compressBatch();}
+			pending[pendingUsed++] = data;
+		}
+
+		void write(const uint8_t* data, const size_t len) override {
+			for (size_t done = 0; done < len; ) {
+				if (pendingUsed == pending.size()) {compressBatch();}
+				const size_t cnt = std::min(len - done, pending.size() - pendingUsed);
+				memcpy(pending.data() + pendingUsed, data + done, cnt);
+				pendingUsed += cnt;
+				done += cnt;
+			}
+		}
+
+		/** compress and write everything pending. the last block may be shorter than the block size */
+		void flush() override {
+			compressBatch();
+			writeBatch();
+			os.flush();
+		}
+
+		/** finish the frame, append the index and close the underlying stream */
+		void close() override {
+			if (closed) {return;}
+			closed = true;
+			compressBatch();
+			writeBatch();
+			writeHeader();
+			writeFooter();
+			os.close();
+		}
+
+		/** get the number of blocks written so far */
+		size_t getNumBlocks() const {return index.size();}
+
+	private:
+
+		/** compress the pending data in parallel while writing the previous batch */
+		void compressBatch() {
+
+			if (pendingUsed == 0) {return;}
+			writeHeader();
+
+			const int cnt = (int) ((pendingUsed + blockSize - 1) / blockSize);
+			volatile bool failed = false;
+
+			#pragma omp parallel
+			{
+
+				#pragma omp single nowait
+				{
+					try {writeBatch();} catch (...) {failed = true;}
+				}
+
+				#pragma omp for schedule(dynamic) nowait
+				for (int i = 0; i < cnt; ++i) {
+					const size_t start = (size_t) i * blockSize;
+					compressBlock(pending.data() + start, std::min(blockSize, pendingUsed - start), current[i]);
+				}
+
+			}
+
+			if (failed) {throw StreamException("LZ4: error while writing the compressed blocks");}
+
+			std::swap(current, previous);
+			numPrevious = (size_t) cnt;
+			pendingUsed = 0;
+
+		}
+
+		/** compress one block into the given output */
+		void compressBlock(const uint8_t* src, const size_t len, Block& dst) {
+
+			dst.data.resize(4 + (size_t) LZ4_compressBound((int) blockSize) + 4);
+			dst.uncompressed = len;
+
+			// store uncompressed if compression does not reduce the size
+			uint32_t size = (uint32_t) LZ4_compress_limitedOutput((const char*) src, (char*) dst.data.data() + 4, (int) len, (int) len - 1);
+			if (size == 0) {
+				memcpy(dst.data.data() + 4, src, len);
+				size = (uint32_t) len;
+				LZ4Frame::write32(dst.data.data(), size | LZ4Frame::UNCOMPRESSED);
+			} else {
+				LZ4Frame::write32(dst.data.data(), size);
+			}
+
+			dst.len = 4 + size;
+			if (blockChecksums) {
+				LZ4Frame::write32(dst.data.data() + dst.len, LZ4Frame::xxh32(dst.data.data() + 4, size));
+				dst.len += 4;
+			}
+
+		}
+
+		/** write the previously compressed batch (in order) */
+		void writeBatch() {
+			for (size_t i = 0; i < numPrevious; ++i) {
+				const Block& b = previous[i];
+				index.push_back(LZ4Frame::IndexEntry(written, total));
+				os.write(b.data.data(), b.len);
+				written += b.len;
+				total += b.uncompressed;
+			}
+			numPrevious = 0;
+		}
+
+		/** write the frame header, once */
+		void writeHeader() {
+			if (headerWritten) {return;}
+			headerWritten = true;
+			uint8_t hdr[7];
+			LZ4Frame::write32(hdr, LZ4Frame::MAGIC);
+			hdr[4] = LZ4Frame::FLG_VERSION | LZ4Frame::FLG_BLOCK_INDEPENDENT | ((blockChecksums) ? (LZ4Frame::FLG_BLOCK_CHECKSUM) : (0));
+			hdr[5] = LZ4Frame::getBD(blockSize);
+			hdr[6] = (uint8_t) ((LZ4Frame::xxh32(hdr + 4, 2) >> 8) & 0xFF);
+			os.write(hdr, 7);
+			written += 7;
+		}
+
+		/** write the end-mark and the index */
+		void writeFooter() {
+
+			uint8_t end[4];
+			LZ4Frame::write32(end, 0);
+			os.write(end, 4);
+			written += 4;
+
+			if (!writeIndex) {return;}
+
+			// skippable frame: magic, size, entries, total size, number of entries, tag
+			const size_t payload = index.size() * 16 + 16;
+			std::vector<uint8_t> buf(8 + payload);
+			LZ4Frame::write32(&buf[0], LZ4Frame::MAGIC_INDEX);
+			LZ4Frame::write32(&buf[4], (uint32_t) payload);
+			size_t pos = 8;
+			for (const LZ4Frame::IndexEntry& e : index) {
+				LZ4Frame::write64(&buf[pos], e.compressedOffset);
+				LZ4Frame::write64(&buf[pos + 8], e.uncompressedOffset);
+				pos += 16;
+			}
+			LZ4Frame::write64(&buf[pos], total);
+			LZ4Frame::write32(&buf[pos + 8], (uint32_t) index.size());
+			LZ4Frame::write32(&buf[pos + 12], LZ4Frame::INDEX_TAG);
+			os.write(buf.data(), buf.size());
+
+		}
+
+	};
+
+}
+
+#endif // K_STREAMS_LZ4FRAMEOUTPUTSTREAM_H
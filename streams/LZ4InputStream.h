@@ -9,8 +9,10 @@
 #define LZ4INPUTSTREAM_H_
 
 #include "lz4/lz4.h"
+#include "lz4/lz4.hc"
 #include "InputStream.h"
 #include "Buffer.h"
+#include "RingBuffer.h"
 #include "StreamException.h"
 
 namespace K {
@@ -23,8 +25,8 @@ class LZ4InputStream : public InputStream {
 public:
 
 	/** ctor */
-	LZ4InputStream(InputStream& is) : is(is), eof(false) {
-		bufferDecomp.resize(4*1024);
+	LZ4InputStream(InputStream& is) : is(is), bufferDecomp(4*1024), eof(false) {
+		;
 	}
 
 	/** dtor */
@@ -41,10 +43,22 @@ public:
 	ssize_t read(uint8_t* data, const size_t len) override {
 		if (bufferDecomp.empty()) {decompressBlock();}
 		if (bufferDecomp.empty()) {return -1;}
-		const size_t toRead = (len <= bufferDecomp.getNumUsed()) ? (len) : (bufferDecomp.getNumUsed());
-		memcpy(data, bufferDecomp.getData(), toRead);
-		bufferDecomp.remove(toRead);
-		return toRead;
+		return bufferDecomp.read(data, len);
+	}
+
+	/**
+	 * get a view of the decompressed bytes without copying them (empty on EOF).
+	 * the view is valid until the next call to any other method.
+	 * use consume() to remove the bytes that were used.
+	 */
+	RingBufferSpan<const uint8_t> getAvailable() {
+		if (bufferDecomp.empty()) {decompressBlock();}
+		return bufferDecomp.getReadable();
+	}
+
+	/** remove the given number of bytes that were returned by getAvailable() */
+	void consume(const size_t n) {
+		bufferDecomp.consume(n);
 	}
 
 	void close() override {
@@ -70,36 +84,35 @@ private:
 		if (read == -1) {return;}
 		//std::cout << "next block: " << blockSize << std::endl;
 
-		// read compressed data
-		uint8_t buf[blockSize];
-		read = is.readFully(buf, blockSize);
+		// read compressed data (reusing the buffer's memory)
+		bufferComp.ensureMinSize(blockSize);
+		read = is.readFully(bufferComp.getData(), blockSize);
 		if (read != blockSize) {throw "could not read block";}
 
-		// decompress
+		// decompress directly into the (empty) ring buffer
+		size_t space = bufferDecomp.getCapacity();
 		again:
-		int decomp = LZ4_decompress_safe( (const char*) buf, (char*) bufferDecomp.getData(), blockSize, bufferDecomp.getSize() );
+		const RingBufferSpan<uint8_t> dst = bufferDecomp.getWritable(space);
+		int decomp = LZ4_decompress_safe( (const char*) bufferComp.getData(), (char*) dst.data, blockSize, (int) dst.len );
 
 
 		// check whether the buffer was able to catch all decompressed bytes
 		// if not: resize the buffer and try again
-		if (decomp < 0 || (unsigned int)decomp == bufferDecomp.getSize()) {
+		if (decomp < 0 || (unsigned int)decomp == dst.len) {
 
 			// prevent growing to infinity
-			if (bufferDecomp.getSize() > 1024*1024*16) {
+			if (dst.len > 1024*1024*16) {
 				throw "stream corrupted??";
 			}
 
-			// resize the buffer
-			bufferDecomp.resize(bufferDecomp.getSize()*2);
-			std::cout << "growing to " << bufferDecomp.getSize() << std::endl;
-
-			// try decompression
+			// try again with twice the space
+			space = dst.len * 2;
 			goto again;
 
 		}
 
 		// everything fine
-		bufferDecomp.setNumUsed(decomp);
+		bufferDecomp.commit((size_t) decomp);
 
 	}
 
@@ -108,7 +121,10 @@ private:
 	InputStream& is;
 
 	/** the decompression buffer */
-	Buffer<uint8_t> bufferDecomp;
+	RingBuffer<uint8_t> bufferDecomp;
+
+	/** the compressed data of the current block */
+	Buffer<uint8_t> bufferComp;
 
 	/** eof reached? */
 	bool eof;
@@ -12,6 +12,7 @@
 #include "lz4/lz4.hc"
 #include "OutputStream.h"
 #include "Buffer.h"
+#include "RingBuffer.h"
 
 namespace K {
 
@@ -28,7 +29,7 @@ public:
 	 * @param os the OutputStream to write the compressed data to
 	 * @param bufferSize the number of bytes to buffer before compressing the data
 	 */
-	LZ4OutputStream(OutputStream& os, unsigned int bufferSize = 4096) : os(os), bufferSize(bufferSize) {
+	LZ4OutputStream(OutputStream& os, unsigned int bufferSize = 4096) : os(os), bufferSize(bufferSize), buffer(bufferSize) {
 		;
 	}
 
@@ -72,22 +73,26 @@ private:
 		// nothing to compress?
 		if (buffer.empty()) {return;}
 
-		// ensure compression buffer provides enough space
-		unsigned int maxCompSize = LZ4_compressBound(buffer.getNumUsed());
-		bufferComp.ensureMinSize(maxCompSize);
+		// the input is never consumed partially and thus always contiguous
+		const RingBufferSpan<const uint8_t> in = buffer.getReadable();
+
+		// ensure compression buffer provides enough space (including the size-information)
+		unsigned int maxCompSize = LZ4_compressBound((int) in.len);
+		bufferComp.ensureMinSize(maxCompSize + 4);
+		uint8_t* out = bufferComp.getData();
 
 		// compress available input
-		unsigned int outSize = LZ4_compress( (const char*) buffer.getData(), (char*) bufferComp.getData()+4, buffer.getNumUsed());
+		unsigned int outSize = LZ4_compress( (const char*) in.data, (char*) out+4, (int) in.len);
 		if (outSize == 0) {throw "empty compression";}
 
 		// remove available input
 		buffer.clear();
 
 		// add size-information for the number of compressed bytes to the stream
-		*((int*)bufferComp.getData()) = outSize;
+		memcpy(out, &outSize, 4);
 
 		// pass to next layer
-		os.write(bufferComp.getData(), outSize+4);
+		os.write(out, outSize+4);
 
 	}
 
@@ -98,7 +103,7 @@ private:
 	unsigned int bufferSize;
 
 	/** data buffer to enhance compression */
-	Buffer<uint8_t> buffer;
+	RingBuffer<uint8_t> buffer;
 
 	/** compression buffer */
 	Buffer<uint8_t> bufferComp;
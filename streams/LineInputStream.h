@@ -11,6 +11,7 @@
 #include "InputStream.h"
 #include "InputStreamPeek.h"
 #include "BufferedInputStream.h"
+#include "LineReader.h"
 #include "IOException.h"
 
 namespace K {
@@ -19,8 +20,13 @@ namespace K {
 
 	public:
 
-		/** ctor */
-		LineInputStream(InputStreamPeek* is) : is(is), lastChar(0) {
+		/**
+		 * ctor
+		 * @param is the stream to read from. if it is a BufferedInputStream, lines are split within its buffer
+		 * @param maxLineLength the max. number of chars per line (buffered streams only)
+		 */
+		LineInputStream(InputStreamPeek* is, const size_t maxLineLength = 64*1024) :
+			is(is), bis(dynamic_cast<BufferedInputStream*>(is)), reader(bis, maxLineLength), lastChar(0) {
 			;
 		}
 
@@ -44,6 +50,13 @@ namespace K {
 		/** read next line from the underlying device */
 		std::string readLine() {
 
+			// buffered input? -> scan the buffer instead of reading byte by byte
+			if (bis) {
+				std::string ret;
+				if (!reader.readLine(ret)) {throw IOException("error while reading next line from stream");}
+				return ret;
+			}
+
 			std::string ret;
 			int byte;
 
@@ -87,6 +100,25 @@ namespace K {
 
 		}
 
+		/**
+		 * read the next line into the given (reusable) string.
+		 * returns false on EOF
+		 */
+		bool readLine(std::string& line) {
+			if (bis) {return reader.readLine(line);}
+			try {line = readLine();} catch (IOException&) {return false;}
+			return true;
+		}
+
+		/**
+		 * read the next line as view into the buffer, valid until the next read.
+		 * returns false on EOF. requires a BufferedInputStream
+		 */
+		bool readLine(LineView& line) {
+			if (!bis) {throw IOException("LineInputStream: views require a BufferedInputStream");}
+			return reader.readLine(line);
+		}
+
 		int read() override {
 			return is->read();
 		}
@@ -109,6 +141,12 @@ namespace K {
 		/** input stream. should be buffered! */
 		InputStreamPeek* is;
 
+		/** the same stream, if it is a BufferedInputStream. nullptr otherwise */
+		BufferedInputStream* bis;
+
+		/** splits the buffered input of "bis" into lines */
+		LineReader reader;
+
 		/** used to detect \r\n */
 		int lastChar;
 
@@ -0,0 +1,174 @@
+#ifndef K_STREAMS_LINEREADER_H
+#define K_STREAMS_LINEREADER_H
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+#include "BufferedInputStream.h"
+#include "IOException.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace K {
+
+	/** a line within the buffer of a LineReader. valid until the next read */
+	struct LineView {
+
+		/** the first char of the line */
+		const char* data;
+
+		/** the number of chars (without the line-break) */
+		size_t len;
+
+		/** ctor */
+		LineView() : data(nullptr), len(0) {;}
+
+		/** ctor */
+		LineView(const char* data, const size_t len) : data(data), len(len) {;}
+
+		/** is the line empty? */
+		bool empty() const {return len == 0;}
+
+		/** get a copy as string */
+		std::string str() const {return std::string(data, len);}
+
+		/** compare with the given string */
+		bool operator == (const std::string& s) const {return s.length() == len && memcmp(s.data(), data, len) == 0;}
+
+	};
+
+	/**
+	 * @brief splits the input of a BufferedInputStream into lines.
+	 *
+	 * the line-breaks are searched within the stream's buffer (16 bytes at
+	 * once using SSE2) and lines are returned as views into this buffer,
+	 * or copied into a reusable string. "\n", "\r\n" and "\r" are supported.
+	 *
+	 * only the line and its line-break are consumed from the stream, thus
+	 * the stream may be used to read the payload afterwards (e.g. HTTP).
+	 */
+	class LineReader {
+
+	private:
+
+		/** the stream to read from */
+		BufferedInputStream* bis;
+
+		/** lines longer than this throw an IOException */
+		size_t maxLineLength;
+
+	public:
+
+		/**
+		 * ctor
+		 * @param bis the stream to read lines from
+		 * @param maxLineLength the max. number of chars per line (protects against endless lines)
+		 */
+		LineReader(BufferedInputStream* bis, const size_t maxLineLength = 64*1024) :
+			bis(bis), maxLineLength(maxLineLength) {
+			;
+		}
+
+		/** get the max. number of chars per line */
+		size_t getMaxLineLength() const {return maxLineLength;}
+
+		/** set the max. number of chars per line */
+		void setMaxLineLength(const size_t len) {maxLineLength = len;}
+
+		/**
+		 * @brief read the next line (without line-break) as view into the stream's buffer.
+		 * the view is valid until the next call to the stream.
+		 * returns false on EOF (no more lines).
+		 * blocks until a line is available
+		 */
+		bool readLine(LineView& line) {
+
+			size_t scanned = 0;
+
+			while (true) {
+
+				// contiguous view of all buffered bytes, at least one more than already scanned (if possible)
+				const RingBufferSpan<const uint8_t> span = bis->getAvailable(scanned + 1);
+
+				// no new bytes?
+				if (span.len <= scanned) {
+					if (!bis->isEOF()) {continue;}
+					if (span.len == 0) {return false;}
+					return take(span, span.len, 0, line);		// last line without line-break
+				}
+
+				// search for the next line-break
+				const uint8_t* pos = findLineBreak(span.data + scanned, span.data + span.len);
+				if (!pos) {
+					scanned = span.len;
+					if (scanned > maxLineLength) {throw IOException("line exceeds the max. line length");}
+					continue;
+				}
+
+				// "\r" at the end of the buffer: fetch one more byte to check for "\r\n"
+				const size_t len = (size_t) (pos - span.data);
+				if (*pos == '\r' && len + 1 == span.len && !bis->isEOF()) {
+					const RingBufferSpan<const uint8_t> more = bis->getAvailable(len + 2);
+					if (more.len < len + 2 && !bis->isEOF()) {scanned = len; continue;}
+					return take(more, len, (more.len > len + 1 && more.data[len + 1] == '\n') ? (2) : (1), line);
+				}
+
+				const size_t lbLen = (*pos == '\r' && len + 1 < span.len && pos[1] == '\n') ? (2) : (1);
+				return take(span, len, lbLen, line);
+
+			}
+
+		}
+
+		/**
+		 * @brief read the next line (without line-break) into the given string.
+		 * reusing the string prevents allocations.
+		 * returns false on EOF (no more lines).
+		 */
+		bool readLine(std::string& line) {
+			LineView view;
+			if (!readLine(view)) {return false;}
+			line.assign(view.data, view.len);
+			return true;
+		}
+
+		/** find the first '\n' or '\r' within [start:end). nullptr if none */
+		static inline const uint8_t* findLineBreak(const uint8_t* start, const uint8_t* end) {
+
+			const uint8_t* p = start;
+
+#if defined(__SSE2__)
+			const __m128i lf = _mm_set1_epi8('\n');
+			const __m128i cr = _mm_set1_epi8('\r');
+			for (; p + 16 <= end; p += 16) {
+				const __m128i v = _mm_loadu_si128((const __m128i*) p);
+				const int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)));
+				if (mask) {return p + __builtin_ctz((unsigned int) mask);}
+			}
+#endif
+
+			for (; p < end; ++p) {
+				if (*p == '\n' || *p == '\r') {return p;}
+			}
+			return nullptr;
+
+		}
+
+	private:
+
+		/** return the first len bytes of the span as line and consume them and the line-break */
+		bool take(const RingBufferSpan<const uint8_t>& span, const size_t len, const size_t lbLen, LineView& line) {
+			if (len > maxLineLength) {throw IOException("line exceeds the max. line length");}
+			line = LineView((const char*) span.data, len);
+			bis->consume(len + lbLen);
+			return true;
+		}
+
+	};
+
+}
+
+#endif // K_STREAMS_LINEREADER_H
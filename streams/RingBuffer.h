@@ -0,0 +1,296 @@
+#ifndef K_STREAMS_RINGBUFFER_H_
+#define K_STREAMS_RINGBUFFER_H_
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+#include "../Exception.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace K {
+
+	/** a contiguous region within a RingBuffer */
+	template <typename T> struct RingBufferSpan {
+
+		/** the first entry */
+		T* data;
+
+		/** the number of entries */
+		size_t len;
+
+		/** ctor */
+		RingBufferSpan(T* data, const size_t len) : data(data), len(len) {;}
+
+		/** is the span empty? */
+		bool empty() const {return len == 0;}
+
+	};
+
+	/**
+	 * @brief FIFO ring buffer providing contiguous read and write spans.
+	 *
+	 * producers ask for a writable span, write directly into it (e.g. using
+	 * a socket's read()) and commit() the number of written entries.
+	 * consumers look at the readable span and consume() what they used.
+	 * nothing is moved unless a span must be contiguous across the wrap-around
+	 * or the buffer grows (doubling, power-of-two capacity).
+	 *
+	 * optionally (linux), the memory is mapped twice, back to back. reads and
+	 * writes across the wrap-around then are contiguous as well, and the
+	 * readable span always covers all used entries.
+	 * if the mapping fails, the buffer silently falls back to plain memory.
+	 *
+	 * only for trivially copyable types.
+	 */
+	template <typename T> class RingBuffer {
+
+		static_assert(std::is_trivially_copyable<T>::value, "RingBuffer requires trivially copyable types");
+
+	private:
+
+		/** the memory (twice the capacity when mirrored) */
+		T* mem;
+
+		/** the number of entries (power of two) */
+		size_t capacity;
+
+		/** index of the first used entry */
+		size_t head;
+
+		/** the number of used entries */
+		size_t used;
+
+		/** should the memory be mirrored? */
+		bool mirror;
+
+		/** is the current memory mirrored? */
+		bool mirrored;
+
+	public:
+
+		/**
+		 * ctor
+		 * @param capacity the initial number of entries (rounded up to a power of two)
+		 * @param mirror map the memory twice for contiguous wrap-around access (linux only)
+		 */
+		RingBuffer(const size_t capacity = 4096, const bool mirror = false) :
+			mem(nullptr), capacity(getPow2(capacity)), head(0), used(0), mirror(mirror), mirrored(false) {
+			mem = allocate(this->capacity, mirrored);
+		}
+
+		/** dtor */
+		~RingBuffer() {
+			release(mem, capacity, mirrored);
+		}
+
+		/** no copies */
+		RingBuffer(const RingBuffer&) = delete;
+		RingBuffer& operator = (const RingBuffer&) = delete;
+
+		/** get the number of used entries */
+		size_t getNumUsed() const {return used;}
+
+		/** get the number of free entries (not necessarily contiguous) */
+		size_t getNumFree() const {return capacity - used;}
+
+		/** get the number of allocated entries */
+		size_t getCapacity() const {return capacity;}
+
+		/** is the buffer currently empty? */
+		bool empty() const {return used == 0;}
+
+		/** is the memory currently mirrored? */
+		bool isMirrored() const {return mirrored;}
+
+		/** remove all entries. the allocated memory remains */
+		void clear() {
+			head = 0;
+			used = 0;
+		}
+
+		/** ensure the buffer can hold at least the given number of entries */
+		void reserve(const size_t numEntries) {
+			if (numEntries > capacity) {reallocate(getPow2(numEntries));}
+		}
+
+		/**
+		 * get the contiguous span of readable entries starting at the oldest one.
+		 * without mirroring, this ends at the wrap-around.
+		 */
+		RingBufferSpan<const T> getReadable() const {
+			const size_t len = (mirrored) ? (used) : (min(used, capacity - head));
+			return RingBufferSpan<const T>(mem + head, len);
+		}
+
+		/**
+		 * get a contiguous span of at least min(minLen, getNumUsed()) readable entries.
+		 * if needed (no mirroring), the entries are moved to make them contiguous.
+		 */
+		RingBufferSpan<const T> getReadable(const size_t minLen) {
+			if (getReadable().len < min(minLen, used)) {reallocate(capacity);}
+			return getReadable();
+		}
+
+		/** remove the given number of entries from the front */
+		void consume(const size_t numEntries) {
+			if (numEntries > used) {throw Exception("out of bounds during RingBuffer.consume()");}
+			used -= numEntries;
+			head = (used == 0) ? (0) : ((head + numEntries) & (capacity - 1));
+		}
+
+		/**
+		 * get a contiguous span of at least minLen writable entries,
+		 * behind the newest entry. grows the buffer if needed.
+		 * use commit() to append what was written.
+		 */
+		RingBufferSpan<T> getWritable(const size_t minLen = 1) {
+			if (getWritableLength() < minLen) {
+				const size_t needed = used + minLen;
+				reallocate((needed <= capacity) ? (capacity) : (getPow2(needed)));
+			}
+			return RingBufferSpan<T>(mem + getTail(), getWritableLength());
+		}
+
+		/** append the given number of entries that were written into getWritable() */
+		void commit(const size_t numEntries) {
+			if (numEntries > getWritableLength()) {throw Exception("out of bounds during RingBuffer.commit()");}
+			used += numEntries;
+		}
+
+		/** append the given entries */
+		void add(const T* elems, const size_t numElems) {
+			const RingBufferSpan<T> span = getWritable(numElems);
+			memcpy(span.data, elems, numElems * sizeof(T));
+			used += numElems;
+		}
+
+		/** append the given entry */
+		void add(const T elem) {
+			*getWritable(1).data = elem;
+			++used;
+		}
+
+		/** get the oldest entry and remove it */
+		T get() {
+			const T ret = mem[head];
+			consume(1);
+			return ret;
+		}
+
+		/** get the oldest entry without removing it */
+		T peek() const {
+			return mem[head];
+		}
+
+		/** copy (and remove) up to len entries into dst. returns the number of copied entries */
+		size_t read(T* dst, const size_t len) {
+			const size_t total = min(len, used);
+			const size_t first = min(total, capacity - head);
+			memcpy(dst, mem + head, first * sizeof(T));
+			memcpy(dst + first, mem, (total - first) * sizeof(T));
+			consume(total);
+			return total;
+		}
+
+		/** access the index-th used entry */
+		T& operator [] (const size_t index) {
+			return mem[(head + index) & (capacity - 1)];
+		}
+
+	private:
+
+		static inline size_t min(const size_t a, const size_t b) {return (a < b) ? (a) : (b);}
+
+		static inline size_t getPow2(const size_t v) {
+			size_t p = 1;
+			while (p < v) {p <<= 1;}
+			return p;
+		}
+
+		/** index behind the newest entry */
+		size_t getTail() const {
+			return (head + used) & (capacity - 1);
+		}
+
+		/** the number of contiguous entries behind the newest entry */
+		size_t getWritableLength() const {
+			if (mirrored) {return capacity - used;}
+			const size_t tail = getTail();
+			return (used != 0 && tail <= head) ? (head - tail) : (capacity - tail);
+		}
+
+		/** allocate new memory, try mirroring if requested. throws without modifying the buffer */
+		T* allocate(const size_t newCapacity, bool& newMirrored) const {
+			T* ptr = nullptr;
+			newMirrored = false;
+			if (mirror) {ptr = allocateMirrored(newCapacity); newMirrored = (ptr != nullptr);}
+			if (!ptr) {ptr = (T*) malloc(newCapacity * sizeof(T));}
+			if (!ptr) {throw Exception("out of memory");}
+			return ptr;
+		}
+
+		/** move all entries to the front of new memory with the given capacity */
+		void reallocate(const size_t newCapacity) {
+			bool newMirrored;
+			T* newMem = allocate(newCapacity, newMirrored);
+			const size_t first = min(used, capacity - head);
+			memcpy(newMem, mem + head, first * sizeof(T));
+			memcpy(newMem + first, mem, (used - first) * sizeof(T));
+			release(mem, capacity, mirrored);
+			mem = newMem;
+			capacity = newCapacity;
+			mirrored = newMirrored;
+			head = 0;
+		}
+
+		static void release(T* ptr, const size_t capacity, const bool mirrored) {
+#if defined(__linux__)
+			if (mirrored) {munmap(ptr, 2 * capacity * sizeof(T)); return;}
+#else
+			(void) capacity; (void) mirrored;
+#endif
+			free(ptr);
+		}
+
+		/** map the same memory twice, back to back. nullptr on error */
+		static T* allocateMirrored(const size_t capacity) {
+
+#if defined(__linux__) && defined(SYS_memfd_create)
+
+			const size_t bytes = capacity * sizeof(T);
+			if (bytes % (size_t) sysconf(_SC_PAGESIZE) != 0) {return nullptr;}
+
+			const int fd = (int) syscall(SYS_memfd_create, "K::RingBuffer", 0);
+			if (fd < 0) {return nullptr;}
+			if (ftruncate(fd, (off_t) bytes) != 0) {::close(fd); return nullptr;}
+
+			// reserve the address range, then map the file into both halves
+			uint8_t* base = (uint8_t*) mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (base == MAP_FAILED) {::close(fd); return nullptr;}
+			const void* a = mmap(base, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+			const void* b = mmap(base + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+			::close(fd);
+			if (a == MAP_FAILED || b == MAP_FAILED) {munmap(base, 2 * bytes); return nullptr;}
+			return (T*) base;
+
+#else
+
+			(void) capacity;
+			return nullptr;
+
+#endif
+
+		}
+
+	};
+
+}
+
+#endif /* K_STREAMS_RINGBUFFER_H_ */
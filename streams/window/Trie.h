@@ -1,6 +1,9 @@
 #ifndef TRIE_H
 #define TRIE_H
 
+#include <deque>
+#include <cstdint>
+
 namespace K {
 
 	class TrieLevel;
@@ -9,7 +12,8 @@ namespace K {
 
 	private:
 
-		std::vector<TrieLevel> entries;
+		/** deque: levels are linked via pointers, which must stay valid when adding */
+		std::deque<TrieLevel> entries;
 
 	public:
 
@@ -77,8 +81,7 @@ namespace K {
 	/** impl */
 	TrieLevel* TrieLevelFactory::get(uint8_t val, uint32_t idx) {
 		entries.push_back(TrieLevel(val, idx));
-		TrieLevel* arr = entries.data();
-		return &arr[entries.size() - 1];
+		return &entries.back();
 	}
 
 
@@ -2,6 +2,7 @@
 #define K_STREAMS_WINDOW_WINDOWBUFFER_H
 
 #include <list>
+#include <vector>
 
 #include <algorithm>
 #include <iostream>
@@ -18,6 +19,11 @@ namespace K {
 	class WindowBuffer {
 
 
+	public:
+
+		/** number of bytes within the window */
+		static constexpr unsigned int SIZE = 1024*1024;
+
 	private:
 
 		unsigned int size;
@@ -28,12 +34,15 @@ namespace K {
 
 		std::list<uint32_t> index[256];
 
+		/** maintain the index? only needed for getLongestMatch() */
+		bool indexed;
+
 		int debug = 1;
 
 	public:
 
 		/** ctor */
-		WindowBuffer() : size(1024*1024), head(0) {
+		WindowBuffer(const bool indexed = true) : size(SIZE), head(0), indexed(indexed) {
 
 			buf = new uint8_t[size];
 
@@ -60,6 +69,12 @@ namespace K {
 
 			const uint32_t maxEntries = 128;
 
+			if (!indexed) {
+				buf[head] = byte;
+				head = (head + 1) % size;
+				return;
+			}
+
 			remove(head);
 			if (debug >= 2) {std::cout << "\tadding " << (int) byte << " to index " << head << std::endl;}
 			buf[head] = byte;
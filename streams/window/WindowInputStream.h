@@ -23,7 +23,7 @@ namespace K {
 	public:
 
 		/** ctor */
-		WindowInputStream(InputStream* is) : is(is) {
+		WindowInputStream(InputStream* is) : buf(false), is(is) {
 
 		}
 
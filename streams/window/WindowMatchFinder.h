@@ -0,0 +1,179 @@
+#ifndef K_STREAMS_WINDOW_WINDOWMATCHFINDER_H
+#define K_STREAMS_WINDOW_WINDOWMATCHFINDER_H
+
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+namespace K {
+
+	/** a match within the history: its position (relative to the finder's buffer) and length */
+	struct WindowHashMatch {
+		uint32_t pos;
+		uint32_t len;
+		WindowHashMatch() : pos(0), len(0) {;}
+		WindowHashMatch(const uint32_t pos, const uint32_t len) : pos(pos), len(len) {;}
+	};
+
+	/**
+	 * @brief LZ77 match finder using hash chains.
+	 *
+	 * the first MIN_LEN bytes of every position are hashed. "head" holds the
+	 * most recent position per hash, "prev" links each position to the previous
+	 * one with the same hash. searching a match walks this chain up to
+	 * maxChain entries, newest first, instead of all prior positions.
+	 *
+	 * the finder holds the history (max. windowSize bytes) and the lookahead
+	 * within one linear buffer of twice the window size. once full, the older
+	 * half is dropped and all positions are rebased (as done by zlib).
+	 */
+	class WindowMatchFinder {
+
+	public:
+
+		/** number of bytes to hash = min. length of a match */
+		static constexpr uint32_t MIN_LEN = 4;
+
+		/** marks an empty chain entry. an enum, as it is passed by reference (no out-of-class definition needed) */
+		enum : uint32_t {NONE = 0xFFFFFFFF};
+
+	private:
+
+		static constexpr int HASH_BITS = 16;
+
+		/** max. distance of a match (power of two) */
+		const uint32_t windowSize;
+
+		/** max. length of a match */
+		const uint32_t maxLen;
+
+		/** max. number of chain entries to check per search */
+		const uint32_t maxChain;
+
+		/** history and lookahead */
+		std::vector<uint8_t> buf;
+
+		/** number of used bytes within buf */
+		uint32_t used;
+
+		/** the next position to add to the hash chains */
+		uint32_t inserted;
+
+		/** number of bytes dropped from the front of buf */
+		uint64_t offset;
+
+		std::vector<uint32_t> head;
+		std::vector<uint32_t> prev;
+
+	public:
+
+		/**
+		 * ctor
+		 * @param windowSize max. distance of a match, must be a power of two
+		 * @param maxLen max. length of a match
+		 * @param maxChain max. number of candidates to check per search
+		 */
+		WindowMatchFinder(const uint32_t windowSize, const uint32_t maxLen, const uint32_t maxChain = 16) :
+			windowSize(windowSize), maxLen(maxLen), maxChain(maxChain),
+			buf(2 * windowSize), used(0), inserted(0), offset(0),
+			head(1 << HASH_BITS, NONE), prev(windowSize, NONE) {
+			;
+		}
+
+		/** number of bytes that can be appended without sliding */
+		uint32_t getFree() const {return (uint32_t) buf.size() - used;}
+
+		/** append data to the lookahead. at most getFree() bytes */
+		void append(const uint8_t* data, const uint32_t len) {
+			memcpy(buf.data() + used, data, len);
+			used += len;
+		}
+
+		/** drop the older half of the buffer. all positions before "pos" must be processed */
+		void slide(uint32_t& pos) {
+			if (pos < windowSize || inserted < windowSize) {return;}
+			memmove(buf.data(), buf.data() + windowSize, used - windowSize);
+			used -= windowSize;
+			pos -= windowSize;
+			inserted -= windowSize;
+			offset += windowSize;
+			for (uint32_t& v : head) {v = (v == NONE || v < windowSize) ? (NONE) : (v - windowSize);}
+			for (uint32_t& v : prev) {v = (v == NONE || v < windowSize) ? (NONE) : (v - windowSize);}
+		}
+
+		/** number of used bytes (history and lookahead) */
+		uint32_t getUsed() const {return used;}
+
+		/** the byte at the given position */
+		uint8_t get(const uint32_t pos) const {return buf[pos];}
+
+		/** the absolute stream position of the given buffer position */
+		uint64_t getAbsolute(const uint32_t pos) const {return offset + pos;}
+
+		/**
+		 * @brief find the longest match for the bytes starting at pos.
+		 * the match lies completely before pos (no overlap) and is at most
+		 * windowSize-1 bytes away. len is 0 if nothing (>= MIN_LEN) was found
+		 */
+		WindowHashMatch find(const uint32_t pos) {
+
+			insertUntil(pos);
+
+			WindowHashMatch best;
+			const uint32_t avail = std::min(maxLen, used - pos);
+			if (avail < MIN_LEN) {return best;}
+
+			const uint8_t* cur = buf.data() + pos;
+			uint32_t cand = head[hash(cur)];
+
+			for (uint32_t chain = 0; chain < maxChain && cand != NONE; ++chain) {
+
+				const uint32_t dist = pos - cand;
+				if (dist >= windowSize) {break;}
+
+				// the decoder can not copy bytes it has not yet seen
+				const uint32_t limit = std::min(avail, dist);
+
+				// quick reject: must at least improve the current best
+				const uint8_t* ref = buf.data() + cand;
+				if (limit > best.len && ref[best.len] == cur[best.len] && ref[0] == cur[0]) {
+					uint32_t len = 0;
+					while (len < limit && ref[len] == cur[len]) {++len;}
+					if (len > best.len) {
+						best = WindowHashMatch(cand, len);
+						if (len == avail) {break;}
+					}
+				}
+
+				cand = prev[cand & (windowSize - 1)];
+
+			}
+
+			if (best.len < MIN_LEN) {best.len = 0;}
+			return best;
+
+		}
+
+		/** add all positions before the given one to the hash chains */
+		void insertUntil(const uint32_t pos) {
+			for (; inserted < pos && inserted + MIN_LEN <= used; ++inserted) {
+				const uint32_t h = hash(buf.data() + inserted);
+				prev[inserted & (windowSize - 1)] = head[h];
+				head[h] = inserted;
+			}
+		}
+
+	private:
+
+		static inline uint32_t hash(const uint8_t* p) {
+			uint32_t v;
+			memcpy(&v, p, 4);
+			return (v * 2654435761U) >> (32 - HASH_BITS);
+		}
+
+	};
+
+}
+
+#endif // K_STREAMS_WINDOW_WINDOWMATCHFINDER_H
@@ -3,37 +3,91 @@
 
 #include "../../streams/OutputStream.h"
 #include "WindowBuffer.h"
+#include "WindowMatchFinder.h"
 #include "../dict/DictHelper.h"
 
 namespace K {
 
+	/** how WindowOutputStream searches for matches */
+	enum class WindowMatcher {
+
+		/** compare against every prior position starting with the same byte (WindowBuffer) */
+		INDEX_LIST,
+
+		/** hash chains with bounded depth and lazy matching (WindowMatchFinder) */
+		HASH_CHAIN,
+
+	};
+
 	class WindowOutputStream : public OutputStream {
 
 	private:
 
+		/** max. length of a match (stored as one byte) */
+		static constexpr uint32_t MAX_LEN = 255;
+
+		/** matches at least this long are taken without checking the next position */
+		static constexpr uint32_t LAZY_LEN = 32;
+
 		WindowBuffer buf;
 
 		OutputStream* os;
 
 		std::vector<uint8_t> curWord;
 
+		WindowMatcher matcher;
+
+		/** HASH_CHAIN: the finder and the next position to encode */
+		WindowMatchFinder finder;
+		uint32_t pos;
+
+		/** HASH_CHAIN: check whether the next position yields a longer match */
+		bool lazy;
+
+		/** HASH_CHAIN: the match for "pos", found by the lazy check */
+		WindowHashMatch cached;
+		bool hasCached;
+
 	public:
 
-		/** ctor */
-		WindowOutputStream(OutputStream* os) : os(os) {;}
+		/**
+		 * ctor
+		 * @param os the stream to write to
+		 * @param matcher how to search for matches
+		 * @param lazy use lazy matching (HASH_CHAIN only)
+		 * @param maxChain max. number of candidates to check per position (HASH_CHAIN only)
+		 */
+		WindowOutputStream(OutputStream* os, const WindowMatcher matcher = WindowMatcher::HASH_CHAIN, const bool lazy = true, const uint32_t maxChain = 16) :
+			buf(matcher == WindowMatcher::INDEX_LIST), os(os), matcher(matcher),
+			finder((matcher == WindowMatcher::HASH_CHAIN) ? (WindowBuffer::SIZE) : (1), MAX_LEN, maxChain),
+			pos(0), lazy(lazy), hasCached(false) {
+			;
+		}
 
 		void write(uint8_t data) override {
+			if (matcher == WindowMatcher::HASH_CHAIN) {write(&data, 1); return;}
 			curWord.push_back(data);
 			send(false);
 		}
 
 		void write(const uint8_t* data, const size_t len) override {
+			if (matcher == WindowMatcher::HASH_CHAIN) {
+				for (size_t done = 0; done < len; ) {
+					if (finder.getFree() == 0) {finder.slide(pos); hasCached = false;}
+					const uint32_t cnt = (uint32_t) std::min(len - done, (size_t) finder.getFree());
+					finder.append(data + done, cnt);
+					done += cnt;
+					encode(false);
+				}
+				return;
+			}
 			for (uint32_t i = 0; i < len; ++i) {
 				write(data[i]);
 			}
 		}
 
 		void close() override {
+			if (matcher == WindowMatcher::HASH_CHAIN) {encode(true); return;}
 			if (!curWord.empty()) {send(true);}
 			buf.dump();
 		}
@@ -44,6 +98,60 @@ namespace K {
 
 	private:
 
+		/** encode the lookahead. keeps enough bytes for the longest match unless final */
+		void encode(const bool final) {
+
+			const uint32_t lookahead = MAX_LEN + WindowMatchFinder::MIN_LEN + 1;
+
+			while (pos < finder.getUsed() && (final || finder.getUsed() - pos >= lookahead)) {
+
+				const WindowHashMatch m = (hasCached) ? (cached) : (getMatch(pos));
+				hasCached = false;
+
+				if (m.len == 0) {
+					sendLiteral();
+					continue;
+				}
+
+				// lazy: a longer match at the next position? -> emit one literal and take that one
+				if (lazy && m.len < LAZY_LEN) {
+					const WindowHashMatch next = getMatch(pos + 1);
+					if (next.len > m.len) {
+						sendLiteral();
+						cached = next;
+						hasCached = true;
+						continue;
+					}
+				}
+
+				DictHelper::writeVarLength(os, getWindowIndex(m) + 256);
+				os->write((uint8_t) m.len);
+				pos += m.len;
+
+			}
+
+		}
+
+		void sendLiteral() {
+			DictHelper::writeVarLength(os, finder.get(pos));
+			++pos;
+		}
+
+		/** the index of the match within the decoder's WindowBuffer */
+		uint32_t getWindowIndex(const WindowHashMatch& m) const {
+			return (uint32_t) (finder.getAbsolute(m.pos) % WindowBuffer::SIZE);
+		}
+
+		/** the match for the given position, if it needs fewer bytes than the literals */
+		WindowHashMatch getMatch(const uint32_t p) {
+			WindowHashMatch m = finder.find(p);
+			if (m.len == 0) {return m;}
+			const uint32_t idx = getWindowIndex(m) + 256;
+			const uint32_t cost = ((idx <= 0x7F) ? (1) : (idx <= 0x3FFF) ? (2) : (3)) + 1;
+			if (m.len <= cost) {m.len = 0;}
+			return m;
+		}
+
 		void send(bool flush) {
 
 			WindowMatch wm = buf.getLongestMatch(curWord);
@@ -0,0 +1,370 @@
+#ifndef K_STRING_NUMBERFORMAT_H
+#define K_STRING_NUMBERFORMAT_H
+
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+
+namespace K {
+
+	/**
+	 * @brief fast number to text conversion (locale independent, not null-terminated).
+	 *
+	 * integers are written two digits at once. doubles are written with the
+	 * fewest digits that read back into the same value (shortest round-trip).
+	 * the digits are generated by Grisu3, for the few values Grisu3 can not
+	 * decide (~0.5%) the shortest correctly rounded printf output is used.
+	 */
+	class NumberFormat {
+
+	public:
+
+		/** max. number of chars written for an integer */
+		static constexpr int MAX_INT_LEN = 20;
+
+		/** max. number of chars written for a double */
+		static constexpr int MAX_DOUBLE_LEN = 32;
+
+		/** write the given value into buf. returns the number of chars */
+		static inline int format(uint64_t v, char* buf) {
+
+			static const char* pairs =
+				"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+				"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+				"8081828384858687888990919293949596979899";
+
+			char tmp[MAX_INT_LEN];
+			int pos = MAX_INT_LEN;
+			while (v >= 100) {
+				const uint32_t r = (uint32_t) (v % 100);
+				v /= 100;
+				pos -= 2;
+				memcpy(tmp + pos, pairs + 2 * r, 2);
+			}
+			if (v >= 10)	{pos -= 2; memcpy(tmp + pos, pairs + 2 * v, 2);}
+			else			{tmp[--pos] = (char) ('0' + v);}
+
+			memcpy(buf, tmp + pos, MAX_INT_LEN - pos);
+			return MAX_INT_LEN - pos;
+
+		}
+
+		/** write the given value into buf. returns the number of chars */
+		static inline int format(const int64_t v, char* buf) {
+			if (v >= 0) {return format((uint64_t) v, buf);}
+			buf[0] = '-';
+			return 1 + format((uint64_t) 0 - (uint64_t) v, buf + 1);
+		}
+
+		/**
+		 * write the given value into buf using the fewest digits that round-trip.
+		 * fixed notation for 1e-6 <= |v| < 1e21 (always with a '.', e.g. "1.0"), else "1.5e300".
+		 * returns the number of chars
+		 */
+		static inline int format(const double v, char* buf) {
+
+			if (v != v) {memcpy(buf, "NaN", 3); return 3;}
+
+			char* p = buf;
+			if (std::signbit(v)) {*p++ = '-';}
+			const double a = std::fabs(v);
+			if (std::isinf(a))	{memcpy(p, "Infinity", 8); return (int) (p - buf) + 8;}
+			if (a == 0)			{memcpy(p, "0.0", 3); return (int) (p - buf) + 3;}
+
+			char digits[18];
+			int exp10;
+			const int n = shortest(a, digits, exp10);
+			return (int) (p - buf) + layout(digits, n, exp10, p);
+
+		}
+
+		/**
+		 * get the shortest digits for the given (finite, positive) value: v = digits * 10^exp10.
+		 * returns the number of digits (<= 17)
+		 */
+		static inline int shortest(const double v, char* digits, int& exp10) {
+
+			int len;
+			if (grisu3(v, digits, len, exp10)) {return len;}
+
+			// fallback: the correctly rounded output with the fewest digits that round-trips
+			char tmp[40];
+			for (int prec = 1; prec <= 17; ++prec) {
+				snprintf(tmp, sizeof(tmp), "%.*e", prec - 1, v);
+				if (strtod(tmp, nullptr) == v) {break;}
+			}
+
+			// d[.ddd]e[+-]xx
+			len = 0;
+			const char* s = tmp;
+			for (; *s != 'e'; ++s) {
+				if (*s >= '0' && *s <= '9') {digits[len++] = *s;}
+			}
+			exp10 = atoi(s + 1) - (len - 1);
+			while (len > 1 && digits[len - 1] == '0') {--len; ++exp10;}
+			return len;
+
+		}
+
+	private:
+
+		/** "do-it-yourself floating point": f * 2^e */
+		struct DiyFp {
+
+			uint64_t f;
+			int e;
+
+			DiyFp() : f(0), e(0) {;}
+			DiyFp(const uint64_t f, const int e) : f(f), e(e) {;}
+
+			/** shift until the highest bit is set */
+			DiyFp normalized() const {
+				DiyFp res = *this;
+				while (!(res.f & (1ULL << 63))) {res.f <<= 1; --res.e;}
+				return res;
+			}
+
+			/** the upper 64 bits of the product (rounded) */
+			DiyFp operator * (const DiyFp& o) const {
+				const uint64_t M32 = 0xFFFFFFFFu;
+				const uint64_t a = f >> 32, b = f & M32, c = o.f >> 32, d = o.f & M32;
+				const uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+				const uint64_t tmp = (bd >> 32) + (ad & M32) + (bc & M32) + (1ULL << 31);
+				return DiyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), e + o.e + 64);
+			}
+
+		};
+
+		/** a normalized power of ten: 10^k ~ f * 2^e */
+		struct CachedPower {
+			uint64_t f;
+			int e;
+			int k;
+		};
+
+		static constexpr int ALPHA = -60;
+		static constexpr int GAMMA = -32;
+		static constexpr int CACHED_MIN_K = -348;
+		static constexpr int CACHED_STEP_K = 8;
+		static constexpr int CACHED_NUM = 87;
+
+		/** 10^k for k = -348, -340, ..., 340. computed once using exact big integer arithmetic */
+		static const CachedPower* getCachedPowers() {
+			static const std::vector<CachedPower> powers = buildCachedPowers();
+			return powers.data();
+		}
+
+		static std::vector<CachedPower> buildCachedPowers() {
+
+			std::vector<CachedPower> res;
+
+			for (int i = 0; i < CACHED_NUM; ++i) {
+
+				CachedPower cp;
+				cp.k = CACHED_MIN_K + i * CACHED_STEP_K;
+
+				// little endian big integer
+				std::vector<uint32_t> n;
+				int shift = 0;
+
+				if (cp.k >= 0) {
+					n.push_back(1);
+					for (int j = 0; j < cp.k; ++j) {mul10(n);}
+				} else {
+					// floor(2^shift / 10^-k) with enough bits for rounding
+					shift = (int) (-cp.k * 3.3219280948873623) + 1 + 64 + 32;
+					n.resize(shift / 32 + 1, 0);
+					n.back() = 1u << (shift % 32);
+					for (int j = 0; j < -cp.k; ++j) {div10(n);}
+				}
+
+				// the upper 64 bits, rounded
+				int bits = (int) n.size() * 32;
+				while (!getBit(n, bits - 1)) {--bits;}
+				cp.f = 0;
+				for (int b = 0; b < 64; ++b) {
+					const int idx = bits - 1 - b;
+					cp.f = (cp.f << 1) | ((idx >= 0) ? getBit(n, idx) : 0);
+				}
+				cp.e = bits - 64 - shift;
+				if (bits > 64 && getBit(n, bits - 65)) {
+					if (++cp.f == 0) {cp.f = 1ULL << 63; ++cp.e;}
+				}
+
+				res.push_back(cp);
+
+			}
+
+			return res;
+
+		}
+
+		static inline uint32_t getBit(const std::vector<uint32_t>& n, const int idx) {
+			return (n[idx / 32] >> (idx % 32)) & 1;
+		}
+
+		static inline void mul10(std::vector<uint32_t>& n) {
+			uint64_t carry = 0;
+			for (uint32_t& w : n) {
+				const uint64_t v = (uint64_t) w * 10 + carry;
+				w = (uint32_t) v;
+				carry = v >> 32;
+			}
+			if (carry) {n.push_back((uint32_t) carry);}
+		}
+
+		static inline void div10(std::vector<uint32_t>& n) {
+			uint64_t rem = 0;
+			for (size_t i = n.size(); i-- > 0; ) {
+				const uint64_t v = (rem << 32) | n[i];
+				n[i] = (uint32_t) (v / 10);
+				rem = v % 10;
+			}
+		}
+
+		/** the cached power c such that ALPHA <= c.e + e + 64 <= GAMMA */
+		static inline const CachedPower& getCachedPower(const int e) {
+			const int minExp = ALPHA - (e + 64);
+			const int k = (int) std::ceil((minExp + 64 - 1) * 0.30102999566398114);
+			int idx = (-CACHED_MIN_K + k - 1) / CACHED_STEP_K + 1;
+			const CachedPower* powers = getCachedPowers();
+			while (idx > 0 && powers[idx].e + e + 64 > GAMMA) {--idx;}
+			while (idx < CACHED_NUM - 1 && powers[idx].e + e + 64 < ALPHA) {++idx;}
+			return powers[idx];
+		}
+
+		/** shortest digits using Grisu3. returns false if the result is not guaranteed to be shortest and correct */
+		static bool grisu3(const double v, char* digits, int& len, int& exp10) {
+
+			uint64_t bits;
+			memcpy(&bits, &v, 8);
+			const uint64_t fraction = bits & ((1ULL << 52) - 1);
+			const int biased = (int) ((bits >> 52) & 0x7FF);
+
+			// v = f * 2^e
+			const DiyFp w = (biased == 0) ? (DiyFp(fraction, -1074)) : (DiyFp(fraction | (1ULL << 52), biased - 1075));
+
+			// the boundaries to the neighboring doubles. the lower one is closer for powers of two
+			const DiyFp plus = DiyFp((w.f << 1) + 1, w.e - 1).normalized();
+			DiyFp minus = (fraction == 0 && biased > 1) ? (DiyFp((w.f << 2) - 1, w.e - 2)) : (DiyFp((w.f << 1) - 1, w.e - 1));
+			minus.f <<= (minus.e - plus.e);
+			minus.e = plus.e;
+
+			const DiyFp wn = w.normalized();
+			const CachedPower& cp = getCachedPower(wn.e);
+			const DiyFp c(cp.f, cp.e);
+
+			int kappa;
+			const bool ok = digitGen(minus * c, wn * c, plus * c, digits, len, kappa);
+			exp10 = kappa - cp.k;
+			return ok;
+
+		}
+
+		/** generate the digits of the scaled value, as few as possible within the boundaries */
+		static bool digitGen(const DiyFp low, const DiyFp w, const DiyFp high, char* digits, int& len, int& kappa) {
+
+			uint64_t unit = 1;
+			const DiyFp tooLow(low.f - unit, low.e);
+			const DiyFp tooHigh(high.f + unit, high.e);
+			uint64_t unsafe = tooHigh.f - tooLow.f;
+
+			const int shift = -w.e;
+			const uint64_t one = 1ULL << shift;
+			uint32_t integrals = (uint32_t) (tooHigh.f >> shift);
+			uint64_t fractionals = tooHigh.f & (one - 1);
+
+			// the largest power of ten <= integrals
+			uint32_t divisor = 0;
+			kappa = 0;
+			if (integrals) {
+				divisor = 1; kappa = 1;
+				while ((uint64_t) divisor * 10 <= integrals) {divisor *= 10; ++kappa;}
+			}
+
+			len = 0;
+			while (kappa > 0) {
+				digits[len++] = (char) ('0' + integrals / divisor);
+				integrals %= divisor;
+				--kappa;
+				const uint64_t rest = ((uint64_t) integrals << shift) + fractionals;
+				if (rest < unsafe) {
+					return roundWeed(digits, len, tooHigh.f - w.f, unsafe, rest, (uint64_t) divisor << shift, unit);
+				}
+				divisor /= 10;
+			}
+
+			while (true) {
+				fractionals *= 10;
+				unit *= 10;
+				unsafe *= 10;
+				digits[len++] = (char) ('0' + (fractionals >> shift));
+				fractionals &= one - 1;
+				--kappa;
+				if (fractionals < unsafe) {
+					return roundWeed(digits, len, (tooHigh.f - w.f) * unit, unsafe, fractionals, one, unit);
+				}
+			}
+
+		}
+
+		/** move the last digit towards the exact value. returns false if the result can not be guaranteed */
+		static bool roundWeed(char* digits, const int len, const uint64_t distTooHighW, const uint64_t unsafe,
+							  uint64_t rest, const uint64_t tenKappa, const uint64_t unit) {
+
+			const uint64_t smallDist = distTooHighW - unit;
+			const uint64_t bigDist = distTooHighW + unit;
+
+			while (rest < smallDist && unsafe - rest >= tenKappa &&
+				   (rest + tenKappa < smallDist || smallDist - rest >= rest + tenKappa - smallDist)) {
+				--digits[len - 1];
+				rest += tenKappa;
+			}
+
+			if (rest < bigDist && unsafe - rest >= tenKappa &&
+				(rest + tenKappa < bigDist || bigDist - rest > rest + tenKappa - bigDist)) {
+				return false;
+			}
+
+			return (2 * unit <= rest) && (rest <= unsafe - 4 * unit);
+
+		}
+
+		/** fixed or scientific notation for digits * 10^exp10 */
+		static inline int layout(const char* d, const int n, const int exp10, char* out) {
+
+			// number of digits before the decimal point
+			const int p = n + exp10;
+			char* o = out;
+
+			if (exp10 >= 0 && p <= 21) {
+				memcpy(o, d, n); o += n;
+				memset(o, '0', exp10); o += exp10;
+				*o++ = '.'; *o++ = '0';
+			} else if (p > 0 && p <= 21) {
+				memcpy(o, d, p); o += p;
+				*o++ = '.';
+				memcpy(o, d + p, n - p); o += n - p;
+			} else if (p > -6 && p <= 0) {
+				*o++ = '0'; *o++ = '.';
+				memset(o, '0', -p); o += -p;
+				memcpy(o, d, n); o += n;
+			} else {
+				*o++ = d[0];
+				if (n > 1) {*o++ = '.'; memcpy(o, d + 1, n - 1); o += n - 1;}
+				*o++ = 'e';
+				o += format((int64_t) (p - 1), o);
+			}
+
+			return (int) (o - out);
+
+		}
+
+	};
+
+}
+
+#endif // K_STRING_NUMBERFORMAT_H
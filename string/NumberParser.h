@@ -0,0 +1,131 @@
+#ifndef K_STRING_NUMBERPARSER_H
+#define K_STRING_NUMBERPARSER_H
+
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+
+namespace K {
+
+	/**
+	 * @brief fast text to number conversion on [begin:end) ranges (like std::from_chars).
+	 *
+	 * no null-termination, no copies and no allocations. every parse returns
+	 * the position after the number or nullptr if there is no valid number.
+	 *
+	 * doubles use an exact fast path when the mantissa fits into 53 bits and
+	 * the power of ten is <= 22 (one correctly rounded multiplication or
+	 * division), all others are passed to strtod.
+	 */
+	class NumberParser {
+
+	public:
+
+		/** parse [+-]digits[.digits][(e|E)[+-]digits] */
+		static inline const char* parse(const char* p, const char* end, double& res) {
+
+			static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+										   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+			const char* start = p;
+			bool neg = false;
+			if (p < end && (*p == '-' || *p == '+')) {neg = (*p == '-'); ++p;}
+
+			// up to 19 significant digits fit into the mantissa
+			uint64_t mantissa = 0;
+			int digits = 0;
+			int exp10 = 0;
+			bool any = false;
+			for (; p < end && isDigit(*p); ++p) {
+				any = true;
+				if (digits < 19)	{mantissa = mantissa * 10 + (uint64_t) (*p - '0'); if (mantissa) {++digits;}}
+				else				{++exp10;}
+			}
+			if (p < end && *p == '.') {
+				for (++p; p < end && isDigit(*p); ++p) {
+					any = true;
+					if (digits < 19) {mantissa = mantissa * 10 + (uint64_t) (*p - '0'); if (mantissa) {++digits;} --exp10;}
+				}
+			}
+			if (!any) {return nullptr;}
+
+			// the exponent is only consumed if it contains digits
+			if (p < end && (*p == 'e' || *p == 'E')) {
+				const char* e = p + 1;
+				bool negExp = false;
+				if (e < end && (*e == '-' || *e == '+')) {negExp = (*e == '-'); ++e;}
+				if (e < end && isDigit(*e)) {
+					int val = 0;
+					for (; e < end && isDigit(*e); ++e) {
+						if (val < 100000) {val = val * 10 + (*e - '0');}
+					}
+					exp10 += (negExp) ? (-val) : (val);
+					p = e;
+				}
+			}
+
+			if (mantissa == 0) {
+				res = (neg) ? (-0.0) : (0.0);
+			} else if (mantissa <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22) {
+				res = (double) mantissa;
+				res = (exp10 < 0) ? (res / pow10[-exp10]) : (res * pow10[exp10]);
+				if (neg) {res = -res;}
+			} else {
+				res = slowPath(start, p);
+			}
+
+			return p;
+
+		}
+
+		/** parse a float (via double). res is unchanged on errors */
+		static inline const char* parse(const char* p, const char* end, float& res) {
+			double d;
+			p = parse(p, end, d);
+			if (p) {res = (float) d;}
+			return p;
+		}
+
+		/** parse [+-]digits */
+		static inline const char* parse(const char* p, const char* end, int64_t& res) {
+			bool neg = false;
+			if (p < end && (*p == '-' || *p == '+')) {neg = (*p == '-'); ++p;}
+			if (p >= end || !isDigit(*p)) {return nullptr;}
+			uint64_t v = 0;
+			for (; p < end && isDigit(*p); ++p) {v = v * 10 + (uint64_t) (*p - '0');}
+			res = (neg) ? ((int64_t) (0 - v)) : ((int64_t) v);
+			return p;
+		}
+
+		/** parse [+-]digits */
+		static inline const char* parse(const char* p, const char* end, int32_t& res) {
+			int64_t v;
+			p = parse(p, end, v);
+			if (p) {res = (int32_t) v;}
+			return p;
+		}
+
+	private:
+
+		static inline bool isDigit(const char c) {
+			return c >= '0' && c <= '9';
+		}
+
+		/** strtod needs a null-terminated copy */
+		static double slowPath(const char* start, const char* end) {
+			const size_t len = (size_t) (end - start);
+			char tmp[64];
+			if (len < sizeof(tmp)) {
+				memcpy(tmp, start, len);
+				tmp[len] = 0;
+				return strtod(tmp, nullptr);
+			}
+			return strtod(std::string(start, len).c_str(), nullptr);
+		}
+
+	};
+
+}
+
+#endif // K_STRING_NUMBERPARSER_H
@@ -0,0 +1,214 @@
+
+
+#ifdef WITH_TESTS
+
+#include "../Test.h"
+#include "../../cv/BitmapPacked.h"
+#include "../../cv/filter/Dilate.h"
+#include "../../cv/segmentation/Segmentation.h"
+#include "../../os/Time.h"
+#include <cstdlib>
+using namespace K;
+
+static BitmapPacked getRandomBitmap(const int w, const int h, const int percent) {
+	BitmapPacked bmp(w, h);
+	for (int y = 0; y < h; ++y) {
+		for (int x = 0; x < w; ++x) {
+			if (rand() % 100 < percent) {bmp.set(x,y);}
+		}
+	}
+	return bmp;
+}
+
+/** brute-force dilation using the given structuring element */
+static BitmapPacked dilateRef(const BitmapPacked& bmp, const std::vector<int>& ext) {
+	const int r = (int) ext.size() / 2;
+	BitmapPacked out(bmp.getWidth(), bmp.getHeight());
+	for (int y = 0; y < bmp.getHeight(); ++y) {
+		for (int x = 0; x < bmp.getWidth(); ++x) {
+			if (!bmp.isSet(x,y)) {continue;}
+			for (int dy = -r; dy <= r; ++dy) {
+				for (int dx = -ext[dy+r]; dx <= ext[dy+r]; ++dx) {
+					const int x1 = x+dx;
+					const int y1 = y+dy;
+					if (x1 >= 0 && y1 >= 0 && x1 < bmp.getWidth() && y1 < bmp.getHeight()) {out.set(x1, y1);}
+				}
+			}
+		}
+	}
+	return out;
+}
+
+TEST(BitmapPacked, access) {
+
+	BitmapPacked bmp(130, 3);
+	ASSERT_EQ(3, bmp.getWordsPerRow());
+	ASSERT_EQ(0, bmp.count());
+
+	bmp.set(0,0);
+	bmp.set(63,0);
+	bmp.set(64,1);
+	bmp.set(129,2);
+	ASSERT_TRUE(bmp.isSet(63,0));
+	ASSERT_FALSE(bmp.isSet(64,0));
+	ASSERT_TRUE(bmp.isSet(64,1));
+	ASSERT_EQ(4, bmp.count());
+	ASSERT_EQ(2, bmp.count(0));
+
+	bmp.clear(63,0);
+	ASSERT_EQ(3, bmp.count());
+
+	// padding bits remain cleared
+	bmp.invert();
+	ASSERT_EQ(130*3-3, bmp.count());
+	bmp.setAll();
+	ASSERT_EQ(130*3, bmp.count());
+
+	// conversions
+	ImageChannel img(70, 2);
+	img.set(5, 0, 1.0f);
+	img.set(69, 1, 0.7f);
+	img.set(68, 1, 0.2f);
+	const BitmapPacked bmp2(img);
+	ASSERT_EQ(2, bmp2.count());
+	ASSERT_TRUE(bmp2.isSet(69,1));
+	const Bitmap unpacked = bmp2.toBitmap();
+	ASSERT_TRUE(unpacked.isSet(5,0));
+	ASSERT_FALSE(unpacked.isSet(68,1));
+	ASSERT_TRUE(BitmapPacked(unpacked) == bmp2);
+
+}
+
+TEST(BitmapPacked, boolean) {
+
+	const BitmapPacked a = getRandomBitmap(100, 10, 50);
+	const BitmapPacked b = getRandomBitmap(100, 10, 50);
+
+	BitmapPacked o = a; o |= b;
+	BitmapPacked n = a; n &= b;
+	BitmapPacked x = a; x ^= b;
+
+	for (int y = 0; y < 10; ++y) {
+		for (int i = 0; i < 100; ++i) {
+			ASSERT_EQ(a.isSet(i,y) || b.isSet(i,y), o.isSet(i,y));
+			ASSERT_EQ(a.isSet(i,y) && b.isSet(i,y), n.isSet(i,y));
+			ASSERT_EQ(a.isSet(i,y) != b.isSet(i,y), x.isSet(i,y));
+		}
+	}
+
+}
+
+TEST(BitmapPacked, dilateErode) {
+
+	const BitmapPacked bmp = getRandomBitmap(200, 50, 3);
+
+	// several shapes, including horizontal extents beyond one word
+	const std::vector<std::vector<int>> shapes = {
+		{0, 1, 0},
+		{1, 2, 2, 2, 1},
+		{-1, 3, -1},
+		{70},
+		std::vector<int>(9, 4),
+	};
+
+	for (const std::vector<int>& ext : shapes) {
+		ASSERT_TRUE(dilateRef(bmp, ext) == bmp.dilate(ext));
+	}
+
+	// erosion is the dual of dilation
+	BitmapPacked inv = bmp.dilateSquare(2);
+	const BitmapPacked ero = inv.erodeSquare(1);
+	inv.invert();
+	BitmapPacked ref = inv.dilateSquare(1);
+	ref.invert();
+	ASSERT_TRUE(ref == ero);
+
+	// eroding a single block
+	BitmapPacked block(10, 10);
+	for (int y = 2; y < 7; ++y) {for (int x = 2; x < 7; ++x) {block.set(x,y);}}
+	ASSERT_EQ(9, block.erodeSquare(1).count());
+	ASSERT_EQ(1, block.erodeDiamond(2).count());
+
+	// the shapes of Dilate
+	BitmapPacked dot(11, 11);
+	dot.set(5,5);
+	ASSERT_EQ(5, Dilate::apply(dot, 1, Dilate::SQUARE_45).count());
+	ASSERT_EQ(13, Dilate::apply(dot, 2, Dilate::SQUARE_45).count());
+	ASSERT_EQ(21, Dilate::apply(dot, 2, Dilate::CIRCLE).count());
+	ASSERT_EQ(25, Dilate::apply(dot, 3, Dilate::SQUARE_45).count());
+	ASSERT_EQ(29, Dilate::apply(dot, 3, Dilate::CIRCLE).count());
+	ASSERT_TRUE(dot == Dilate::erode(Dilate::apply(dot, 2, Dilate::CIRCLE), 2, Dilate::CIRCLE));
+
+}
+
+TEST(BitmapPacked, components) {
+
+	BitmapPacked bmp(130, 4);
+
+	// two runs connected diagonally across a word boundary
+	for (int x = 60; x < 64; ++x) {bmp.set(x,0);}
+	bmp.set(64,1);
+
+	// separated by one pixel
+	bmp.set(66,1);
+
+	// spanning a whole row
+	for (int x = 0; x < 130; ++x) {bmp.set(x,3);}
+
+	std::vector<BitmapRun> runs;
+	ASSERT_EQ(3, bmp.getComponents(runs));
+	ASSERT_EQ(4, runs.size());
+	ASSERT_EQ(60, runs[0].x0);	ASSERT_EQ(64, runs[0].x1);	ASSERT_EQ(0, runs[0].label);
+	ASSERT_EQ(64, runs[1].x0);	ASSERT_EQ(65, runs[1].x1);	ASSERT_EQ(0, runs[1].label);
+	ASSERT_EQ(66, runs[2].x0);	ASSERT_EQ(67, runs[2].x1);	ASSERT_EQ(1, runs[2].label);
+	ASSERT_EQ(0, runs[3].x0);	ASSERT_EQ(130, runs[3].x1);	ASSERT_EQ(2, runs[3].label);
+
+}
+
+TEST(BitmapPacked, segmentation) {
+
+	// compare the run-based labeling against flood-filling
+	const BitmapPacked bmp = getRandomBitmap(90, 40, 40);
+	const ImageChannel img = bmp.toImage();
+
+	const std::vector<Segment<float>> segs = Segmentation::getSegments(img);
+	Bitmap used(img.getWidth(), img.getHeight());
+	const std::vector<Segment<float>> ref = Segmentation::getSegments(img, used, 0.1f);
+
+	ASSERT_EQ(ref.size(), segs.size());
+	for (size_t i = 0; i < ref.size(); ++i) {
+		ASSERT_EQ(ref[i].avg, segs[i].avg);
+		ASSERT_EQ(ref[i].points.size(), segs[i].points.size());
+		ASSERT_EQ(ref[i].calcBBox().getMin(), segs[i].calcBBox().getMin());
+		ASSERT_EQ(ref[i].calcBBox().getMax(), segs[i].calcBBox().getMax());
+	}
+
+}
+
+TEST(BitmapPacked, Benchmark) {
+
+	const BitmapPacked bmp = getRandomBitmap(2048, 2048, 2);
+	const ImageChannel img = bmp.toImage();
+
+	uint64_t start = Time::getTimeMS();
+	const ImageChannel d1 = Dilate::apply(img, 3, Dilate::CIRCLE);
+	std::cout << "dilate (image): " << (Time::getTimeMS() - start) << " ms" << std::endl;
+
+	start = Time::getTimeMS();
+	const BitmapPacked d2 = Dilate::apply(bmp, 3, Dilate::CIRCLE);
+	std::cout << "dilate (packed): " << (Time::getTimeMS() - start) << " ms" << std::endl;
+
+	start = Time::getTimeMS();
+	Bitmap used(img.getWidth(), img.getHeight());
+	const size_t n1 = Segmentation::getSegments(d1, used, 0.1f).size();
+	std::cout << "segments (flood-fill): " << (Time::getTimeMS() - start) << " ms" << std::endl;
+
+	start = Time::getTimeMS();
+	const size_t n2 = Segmentation::getSegments(d2).size();
+	std::cout << "segments (runs): " << (Time::getTimeMS() - start) << " ms" << std::endl;
+
+	ASSERT_EQ(n1 > 0, n2 > 0);
+
+}
+
+#endif
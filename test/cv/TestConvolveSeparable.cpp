@@ -0,0 +1,143 @@
+
+
+#ifdef WITH_TESTS
+
+#include "../Test.h"
+#include "../../cv/KernelFactory.h"
+#include "../../cv/Convolve.h"
+#include "../../cv/ConvolveSeparable.h"
+#include "../../cv/filter/Gauss.h"
+#include "../../os/Time.h"
+#include <cstdlib>
+using namespace K;
+
+static void assertNear(const ImageChannel& a, const ImageChannel& b, const float delta) {
+	ASSERT_EQ(a.getWidth(), b.getWidth());
+	ASSERT_EQ(a.getHeight(), b.getHeight());
+	for (int y = 0; y < a.getHeight(); ++y) {
+		for (int x = 0; x < a.getWidth(); ++x) {
+			ASSERT_NEAR(a.get(x,y), b.get(x,y), delta) << x << ":" << y;
+		}
+	}
+}
+
+TEST(ConvolveSeparable, Separate) {
+
+	// gauss is separable
+	Kernel kH;
+	Kernel kV;
+	Kernel k = KernelFactory::gauss2D(1.5f);
+	ASSERT_TRUE(k.separate(kH, kV));
+	ASSERT_EQ(k.getWidth(), kH.getWidth());		ASSERT_EQ(1, kH.getHeight());
+	ASSERT_EQ(1, kV.getWidth());				ASSERT_EQ(k.getHeight(), kV.getHeight());
+
+	// 1D kernels are always separable
+	ASSERT_TRUE(KernelFactory::gauss1D(2.0f).isSeparable());
+
+	// not separable
+	const float v2[] = {1,0,0, 0,1,0, 0,0,1};
+	Kernel k2(v2, 3, 3);
+	ASSERT_FALSE(k2.isSeparable());
+
+	// empty kernel
+	Kernel k3(3,3);
+	k3.setAll(0);
+	ASSERT_FALSE(k3.isSeparable());
+
+}
+
+TEST(ConvolveSeparable, UnitImpulse) {
+
+	Kernel k = KernelFactory::gauss2D(1.0, 5);
+
+	ImageChannel img(5,5);
+	img.set(2,2,1);
+
+	ImageChannel img2 = ConvolveSeparable(k).run(img);
+	ImageChannel img3 = Convolve::run(img, k);
+	assertNear(img3, img2, 0.00001f);
+
+}
+
+TEST(ConvolveSeparable, EqualsConvolve) {
+
+	// different sizes, including images smaller than the kernel and several column-tiles
+	const int sizes[][2] = { {1,1}, {3,2}, {7,9}, {64,48}, {4100,5} };
+	const Kernel kernels[] = { KernelFactory::gauss2D(1.0f), KernelFactory::gauss2D(2.5f, 7) };
+
+	for (const Kernel& k : kernels) {
+		for (const auto& s : sizes) {
+			const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(s[0], s[1], 255);
+			const ImageChannel ref = Convolve::run(img, k);
+			ImageChannel dst(s[0], s[1]);
+			Convolve::run(img, k, dst);
+			assertNear(ref, dst, 0.001f);
+		}
+	}
+
+}
+
+TEST(ConvolveSeparable, NonSquare) {
+
+	// 4x1 horizontal and 1x2 vertical kernel (even sizes)
+	const float vH[] = {1,2,3,4};
+	const float vV[] = {1,3};
+	const float v[] = {1,2,3,4, 3,6,9,12};
+	Kernel kH(vH, 4, 1);
+	Kernel kV(vV, 1, 2);
+	Kernel k(v, 4, 2);
+
+	const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(23, 17, 255);
+	const ImageChannel ref = Convolve::run(img, k);
+	const ImageChannel res = ConvolveSeparable(kH, kV).run(img);
+	assertNear(ref, res, 0.001f);
+
+}
+
+TEST(ConvolveSeparable, Gauss) {
+
+	const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(100, 80, 255);
+	Gauss g(2.0f);
+
+	ImageChannel dst(100, 80);
+	g.filter(img, dst);
+
+	const Kernel kH = KernelFactory::gauss1D(2.0f);
+	Kernel kV = KernelFactory::gauss1D(2.0f); kV.tilt();
+	const ImageChannel ref = Convolve::run(Convolve::run(img, kH), kV);
+	assertNear(ref, dst, 0.001f);
+
+}
+
+TEST(ConvolveSeparable, Benchmark) {
+
+	const int sizes[][2] = { {1024,576}, {3840,2160}, {7680,4320} };
+	const Kernel kH = KernelFactory::gauss1D(1.0f);
+	Kernel kV = KernelFactory::gauss1D(1.0f); kV.tilt();
+	const ConvolveSeparable conv(kH, kV);
+
+	for (const auto& s : sizes) {
+
+		const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(s[0], s[1], 255);
+		ImageChannel dst(s[0], s[1]);
+		std::cout << s[0] << "x" << s[1] << std::endl;
+
+		{
+			uint64_t start = K::Time::getTimeMS();
+			ImageChannel res = Convolve::run(Convolve::run(img, kH), kV);
+			uint64_t end = K::Time::getTimeMS();
+			std::cout << "\tConvolve::run (2x1D): " << (end-start) << " ms" << std::endl;
+		}
+
+		{
+			uint64_t start = K::Time::getTimeMS();
+			conv.run(img, dst);
+			uint64_t end = K::Time::getTimeMS();
+			std::cout << "\tConvolveSeparable:    " << (end-start) << " ms" << std::endl;
+		}
+
+	}
+
+}
+
+#endif
@@ -0,0 +1,94 @@
+
+
+#ifdef WITH_TESTS
+
+#include "../Test.h"
+#include "../../cv/ImageChannel.h"
+#include "../../os/Time.h"
+#include <cstdlib>
+using namespace K;
+
+TEST(ImageExpression, scalar) {
+
+	ImageChannel img(3,2);
+	img << 1,2,3, 4,5,6;
+
+	ImageChannel res = (1 - img) * 2;
+	ASSERT_EQ(3, res.getWidth());
+	ASSERT_EQ(2, res.getHeight());
+	for (int i = 0; i < 6; ++i) {ASSERT_EQ((1 - img.getData()[i]) * 2, res.getData()[i]);}
+
+	res = img / 2.0f + 1;
+	for (int i = 0; i < 6; ++i) {ASSERT_EQ(img.getData()[i] / 2.0f + 1, res.getData()[i]);}
+
+	res = -img;
+	ASSERT_EQ(-6, res.get(2,1));
+
+}
+
+TEST(ImageExpression, images) {
+
+	ImageChannel a(4,4);
+	ImageChannel b(4,4);
+	for (float& f : a) {f = (float) (rand() % 100) - 50;}
+	for (float& f : b) {f = (float) (rand() % 100) - 50;}
+
+	ImageChannel res = (a - b).abs() * 0.5f + a * b;
+	for (int i = 0; i < 16; ++i) {
+		const float exp = std::abs(a.getData()[i] - b.getData()[i]) * 0.5f + a.getData()[i] * b.getData()[i];
+		ASSERT_EQ(exp, res.getData()[i]);
+	}
+
+	// abs() of the image itself is evaluated at once: safe for temporaries
+	ImageChannel absA = a.abs();
+	for (int i = 0; i < 16; ++i) {ASSERT_EQ(std::abs(a.getData()[i]), absA.getData()[i]);}
+	const auto absCopy = ImageChannel(a).abs();
+	static_assert(std::is_same<decltype(absCopy), const ImageChannel>::value, "abs() of an image must not be lazy");
+	for (int i = 0; i < 16; ++i) {ASSERT_EQ(absA.getData()[i], absCopy.getData()[i]);}
+
+	// custom function
+	ImageChannel sq = a.map([] (const float v) {return v*v;}) + 1;
+	for (int i = 0; i < 16; ++i) {ASSERT_EQ(a.getData()[i] * a.getData()[i] + 1, sq.getData()[i]);}
+
+}
+
+TEST(ImageExpression, selfAssign) {
+
+	ImageChannel img(2,2);
+	img << 1,2,3,4;
+
+	// same size: evaluated in-place
+	img = img * img - 1;
+	ASSERT_EQ(0, img.get(0,0));
+	ASSERT_EQ(15, img.get(1,1));
+
+	// different size: re-allocated
+	ImageChannel other(3,3);
+	other.ones();
+	img = other * 3;
+	ASSERT_EQ(3, img.getWidth());
+	ASSERT_EQ(3, img.get(2,2));
+
+}
+
+TEST(ImageExpression, forEach) {
+
+	ImageChannel img(3,2);
+	img.setEach([] (const int x, const int y) {return (float) (x + y*10);});
+	ASSERT_EQ(12, img.get(2,1));
+
+	img.forEachModify([] (const int x, const int y, const float v) {(void) x; (void) y; return v*2;});
+	ASSERT_EQ(24, img.get(2,1));
+
+	float sum = 0;
+	img.forEach([&sum] (const int x, const int y, const float v) {(void) x; (void) y; sum += v;});
+	ASSERT_EQ(2*(0+1+2+10+11+12), sum);
+
+	// std::function still works
+	std::function<float(const int, const int)> func = [] (const int x, const int y) {return (float) (x*y);};
+	img.setEach(func);
+	ASSERT_EQ(2, img.get(2,1));
+
+}
+
+#endif
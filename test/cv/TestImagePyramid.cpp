@@ -5,6 +5,11 @@
 #include "../Test.h"
 #include "../../cv/ImagePyramid.h"
 #include "../../cv/ImageFactory.h"
+#include "../../cv/LaplacianPyramid.h"
+#include "../../cv/ScaleSpace.h"
+#include "../../cv/Kernel.h"
+#include "../../os/Time.h"
+#include <cstdlib>
 #include <sstream>
 using namespace K;
 
@@ -50,6 +55,153 @@ TEST(ImagePyramid, create) {
 
 }
 
+/** reference: convolve with the 5x5 binomial kernel at every second pixel, normalizing at the edges */
+static ImageChannel downsampleRef(const ImageChannel& prev) {
+
+	const float k1[5] = {1,4,6,4,1};
+	ImageChannel cur(prev.getWidth()/2, prev.getHeight()/2);
+
+	for (int y = 0; y < cur.getHeight(); ++y) {
+		for (int x = 0; x < cur.getWidth(); ++x) {
+			float val = 0;
+			float sum = 0;
+			for (int ky = -2; ky <= 2; ++ky) {
+				for (int kx = -2; kx <= 2; ++kx) {
+					const int ix = x*2 + kx;
+					const int iy = y*2 + ky;
+					if (ix < 0 || ix >= prev.getWidth())	{continue;}
+					if (iy < 0 || iy >= prev.getHeight())	{continue;}
+					const float kv = k1[kx+2] * k1[ky+2];
+					val += kv * prev.get(ix, iy);
+					sum += kv;
+				}
+			}
+			cur.set(x, y, val/sum);
+		}
+	}
+
+	return cur;
+
+}
+
+TEST(ImagePyramid, equalsReference) {
+
+	// even and odd sizes, tiny layers
+	for (const int w : {37, 64, 5}) {
+
+		const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(w, 29);
+		const ImagePyramid pyr(img);
+
+		ImageChannel ref = img;
+		for (size_t i = 1; i < pyr.size(); ++i) {
+			ref = downsampleRef(ref);
+			ASSERT_EQ(ref.getWidth(), pyr.get((int)i).getWidth());
+			ASSERT_EQ(ref.getHeight(), pyr.get((int)i).getHeight());
+			for (int y = 0; y < ref.getHeight(); ++y) {
+				for (int x = 0; x < ref.getWidth(); ++x) {
+					ASSERT_NEAR(ref.get(x,y), pyr.get((int)i).get(x,y), 0.0001f);
+				}
+			}
+		}
+
+	}
+
+}
+
+TEST(ImagePyramid, update) {
+
+	ImagePyramid pyr(3);
+	pyr.update(TestHelper::getRandomImage<ImageChannel>(64, 48));
+	ASSERT_EQ(3, pyr.size());
+	ASSERT_EQ(16, pyr.get(2).getWidth());
+	ASSERT_EQ(12, pyr.get(2).getHeight());
+
+	// same size: the layers are reused
+	const float* data = pyr.get(2).getData();
+	const ImageChannel img2 = TestHelper::getRandomImage<ImageChannel>(64, 48);
+	pyr.update(img2);
+	ASSERT_EQ(data, pyr.get(2).getData());
+	ASSERT_EQ(img2.get(5,5), pyr.get(0).get(5,5));
+
+	// different size: reallocated
+	pyr.update(TestHelper::getRandomImage<ImageChannel>(20, 20));
+	ASSERT_EQ(5, pyr.get(2).getWidth());
+
+}
+
+TEST(ImagePyramid, laplacian) {
+
+	const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(67, 45);
+	LaplacianPyramid lap(img);
+	ASSERT_EQ(lap.getGaussian().size(), lap.size());
+
+	// the last layer is the low-pass residual
+	const int n = (int) lap.size();
+	ASSERT_EQ(lap.getGaussian().get(n-1).get(0,0), lap.get(n-1).get(0,0));
+
+	// a constant image has no band-pass content
+	ImageChannel flat(32, 32);
+	flat.setAll(0.5f);
+	LaplacianPyramid lapFlat(flat);
+	for (const float v : lapFlat.get(0)) {ASSERT_NEAR(0, v, 0.00001f);}
+
+	// reconstruction
+	const ImageChannel rec = lap.reconstruct();
+	for (int y = 0; y < img.getHeight(); ++y) {
+		for (int x = 0; x < img.getWidth(); ++x) {
+			ASSERT_NEAR(img.get(x,y), rec.get(x,y), 0.0001f);
+		}
+	}
+
+}
+
+TEST(ImagePyramid, scaleSpace) {
+
+	const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(100, 64);
+	ScaleSpace ss(img, 3, 1.6f);
+
+	ASSERT_EQ(4, ss.getNumOctaves());					// 100x64, 50x32, 25x16, 12x8
+	ASSERT_EQ(12, ss.get(3, 0).getWidth());
+	ASSERT_NEAR(1.6f, ss.getSigma(0, 0), 0.0001f);
+	ASSERT_NEAR(3.2f, ss.getSigma(0, 3), 0.0001f);
+	ASSERT_NEAR(3.2f, ss.getAbsoluteSigma(1, 0), 0.0001f);
+	ASSERT_NEAR(6.4f, ss.getAbsoluteSigma(1, 3), 0.0001f);
+
+	// next octave starts with the decimated last scale
+	ASSERT_EQ(ss.get(0, 3).get(10, 6), ss.get(1, 0).get(5, 3));
+
+	// blurring reduces the variance
+	auto getVar = [] (const ImageChannel& i) {
+		double sum = 0; double sum2 = 0; const int n = i.getWidth()*i.getHeight();
+		for (int j = 0; j < n; ++j) {sum += i.getData()[j]; sum2 += i.getData()[j]*i.getData()[j];}
+		return sum2/n - (sum/n)*(sum/n);
+	};
+	ASSERT_LT(getVar(ss.get(0,1)), getVar(ss.get(0,0)));
+	ASSERT_LT(getVar(ss.get(0,3)), getVar(ss.get(0,1)));
+
+	// refresh without reallocation
+	const float* data = ss.get(1, 2).getData();
+	ss.update(TestHelper::getRandomImage<ImageChannel>(100, 64));
+	ASSERT_EQ(data, ss.get(1, 2).getData());
+
+}
+
+TEST(ImagePyramid, Benchmark) {
+
+	const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(1920, 1080);
+
+	uint64_t start = Time::getTimeMS();
+	ImageChannel ref = img;
+	while (ref.getWidth() > 1 && ref.getHeight() > 1) {ref = downsampleRef(ref);}
+	std::cout << "5x5 kernel per pixel: " << (Time::getTimeMS() - start) << " ms" << std::endl;
+
+	ImagePyramid pyr(img);
+	start = Time::getTimeMS();
+	for (int i = 0; i < 10; ++i) {pyr.update(img);}
+	std::cout << "separable + reused layers: " << (float) (Time::getTimeMS() - start) / 10.0f << " ms per frame" << std::endl;
+
+}
+
 
 #endif
 
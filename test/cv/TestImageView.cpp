@@ -0,0 +1,119 @@
+
+
+#ifdef WITH_TESTS
+
+#include "../Test.h"
+#include "../../cv/ImageChannel.h"
+#include "../../cv/DataMatrixView.h"
+#include "../../cv/TiledExecutor.h"
+#include "../../cv/Convolve.h"
+#include "../../cv/KernelFactory.h"
+#include "../../cv/Derivative.h"
+#include "../../cv/filter/Gauss.h"
+#include "../../cv/filter/Threshold.h"
+#include "../../cv/filter/Normalize.h"
+#include <cstdlib>
+using namespace K;
+
+static void assertNear(const ConstImageView& a, const ConstImageView& b, const float delta) {
+	ASSERT_EQ(a.getWidth(), b.getWidth());
+	ASSERT_EQ(a.getHeight(), b.getHeight());
+	for (int y = 0; y < a.getHeight(); ++y) {
+		for (int x = 0; x < a.getWidth(); ++x) {
+			ASSERT_NEAR(a.get(x,y), b.get(x,y), delta) << x << ":" << y;
+		}
+	}
+}
+
+TEST(ImageView, access) {
+
+	ImageChannel img(4,3);
+	img <<	1,2,3,4,
+			5,6,7,8,
+			9,10,11,12;
+
+	// no copy: changes are visible in the image
+	ImageView view = img.getView(1,1,2,2);
+	ASSERT_EQ(2, view.getWidth());
+	ASSERT_EQ(2, view.getHeight());
+	ASSERT_EQ(4, view.getStride());
+	ASSERT_FALSE(view.isContiguous());
+	ASSERT_EQ(6, view.get(0,0));
+	ASSERT_EQ(11, view.get(1,1));
+	view.set(1,0,99);
+	ASSERT_EQ(99, img.get(2,1));
+
+	// views of views
+	ConstImageView sub = view.getView(1,1,1,1);
+	ASSERT_EQ(11, sub.get(0,0));
+
+	// deep-copy into a new image
+	ImageChannel crop(view);
+	ASSERT_EQ(2, crop.getWidth());
+	ASSERT_EQ(99, crop.get(1,0));
+	crop.set(0,0,0);
+	ASSERT_EQ(6, img.get(1,1));
+
+}
+
+TEST(ImageView, filters) {
+
+	const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(50,40);
+	const ConstImageView roi = img.getView(7,5,30,20);
+	const ImageChannel crop(roi);
+
+	// convolution
+	const Kernel k = KernelFactory::gauss2D(1.0f);
+	ImageChannel out(30,20);
+	Convolve::run(roi, k, out);
+	assertNear(Convolve::run(crop, k), out, 0.0001f);
+
+	// gauss
+	Gauss g(1.5f);
+	g.filter(roi, out);
+	assertNear(g.filter(crop), out, 0.0001f);
+
+	// derivatives
+	Derivative::getXcen(roi, out);
+	assertNear(Derivative::getXcen(crop), out, 0);
+	Derivative::getY(roi, out);
+	assertNear(Derivative::getY(crop), out, 0);
+
+	// threshold
+	Threshold::run(roi, out, 0.5f);
+	ImageChannel thres = crop;
+	Threshold::inplace(thres, 0.5f);
+	assertNear(thres, out, 0);
+
+	// normalize the view only
+	ImageChannel img2 = img;
+	Normalize::inplace(img2.getView(7,5,30,20));
+	assertNear(Normalize::run(crop), img2.getView(7,5,30,20), 0.00001f);
+	ASSERT_EQ(img.get(0,0), img2.get(0,0));
+
+}
+
+TEST(ImageView, tiledExecutor) {
+
+	const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(300,170);
+
+	Gauss g1(1.0f);
+	Gauss g2(2.0f);
+
+	TiledExecutor exec(64, 48);
+	exec.add(g1.getRadius(), [&] (const ConstImageView& src, const ImageView& dst) {g1.filter(src, dst);});
+	exec.add(1, [] (const ConstImageView& src, const ImageView& dst) {Derivative::getXcen(src, dst);});
+	exec.add(g2.getRadius(), [&] (const ConstImageView& src, const ImageView& dst) {g2.filter(src, dst);});
+	exec.add(0, [] (const ConstImageView& src, const ImageView& dst) {Normalize::run(src, dst, -0.1f, 0.1f);});
+
+	// the same chain on the whole image
+	ImageChannel ref = g1.filter(img);
+	ref = Derivative::getXcen(ref);
+	ref = g2.filter(ref);
+	Normalize::inplace(ref, -0.1f, 0.1f);
+
+	assertNear(ref, exec.run(img), 0.0001f);
+
+}
+
+#endif
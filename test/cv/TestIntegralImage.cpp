@@ -0,0 +1,193 @@
+
+
+#ifdef WITH_TESTS
+
+#include "../Test.h"
+#include "../../cv/IntegralImage.h"
+#include "../../cv/filter/Box.h"
+#include "../../cv/filter/Clean.h"
+#include "../../cv/matching/MatchingSAD.h"
+#include "../../cv/features/Simple.h"
+#include "../../cv/features/CornerDetectorHarris.h"
+#include "../../os/Time.h"
+#include <cstdlib>
+using namespace K;
+
+TEST(IntegralImage, sum) {
+
+	const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(31, 17);
+	const IntegralImage ii(img);
+
+	for (int i = 0; i < 200; ++i) {
+		const int x0 = rand() % 31;		const int x1 = x0 + rand() % (31-x0);
+		const int y0 = rand() % 17;		const int y1 = y0 + rand() % (17-y0);
+		double sum = 0;
+		for (int y = y0; y <= y1; ++y) {for (int x = x0; x <= x1; ++x) {sum += img.get(x,y);}}
+		ASSERT_NEAR(sum, ii.getSum(x0, y0, x1, y1), 1e-9);
+	}
+
+	// whole image and single pixels
+	ASSERT_NEAR(img.get(30,16), ii.getSum(30,16,30,16), 1e-9);
+	ASSERT_NEAR(img.get(0,0), ii.getSum(0,0,0), 1e-9);
+
+}
+
+TEST(IntegralImage, padded) {
+
+	const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(12, 9);
+	const int pad = 3;
+	const IntegralImage ii(img, pad);
+	const IntegralImageSquared ii2(img, pad);
+
+	// windows beyond the edges repeat the edge values
+	for (int y = 0; y < 9; ++y) {
+		for (int x = 0; x < 12; ++x) {
+			double sum = 0;
+			double sum2 = 0;
+			for (int y1 = y-pad; y1 <= y+pad; ++y1) {
+				for (int x1 = x-pad; x1 <= x+pad; ++x1) {
+					const double v = img.getClamped(x1, y1);
+					sum += v;
+					sum2 += v*v;
+				}
+			}
+			ASSERT_NEAR(sum, ii.getSum(x, y, pad), 1e-9);
+			ASSERT_NEAR(sum2, ii2.getSum(x, y, pad), 1e-9);
+		}
+	}
+
+}
+
+TEST(IntegralImage, statistics) {
+
+	ImageChannel img(5, 5);
+	img.setAll(2);
+	img.set(2, 2, 7);
+
+	const BoxStatistics stats(img);
+	ASSERT_NEAR(2.2, stats.getMean(2, 2, 2), 1e-9);
+	ASSERT_NEAR((8*2 + 7) / 9.0, stats.getMean(1, 1, 1), 1e-9);
+	ASSERT_NEAR(0.0, stats.getVariance(1, 1, 0), 1e-9);
+
+	// 24 x 2 and 1 x 7 -> E[x^2] - E[x]^2
+	ASSERT_NEAR((24*4 + 49) / 25.0 - 2.2*2.2, stats.getVariance(2, 2, 2), 1e-9);
+
+	// large uniform images do not drift
+	ImageChannel big(2000, 2000);
+	big.setAll(0.1f);
+	const BoxStatistics bigStats(big);
+	ASSERT_NEAR(0.1, bigStats.getMean(1990, 1990, 5), 1e-6);
+	ASSERT_NEAR(0.0, bigStats.getVariance(1990, 1990, 5), 1e-6);
+
+}
+
+TEST(IntegralImage, box) {
+
+	const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(40, 30);
+	const int r = 4;
+	const ImageChannel out = Box::apply(img, r);
+
+	for (int y = 0; y < 30; ++y) {
+		for (int x = 0; x < 40; ++x) {
+			float sum = 0;
+			int cnt = 0;
+			for (int y1 = std::max(0, y-r); y1 <= std::min(29, y+r); ++y1) {
+				for (int x1 = std::max(0, x-r); x1 <= std::min(39, x+r); ++x1) {
+					sum += img.get(x1, y1); ++cnt;
+				}
+			}
+			ASSERT_NEAR(sum/(float)cnt, out.get(x,y), 1e-5);
+		}
+	}
+
+}
+
+TEST(IntegralImage, clean) {
+
+	ImageChannel img(40, 30);
+	for (float& f : img) {f = (rand() % 3 == 0) ? (0.0f) : (1.0f);}
+
+	for (const int r : {1, 2, 5}) {
+		const ImageChannel a = Clean::avgThreshold(img, r, 0.6f);
+		const ImageChannel b = Clean::avgThreshold(img, r, 0.6f, true);
+		for (int i = 0; i < 40*30; ++i) {ASSERT_EQ(a.getData()[i], b.getData()[i]);}
+	}
+
+}
+
+TEST(IntegralImage, matchingSAD) {
+
+	const ImageChannel img1 = TestHelper::getRandomImage<ImageChannel>(30, 20);
+	const ImageChannel img2 = TestHelper::getRandomImage<ImageChannel>(30, 20);
+	const MatchingSAD sad(img1, img2, 7);
+
+	for (const Point2i offset : {Point2i(0,0), Point2i(3,-2), Point2i(-5,4)}) {
+		const ImageChannel errors = sad.getErrors(offset);
+		for (int y = 0; y < 20; ++y) {
+			for (int x = 0; x < 30; ++x) {
+				ASSERT_NEAR(sad.getError(Point2i(x,y), Point2i(x,y)+offset), errors.get(x,y), 1e-4);
+			}
+		}
+	}
+
+}
+
+TEST(IntegralImage, simpleFeatures) {
+
+	const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(24, 20);
+	const DataMatrix<SimpleFeatures::FeatureVec> a = SimpleFeatures::getFeatures(img, 5);
+	const DataMatrix<SimpleFeatures::FeatureVec> b = SimpleFeatures::getFeatures(img, 5, true);
+
+	for (int y = 0; y < 20; ++y) {
+		for (int x = 0; x < 24; ++x) {
+			ASSERT_NEAR(a.get(x,y).sigma, b.get(x,y).sigma, 1e-3);
+			ASSERT_NEAR(a.get(x,y).avg1Sigma, b.get(x,y).avg1Sigma, 1e-3);
+			ASSERT_EQ(a.get(x,y).avg1GradX, b.get(x,y).avg1GradX);
+		}
+	}
+
+}
+
+TEST(IntegralImage, harris) {
+
+	// white square on black background
+	ImageChannel img(40, 40);
+	img.zero();
+	for (int y = 10; y < 30; ++y) {for (int x = 10; x < 30; ++x) {img.set(x, y, 1);}}
+
+	CornerDetectorHarris cdh;
+	cdh.setUseBoxWindow(true);
+	const std::vector<Corner> corners = cdh.getCorners(img);
+	ASSERT_FALSE(corners.empty());
+
+	// all corners are near the square's corners
+	for (const Corner& c : corners) {
+		const int dx = std::min(std::abs(c.x - 10), std::abs(c.x - 29));
+		const int dy = std::min(std::abs(c.y - 10), std::abs(c.y - 29));
+		ASSERT_LE(dx, 2);
+		ASSERT_LE(dy, 2);
+	}
+
+}
+
+TEST(IntegralImage, Benchmark) {
+
+	const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(1024, 576);
+
+	for (const int r : {2, 8, 16}) {
+
+		uint64_t start = Time::getTimeMS();
+		const ImageChannel a = Clean::avgThreshold(img, r, 0.5f);
+		const uint64_t tDirect = Time::getTimeMS() - start;
+
+		start = Time::getTimeMS();
+		const ImageChannel b = Clean::avgThreshold(img, r, 0.5f, true);
+		const uint64_t tIntegral = Time::getTimeMS() - start;
+
+		std::cout << "radius " << r << ": direct " << tDirect << " ms, integral " << tIntegral << " ms" << std::endl;
+
+	}
+
+}
+
+#endif
@@ -0,0 +1,162 @@
+
+
+#ifdef WITH_TESTS
+
+#include "../../Test.h"
+#include "../../../cv/features/HOGDense.h"
+#include "../../../cv/features/HOG.h"
+#include "../../../os/Time.h"
+#include <cstdlib>
+
+using namespace K;
+
+/** reference: per-pixel derivatives, exact atan2 and brute-force cell histograms */
+static std::vector<float> getDescriptorRef(const ImageChannel& img, const int x, const int y, const int cellSize, const int blockCells, const int bins) {
+
+	std::vector<float> desc(blockCells*blockCells*bins, 0.0f);
+	const int win = blockCells * cellSize;
+
+	for (int cy = 0; cy < blockCells; ++cy) {
+		for (int cx = 0; cx < blockCells; ++cx) {
+			float* hist = &desc[(cy*blockCells + cx) * bins];
+			for (int py = y - win/2 + cy*cellSize; py < y - win/2 + (cy+1)*cellSize; ++py) {
+				for (int px = x - win/2 + cx*cellSize; px < x - win/2 + (cx+1)*cellSize; ++px) {
+					if (px < 0 || py < 0 || px >= img.getWidth() || py >= img.getHeight()) {continue;}
+					const float dx = (px > 0 && px < img.getWidth()-1) ? ((img.get(px+1,py) - img.get(px-1,py)) / 2) : (0);
+					const float dy = (py > 0 && py < img.getHeight()-1) ? ((img.get(px,py+1) - img.get(px,py-1)) / 2) : (0);
+					const float mag = std::sqrt(dx*dx + dy*dy);
+					float ang = std::atan2(dy, dx);
+					if (ang < 0) {ang += (float) M_PI;}
+					if (ang >= (float) M_PI) {ang = 0;}
+					const float bp = ang * (float) bins / (float) M_PI - 0.5f;
+					const int b0 = (int) std::floor(bp);
+					const float frac = bp - (float) b0;
+					hist[(b0 + bins) % bins] += mag * (1 - frac);
+					hist[(b0 + 1) % bins] += mag * frac;
+				}
+			}
+		}
+	}
+
+	// L2-Hys
+	for (int pass = 0; pass < 2; ++pass) {
+		float sum = 0;
+		for (const float v : desc) {sum += v*v;}
+		for (float& v : desc) {v /= std::sqrt(sum + 1e-10f); if (pass == 0) {v = std::min(0.2f, v);}}
+	}
+
+	return desc;
+
+}
+
+TEST(HOGDense, atan2) {
+
+	for (int i = 0; i < 10000; ++i) {
+		const float y = (float) (rand() % 2001 - 1000) / 100.0f;
+		const float x = (float) (rand() % 2001 - 1000) / 100.0f;
+		ASSERT_NEAR(std::atan2(y, x), HOGDense::atan2Approx(y, x), 0.0001f) << x << ":" << y;
+	}
+	ASSERT_NEAR(0, HOGDense::atan2Approx(0, 0), 0.0001f);
+
+}
+
+TEST(HOGDense, equalsReference) {
+
+	const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(61, 47);
+	const HOGDense hog(img, 6, 2, 9);
+	ASSERT_EQ(2*2*9, hog.getDescriptorSize());
+
+	// including points near the edges (clipped cells)
+	const std::vector<Point2i> points = {Point2i(30,20), Point2i(6,6), Point2i(0,0), Point2i(60,46), Point2i(17,40)};
+	const DataMatrix<float> desc = hog.getDescriptors(points);
+	ASSERT_EQ(hog.getDescriptorSize(), desc.getWidth());
+	ASSERT_EQ((int)points.size(), desc.getHeight());
+
+	for (size_t i = 0; i < points.size(); ++i) {
+		const std::vector<float> ref = getDescriptorRef(img, points[i].x, points[i].y, 6, 2, 9);
+		for (int j = 0; j < hog.getDescriptorSize(); ++j) {
+			ASSERT_NEAR(ref[j], desc.get(j, (int)i), 0.001f) << i << ":" << j;
+		}
+	}
+
+}
+
+TEST(HOGDense, largeImage) {
+
+	// the integral histogram is stored as float: cells far from the origin must still match
+	const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(1920, 1080);
+	const HOGDense hog(img, 8, 2, 9);
+
+	const std::vector<Point2i> points = {Point2i(1900,1060), Point2i(1000,1070), Point2i(1910,500), Point2i(16,16)};
+	const DataMatrix<float> desc = hog.getDescriptors(points);
+
+	for (size_t i = 0; i < points.size(); ++i) {
+		const std::vector<float> ref = getDescriptorRef(img, points[i].x, points[i].y, 8, 2, 9);
+		for (int j = 0; j < hog.getDescriptorSize(); ++j) {
+			ASSERT_NEAR(ref[j], desc.get(j, (int)i), 0.001f) << i << ":" << j;
+		}
+	}
+
+}
+
+TEST(HOGDense, orientation) {
+
+	// vertical edge -> horizontal gradient -> bin 0 and bin 8 (bin-centers at 10 and 170 degrees)
+	ImageChannel img(16, 16);
+	img.setEach([] (const int x, const int y) {(void) y; return (x < 8) ? (0.0f) : (1.0f);});
+
+	const HOGDense hog(img, 4, 1, 9);
+	std::vector<float> desc(hog.getDescriptorSize());
+	hog.getDescriptor(8, 8, desc.data());
+	ASSERT_NEAR(desc[0], desc[8], 0.0001f);
+	ASSERT_GT(desc[0], 0.5f);
+	for (int i = 1; i < 8; ++i) {ASSERT_EQ(0, desc[i]);}
+
+}
+
+TEST(HOGDense, grid) {
+
+	const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(64, 40);
+	const HOGDense hog(img, 8, 2, 9);
+
+	const std::vector<Point2i> grid = hog.getGrid(8);
+	ASSERT_EQ(7*4, grid.size());							// windows of 16x16 pixels
+	ASSERT_EQ(Point2i(8,8), grid.front());
+	ASSERT_EQ(Point2i(56,32), grid.back());
+
+	const DataMatrix<float> desc = hog.getDescriptors(8);
+	ASSERT_EQ(hog.getDescriptorSize(), desc.getWidth());
+	ASSERT_EQ((int)grid.size(), desc.getHeight());
+
+	// each descriptor has unit length
+	for (int i = 0; i < desc.getHeight(); ++i) {
+		float sum = 0;
+		for (int j = 0; j < desc.getWidth(); ++j) {sum += desc.get(j,i) * desc.get(j,i);}
+		ASSERT_NEAR(1.0f, sum, 0.001f);
+	}
+
+}
+
+TEST(HOGDense, Benchmark) {
+
+	const ImageChannel img = TestHelper::getRandomImage<ImageChannel>(1024, 576);
+
+	uint64_t start = Time::getTimeMS();
+	const HOGDense hog(img, 8, 2, 9);
+	const DataMatrix<float> desc = hog.getDescriptors(4);
+	std::cout << "dense: " << desc.getHeight() << " descriptors in " << (Time::getTimeMS() - start) << " ms" << std::endl;
+
+	start = Time::getTimeMS();
+	HOG hog2(img, 8, 9);
+	int cnt = 0;
+	for (int y = 8; y < img.getHeight()-8; y += 4) {
+		for (int x = 8; x < img.getWidth()-8; x += 4) {
+			hog2.get(img, x, y);
+			++cnt;
+		}
+	}
+	std::cout << "per point: " << cnt << " descriptors in " << (Time::getTimeMS() - start) << " ms" << std::endl;
+
+}
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "../../Test.h"
 #include "../../../cv/filter/Median.h"
+#include "../../../os/Time.h"
 
 namespace K {
 
@@ -44,6 +45,113 @@ namespace K {
 
 	}
 
+	/** compare apply() against the per-pixel get() */
+	static void compareWithGet(const ImageChannel& img, const int sx, const int sy) {
+		ImageChannel res = MedianFilter::apply(img, sx, sy);
+		for (int y = 0; y < img.getHeight(); ++y) {
+			for (int x = 0; x < img.getWidth(); ++x) {
+				ASSERT_EQ(MedianFilter::get(img, x, y, sx, sy), res.get(x,y)) << x << ":" << y;
+			}
+		}
+	}
+
+	TEST(FilterMedian, histogram) {
+
+		// integer values -> constant-time histogram median
+		ImageChannel img(37,23);
+		for (float& f : img) {f = (float) (rand() % 256);}
+
+		compareWithGet(img, 3, 3);
+		compareWithGet(img, 7, 1);
+		compareWithGet(img, 1, 9);
+		compareWithGet(img, 11, 5);
+		compareWithGet(img, 51, 51);
+
+	}
+
+	TEST(FilterMedian, sorted) {
+
+		// arbitrary values -> sliding sorted window
+		ImageChannel img(29,31);
+		for (float& f : img) {f = (float) rand() / (float) RAND_MAX;}
+
+		compareWithGet(img, 3, 3);
+		compareWithGet(img, 5, 1);
+		compareWithGet(img, 9, 7);
+		compareWithGet(img, 65, 3);
+
+	}
+
+	TEST(FilterMedian, select) {
+
+		// windows up to 3x3 -> per pixel selection
+		ImageChannel img(31,17);
+		for (float& f : img) {f = (float) rand() / (float) RAND_MAX;}
+
+		compareWithGet(img, 3, 3);
+		compareWithGet(img, 3, 1);
+		compareWithGet(img, 1, 3);
+		compareWithGet(img, 1, 1);
+
+	}
+
+	TEST(FilterMedian, quantized) {
+
+		ImageChannel img(40,30);
+		for (float& f : img) {f = (float) rand() / (float) RAND_MAX;}
+
+		// quantization error is at most half a step
+		ImageChannel res = MedianFilter::applyQuantized(img, 5, 5, 256);
+		for (int y = 0; y < img.getHeight(); ++y) {
+			for (int x = 0; x < img.getWidth(); ++x) {
+				ASSERT_NEAR(MedianFilter::get(img, x, y, 5, 5), res.get(x,y), 1.0f / 255.0f);
+			}
+		}
+
+	}
+
+
+	/** the variants for growing windows: apply() selects per pixel up to 3x3, above it uses the histogram for 8-bit data */
+	TEST(FilterMedian, benchmark) {
+
+		ImageChannel img = TestHelper::getRandomImage<ImageChannel>(1024, 768, 255);
+		for (float& f : img) {f = std::round(f);}
+		img.set(0, 0, 0); img.set(1, 0, 255);
+
+		// non-integer values: selection or sorted window
+		ImageChannel imgF = img;
+		for (float& f : imgF) {f += 0.5f;}
+
+		for (const int r : {1, 2, 3, 4, 8}) {
+
+			const int s = 2*r+1;
+			std::cout << s << "x" << s << std::endl;
+
+			{
+				uint64_t start = Time::getTimeMS();
+				ImageChannel res = MedianFilter::apply(imgF, s, s);
+				uint64_t end = Time::getTimeMS();
+				std::cout << "\tapply (float): " << (end-start) << " ms" << std::endl;
+			}
+
+			{
+				uint64_t start = Time::getTimeMS();
+				ImageChannel res = MedianFilter::applyQuantized(img, s, s, 256);
+				uint64_t end = Time::getTimeMS();
+				std::cout << "\thistogram:     " << (end-start) << " ms" << std::endl;
+			}
+
+			{
+				uint64_t start = Time::getTimeMS();
+				ImageChannel res = MedianFilter::apply(img, s, s);
+				uint64_t end = Time::getTimeMS();
+				std::cout << "\tapply (8 bit): " << (end-start) << " ms" << std::endl;
+			}
+
+		}
+
+	}
+
 }
 
 
@@ -0,0 +1,54 @@
+
+
+#ifdef WITH_TESTS
+
+#include "../../Test.h"
+#include "../../../cv/filter/Minimum.h"
+#include "../../../cv/filter/Maximum.h"
+
+using namespace K;
+
+/** compare the running extrema against the per-pixel get() */
+template <typename Filter> static void compareWithGet(const ImageChannel& img, const int sx, const int sy) {
+	ImageChannel res = Filter::apply(img, sx, sy);
+	for (int y = 0; y < img.getHeight(); ++y) {
+		for (int x = 0; x < img.getWidth(); ++x) {
+			ASSERT_EQ(Filter::get(img, x, y, sx, sy), res.get(x,y)) << x << ":" << y;
+		}
+	}
+}
+
+TEST(FilterMinMax, simple) {
+
+	ImageChannel img(3,3);
+	img <<
+			1,2,3,
+			4,5,6,
+			7,8,9;
+
+	ImageChannel min = MinimumRegion::apply(img);
+	ASSERT_EQ(1, min.get(0,0));
+	ASSERT_EQ(1, min.get(1,1));
+	ASSERT_EQ(5, min.get(2,2));
+
+	ImageChannel max = MaximumRegion::apply(img);
+	ASSERT_EQ(5, max.get(0,0));
+	ASSERT_EQ(9, max.get(1,1));
+	ASSERT_EQ(8, max.get(0,2));
+
+}
+
+TEST(FilterMinMax, random) {
+
+	ImageChannel img(41,27);
+	for (float& f : img) {f = (float) rand() / (float) RAND_MAX;}
+
+	const int sizes[][2] = { {1,1}, {3,3}, {5,1}, {1,7}, {9,5}, {45,3}, {3,61} };
+	for (const auto& s : sizes) {
+		compareWithGet<MinimumRegion>(img, s[0], s[1]);
+		compareWithGet<MaximumRegion>(img, s[0], s[1]);
+	}
+
+}
+
+#endif
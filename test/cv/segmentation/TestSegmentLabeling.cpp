@@ -0,0 +1,155 @@
+
+
+#ifdef WITH_TESTS
+
+#include "../../Test.h"
+#include "../../../cv/segmentation/SegmentLabeling.h"
+#include "../../../cv/segmentation/Segmentation.h"
+#include "../../../os/Time.h"
+#include <cstdlib>
+#include <algorithm>
+
+using namespace K;
+
+/** random image with some plateaus and some noise */
+static ImageChannel getTestImage(const int w, const int h) {
+	ImageChannel img(w, h);
+	for (int y = 0; y < h; ++y) {
+		for (int x = 0; x < w; ++x) {
+			const float base = (float) (((x / 7) + (y / 5)) % 4) * 0.25f;
+			const float noise = (rand() % 10 == 0) ? ((float) (rand() % 100) / 100.0f) : (0.0f);
+			img.set(x, y, base + noise);
+		}
+	}
+	return img;
+}
+
+TEST(SegmentLabeling, stats) {
+
+	ImageChannel img(16, 16);
+	img.set(8,8, 1);
+	img.set(7,8, 1);
+	img.set(9,8, 1);
+	img.set(15,15,0.5);
+	img.set(15,14,0.5);
+
+	const SegmentLabels res = SegmentLabeling::run(img);
+	ASSERT_EQ(3, res.getNumSegments());
+
+	// labels are assigned row by row
+	ASSERT_EQ(0, res.getLabel(0,0));
+	ASSERT_EQ(1, res.getLabel(8,8));
+	ASSERT_EQ(2, res.getLabel(15,15));
+
+	ASSERT_EQ(256-5, res.getStats(0).count);	ASSERT_EQ(0, res.getStats(0).avg);
+	ASSERT_EQ(3, res.getStats(1).count);		ASSERT_EQ(1, res.getStats(1).avg);
+	ASSERT_EQ(2, res.getStats(2).count);		ASSERT_EQ(0.5, res.getStats(2).avg);
+
+	ASSERT_EQ(Point2i(7,8), res.getStats(1).bbox.getMin());
+	ASSERT_EQ(Point2i(9,8), res.getStats(1).bbox.getMax());
+	ASSERT_EQ(Point2i(0,0), res.getStats(0).bbox.getMin());
+	ASSERT_EQ(Point2i(15,15), res.getStats(0).bbox.getMax());
+
+	const Segment<float> seg = res.getSegment(2);
+	ASSERT_EQ(2, seg.points.size());
+	ASSERT_EQ(Point2i(15,14), seg.points[0]);
+
+}
+
+TEST(SegmentLabeling, threshold) {
+
+	// a gradient: each step is below the threshold, the whole range is not
+	ImageChannel img(10, 3);
+	img.setEach([] (const int x, const int y) {(void) y; return (float) x * 0.05f;});
+	ASSERT_EQ(1, SegmentLabeling::run(img, 0.1f).getNumSegments());
+	ASSERT_EQ(10, SegmentLabeling::run(img, 0.01f).getNumSegments());
+
+	// diagonal neighbors are connected (the background as well)
+	ImageChannel diag(4, 4);
+	for (int i = 0; i < 4; ++i) {diag.set(i, i, 1);}
+	ASSERT_EQ(2, SegmentLabeling::run(diag).getNumSegments());
+
+}
+
+TEST(SegmentLabeling, binaryThreshold) {
+
+	// binary images use the packed bitmap only for thresholds within [0:1[
+	ImageChannel img(9, 7);
+	img.setEach([] (const int x, const int y) {return (float) (((x / 3) + (y / 2)) % 2);});
+
+	for (const float threshold : {-0.5f, 0.0f, 0.5f, 0.999f, 1.0f}) {
+		const std::vector<Segment<float>> ref = SegmentLabeling::run(img, threshold).getSegments();
+		const std::vector<Segment<float>> segs = Segmentation::getSegments(img, threshold);
+		ASSERT_EQ(ref.size(), segs.size()) << threshold;
+		for (size_t i = 0; i < ref.size(); ++i) {
+			ASSERT_EQ(ref[i].points.size(), segs[i].points.size()) << threshold;
+		}
+	}
+
+	// negative: no pixels are joined, 1: all pixels are joined
+	ASSERT_EQ(9u*7u, Segmentation::getSegments(img, -0.5f).size());
+	ASSERT_EQ(1u, Segmentation::getSegments(img, 1.0f).size());
+
+}
+
+TEST(SegmentLabeling, equalsRegionGrowing) {
+
+	const ImageChannel img = getTestImage(60, 45);
+
+	// reference: flood-filling
+	Bitmap used(img.getWidth(), img.getHeight());
+	const std::vector<Segment<float>> ref = Segmentation::getSegments(img, used, 0.1f);
+	const std::vector<Segment<float>> segs = SegmentLabeling::run(img, 0.1f).getSegments();
+
+	ASSERT_EQ(ref.size(), segs.size());
+	for (size_t i = 0; i < ref.size(); ++i) {
+		ASSERT_EQ(ref[i].points.size(), segs[i].points.size());
+		ASSERT_NEAR(ref[i].avg, segs[i].avg, 0.0001f);
+		ASSERT_EQ(ref[i].calcBBox().getMin(), segs[i].calcBBox().getMin());
+		ASSERT_EQ(ref[i].calcBBox().getMax(), segs[i].calcBBox().getMax());
+	}
+
+}
+
+TEST(SegmentLabeling, parallel) {
+
+	const ImageChannel img = getTestImage(123, 77);
+	const SegmentLabels seq = SegmentLabeling::run(img, 0.1f);
+
+	// several strip heights, including single rows
+	for (const int stripHeight : {1, 3, 10, 64, 200}) {
+		const SegmentLabels par = SegmentLabeling::runParallel(img, 0.1f, stripHeight);
+		ASSERT_EQ(seq.getNumSegments(), par.getNumSegments());
+		const int* a = seq.getLabels().getData();
+		ASSERT_TRUE(std::equal(a, a + 123*77, par.getLabels().getData()));
+		for (int i = 0; i < seq.getNumSegments(); ++i) {
+			ASSERT_EQ(seq.getStats(i).count, par.getStats(i).count);
+			ASSERT_EQ(seq.getStats(i).bbox.getMin(), par.getStats(i).bbox.getMin());
+		}
+	}
+
+}
+
+TEST(SegmentLabeling, Benchmark) {
+
+	const ImageChannel img = getTestImage(2048, 2048);
+
+	uint64_t start = Time::getTimeMS();
+	Bitmap used(img.getWidth(), img.getHeight());
+	const int n1 = (int) Segmentation::getSegments(img, used, 0.1f).size();
+	std::cout << "region growing: " << (Time::getTimeMS() - start) << " ms" << std::endl;
+
+	start = Time::getTimeMS();
+	const int n2 = SegmentLabeling::run(img, 0.1f).getNumSegments();
+	std::cout << "labeling: " << (Time::getTimeMS() - start) << " ms" << std::endl;
+
+	start = Time::getTimeMS();
+	const int n3 = SegmentLabeling::runParallel(img, 0.1f).getNumSegments();
+	std::cout << "labeling (parallel): " << (Time::getTimeMS() - start) << " ms" << std::endl;
+
+	ASSERT_EQ(n1, n2);
+	ASSERT_EQ(n1, n3);
+
+}
+
+#endif
@@ -0,0 +1,261 @@
+#ifdef WITH_TESTS
+
+#include "../../Test.h"
+#include "../../../data/json/JSONDocument.h"
+#include "../../../data/json/JSONStreamReader.h"
+#include "../../../data/json/JSONReader.h"
+#include "../../../streams/ByteArrayInputStream.h"
+#include "../../../os/Time.h"
+#include <random>
+#include <sstream>
+using namespace K;
+
+/** char-by-char reference for the structural index. backslashes escape the next char even outside of strings */
+static bool jsonStructuralsRef(const std::string& str, std::vector<uint32_t>& res) {
+	bool inString = false;
+	bool escaped = false;
+	bool prevScalar = false;
+	for (uint32_t i = 0; i < str.size(); ++i) {
+		const char c = str[i];
+		const bool isEscaped = escaped;
+		escaped = (c == '\\' && !isEscaped);
+		bool scalar = false;
+		if (inString) {
+			if (c == '"' && !isEscaped) {inString = false; res.push_back(i);}
+		} else if (c == '"' && !isEscaped) {
+			inString = true; res.push_back(i);
+		} else if (strchr("{}[]:,", c)) {
+			res.push_back(i);
+		} else if (!strchr(" \t\r\n", c)) {
+			scalar = true;
+			if (!prevScalar) {res.push_back(i);}
+		}
+		prevScalar = scalar;
+	}
+	return !inString;
+}
+
+TEST(JSONDocument, structuralIndex) {
+
+	std::minstd_rand gen(1337);
+	const char chars[] = "\\\\\\\"\"a1 {}[]:,";
+	std::uniform_int_distribution<int> dChar(0, sizeof(chars) - 2);
+	std::uniform_int_distribution<int> dLen(0, 300);
+	std::vector<uint32_t> res;
+
+	for (int run = 0; run < 5000; ++run) {
+
+		std::string str;
+		const int len = dLen(gen);
+		for (int i = 0; i < len; ++i) {str += chars[dChar(gen)];}
+
+		std::vector<uint32_t> ref;
+		const bool refOk = jsonStructuralsRef(str, ref);
+
+		// unterminated strings throw
+		bool ok = true;
+		try {JSONStructuralIndex::build(str.data(), str.size(), res);} catch (JSONReaderException&) {ok = false;}
+
+		ASSERT_EQ(refOk, ok) << str;
+		if (ok) {ASSERT_EQ(ref, res) << str;}
+
+	}
+
+}
+
+TEST(JSONDocument, lazy) {
+
+	const std::string str = "{\"a\": 1337, \"b\": false, \"c\":null, \"d\":[1,-2,3.5], \"e\":{\"abc\":\"xyz\"}, \"f\": true }";
+	JSONDocument doc;
+	const JSONElement root = doc.parse(str);
+
+	ASSERT_EQ(JSONValueType::JSON_OBJECT, root.getType());
+	ASSERT_EQ(6u, root.size());
+	ASSERT_EQ(1337, root["a"].asInt());
+	ASSERT_FALSE(root["b"].asBool());
+	ASSERT_TRUE(root["f"].asBool());
+	ASSERT_TRUE(root["c"].isNull());
+	ASSERT_TRUE(root.containsValue("c"));
+	ASSERT_FALSE(root.containsValue("x"));
+	ASSERT_THROW(root["x"], JSONReaderException);
+
+	const JSONElement d = root["d"];
+	ASSERT_EQ(3u, d.size());
+	ASSERT_EQ(1, d[0].asInt());
+	ASSERT_EQ(-2, d[1].asInt());
+	ASSERT_EQ(3.5, d[2].asDouble());
+	ASSERT_EQ(JSONValueType::DOUBLE, d[2].getType());
+	ASSERT_THROW(d[3], JSONReaderException);
+
+	ASSERT_EQ("xyz", root["e"]["abc"].asString());
+	ASSERT_TRUE(root["e"]["abc"].asRawString() == "xyz");
+
+	// type mismatch
+	ASSERT_THROW(root["a"].asString(), JSONReaderException);
+	ASSERT_THROW(root["e"][0], JSONReaderException);
+
+	// iterate
+	std::string keys;
+	for (JSONElement::Iterator it = root.begin(); it != root.end(); ++it) {keys += it.key().str();}
+	ASSERT_EQ("abcdef", keys);
+	double sum = 0;
+	for (const JSONElement e : d) {sum += e.asDouble();}
+	ASSERT_EQ(2.5, sum);
+
+	// scalars at the root
+	ASSERT_EQ(42, doc.parse(" 42 ").asInt());
+	ASSERT_EQ("x", doc.parse("\"x\"").asString());
+	ASSERT_TRUE(doc.parse("null").isNull());
+
+}
+
+TEST(JSONDocument, strings) {
+
+	JSONDocument doc;
+	const std::string str = "[\"a\\\"b\", \"\\\\\", \"\\n\\t\\/\", \"\\u00e4\\u20AC\", \"\\ud83d\\ude00\", \"\", {\"k\\\"ey\": 1}]";
+	const JSONElement root = doc.parse(str);
+
+	ASSERT_EQ("a\"b", root[0].asString());
+	ASSERT_EQ("\\", root[1].asString());
+	ASSERT_EQ("\n\t/", root[2].asString());
+	ASSERT_EQ("\xC3\xA4\xE2\x82\xAC", root[3].asString());
+	ASSERT_EQ("\xF0\x9F\x98\x80", root[4].asString());
+	ASSERT_EQ("", root[5].asString());
+	ASSERT_EQ(1, root[6]["k\"ey"].asInt());
+
+	ASSERT_THROW(doc.parse("[\"\\x\"]")[0].asString(), JSONReaderException);
+	ASSERT_THROW(doc.parse("[\"\\u12\"]")[0].asString(), JSONReaderException);
+	ASSERT_THROW(doc.parse("[\"\\ud83d\"]")[0].asString(), JSONReaderException);
+
+}
+
+TEST(JSONDocument, numbers) {
+
+	JSONDocument doc;
+	const JSONElement root = doc.parse("[0, -0, 123456789012345678, 1234567890123456789012, 1e3, -2.5E-3, 0.1, 1.7976931348623157e308, 5e-324, 123.456e-2]");
+
+	ASSERT_EQ(0, root[0].asInt());
+	ASSERT_EQ(0, root[1].asInt());
+	ASSERT_EQ(123456789012345678LL, root[2].asInt());
+	ASSERT_EQ(JSONValueType::DOUBLE, root[3].getType());
+	ASSERT_EQ(1234567890123456789012.0, root[3].asDouble());
+	ASSERT_EQ(1000.0, root[4].asDouble());
+	ASSERT_EQ(-2.5e-3, root[5].asDouble());
+	ASSERT_EQ(0.1, root[6].asDouble());
+	ASSERT_EQ(1.7976931348623157e308, root[7].asDouble());
+	ASSERT_EQ(5e-324, root[8].asDouble());
+	ASSERT_EQ(1.23456, root[9].asDouble());
+
+	// fast and slow path must match strtod
+	std::minstd_rand gen(1337);
+	std::uniform_real_distribution<double> dVal(-1e6, 1e6);
+	std::uniform_int_distribution<int> dExp(-40, 40);
+	for (int i = 0; i < 10000; ++i) {
+		char tmp[64];
+		snprintf(tmp, sizeof(tmp), (i % 2) ? "%.17g" : "%.6fe%d", dVal(gen), dExp(gen));
+		const std::string s = tmp;
+		ASSERT_EQ(strtod(s.c_str(), nullptr), doc.parse(s).asDouble()) << s;
+	}
+
+}
+
+TEST(JSONDocument, errors) {
+
+	JSONDocument doc;
+	const char* invalid[] = {
+		"", " ", "[,]", "[],", "{a:1}", "[1 2]", "[1,]", "{\"a\" 1}", "{\"a\":}", "{\"a\":1,}",
+		"[\"abc]", "[tru]", "[nul]", "[falsee]", "[1.]", "[.1]", "[1e]", "[-]", "[01x]",
+		"{\"a\":1]", "[1}", "[[]", "]", "\"a\"b", "{\"a\":1}}", "[1] [2]",
+	};
+	for (const char* str : invalid) {
+		ASSERT_THROW(doc.parse(str), JSONReaderException) << str;
+	}
+
+	// parse many
+	std::vector<uint32_t> roots;
+	doc.parseMany("[1] [2]\n{}\n3", 12, roots);
+	ASSERT_EQ(4u, roots.size());
+	ASSERT_EQ(2, doc.get(roots[1])[0].asInt());
+	ASSERT_EQ(3, doc.get(roots[3]).asInt());
+
+}
+
+TEST(JSONDocument, compat) {
+
+	JSONReader reader;
+	JSONValue val = reader.parse("{\"a\": 1337, \"b\": false, \"c\":null, \"d\":[1,2,3.5], \"e\":{\"a\\\"bc\":\"x\\\"yz\"} }");
+	JSONObject* obj = val.asObject();
+
+	ASSERT_EQ(1337, obj->getInt("a"));
+	ASSERT_EQ(false, obj->getBoolean("b"));
+	ASSERT_TRUE(obj->containsValue("c"));
+	ASSERT_EQ(3.5, obj->getArray("d")->get(2).asDouble());
+	ASSERT_EQ("x\"yz", obj->getObject("e")->getString("a\"bc"));
+
+	// the JSONValue API requires an object or array
+	ASSERT_THROW(reader.parse("1"), JSONReaderException);
+
+}
+
+TEST(JSONDocument, stream) {
+
+	// lines longer than the chunk, empty lines, no final line-break
+	std::string str;
+	for (int i = 0; i < 100; ++i) {
+		str += "{\"id\":" + std::to_string(i) + ", \"name\":\"" + std::string(i, 'x') + "\"}\n";
+		if (i % 10 == 0) {str += "\n";}
+	}
+	str += "[100]";
+
+	for (const size_t chunkSize : {16, 64, 1024, 1024*1024}) {
+
+		ByteArrayInputStream bais((const uint8_t*) str.data(), str.size());
+		JSONStreamReader reader(&bais, chunkSize);
+		JSONElement e;
+		int cnt = 0;
+		while (reader.next(e)) {
+			if (cnt < 100) {
+				ASSERT_EQ(cnt, e["id"].asInt());
+				ASSERT_EQ((size_t) cnt, e["name"].asString().length());
+			} else {
+				ASSERT_EQ(100, e[0].asInt());
+			}
+			++cnt;
+		}
+		ASSERT_EQ(101, cnt);
+
+	}
+
+}
+
+TEST(JSONDocument, benchmark) {
+
+	std::stringstream ss;
+	ss << "[";
+	for (int i = 0; i < 200000; ++i) {
+		if (i) {ss << ",\n";}
+		ss << "{\"id\": " << i << ", \"name\": \"entry number " << i << "\", \"value\": " << (i % 1000 + 0.5) << ", \"tags\": [\"a\", \"b\", \"c\"], \"ok\": true}";
+	}
+	ss << "]";
+	const std::string str = ss.str();
+
+	JSONDocument doc;
+	uint64_t start = K::Time::getTimeMS();
+	const JSONElement root = doc.parse(str);
+	double sum = 0;
+	for (const JSONElement e : root) {sum += e["value"].asDouble();}
+	std::cout << "JSONDocument (" << (str.size() / 1024 / 1024) << " MB): " << (K::Time::getTimeMS() - start) << " ms" << std::endl;
+
+	start = K::Time::getTimeMS();
+	JSONReader reader;
+	JSONValue val = reader.parse(str);
+	double sum2 = 0;
+	JSONArray* arr = val.asArray();
+	for (int i = 0; i < 200000; ++i) {sum2 += arr->get(i).asObject()->getDouble("value");}
+	std::cout << "JSONReader (JSONValue): " << (K::Time::getTimeMS() - start) << " ms" << std::endl;
+
+	ASSERT_EQ(sum, sum2);
+
+}
+
+#endif
@@ -0,0 +1,151 @@
+#ifdef WITH_TESTS
+
+#include "../../Test.h"
+#include "../../../data/json/JSONStreamWriter.h"
+#include "../../../data/json/JSONWriter.h"
+#include "../../../data/json/JSONReader.h"
+#include "../../../streams/ByteArrayOutputStream.h"
+#include "../../../os/Time.h"
+#include <sstream>
+using namespace K;
+
+static std::string jsonStreamWriterData(ByteArrayOutputStream& baos) {
+	return std::string((const char*) baos.getData(), baos.getDataLength());
+}
+
+TEST(JSONStreamWriter, sax) {
+
+	ByteArrayOutputStream baos;
+	{
+		JSONStreamWriter w(baos);
+		w.beginObject();
+		w.key("id").value(1337);
+		w.key("neg").value((int64_t) -42);
+		w.key("pi").value(3.14159);
+		w.key("one").value(1.0);
+		w.key("nan").value(NAN);
+		w.key("ok").value(true);
+		w.key("none").null();
+		w.key("name").value("a\"b\\c\n\x01");
+		w.key("empty").beginArray().endArray();
+		w.key("list").beginArray().value(1).beginObject().endObject().value("x").endArray();
+		w.endObject();
+	}
+
+	ASSERT_EQ("{\"id\":1337,\"neg\":-42,\"pi\":3.14159,\"one\":1.0,\"nan\":null,\"ok\":true,\"none\":null,"
+			  "\"name\":\"a\\\"b\\\\c\\n\\u0001\",\"empty\":[],\"list\":[1,{},\"x\"]}", jsonStreamWriterData(baos));
+
+	// misuse
+	ByteArrayOutputStream baos2;
+	JSONStreamWriter w2(baos2);
+	w2.beginObject();
+	ASSERT_ANY_THROW(w2.value(1));
+	ASSERT_ANY_THROW(w2.endArray());
+
+}
+
+TEST(JSONStreamWriter, likeJSONWriter) {
+
+	JSONReader reader;
+	const JSONValue val = reader.parse("{\"a\": 1337, \"b\": false, \"c\":null, \"d\":[1,2,3.5,[],{}], \"e\":{\"abc\":\"x\\\"yz\", \"f\":[{\"g\":[]}]} }");
+
+	for (const bool pretty : {false, true}) {
+
+		std::stringstream ss;
+		JSONWriter writer(ss, pretty);
+		writer.write(*val.asObject());
+
+		ByteArrayOutputStream baos;
+		JSONStreamWriter w(baos, pretty);
+		w.value(val);
+		w.flush();
+
+		ASSERT_EQ(ss.str(), jsonStreamWriterData(baos));
+
+	}
+
+}
+
+TEST(JSONStreamWriter, roundTrip) {
+
+	// strings longer than the buffer, chars needing escapes at every position
+	std::vector<std::string> strings;
+	for (int len = 0; len < 300; len += 7) {
+		std::string s;
+		for (int i = 0; i < len; ++i) {s += (char) ((i * 31 + len) % 128);}
+		strings.push_back(s);
+	}
+	strings.push_back(std::string(10000, 'x') + "\"" + std::string(10000, 'y'));
+	strings.push_back("\xC3\xA4\xE2\x82\xAC");
+
+	for (const size_t bufferSize : {16, 100, 4096}) {
+
+		ByteArrayOutputStream baos;
+		{
+			JSONStreamWriter w(baos, bufferSize == 100, ' ', bufferSize);
+			w.beginArray();
+			for (const std::string& s : strings) {w.value(s);}
+			for (int i = 0; i < 100; ++i) {w.value(i * 0.1).value((int64_t) i * (int64_t) 1000000007);}
+			w.endArray();
+		}
+
+		const std::string str = jsonStreamWriterData(baos);
+		JSONDocument doc;
+		const JSONElement root = doc.parse(str);
+		ASSERT_EQ(strings.size() + 200, root.size());
+		JSONElement::Iterator it = root.begin();
+		for (const std::string& s : strings) {ASSERT_EQ(s, (*it).asString()); ++it;}
+		for (int i = 0; i < 100; ++i) {
+			ASSERT_EQ(i * 0.1, (*it).asDouble()); ++it;
+			ASSERT_EQ((int64_t) i * (int64_t) 1000000007, (*it).asInt()); ++it;
+		}
+
+	}
+
+}
+
+TEST(JSONStreamWriter, benchmark) {
+
+	const int num = 200000;
+
+	uint64_t start = K::Time::getTimeMS();
+	ByteArrayOutputStream baos;
+	{
+		JSONStreamWriter w(baos);
+		w.beginArray();
+		for (int i = 0; i < num; ++i) {
+			w.beginObject();
+			w.key("id").value(i);
+			w.key("name").value("entry number");
+			w.key("value").value(i * 0.37);
+			w.key("ok").value(true);
+			w.endObject();
+		}
+		w.endArray();
+	}
+	std::cout << "JSONStreamWriter: " << (K::Time::getTimeMS() - start) << " ms" << std::endl;
+
+	start = K::Time::getTimeMS();
+	JSONArray arr;
+	for (int i = 0; i < num; ++i) {
+		JSONObject* obj = new JSONObject();
+		obj->put("id", (int64_t) i);
+		obj->put("name", "entry number");
+		obj->put("value", i * 0.37);
+		obj->put("ok", true);
+		arr.addObject(obj);
+	}
+	std::stringstream ss;
+	JSONWriter writer(ss, false);
+	writer.write(arr);
+	const std::string str = ss.str();
+	std::cout << "JSONArray + JSONWriter: " << (K::Time::getTimeMS() - start) << " ms" << std::endl;
+
+	JSONDocument doc;
+	const std::string res = jsonStreamWriterData(baos);
+	ASSERT_EQ((size_t) num, doc.parse(res).size());
+	ASSERT_EQ((size_t) num, doc.parse(str).size());
+
+}
+
+#endif
@@ -6,8 +6,11 @@
 #include "../../Test.h"
 #include "../../../data/kd-tree/KDTree.h"
 #include "../../../data/kd-tree/KDTreeKNN.h"
+#include "../../../data/kd-tree/KDTreeFrozen.h"
 #include "../../../os/Time.h"
 
+#include <random>
+
 #include "../../../misc/gnuplot/Gnuplot.h"
 #include "../../../misc/gnuplot/GnuplotPlot.h"
 #include "../../../misc/gnuplot/GnuplotPlotElementPoints.h"
@@ -367,6 +370,323 @@ TEST(KDTree, remove) {
 }
 
 
+/** brute-force k-NN for comparison */
+static std::vector<KDTreeNeighbor<float>> kdBruteForce(const KDPointCloud& vals, const float* q, const size_t k) {
+	std::vector<KDTreeNeighbor<float>> all;
+	for (size_t i = 0; i < vals.size(); ++i) {all.push_back(KDTreeNeighbor<float>((KDIdx)i, vals.kdGetDistance((int)i, q)));}
+	std::sort(all.begin(), all.end());
+	all.resize(std::min(k, all.size()));
+	return all;
+}
+
+TEST(KDTree, kNNExact) {
+
+	std::minstd_rand gen(1234);
+	std::uniform_real_distribution<float> dist(-1, +1);
+
+	KDPointCloud vals;
+	for (int i = 0; i < 5000; ++i) {vals.push_back(KDPoint3(dist(gen), dist(gen), dist(gen)));}
+
+	KDTree<CFG> tree(20, 8);
+	tree.setDataSource(&vals);
+	tree.addAll((KDIdx)vals.size());
+
+	KDTreeKNNScratch<float> scratch;
+	std::vector<KDTreeNeighbor<float>> res;
+
+	for (int i = 0; i < 200; ++i) {
+		const float q[3] = {dist(gen) * 1.2f, dist(gen) * 1.2f, dist(gen) * 1.2f};
+		for (const KDIdx k : {1u, 5u, 32u}) {
+			KDTreeKNN::getNeighbors(tree, q, k, scratch, res);
+			const std::vector<KDTreeNeighbor<float>> exp = kdBruteForce(vals, q, k);
+			ASSERT_EQ(exp.size(), res.size());
+			for (size_t j = 0; j < exp.size(); ++j) {
+				ASSERT_NEAR(exp[j].distance, res[j].distance, 1e-5);
+			}
+			ASSERT_EQ(exp[0].idx, res[0].idx);
+		}
+	}
+
+	// fewer elements than requested
+	ASSERT_EQ(vals.size(), KDTreeKNN::getNeighbors(tree, {0,0,0}, 10000).size());
+
+}
+
+TEST(KDTree, kNNBatch) {
+
+	std::minstd_rand gen(1234);
+	std::uniform_real_distribution<float> dist(-1, +1);
+
+	KDPointCloud vals;
+	for (int i = 0; i < 3; ++i) {vals.push_back(KDPoint3(dist(gen), dist(gen), dist(gen)));}
+	for (int i = 0; i < 20000; ++i) {vals.push_back(KDPoint3(dist(gen), dist(gen), dist(gen)));}
+
+	KDTree<CFG> tree(20, 16);
+	tree.setDataSource(&vals);
+	tree.addAll((KDIdx)vals.size());
+
+	std::vector<float> queries;
+	for (int i = 0; i < 1000 * 3; ++i) {queries.push_back(dist(gen));}
+
+	const KDIdx k = 8;
+	std::vector<KDTreeNeighbor<float>> res;
+	KDTreeKNN::getNeighbors(tree, queries.data(), 1000, k, res);
+	ASSERT_EQ(1000u * k, res.size());
+
+	for (size_t q = 0; q < 1000; ++q) {
+		const std::vector<KDTreeNeighbor<float>> exp = KDTreeKNN::getNeighbors(tree, &queries[q*3], k);
+		for (size_t j = 0; j < k; ++j) {
+			ASSERT_EQ(exp[j].idx, res[q*k+j].idx);
+			ASSERT_EQ(exp[j].distance, res[q*k+j].distance);
+		}
+	}
+
+	// a tree smaller than k: missing entries are marked
+	KDPointCloud small;
+	small.insert(small.end(), vals.begin(), vals.begin() + 3);
+	KDTree<CFG> tree2;
+	tree2.setDataSource(&small);
+	tree2.addAll(3);
+	KDTreeKNN::getNeighbors(tree2, queries.data(), 10, 5, res);
+	ASSERT_EQ(50u, res.size());
+	ASSERT_NE((KDIdx)-1, res[2].idx);
+	ASSERT_EQ((KDIdx)-1, res[3].idx);
+	ASSERT_EQ((KDIdx)-1, res[4].idx);
+
+}
+
+TEST(KDTree, kNNBenchmark) {
+
+	std::minstd_rand gen(1234);
+	std::uniform_real_distribution<float> dist(-1, +1);
+
+	KDPointCloud vals;
+	for (int i = 0; i < 200000; ++i) {vals.push_back(KDPoint3(dist(gen), dist(gen), dist(gen)));}
+
+	KDTree<CFG> tree(30, 16);
+	tree.setDataSource(&vals);
+	tree.addAll((KDIdx)vals.size());
+
+	const size_t num = 200000;
+	std::vector<float> queries;
+	for (size_t i = 0; i < num * 3; ++i) {queries.push_back(dist(gen));}
+	const KDIdx k = 8;
+
+	uint64_t s1 = Time::getTimeMS();
+	size_t sum = 0;
+	for (size_t q = 0; q < num; ++q) {sum += KDTreeKNN::getNeighborsApx(tree, &queries[q*3], k).size();}
+	uint64_t s2 = Time::getTimeMS();
+	KDTreeKNNScratch<float> scratch;
+	std::vector<KDTreeNeighbor<float>> res;
+	for (size_t q = 0; q < num; ++q) {KDTreeKNN::getNeighbors(tree, &queries[q*3], k, scratch, res); sum += res.size();}
+	uint64_t s3 = Time::getTimeMS();
+	KDTreeKNN::getNeighbors(tree, queries.data(), num, k, res);
+	uint64_t s4 = Time::getTimeMS();
+
+	std::cout << num << " queries, k=" << k << std::endl;
+	std::cout << "approximate (leaf only): " << (s2-s1) << " ms" << std::endl;
+	std::cout << "exact: " << (s3-s2) << " ms" << std::endl;
+	std::cout << "exact (batch): " << (s4-s3) << " ms" << std::endl;
+	ASSERT_TRUE(sum > 0);
+
+}
+
+
+TEST(KDTree, frozen) {
+
+	std::minstd_rand gen(1234);
+	std::uniform_real_distribution<float> dist(-1, +1);
+
+	KDPointCloud vals;
+	for (int i = 0; i < 10000; ++i) {vals.push_back(KDPoint3(dist(gen), dist(gen), dist(gen)));}
+
+	KDTree<CFG> tree(20, 13);
+	tree.setDataSource(&vals);
+	tree.addAll((KDIdx)vals.size());
+
+	using Frozen = KDTreeFrozen<float, 3>;
+	const Frozen frozen = Frozen::freeze(tree);
+	ASSERT_EQ(vals.size(), frozen.getNumPoints());
+
+	// save and map
+	const std::string file = getTempFile("kdtree.bin");
+	frozen.save(file);
+	const Frozen mapped(file);
+	ASSERT_EQ(frozen.getNumNodes(), mapped.getNumNodes());
+	ASSERT_EQ(frozen.getNumPoints(), mapped.getNumPoints());
+
+	Frozen::Scratch scratch;
+	std::vector<KDTreeNeighbor<float>> res1;
+	std::vector<KDTreeNeighbor<float>> res2;
+
+	for (int i = 0; i < 200; ++i) {
+
+		const float q[3] = {dist(gen), dist(gen), dist(gen)};
+
+		// same as the dynamic tree
+		const std::vector<KDTreeNeighbor<float>> exp = KDTreeKNN::getNeighbors(tree, q, 10);
+		frozen.getNeighbors(q, 10, scratch, res1);
+		mapped.getNeighbors(q, 10, scratch, res2);
+		ASSERT_EQ(exp.size(), res1.size());
+		ASSERT_EQ(exp.size(), res2.size());
+		for (size_t j = 0; j < exp.size(); ++j) {
+			ASSERT_NEAR(exp[j].distance, res1[j].distance, 1e-5);
+			ASSERT_EQ(res1[j].idx, res2[j].idx);
+		}
+
+		// radius
+		const std::vector<KDTreeNeighbor<float>> expR = KDTreeKNN::getNeighborsWithinRadius(tree, q, 0.2f);
+		mapped.getNeighborsWithinRadius(q, 0.2f, scratch, res2);
+		ASSERT_EQ(expR.size(), res2.size());
+
+	}
+
+	// wrong type
+	ASSERT_THROW((KDTreeFrozen<double, 3>(file)), FileException);
+	ASSERT_THROW((KDTreeFrozen<float, 2>(file)), FileException);
+
+	// corrupt files: sections outside of the file, nodes referring to missing points/children
+	std::string bin;
+	{std::ifstream is(file, std::ios::binary); bin.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());}
+	const uint32_t offsetNodes = *(const uint32_t*) &bin[32];
+	auto assertCorrupt = [&] (const size_t pos, const uint32_t val) {
+		std::string tmp = bin;
+		memcpy(&tmp[pos], &val, sizeof(val));
+		{std::ofstream os(file, std::ios::binary); os.write(tmp.data(), (std::streamsize) tmp.size());}
+		ASSERT_THROW(Frozen f(file), FileException) << pos;
+	};
+	assertCorrupt(20, 0x7FFFFFFF);						// numNodes
+	assertCorrupt(24, 0x7FFFFFFF);						// numPoints
+	assertCorrupt(32, 0xFFFFFFF0);						// offsetNodes
+	assertCorrupt(40, (uint32_t) bin.size() - 16);		// offsetCoords
+	assertCorrupt(48, 4);								// offsetIDs (unaligned, overlaps the header)
+	assertCorrupt(offsetNodes + 8, 0xFFFFFFF0);			// root: right child
+	assertCorrupt(offsetNodes + 4, 7);					// root: axis
+
+	// empty
+	const Frozen empty;
+	ASSERT_EQ(0u, empty.getNeighbors({0,0,0}, 3).size());
+
+}
+
+TEST(KDTree, frozenBenchmark) {
+
+	std::minstd_rand gen(1234);
+	std::uniform_real_distribution<float> dist(-1, +1);
+
+	KDPointCloud vals;
+	for (int i = 0; i < 1000000; ++i) {vals.push_back(KDPoint3(dist(gen), dist(gen), dist(gen)));}
+
+	KDTree<CFG> tree(30, 16);
+	tree.setDataSource(&vals);
+	uint64_t s0 = Time::getTimeMS();
+	tree.addAll((KDIdx)vals.size());
+	uint64_t s1 = Time::getTimeMS();
+	using Frozen = KDTreeFrozen<float, 3>;
+	Frozen::freeze(tree).save(getTempFile("kdtree.bin"));
+	uint64_t s2 = Time::getTimeMS();
+	const Frozen frozen(getTempFile("kdtree.bin"));
+	uint64_t s3 = Time::getTimeMS();
+
+	const size_t num = 200000;
+	std::vector<float> queries;
+	for (size_t i = 0; i < num * 3; ++i) {queries.push_back(dist(gen));}
+	const KDIdx k = 8;
+
+	KDTreeKNNScratch<float> scratch1;
+	Frozen::Scratch scratch2;
+	std::vector<KDTreeNeighbor<float>> res;
+	size_t sum = 0;
+	uint64_t s4 = Time::getTimeMS();
+	for (size_t q = 0; q < num; ++q) {KDTreeKNN::getNeighbors(tree, &queries[q*3], k, scratch1, res); sum += res[0].idx;}
+	uint64_t s5 = Time::getTimeMS();
+	for (size_t q = 0; q < num; ++q) {frozen.getNeighbors(&queries[q*3], k, scratch2, res); sum -= res[0].idx;}
+	uint64_t s6 = Time::getTimeMS();
+	ASSERT_EQ(0u, sum);
+
+	std::cout << "build: " << (s1-s0) << " ms, freeze+save: " << (s2-s1) << " ms, map: " << (s3-s2) << " ms" << std::endl;
+	std::cout << num << " queries, k=" << k << ": tree " << (s5-s4) << " ms, frozen " << (s6-s5) << " ms" << std::endl;
+
+}
+
+
+/** every element must be found within the leaf getLeafFor() returns */
+template <typename Splitter> static void kdCheckBulk(const KDPointCloud& vals, const int maxDepth, const int maxPerLeaf) {
+
+	KDTree<CFG> tree(maxDepth, maxPerLeaf);
+	tree.setDataSource(&vals);
+	tree.build<Splitter>((KDIdx)vals.size());
+	ASSERT_EQ((int)vals.size(), tree.getNumElementsBelow(tree.getRoot()));
+
+	for (KDIdx i = 0; i < vals.size(); ++i) {
+		const KDTreeLeaf<float>* leaf = tree.getLeafFor(i);
+		const KDIdx* data = leaf->entries.data();
+		ASSERT_TRUE(std::find(data, data + leaf->entries.size(), i) != data + leaf->entries.size());
+	}
+
+	for (int i = 0; i < 50; ++i) {
+		const float* q = &vals[i * 7 % vals.size()].x;
+		const std::vector<KDTreeNeighbor<float>> exp = kdBruteForce(vals, q, 10);
+		const std::vector<KDTreeNeighbor<float>> res = KDTreeKNN::getNeighbors(tree, q, 10);
+		ASSERT_EQ(exp.size(), res.size());
+		for (size_t j = 0; j < exp.size(); ++j) {ASSERT_NEAR(exp[j].distance, res[j].distance, 1e-5);}
+	}
+
+}
+
+TEST(KDTree, buildBulk) {
+
+	std::minstd_rand gen(1234);
+	std::uniform_real_distribution<float> dist(-1, +1);
+
+	// random
+	KDPointCloud vals;
+	for (int i = 0; i < 50000; ++i) {vals.push_back(KDPoint3(dist(gen), dist(gen), dist(gen)));}
+	kdCheckBulk<KDTreeSplit::Median>(vals, 30, 8);
+	kdCheckBulk<KDTreeSplit::SlidingMidpoint>(vals, 30, 8);
+
+	// clustered and many duplicates (plane at z=0, grid coordinates, one far outlier)
+	KDPointCloud vals2;
+	for (int i = 0; i < 20000; ++i) {vals2.push_back(KDPoint3((float)(i % 37), (float)(i % 5), 0));}
+	vals2.push_back(KDPoint3(1000, 1000, 1000));
+	kdCheckBulk<KDTreeSplit::Median>(vals2, 30, 8);
+	kdCheckBulk<KDTreeSplit::SlidingMidpoint>(vals2, 30, 8);
+
+	// tiny and limited depth
+	KDPointCloud vals3;
+	vals3.insert(vals3.end(), vals2.begin(), vals2.begin() + 3);
+	kdCheckBulk<KDTreeSplit::Median>(vals3, 30, 1);
+	kdCheckBulk<KDTreeSplit::SlidingMidpoint>(vals, 2, 1);
+
+}
+
+TEST(KDTree, buildBulkBenchmark) {
+
+	std::minstd_rand gen(1234);
+	std::uniform_real_distribution<float> dist(-100, +100);
+
+	KDPointCloud vals;
+	for (int i = 0; i < 2000000; ++i) {vals.push_back(KDPoint3(dist(gen), dist(gen), dist(gen) * 0.05f));}
+
+	KDTree<CFG> tree(30, 16);
+	tree.setDataSource(&vals);
+
+	uint64_t s1 = Time::getTimeMS();
+	tree.addAll((KDIdx)vals.size());
+	uint64_t s2 = Time::getTimeMS();
+	tree.build<KDTreeSplit::Median>((KDIdx)vals.size());
+	uint64_t s3 = Time::getTimeMS();
+	tree.build<KDTreeSplit::SlidingMidpoint>((KDIdx)vals.size());
+	uint64_t s4 = Time::getTimeMS();
+
+	std::cout << vals.size() << " points" << std::endl;
+	std::cout << "addAll (AVG): " << (s2-s1) << " ms" << std::endl;
+	std::cout << "build (median): " << (s3-s2) << " ms" << std::endl;
+	std::cout << "build (sliding midpoint): " << (s4-s3) << " ms" << std::endl;
+
+}
+
+
 TEST(KDTree, addManySingleNoBalance) {
 
 	KDTree<CFG> tree(10);
@@ -0,0 +1,175 @@
+#ifdef WITH_TESTS
+
+#include "../../Test.h"
+#include "../../../data/obj/ObjFileLoader.h"
+#include "../../../data/obj/ObjectFile.h"
+#include "../../../os/Time.h"
+#include <fstream>
+#include <cstdio>
+
+using namespace K;
+
+TEST(ObjFileLoader, read) {
+
+	// must match the ObjFileReader
+	ObjFileReader reader(getDataFile("cylinder.obj"));
+	ObjFileLoader loader(getDataFile("cylinder.obj"));
+	const ObjFileLoader::Data& data = loader.getData();
+
+	ASSERT_EQ(reader.getData().vertices.size(), data.vertices.size());
+	ASSERT_EQ(reader.getData().normals.size(), data.normals.size());
+	ASSERT_EQ(reader.getData().faces.size(), data.faces.size());
+	ASSERT_EQ(32u, data.faces.size());
+
+	for (size_t i = 0; i < data.faces.size(); ++i) {
+		const ObjFileReader::Face& ref = reader.getData().faces[i];
+		const ObjFileLoader::Face& face = data.faces[i];
+		for (int j = 0; j < 3; ++j) {
+			ASSERT_EQ(ref.vnt[j].idxVertex, face.vertex[j]);
+			ASSERT_EQ(ref.vnt[j].idxNormal, face.normal[j]);
+			ASSERT_EQ(ref.vnt[j].idxTexture, face.texture[j]);
+		}
+	}
+
+	ASSERT_EQ(ObjFileLoader::Vec3(0,30,0), data.vertices[data.faces[31].vertex[0]]);
+	ASSERT_EQ(ObjFileLoader::Vec3(20,30,0), data.vertices[data.faces[31].vertex[2]]);
+
+}
+
+TEST(ObjFileLoader, syntax) {
+
+	const std::string file = getTempFile("objFileLoader.obj");
+	{
+		std::ofstream os(file);
+		os << "# comment\r\n";
+		os << "v 1 2 3\r\n";
+		os << "  v\t4 5 6\n";
+		os << "v 7 8 9\n";
+		os << "v 1e1 -2.5 .5\n";
+		os << "vt 0.25 0.5\n";
+		os << "vt 0.75\n";
+		os << "vn 0 0 1\n";
+		os << "usemtl abc\n";
+		os << "f 1/1/1 2/2/1 3//1 4\n";
+		os << "f -4 -3 -1\n";
+		os << "f 1 2 3";
+	}
+
+	ObjFileLoader loader(file, true);
+	const ObjFileLoader::Data& data = loader.getData();
+
+	ASSERT_EQ(4u, data.vertices.size());
+	ASSERT_EQ(ObjFileLoader::Vec3(4,6,5), data.vertices[1]);
+	ASSERT_EQ(ObjFileLoader::Vec3(10,0.5f,-2.5f), data.vertices[3]);
+	ASSERT_EQ(2u, data.texCoords.size());
+	ASSERT_EQ(-0.5f, data.texCoords[0].y);
+	ASSERT_EQ(0.75f, data.texCoords[1].x);
+	ASSERT_EQ(1u, data.normals.size());
+	ASSERT_EQ(ObjFileLoader::Vec3(0,1,0), data.normals[0]);
+
+	// quad -> 2 triangles, relative indices, missing line-break at the end
+	ASSERT_EQ(4u, data.faces.size());
+	const int32_t expected[4][3] = {{0,1,2}, {0,2,3}, {0,1,3}, {0,1,2}};
+	for (int i = 0; i < 4; ++i) {
+		for (int j = 0; j < 3; ++j) {ASSERT_EQ(expected[i][j], data.faces[i].vertex[j]);}
+	}
+	ASSERT_EQ(1, data.faces[0].texture[1]);
+	ASSERT_EQ(-1, data.faces[0].texture[2]);
+	ASSERT_EQ(0, data.faces[0].normal[2]);
+	ASSERT_EQ(-1, data.faces[1].normal[2]);
+
+	// invalid files
+	const char* invalid[] = {"v 1 2\n", "v 1 2 x\n", "v 1 2 3\nf 1 1\n", "v 1 2 3\nf 1 1 2\n", "v 1 2 3\nf 1 1 0\n", "v 1 2 3\nf 1 1 1/1\n", "v 1 2 3\nf 1 1 1-1\n", "v 1 2 3\nf 1 1/1x 1\n"};
+	for (const char* str : invalid) {
+		{std::ofstream os(file); os << str;}
+		ASSERT_THROW(ObjFileLoader l(file), FileException) << str;
+	}
+
+	remove(file.c_str());
+
+}
+
+TEST(ObjFileLoader, cache) {
+
+	const std::string file = getTempFile("objFileLoaderCache.obj");
+	const std::string cacheFile = getTempFile("objFileLoaderCache.bin");
+	remove(cacheFile.c_str());
+	{std::ofstream os(file); os << "v 1 2 3\nv 4 5 6\nv 7 8 9\nvn 0 0 1\nf 1//1 2//1 3//1\n";}
+
+	// 1st: parse and write the cache, 2nd: read the cache
+	ObjFileLoader l1(file, false, cacheFile);
+	ASSERT_TRUE(File(cacheFile).exists());
+	ObjFileLoader l2(file, false, cacheFile);
+	ASSERT_EQ(l1.getData().vertices.size(), l2.getData().vertices.size());
+	ASSERT_EQ(ObjFileLoader::Vec3(4,5,6), l2.getData().vertices[1]);
+	ASSERT_EQ(1u, l2.getData().normals.size());
+	ASSERT_EQ(1u, l2.getData().faces.size());
+	ASSERT_EQ(0, memcmp(&l1.getData().faces[0], &l2.getData().faces[0], sizeof(ObjFileLoader::Face)));
+
+	// other settings do not use the cache
+	ObjFileLoader l3(file, true, cacheFile);
+	ASSERT_EQ(ObjFileLoader::Vec3(4,6,5), l3.getData().vertices[1]);
+
+	// changes to the file invalidate the cache
+	{std::ofstream os(file); os << "v 1 2 3\n";}
+	ObjFileLoader l4(file, true, cacheFile);
+	ASSERT_EQ(1u, l4.getData().vertices.size());
+	ASSERT_EQ(0u, l4.getData().faces.size());
+
+	remove(file.c_str());
+	remove(cacheFile.c_str());
+
+}
+
+TEST(ObjFileLoader, benchmark) {
+
+	// a large grid (the ObjFileReader only supports triangles)
+	const std::string file = getTempFile("objFileLoaderBench.obj");
+	const std::string cacheFile = getTempFile("objFileLoaderBench.bin");
+	remove(cacheFile.c_str());
+	const int size = 1000;
+	{
+		std::ofstream os(file);
+		for (int y = 0; y < size; ++y) {
+			for (int x = 0; x < size; ++x) {os << "v " << (x * 0.125) << " " << (y * 0.25) << " " << ((x+y) % 17 * 0.0625) << "\n";}
+		}
+		os << "vn 0 0 1\n";
+		for (int y = 0; y < size-1; ++y) {
+			for (int x = 0; x < size-1; ++x) {
+				const int i = y * size + x + 1;
+				os << "f " << i << "//1 " << (i+1) << "//1 " << (i+1+size) << "//1\n";
+				os << "f " << i << "//1 " << (i+1+size) << "//1 " << (i+size) << "//1\n";
+			}
+		}
+	}
+
+	uint64_t start = K::Time::getTimeMS();
+	ObjFileReader reader(file);
+	std::cout << "ObjFileReader: " << (K::Time::getTimeMS() - start) << " ms" << std::endl;
+
+	start = K::Time::getTimeMS();
+	ObjFileLoader loader(file, false, cacheFile);
+	std::cout << "ObjFileLoader: " << (K::Time::getTimeMS() - start) << " ms" << std::endl;
+
+	start = K::Time::getTimeMS();
+	ObjFileLoader cached(file, false, cacheFile);
+	std::cout << "ObjFileLoader (cached): " << (K::Time::getTimeMS() - start) << " ms" << std::endl;
+
+	ASSERT_EQ(reader.getData().vertices.size(), loader.getData().vertices.size());
+	ASSERT_EQ(reader.getData().faces.size(), loader.getData().faces.size());
+	ASSERT_EQ(reader.getData().faces.size(), cached.getData().faces.size());
+	for (size_t i = 0; i < loader.getData().vertices.size(); ++i) {
+		const ObjFileReader::Vec3& ref = reader.getData().vertices[i];
+		ASSERT_EQ(ObjFileLoader::Vec3(ref.x, ref.y, ref.z), loader.getData().vertices[i]);
+		ASSERT_EQ(loader.getData().vertices[i], cached.getData().vertices[i]);
+	}
+	for (size_t i = 0; i < loader.getData().faces.size(); ++i) {
+		ASSERT_EQ(reader.getData().faces[i].vnt[2].idxVertex, loader.getData().faces[i].vertex[2]);
+	}
+
+	remove(file.c_str());
+	remove(cacheFile.c_str());
+
+}
+
+#endif
@@ -0,0 +1,82 @@
+#ifdef WITH_TESTS
+
+#include "../../Test.h"
+#include "../../../data/xyz/XYZFileLoader.h"
+#include "../../../data/xyz/XYZFile.h"
+#include "../../../os/Time.h"
+#include <fstream>
+#include <cstdio>
+
+using namespace K;
+
+TEST(XYZFileLoader, read) {
+
+	// must match the XYZFileReader
+	XYZFileReader reader(getDataFile("cylinder.xyz"), true);
+	XYZFileLoader loader(getDataFile("cylinder.xyz"), true);
+
+	ASSERT_EQ(717u, loader.getData().vertices.size());
+	ASSERT_EQ(reader.getData().normals.size(), loader.getData().normals.size());
+	for (size_t i = 0; i < loader.getData().vertices.size(); ++i) {
+		const XYZFileReader::Vec3& ref = reader.getData().vertices[i];
+		ASSERT_EQ(XYZFileLoader::Vec3(ref.x, ref.y, ref.z), loader.getData().vertices[i]);
+	}
+
+}
+
+TEST(XYZFileLoader, syntax) {
+
+	const std::string file = getTempFile("xyzFileLoader.xyz");
+	{std::ofstream os(file); os << "1 2 3\r\n\n 4\t5 6 0 0 1\n7 8\n9 10 11 0 1 0 123";}
+
+	XYZFileLoader loader(file);
+	ASSERT_EQ(3u, loader.getData().vertices.size());
+	ASSERT_EQ(2u, loader.getData().normals.size());
+	ASSERT_EQ(XYZFileLoader::Vec3(4,5,6), loader.getData().vertices[1]);
+	ASSERT_EQ(XYZFileLoader::Vec3(0,1,0), loader.getData().normals[1]);
+
+	{std::ofstream os(file); os << "1 2 3\n1 2 x\n";}
+	ASSERT_THROW(XYZFileLoader l(file), FileException);
+
+	remove(file.c_str());
+
+}
+
+TEST(XYZFileLoader, benchmark) {
+
+	const std::string file = getTempFile("xyzFileLoaderBench.xyz");
+	const std::string cacheFile = getTempFile("xyzFileLoaderBench.bin");
+	remove(cacheFile.c_str());
+	{
+		std::ofstream os(file);
+		for (int i = 0; i < 1000000; ++i) {
+			os << (i % 1000 * 0.125) << " " << (i / 1000 * 0.25) << " " << (i % 17 * 0.0625) << " 0 0 1\n";
+		}
+	}
+
+	uint64_t start = K::Time::getTimeMS();
+	XYZFileReader reader(file);
+	std::cout << "XYZFileReader: " << (K::Time::getTimeMS() - start) << " ms" << std::endl;
+
+	start = K::Time::getTimeMS();
+	XYZFileLoader loader(file, false, cacheFile);
+	std::cout << "XYZFileLoader: " << (K::Time::getTimeMS() - start) << " ms" << std::endl;
+
+	start = K::Time::getTimeMS();
+	XYZFileLoader cached(file, false, cacheFile);
+	std::cout << "XYZFileLoader (cached): " << (K::Time::getTimeMS() - start) << " ms" << std::endl;
+
+	ASSERT_EQ(reader.getData().vertices.size(), loader.getData().vertices.size());
+	ASSERT_EQ(1000000u, cached.getData().normals.size());
+	for (size_t i = 0; i < loader.getData().vertices.size(); ++i) {
+		const XYZFileReader::Vec3& ref = reader.getData().vertices[i];
+		ASSERT_EQ(XYZFileLoader::Vec3(ref.x, ref.y, ref.z), loader.getData().vertices[i]);
+		ASSERT_EQ(loader.getData().vertices[i], cached.getData().vertices[i]);
+	}
+
+	remove(file.c_str());
+	remove(cacheFile.c_str());
+
+}
+
+#endif
@@ -0,0 +1,30 @@
+#ifdef WITH_TESTS
+
+#include "../Test.h"
+#include "../../fs/MemoryMappedFile.h"
+
+using namespace K;
+
+TEST(MemoryMappedFile, read) {
+
+	const std::string file = getTempFile("mmap.txt");
+	const std::string str = TestHelper::getLoremIpsum(10);
+	FILE* fp = fopen(file.c_str(), "wb");
+	fwrite(str.data(), 1, str.size(), fp);
+	fclose(fp);
+
+	MemoryMappedFile mmf(file);
+	ASSERT_EQ(str.size(), mmf.size());
+	ASSERT_EQ(str, std::string((const char*) mmf.data(), mmf.size()));
+
+	// empty file
+	fp = fopen(file.c_str(), "wb");
+	fclose(fp);
+	MemoryMappedFile empty(file);
+	ASSERT_TRUE(empty.empty());
+
+	ASSERT_THROW(MemoryMappedFile("/tmp/does/not/exist"), FileException);
+
+}
+
+#endif
@@ -12,6 +12,9 @@
 #include "TestDSPHelper.h"
 #include "../../../math/dsp/convolution/DSPConvolution.h"
 #include "../../../math/dsp/convolution/DSPConvolutionFFT.h"
+#include "../../../math/dsp/convolution/DSPConvolutionPartitioned.h"
+#include "../../../math/dsp/convolution/DSPConvolutionNonUniform.h"
+#include "../../../os/Time.h"
 
 #include "../../../os/Process.h"
 
@@ -74,6 +77,113 @@ namespace K {
 	}
 
 
+	/** reference: direct convolution of the first len output samples */
+	static std::vector<float> convolveRef(const std::vector<float>& x, const std::vector<float>& h) {
+		std::vector<float> y(x.size(), 0.0f);
+		for (size_t i = 0; i < x.size(); ++i) {
+			double sum = 0;
+			for (size_t j = 0; j < h.size() && j <= i; ++j) {sum += (double) h[j] * (double) x[i-j];}
+			y[i] = (float) sum;
+		}
+		return y;
+	}
+
+	static std::vector<float> getRandomSignal(const unsigned int len) {
+		std::vector<float> v(len);
+		for (float& f : v) {f = (float) rand() / (float) RAND_MAX - 0.5f;}
+		return v;
+	}
+
+	TEST(Convolution, partitionedBlocks) {
+
+		const std::vector<float> h = getRandomSignal(1000);
+		const std::vector<float> x = getRandomSignal(64*50);
+		const std::vector<float> ref = convolveRef(x, h);
+
+		DSPConvolutionPartitioned<float> conv(64);
+		conv.setImpulseResponse(h.data(), (unsigned int) h.size());
+		ASSERT_EQ(16u, conv.getNumPartitions());
+
+		std::vector<float> y(x.size());
+		for (size_t i = 0; i < x.size(); i += 64) {conv.processBlock(&x[i], &y[i]);}
+
+		for (size_t i = 0; i < x.size(); ++i) {ASSERT_NEAR(ref[i], y[i], 1e-4) << i;}
+
+	}
+
+	TEST(Convolution, partitionedStream) {
+
+		const std::vector<float> h = getRandomSignal(300);
+		const std::vector<float> x = getRandomSignal(5000);
+		const std::vector<float> ref = convolveRef(x, h);
+
+		DSPConvolutionPartitioned<float> conv(128);
+		conv.setImpulseResponse(h.data(), (unsigned int) h.size());
+
+		// random chunk sizes, inplace
+		std::vector<float> y = x;
+		for (size_t i = 0; i < y.size(); ) {
+			const unsigned int cnt = std::min((unsigned int) (y.size() - i), (unsigned int) (rand() % 300));
+			conv.process(&y[i], &y[i], cnt);
+			i += cnt;
+		}
+
+		const unsigned int lat = conv.getLatency();
+		for (size_t i = 0; i < lat; ++i) {ASSERT_EQ(0.0f, y[i]);}
+		for (size_t i = lat; i < x.size(); ++i) {ASSERT_NEAR(ref[i-lat], y[i], 1e-4) << i;}
+
+	}
+
+	TEST(Convolution, nonUniform) {
+
+		const std::vector<float> h = getRandomSignal(20000);
+		const std::vector<float> x = getRandomSignal(32*1000);
+		const std::vector<float> ref = convolveRef(x, h);
+
+		DSPConvolutionNonUniform<float> conv(32, 2048);
+		conv.setImpulseResponse(h.data(), (unsigned int) h.size());
+		ASSERT_EQ(4u, conv.getNumStages());
+
+		std::vector<float> y(x.size());
+		for (size_t i = 0; i < x.size(); i += 32) {conv.processBlock(&x[i], &y[i]);}
+		for (size_t i = 0; i < x.size(); ++i) {ASSERT_NEAR(ref[i], y[i], 1e-3) << i;}
+
+		// streaming with latency
+		conv.reset();
+		std::vector<float> z(x.size());
+		conv.process(x.data(), z.data(), 1000);
+		conv.process(x.data() + 1000, z.data() + 1000, (unsigned int) x.size() - 1000);
+		for (size_t i = 32; i < x.size(); ++i) {ASSERT_NEAR(y[i-32], z[i], 1e-5) << i;}
+
+	}
+
+	TEST(Convolution, partitionedBenchmark) {
+
+		const unsigned int blockSize = 128;
+		const std::vector<float> h = getRandomSignal(48000);
+		const std::vector<float> x = getRandomSignal(48000 * 10);
+		std::vector<float> y(x.size());
+
+		{
+			DSPConvolutionPartitioned<float> conv(blockSize);
+			conv.setImpulseResponse(h.data(), (unsigned int) h.size());
+			uint64_t s = K::Time::getTimeMS();
+			for (size_t i = 0; i + blockSize <= x.size(); i += blockSize) {conv.processBlock(&x[i], &y[i]);}
+			uint64_t e = K::Time::getTimeMS();
+			std::cout << "uniform, " << conv.getNumPartitions() << " partitions: " << (e-s) << " ms" << std::endl;
+		}
+
+		{
+			DSPConvolutionNonUniform<float> conv(blockSize, 8192);
+			conv.setImpulseResponse(h.data(), (unsigned int) h.size());
+			uint64_t s = K::Time::getTimeMS();
+			for (size_t i = 0; i + blockSize <= x.size(); i += blockSize) {conv.processBlock(&x[i], &y[i]);}
+			uint64_t e = K::Time::getTimeMS();
+			std::cout << "non-uniform, " << conv.getNumStages() << " stages: " << (e-s) << " ms" << std::endl;
+		}
+
+	}
+
 }
 
 #endif
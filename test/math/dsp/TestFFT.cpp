@@ -14,6 +14,7 @@
 #include "../../../math/dsp/dft/FFTFixed.h"
 #include "../../../math/dsp/dft/FFTRecursive.h"
 #include "../../../math/dsp/dft/FFT2.h"
+#include "../../../math/dsp/dft/FFTPlan.h"
 #include "../../../os/Time.h"
 
 
@@ -158,6 +159,166 @@ namespace K {
 
 	}
 
+	/** reference DFT (O(n^2)) */
+	template <typename type> std::vector<Complex<double>> fftRefDFT(const std::vector<Complex<type>>& x) {
+		const size_t n = x.size();
+		std::vector<Complex<double>> res(n);
+		for (size_t k = 0; k < n; ++k) {
+			double r = 0;
+			double i = 0;
+			for (size_t j = 0; j < n; ++j) {
+				const double a = -2.0 * M_PI * (double) ((k*j) % n) / (double) n;
+				r += x[j].r * std::cos(a) - x[j].i * std::sin(a);
+				i += x[j].r * std::sin(a) + x[j].i * std::cos(a);
+			}
+			res[k] = Complex<double>(r, i);
+		}
+		return res;
+	}
+
+	template <typename type> std::vector<Complex<type>> fftRandomSignal(const unsigned int n) {
+		std::vector<Complex<type>> x(n);
+		for (Complex<type>& c : x) {c = Complex<type>((type) rand() / (type) RAND_MAX - (type) 0.5, (type) rand() / (type) RAND_MAX - (type) 0.5);}
+		return x;
+	}
+
+	/** complex forward/inverse of the plan vs. the reference DFT for power-of-2, mixed-radix and prime (bluestein) sizes */
+	TEST(FFT, planComplex) {
+
+		const unsigned int sizes[] = {1, 2, 3, 4, 5, 7, 8, 12, 16, 30, 64, 97, 100, 210, 256, 1000, 1024, 1031};
+
+		for (const unsigned int n : sizes) {
+
+			const std::vector<Complex<double>> x = fftRandomSignal<double>(n);
+			const std::vector<Complex<double>> ref = fftRefDFT(x);
+
+			FFTPlan<double> plan(n);
+			ASSERT_EQ(n == 97 || n == 1031, plan.isBluestein());
+
+			std::vector<Complex<double>> y = x;
+			plan.forward(y.data());
+			for (unsigned int k = 0; k < n; ++k) {
+				ASSERT_NEAR(ref[k].r, y[k].r, 1e-9 * n) << "size " << n;
+				ASSERT_NEAR(ref[k].i, y[k].i, 1e-9 * n) << "size " << n;
+			}
+
+			plan.inverse(y.data());
+			for (unsigned int k = 0; k < n; ++k) {
+				ASSERT_NEAR(x[k].r, y[k].r, 1e-12 * n);
+				ASSERT_NEAR(x[k].i, y[k].i, 1e-12 * n);
+			}
+
+		}
+
+	}
+
+	/** float version using the 2-lane SIMD butterflies */
+	TEST(FFT, planComplexFloat) {
+
+		const unsigned int sizes[] = {2, 8, 32, 48, 512, 4096, 101};
+
+		for (const unsigned int n : sizes) {
+
+			const std::vector<Complex<float>> x = fftRandomSignal<float>(n);
+			const std::vector<Complex<double>> ref = fftRefDFT(x);
+
+			FFTPlan<float> plan(n);
+			std::vector<Complex<float>> y = x;
+			plan.forward(y.data());
+			for (unsigned int k = 0; k < n; ++k) {
+				ASSERT_NEAR(ref[k].r, y[k].r, 1e-4 * std::sqrt(n)) << "size " << n;
+				ASSERT_NEAR(ref[k].i, y[k].i, 1e-4 * std::sqrt(n)) << "size " << n;
+			}
+
+		}
+
+	}
+
+	/** packed real-input transform (even sizes) and the complex fallback (odd sizes) */
+	TEST(FFT, planReal) {
+
+		const unsigned int sizes[] = {2, 4, 6, 16, 18, 100, 512, 9, 15};
+
+		for (const unsigned int n : sizes) {
+
+			std::vector<double> x(n);
+			std::vector<Complex<double>> xc(n);
+			for (unsigned int i = 0; i < n; ++i) {x[i] = (double) rand() / (double) RAND_MAX; xc[i] = Complex<double>(x[i], 0);}
+			const std::vector<Complex<double>> ref = fftRefDFT(xc);
+
+			FFTPlan<double> plan(n);
+			std::vector<Complex<double>> bins(n/2+1);
+			plan.forwardReal(x.data(), bins.data());
+			for (unsigned int k = 0; k <= n/2; ++k) {
+				ASSERT_NEAR(ref[k].r, bins[k].r, 1e-9) << "size " << n;
+				ASSERT_NEAR(ref[k].i, bins[k].i, 1e-9) << "size " << n;
+			}
+
+			std::vector<double> back(n);
+			plan.inverseReal(bins.data(), back.data());
+			for (unsigned int i = 0; i < n; ++i) {ASSERT_NEAR(x[i], back[i], 1e-12);}
+
+		}
+
+	}
+
+	/** sizes far beyond the 64k limit of the bit-reverse LUTs, executed multi-threaded */
+	TEST(FFT, planLarge) {
+
+		const unsigned int n = 1 << 20;
+		std::vector<Complex<double>> x(n);
+		fftFillSine((double*) x.data(), n);		// interleaved: real and imaginary parts
+
+		FFTPlan<double> plan(n);
+		std::vector<Complex<double>> y = x;
+		plan.forward(y.data());
+
+		// compare a few bins with the DFT definition
+		for (unsigned int k : {0u, 1u, 7u, 4096u, n-1}) {
+			double r = 0;
+			double i = 0;
+			for (unsigned int j = 0; j < n; ++j) {
+				const double a = -2.0 * M_PI * (double) (((unsigned long long) k*j) % n) / (double) n;
+				r += x[j].r * std::cos(a) - x[j].i * std::sin(a);
+				i += x[j].r * std::sin(a) + x[j].i * std::cos(a);
+			}
+			ASSERT_NEAR(r, y[k].r, 1e-6);
+			ASSERT_NEAR(i, y[k].i, 1e-6);
+		}
+
+		plan.inverse(y.data());
+		for (unsigned int j = 0; j < n; ++j) {ASSERT_NEAR(x[j].r, y[j].r, 1e-9);}
+
+	}
+
+	/** batched transforms must match single transforms */
+	TEST(FFT, planBatch) {
+
+		const unsigned int n = 240;
+		const unsigned int cnt = 64;
+
+		FFTPlan<float> plan(n);
+		std::vector<float> in(n*cnt);
+		for (float& f : in) {f = (float) rand() / (float) RAND_MAX;}
+
+		std::vector<Complex<float>> out(cnt * (n/2+1));
+		plan.forwardRealBatch(in.data(), out.data(), cnt);
+
+		std::vector<Complex<float>> single(n/2+1);
+		for (unsigned int i = 0; i < cnt; ++i) {
+			plan.forwardReal(in.data() + i*n, single.data());
+			for (unsigned int k = 0; k <= n/2; ++k) {
+				ASSERT_EQ(single[k].r, out[i*(n/2+1)+k].r);
+				ASSERT_EQ(single[k].i, out[i*(n/2+1)+k].i);
+			}
+		}
+
+		std::vector<float> back(n*cnt);
+		plan.inverseRealBatch(out.data(), back.data(), cnt);
+		for (unsigned int i = 0; i < n*cnt; ++i) {ASSERT_NEAR(in[i], back[i], 1e-5);}
+
+	}
+
 	TEST(FFT, Benchmark) {
 
 		bindCurrentThreadToCore(0);
@@ -228,6 +389,77 @@ namespace K {
 
 		}
 
+		{
+			std::cout << "planned FFT (complex)" << std::endl;
+
+			FFTPlan<double> fft(SIZE);
+			std::vector<Complex<double>> buf(SIZE);
+			for (unsigned int i = 0; i < SIZE; ++i) {buf[i].r = sine[i];}
+			uint64_t s = K::Time::getTimeMS();
+			for (unsigned int i = 0; i < REP; ++i) {
+				fft.forward(buf.data());
+			}
+			uint64_t e = K::Time::getTimeMS();
+			std::cout << "exec: " << (e-s) << std::endl;
+
+		}
+
+		{
+			std::cout << "planned FFT (real input)" << std::endl;
+
+			FFTPlan<double> fft(SIZE);
+			std::vector<Complex<double>> bins(SIZE/2+1);
+			uint64_t s = K::Time::getTimeMS();
+			for (unsigned int i = 0; i < REP; ++i) {
+				fft.forwardReal(sine, bins.data());
+			}
+			uint64_t e = K::Time::getTimeMS();
+			std::cout << "exec: " << (e-s) << std::endl;
+
+		}
+
+		{
+			std::cout << "planned FFT (real input, batch of " << REP << ")" << std::endl;
+
+			FFTPlan<double> fft(SIZE);
+			std::vector<double> in(SIZE*REP);
+			for (unsigned int i = 0; i < REP; ++i) {std::copy(sine, sine+SIZE, in.begin() + i*SIZE);}
+			std::vector<Complex<double>> bins((SIZE/2+1)*REP);
+			uint64_t s = K::Time::getTimeMS();
+			fft.forwardRealBatch(in.data(), bins.data(), REP);
+			uint64_t e = K::Time::getTimeMS();
+			std::cout << "exec: " << (e-s) << std::endl;
+
+		}
+
+		// other sizes: the FFT class is limited to 64k
+		for (const unsigned int size : {256u, 65536u, 1000u, 1u << 20}) {
+
+			const unsigned int rep = std::max(1u, (REP * SIZE) / size);
+			std::vector<double> in(size);
+			fftFillSine(in.data(), size);
+
+			std::cout << "size " << size << " x " << rep << std::endl;
+
+			if ((size & (size-1)) == 0 && size <= 65536) {
+				FFT fft(size);
+				std::vector<Complex<double>> buf(size);
+				uint64_t s = K::Time::getTimeMS();
+				for (unsigned int i = 0; i < rep; ++i) {fft.getComplexFFT(in.data(), buf.data());}
+				uint64_t e = K::Time::getTimeMS();
+				std::cout << "\tdynamic FFT: " << (e-s) << std::endl;
+			}
+
+			{
+				FFTPlan<double> fft(size);
+				std::vector<Complex<double>> bins(size/2+1);
+				uint64_t s = K::Time::getTimeMS();
+				for (unsigned int i = 0; i < rep; ++i) {fft.forwardReal(in.data(), bins.data());}
+				uint64_t e = K::Time::getTimeMS();
+				std::cout << "\tplanned FFT (real input): " << (e-s) << std::endl;
+			}
+
+		}
 
 	}
 
@@ -13,6 +13,11 @@
 #include "TestDSPHelper.h"
 #include "../../../math/dsp/filter/IIRSinglePoleLowPass.h"
 #include "../../../math/dsp/filter/IIRMovingAverage.h"
+#include "../../../math/dsp/filter/IIRDesign.h"
+#include "../../../math/dsp/filter/IIRBiquadCascade.h"
+#include "../../../math/dsp/filter/IIRBiquadBank.h"
+#include "../../../math/dsp/filter/IIRChebyshev.h"
+#include "../../../os/Time.h"
 
 #include "../../../math/dsp/dft/FFT.h"
 #include "../../../math/dsp/dft/DFT.h"
@@ -50,6 +55,275 @@ namespace K {
 
 
 
+	/** block processing must match sample-by-sample filtering, for any block sizes */
+	template <typename T, int size> static void checkMovingAverageBlocks(const int range, const double maxErr) {
+		IIRMovingAverage<T, size> ref;
+		IIRMovingAverage<T, size> blk;
+		std::vector<T> in(5000);
+		std::vector<T> out(in.size());
+		for (T& v : in) {v = (T) (rand() % (2*range+1) - range);}
+		for (size_t i = 0; i < in.size(); ) {
+			const unsigned int cnt = std::min((unsigned int) (in.size() - i), (unsigned int) (rand() % (3*size)));
+			blk.process(&in[i], &out[i], cnt);
+			i += cnt;
+		}
+		for (size_t i = 0; i < in.size(); ++i) {
+			const T exp = ref.filter(in[i]);
+			ASSERT_NEAR((double) exp, (double) out[i], maxErr);
+		}
+	}
+
+	TEST(IIR, MovingAverageBlock) {
+		checkMovingAverageBlocks<float, 1>(1000, 1e-4);
+		checkMovingAverageBlocks<float, 7>(1000, 1e-4);
+		checkMovingAverageBlocks<float, 64>(1000, 1e-4);
+		checkMovingAverageBlocks<double, 13>(1000, 1e-9);
+		checkMovingAverageBlocks<int16_t, 1>(32767, 0);
+		checkMovingAverageBlocks<int16_t, 9>(32767, 0);
+		checkMovingAverageBlocks<int16_t, 100>(32767, 0);
+		checkMovingAverageBlocks<int32_t, 5>(2000000000, 0);
+		checkMovingAverageBlocks<int32_t, 128>(2000000000, 0);
+	}
+
+	/** the integer running sum is exact: no drift, even after many samples */
+	TEST(IIR, MovingAverageExact) {
+		IIRMovingAverage<int32_t, 16> ma;
+		std::vector<int32_t> in(1000000);
+		std::vector<int32_t> out(in.size());
+		for (size_t i = 0; i < in.size(); ++i) {in[i] = (i % 2) ? (2000000000) : (-2000000000 + 16);}
+		ma.process(in.data(), out.data(), (unsigned int) in.size());
+		for (size_t i = 16; i < in.size(); ++i) {ASSERT_EQ(8, out[i]);}
+	}
+
+	TEST(IIR, MovingAverageBenchmark) {
+
+		const unsigned int len = 8*1024*1024;
+		std::vector<float> inF(len);
+		std::vector<float> outF(len);
+		std::vector<int16_t> inS(len);
+		std::vector<int16_t> outS(len);
+		for (unsigned int i = 0; i < len; ++i) {inF[i] = (float) (rand() % 1000); inS[i] = (int16_t) (rand() % 1000);}
+
+		{
+			IIRMovingAverage<float, 32> ma;
+			uint64_t s = K::Time::getTimeMS();
+			for (unsigned int i = 0; i < len; ++i) {outF[i] = ma.filter(inF[i]);}
+			uint64_t e = K::Time::getTimeMS();
+			std::cout << "moving average float, per sample: " << (e-s) << " ms" << std::endl;
+		}
+		{
+			IIRMovingAverage<float, 32> ma;
+			uint64_t s = K::Time::getTimeMS();
+			for (unsigned int i = 0; i < len; i += 4096) {ma.process(&inF[i], &outF[i], 4096);}
+			uint64_t e = K::Time::getTimeMS();
+			std::cout << "moving average float, blocks: " << (e-s) << " ms" << std::endl;
+		}
+		{
+			IIRMovingAverage<int16_t, 32> ma;
+			uint64_t s = K::Time::getTimeMS();
+			for (unsigned int i = 0; i < len; ++i) {outS[i] = ma.filter(inS[i]);}
+			uint64_t e = K::Time::getTimeMS();
+			std::cout << "moving average int16, per sample: " << (e-s) << " ms" << std::endl;
+		}
+		{
+			IIRMovingAverage<int16_t, 32> ma;
+			uint64_t s = K::Time::getTimeMS();
+			for (unsigned int i = 0; i < len; i += 4096) {ma.process(&inS[i], &outS[i], 4096);}
+			uint64_t e = K::Time::getTimeMS();
+			std::cout << "moving average int16, blocks: " << (e-s) << " ms" << std::endl;
+		}
+
+	}
+
+	TEST(IIR, DesignButterworth) {
+
+		const double fs = 48000;
+
+		for (int order = 1; order <= 8; ++order) {
+
+			const std::vector<IIRBiquad> lp = IIRDesign::butterworthLowPass(order, 1000, fs);
+			ASSERT_EQ((size_t) (order+1)/2, lp.size());
+			ASSERT_NEAR(1.0, IIRDesign::getMagnitude(lp, 0, fs), 1e-9);
+			ASSERT_NEAR(M_SQRT1_2, IIRDesign::getMagnitude(lp, 1000, fs), 1e-6);
+			ASSERT_LT(IIRDesign::getMagnitude(lp, 4000, fs), IIRDesign::getMagnitude(lp, 2000, fs));
+
+			const std::vector<IIRBiquad> hp = IIRDesign::butterworthHighPass(order, 1000, fs);
+			ASSERT_NEAR(1.0, IIRDesign::getMagnitude(hp, fs/2, fs), 1e-9);
+			ASSERT_NEAR(M_SQRT1_2, IIRDesign::getMagnitude(hp, 1000, fs), 1e-6);
+			ASSERT_NEAR(0.0, IIRDesign::getMagnitude(hp, 0, fs), 1e-9);
+
+		}
+
+	}
+
+	TEST(IIR, DesignChebyshev) {
+
+		const double fs = 48000;
+		const double ripple = 1.0;
+		const double atten = 40.0;
+
+		for (int order = 2; order <= 7; ++order) {
+
+			// type I: passband within [-ripple:0] dB, -ripple at the edge
+			const std::vector<IIRBiquad> c1 = IIRDesign::chebyshev1LowPass(order, ripple, 2000, fs);
+			for (double f = 0; f <= 2000; f += 20) {
+				const double db = 20 * std::log10(IIRDesign::getMagnitude(c1, f, fs));
+				ASSERT_LE(db, 1e-6);
+				ASSERT_GE(db, -ripple - 1e-6);
+			}
+			ASSERT_NEAR(-ripple, 20 * std::log10(IIRDesign::getMagnitude(c1, 2000, fs)), 1e-6);
+
+			const std::vector<IIRBiquad> c1h = IIRDesign::chebyshev1HighPass(order, ripple, 2000, fs);
+			ASSERT_NEAR(-ripple, 20 * std::log10(IIRDesign::getMagnitude(c1h, 2000, fs)), 1e-6);
+
+			// type II: flat passband, stopband below -atten from the edge on
+			const std::vector<IIRBiquad> c2 = IIRDesign::chebyshev2LowPass(order, atten, 2000, fs);
+			ASSERT_NEAR(1.0, IIRDesign::getMagnitude(c2, 0, fs), 1e-9);
+			ASSERT_NEAR(-atten, 20 * std::log10(IIRDesign::getMagnitude(c2, 2000, fs)), 1e-6);
+			for (double f = 2000; f < fs/2; f += 100) {
+				ASSERT_LE(20 * std::log10(IIRDesign::getMagnitude(c2, f, fs)), -atten + 1e-6);
+			}
+
+			const std::vector<IIRBiquad> c2h = IIRDesign::chebyshev2HighPass(order, atten, 2000, fs);
+			ASSERT_NEAR(1.0, IIRDesign::getMagnitude(c2h, fs/2, fs), 1e-9);
+			ASSERT_NEAR(-atten, 20 * std::log10(IIRDesign::getMagnitude(c2h, 2000, fs)), 1e-6);
+
+		}
+
+	}
+
+	TEST(IIR, DesignShelf) {
+
+		const double fs = 44100;
+		const std::vector<IIRBiquad> low = {IIRDesign::lowShelf(200, fs, 6)};
+		ASSERT_NEAR(6.0, 20 * std::log10(IIRDesign::getMagnitude(low, 0, fs)), 1e-6);
+		ASSERT_NEAR(0.0, 20 * std::log10(IIRDesign::getMagnitude(low, fs/2, fs)), 1e-2);
+
+		const std::vector<IIRBiquad> high = {IIRDesign::highShelf(5000, fs, -9)};
+		ASSERT_NEAR(-9.0, 20 * std::log10(IIRDesign::getMagnitude(high, fs/2, fs)), 1e-6);
+		ASSERT_NEAR(0.0, 20 * std::log10(IIRDesign::getMagnitude(high, 0, fs)), 1e-6);
+
+		const std::vector<IIRBiquad> pk = {IIRDesign::peak(1000, fs, 3, 1)};
+		ASSERT_NEAR(3.0, 20 * std::log10(IIRDesign::getMagnitude(pk, 1000, fs)), 1e-6);
+
+	}
+
+	/** the amplitude of a filtered sine must match the designed magnitude */
+	TEST(IIR, CascadeSine) {
+
+		const double fs = 8000;
+		IIRChebyshev<double> cheb;
+		cheb.setLowPass(5, 0.5, 1000, fs);
+
+		for (const double f : {100.0, 900.0, 1500.0}) {
+			const int n = 8000;
+			std::vector<double> x(n);
+			for (int i = 0; i < n; ++i) {x[i] = std::sin(2 * M_PI * f * i / fs);}
+			cheb.reset();
+			cheb.process(x.data(), x.data(), n);
+			double amp = 0;
+			for (int i = n/2; i < n; ++i) {amp = std::max(amp, std::abs(x[i]));}
+			const std::vector<IIRBiquad> sos = IIRDesign::chebyshev1LowPass(5, 0.5, 1000, fs);
+			ASSERT_NEAR(IIRDesign::getMagnitude(sos, f, fs), amp, 1e-3);
+		}
+
+	}
+
+	TEST(IIR, CascadeBlockVsSample) {
+
+		const std::vector<IIRBiquad> sos = IIRDesign::butterworthHighPass(6, 300, 44100);
+		IIRBiquadCascade<float> a(sos);
+		IIRBiquadCascade<float> b(sos);
+
+		std::vector<float> x(1000);
+		for (float& v : x) {v = (float) rand() / (float) RAND_MAX - 0.5f;}
+		std::vector<float> y(x.size());
+		a.process(x.data(), y.data(), 500);
+		a.process(x.data() + 500, y.data() + 500, 500);
+		for (size_t i = 0; i < x.size(); ++i) {ASSERT_NEAR(b.filter(x[i]), y[i], 1e-5);}
+
+	}
+
+	TEST(IIR, Bank) {
+
+		const int channels = 7;
+		const int frames = 1000;
+		const std::vector<IIRBiquad> sos = IIRDesign::butterworthLowPass(4, 2000, 44100);
+
+		IIRBiquadBank bank(channels, sos);
+		bank.setSections(3, IIRDesign::chebyshev1HighPass(4, 1.0, 500, 44100));
+
+		std::vector<float> x(channels * frames);
+		for (float& v : x) {v = (float) rand() / (float) RAND_MAX - 0.5f;}
+
+		// interleaved, inplace, in two blocks
+		std::vector<float> y = x;
+		bank.processInterleaved(y.data(), y.data(), 300);
+		bank.processInterleaved(y.data() + 300*channels, y.data() + 300*channels, frames - 300);
+
+		// planar
+		std::vector<std::vector<float>> planar(channels, std::vector<float>(frames));
+		std::vector<float*> ptrs;
+		for (int c = 0; c < channels; ++c) {
+			for (int f = 0; f < frames; ++f) {planar[c][f] = x[f*channels + c];}
+			ptrs.push_back(planar[c].data());
+		}
+		IIRBiquadBank bank2(channels, sos);
+		bank2.setSections(3, IIRDesign::chebyshev1HighPass(4, 1.0, 500, 44100));
+		bank2.processPlanar(ptrs.data(), ptrs.data(), frames);
+
+		for (int c = 0; c < channels; ++c) {
+			IIRBiquadCascade<float> ref((c == 3) ? (IIRDesign::chebyshev1HighPass(4, 1.0, 500, 44100)) : (sos));
+			std::vector<float> r(frames);
+			for (int f = 0; f < frames; ++f) {r[f] = x[f*channels + c];}
+			ref.process(r.data(), r.data(), frames);
+			for (int f = 0; f < frames; ++f) {
+				ASSERT_NEAR(r[f], y[f*channels + c], 1e-5);
+				ASSERT_NEAR(r[f], planar[c][f], 1e-5);
+			}
+		}
+
+	}
+
+	/** silence after a signal must not run into denormals */
+	TEST(IIR, Denormal) {
+
+		IIRBiquadBank bank(4, IIRDesign::butterworthLowPass(8, 100, 44100));
+		std::vector<float> x(4 * 44100, 0.0f);
+		x[0] = 1.0f;
+		bank.processInterleaved(x.data(), x.data(), 44100);
+		for (const float v : x) {ASSERT_TRUE(v == 0 || std::fpclassify(v) == FP_NORMAL);}
+
+	}
+
+	TEST(IIR, BankBenchmark) {
+
+		const int channels = 16;
+		const int frames = 48000 * 10;
+		const std::vector<IIRBiquad> sos = IIRDesign::butterworthLowPass(8, 1000, 48000);
+		std::vector<float> x(channels * frames);
+		for (float& v : x) {v = (float) rand() / (float) RAND_MAX - 0.5f;}
+
+		{
+			std::vector<IIRBiquadCascade<float>> filters(channels, IIRBiquadCascade<float>(sos));
+			uint64_t s = K::Time::getTimeMS();
+			for (int f = 0; f < frames; ++f) {
+				for (int c = 0; c < channels; ++c) {x[f*channels+c] = filters[c].filter(x[f*channels+c]);}
+			}
+			uint64_t e = K::Time::getTimeMS();
+			std::cout << "per-sample cascades: " << (e-s) << " ms" << std::endl;
+		}
+
+		{
+			IIRBiquadBank bank(channels, sos);
+			uint64_t s = K::Time::getTimeMS();
+			for (int f = 0; f < frames; f += 256) {bank.processInterleaved(&x[f*channels], &x[f*channels], std::min(256, frames-f));}
+			uint64_t e = K::Time::getTimeMS();
+			std::cout << "SIMD bank (256 frame blocks): " << (e-s) << " ms" << std::endl;
+		}
+
+	}
+
 	TEST(IIR, StepResponse) {
 
 		const unsigned int size = 256;
@@ -0,0 +1,127 @@
+
+
+#ifdef WITH_TESTS
+
+#include "../../Test.h"
+#include "../../../math/dsp/resampling/DSPResampler.h"
+#include "../../../math/dsp/window/DSPWindowHanning.h"
+#include "../../../os/Time.h"
+
+namespace K {
+
+	/** resample a sine and compare the (settled) output with the ideal, delayed sine */
+	template <typename T> static double resampleSineError(DSPResampler<T>& rs, const double inRate, const double outRate, const double freq, const unsigned int len) {
+
+		std::vector<T> in(len);
+		for (unsigned int i = 0; i < len; ++i) {in[i] = (T) std::sin(2 * M_PI * freq * i / inRate);}
+
+		std::vector<T> out(rs.getMaxOutput(len));
+		const unsigned int cnt = rs.process(in.data(), len, out.data());
+
+		double err = 0;
+		const unsigned int settle = (unsigned int) (2 * rs.getDelay() * outRate / inRate) + 1;
+		for (unsigned int n = settle; n < cnt; ++n) {
+			const double t = n / outRate - rs.getDelay() / inRate;
+			err = std::max(err, std::abs(std::sin(2 * M_PI * freq * t) - out[n]));
+		}
+		return err;
+
+	}
+
+	TEST(Resampler, rational) {
+
+		struct Conf {unsigned int in; unsigned int out; double freq;};
+		const Conf confs[] = {
+			{44100, 48000, 1000}, {48000, 44100, 1000}, {44100, 48000, 15000},
+			{48000, 96000, 3000}, {48000, 192000, 7000}, {192000, 48000, 2000}, {48000, 16000, 500},
+		};
+
+		for (const Conf& c : confs) {
+			DSPResampler<double> rs(c.in, c.out, 64);
+			ASSERT_FALSE(rs.isArbitrary());
+			const double err = resampleSineError(rs, c.in, c.out, c.freq, 20000);
+			ASSERT_LT(err, 2e-3) << c.in << " -> " << c.out;
+		}
+
+	}
+
+	TEST(Resampler, arbitrary) {
+
+		for (const double ratio : {1.2345, 0.777, 2.5}) {
+			DSPResampler<float> rs = DSPResampler<float>::getArbitrary(ratio, 48, 0.9, &DSPWindowHanning<float, 1>::getValue);
+			ASSERT_TRUE(rs.isArbitrary());
+			const double err = resampleSineError(rs, 1.0, ratio, 0.03, 20000);
+			ASSERT_LT(err, 2e-3) << ratio;
+		}
+
+	}
+
+	/** the result must not depend on the chunks the input is split into */
+	TEST(Resampler, blocks) {
+
+		std::vector<float> in(30000);
+		for (float& f : in) {f = (float) rand() / (float) RAND_MAX - 0.5f;}
+
+		for (int mode = 0; mode < 2; ++mode) {
+
+			DSPResampler<float> a = (mode == 0) ? (DSPResampler<float>(44100, 48000)) : (DSPResampler<float>::getArbitrary(1.1));
+			DSPResampler<float> b = (mode == 0) ? (DSPResampler<float>(44100, 48000, 32, 0.9, &DSPWindowBlackman<float, 1>::getValue, 100)) : (DSPResampler<float>::getArbitrary(1.1, 32, 0.9, &DSPWindowBlackman<float, 1>::getValue, 100));
+
+			std::vector<float> outA(a.getMaxOutput((unsigned int) in.size()));
+			const unsigned int cntA = a.process(in.data(), (unsigned int) in.size(), outA.data());
+
+			std::vector<float> outB(outA.size() + 100);
+			unsigned int cntB = 0;
+			for (size_t i = 0; i < in.size(); ) {
+				const unsigned int cnt = std::min((unsigned int) (in.size() - i), (unsigned int) (rand() % 1000));
+				cntB += b.process(&in[i], cnt, &outB[cntB]);
+				i += cnt;
+			}
+
+			ASSERT_EQ(cntA, cntB);
+			for (unsigned int i = 0; i < cntA; ++i) {ASSERT_EQ(outA[i], outB[i]);}
+
+		}
+
+	}
+
+	/** tones above the new nyquist frequency must be suppressed */
+	TEST(Resampler, antiAliasing) {
+
+		DSPResampler<float> rs(48000u, 12000u, 64);
+		const unsigned int len = 48000;
+		std::vector<float> in(len);
+		for (unsigned int i = 0; i < len; ++i) {in[i] = (float) std::sin(2 * M_PI * 9000 * i / 48000.0);}
+		std::vector<float> out(rs.getMaxOutput(len));
+		const unsigned int cnt = rs.process(in.data(), len, out.data());
+		ASSERT_NEAR(12000, cnt, 1);
+		float maxAmp = 0;
+		for (unsigned int i = 1000; i < cnt; ++i) {maxAmp = std::max(maxAmp, std::abs(out[i]));}
+		ASSERT_LT(maxAmp, 1e-3);
+
+	}
+
+	TEST(Resampler, benchmark) {
+
+		const unsigned int len = 44100 * 60;
+		std::vector<float> in(len);
+		for (unsigned int i = 0; i < len; ++i) {in[i] = (float) std::sin(0.01 * i);}
+
+		DSPResampler<float> rs(44100u, 48000u, 32);
+		std::vector<float> out(rs.getMaxOutput(4096));
+		uint64_t s = K::Time::getTimeMS();
+		for (unsigned int i = 0; i < len; i += 4096) {rs.process(&in[i], std::min(4096u, len - i), out.data());}
+		uint64_t e = K::Time::getTimeMS();
+		std::cout << "44.1k -> 48k, 60 seconds: " << (e-s) << " ms" << std::endl;
+
+		DSPResampler<float> rs2 = DSPResampler<float>::getArbitrary(1.0884, 32);
+		s = K::Time::getTimeMS();
+		for (unsigned int i = 0; i < len; i += 4096) {rs2.process(&in[i], std::min(4096u, len - i), out.data());}
+		e = K::Time::getTimeMS();
+		std::cout << "arbitrary 1.0884, 60 seconds: " << (e-s) << " ms" << std::endl;
+
+	}
+
+}
+
+#endif
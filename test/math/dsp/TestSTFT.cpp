@@ -0,0 +1,150 @@
+
+
+#ifdef WITH_TESTS
+
+#include "../../Test.h"
+#include "../../../math/dsp/dft/STFT.h"
+#include "../../../math/dsp/dft/ISTFT.h"
+#include "../../../math/dsp/window/DSPWindowHamming.h"
+#include "../../../os/Time.h"
+
+namespace K {
+
+	static std::vector<double> stftGetSignal(const size_t len) {
+		std::vector<double> x(len);
+		for (size_t i = 0; i < len; ++i) {x[i] = std::sin(0.01 * (double) i) + 0.3 * std::sin(0.37 * (double) i) + 0.1 * ((double) rand() / RAND_MAX - 0.5);}
+		return x;
+	}
+
+	TEST(STFT, sineBin) {
+
+		const unsigned int n = 256;
+		STFT<double> stft(n, 64);
+
+		// sine exactly at bin 16
+		std::vector<double> x(1024);
+		for (size_t i = 0; i < x.size(); ++i) {x[i] = std::sin(2 * M_PI * 16 * (double) i / n);}
+		ASSERT_EQ(13u, stft.push(x.data(), (unsigned int) x.size()));
+
+		std::vector<double> mag(stft.getNumBins());
+		std::vector<double> phase(stft.getNumBins());
+		ASSERT_TRUE(stft.popFrame(mag.data(), phase.data()));
+		const size_t maxBin = std::max_element(mag.begin(), mag.end()) - mag.begin();
+		ASSERT_EQ(16u, maxBin);
+		ASSERT_NEAR(n / 4.0, mag[16], 1e-9);		// hann: amplitude * n/2 * 0.5
+
+	}
+
+	/** streaming in random chunks must yield the same frames as analyze() */
+	TEST(STFT, streamVsBatch) {
+
+		const std::vector<double> x = stftGetSignal(10000);
+		STFT<double> stft(512, 128, 1000, &DSPWindowHamming<double, 1>::getValue);
+
+		const size_t frames = stft.getNumFrames(x.size());
+		const unsigned int bins = stft.getNumBins();
+		std::vector<double> mag(frames * bins);
+		std::vector<double> phase(frames * bins);
+		stft.analyze(x.data(), x.size(), mag.data(), phase.data());
+
+		for (size_t i = 0; i < x.size(); ) {
+			const unsigned int cnt = std::min((unsigned int) (x.size() - i), (unsigned int) (rand() % 700));
+			stft.push(&x[i], cnt);
+			i += cnt;
+		}
+		ASSERT_EQ(frames, stft.getNumFrames());
+
+		std::vector<double> m(bins);
+		std::vector<double> p(bins);
+		for (size_t f = 0; f < frames; ++f) {
+			ASSERT_TRUE(stft.popFrame(m.data(), p.data()));
+			for (unsigned int k = 0; k < bins; ++k) {
+				ASSERT_EQ(mag[f*bins+k], m[k]);
+				ASSERT_EQ(phase[f*bins+k], p[k]);
+			}
+		}
+		ASSERT_FALSE(stft.popFrame(m.data(), p.data()));
+
+	}
+
+	TEST(STFT, ringOverflow) {
+		STFT<float> stft(64, 32, 4);
+		std::vector<float> x(64 + 32*9, 1.0f);
+		ASSERT_EQ(10u, stft.push(x.data(), (unsigned int) x.size()));
+		ASSERT_EQ(4u, stft.getNumFrames());
+		ASSERT_EQ(6u, stft.getNumDropped());
+	}
+
+	/** analysis + synthesis must reconstruct the signal (COLA normalization) */
+	TEST(STFT, reconstruct) {
+
+		for (const unsigned int hop : {64u, 128u, 256u}) {
+
+			const unsigned int n = 512;
+			const std::vector<double> x = stftGetSignal(n + 99 * hop);
+
+			STFT<double> stft(n, hop);
+			const size_t frames = stft.getNumFrames(x.size());
+			std::vector<double> mag(frames * stft.getNumBins());
+			std::vector<double> phase(frames * stft.getNumBins());
+			stft.analyze(x.data(), x.size(), mag.data(), phase.data());
+
+			// batch
+			ISTFT<double> istft(n, hop);
+			std::vector<double> y(x.size());
+			istft.synthesize(mag.data(), phase.data(), frames, y.data());
+
+			// the edges are only covered by the window's tails (see ISTFT): the 1st sample is lost, the next ones less accurate
+			ASSERT_EQ(0.0, y[0]);
+			for (size_t i = 8; i < x.size() - 8; ++i) {ASSERT_NEAR(x[i], y[i], 1e-6) << "hop " << hop << " i " << i;}
+
+			// streaming
+			std::vector<double> z(x.size());
+			for (size_t f = 0; f < frames; ++f) {
+				istft.pushFrame(&mag[f * stft.getNumBins()], &phase[f * stft.getNumBins()], &z[f * hop]);
+			}
+			istft.flush(&z[frames * hop]);
+			for (size_t i = 8; i < x.size() - 8; ++i) {ASSERT_NEAR(x[i], z[i], 1e-6) << "hop " << hop << " i " << i;}
+
+		}
+
+	}
+
+	TEST(STFT, benchmark) {
+
+		const size_t len = 44100 * 60 * 5;
+		std::vector<float> x(len);
+		for (size_t i = 0; i < len; ++i) {x[i] = (float) std::sin(0.01 * (double) i);}
+
+		STFT<float> stft(1024, 256, 16);
+		const size_t frames = stft.getNumFrames(len);
+		std::vector<float> mag(frames * stft.getNumBins());
+		std::vector<float> phase(frames * stft.getNumBins());
+
+		uint64_t s = K::Time::getTimeMS();
+		stft.analyze(x.data(), len, mag.data(), phase.data());
+		uint64_t e = K::Time::getTimeMS();
+		std::cout << "analyze 5 minutes (" << frames << " frames): " << (e-s) << " ms" << std::endl;
+
+		std::vector<float> m(stft.getNumBins());
+		std::vector<float> p(stft.getNumBins());
+		s = K::Time::getTimeMS();
+		for (size_t i = 0; i < len; i += 4096) {
+			stft.push(&x[i], (unsigned int) std::min((size_t) 4096, len - i));
+			while (stft.popFrame(m.data(), p.data())) {;}
+		}
+		e = K::Time::getTimeMS();
+		std::cout << "streaming 5 minutes: " << (e-s) << " ms" << std::endl;
+
+		ISTFT<float> istft(1024, 256);
+		std::vector<float> y((frames - 1) * 256 + 1024);
+		s = K::Time::getTimeMS();
+		istft.synthesize(mag.data(), phase.data(), frames, y.data());
+		e = K::Time::getTimeMS();
+		std::cout << "synthesize 5 minutes: " << (e-s) << " ms" << std::endl;
+
+	}
+
+}
+
+#endif
@@ -14,6 +14,11 @@
 #include "../../../math/dsp/window/DSPWindowHanning.h"
 #include "../../../math/dsp/window/DSPWindowHamming.h"
 #include "../../../math/dsp/window/DSPWindowBartlett.h"
+#include "../../../os/Time.h"
+
+#include <vector>
+#include <random>
+#include <algorithm>
 
 namespace K {
 
@@ -91,6 +96,91 @@ namespace K {
 
 	}
 
+	/** block processing for float and fixed-point samples */
+	TEST(DSP, WindowProcess) {
+
+		auto hann = [] (const int i) {return DSPWindowHanning<float, 1>::getValue(i, 500);};
+		DSPWindowHanning<float, 500> wf;
+		DSPWindowHanning<int16_t, 500> ws;
+		DSPWindowHanning<int32_t, 500> wi;
+
+		std::minstd_rand gen(1337);
+		std::uniform_int_distribution<int16_t> dS(-32768, 32767);
+		std::uniform_int_distribution<int32_t> dI(-2147483647, 2147483647);
+
+		float inF[500], outF[500], refF[500];
+		int16_t inS[500], outS[500];
+		int32_t inI[500], outI[500];
+		for (int i = 0; i < 500; ++i) {
+			inF[i] = (float) sin(i * 0.1);
+			inS[i] = dS(gen);
+			inI[i] = dI(gen);
+			refF[i] = inF[i];
+		}
+
+		// float equals the scalar window
+		wf.process(inF, outF);
+		for (int i = 0; i < 500; ++i) {ASSERT_NEAR(inF[i] * hann(i), outF[i], 1e-6);}
+		wf.apply(refF);
+		for (int i = 0; i < 500; ++i) {ASSERT_EQ(refF[i], outF[i]);}
+
+		// fixed-point: within rounding of the Q15 window
+		ws.process(inS, outS);
+		for (int i = 0; i < 500; ++i) {ASSERT_NEAR(inS[i] * hann(i), outS[i], 1.01);}
+		wi.process(inI, outI);
+		for (int i = 0; i < 500; ++i) {ASSERT_NEAR(inI[i] * hann(i), outI[i], std::abs(inI[i]) / 32768.0 + 1);}
+
+		// apply() keeps converting the float product, thus truncates fixed-point samples
+		int16_t truncS[500];
+		std::copy(inS, inS + 500, truncS);
+		ws.apply(truncS);
+		for (int i = 0; i < 500; ++i) {ASSERT_EQ((int16_t) (inS[i] * (float) hann(i)), truncS[i]);}
+
+		// partial and inplace
+		wi.process(inI, inI, 123);
+		for (int i = 0; i < 123; ++i) {ASSERT_EQ(outI[i], inI[i]);}
+
+	}
+
+	TEST(DSP, WindowBenchmark) {
+
+		const int size = 1024;
+		const int runs = 50000;
+		DSPWindowBlackman<float, size> w;
+		DSPWindowBlackman<int16_t, size> ws;
+		std::vector<float> table(size);
+		for (int i = 0; i < size; ++i) {table[i] = (float) DSPWindowBlackman<float, 1>::getValue(i, size);}
+		std::vector<float> in(size, 1.0f);
+		std::vector<float> out(size);
+		std::vector<int16_t> inS(size, 1000);
+		std::vector<int16_t> outS(size);
+
+		uint64_t s = K::Time::getTimeMS();
+		for (int r = 0; r < runs; ++r) {
+			for (int i = 0; i < size; ++i) {out[i] = in[i] * table[i];}
+			in[r % size] = out[(r * 7) % size];
+		}
+		uint64_t e = K::Time::getTimeMS();
+		std::cout << "window float, scalar: " << (e-s) << " ms" << std::endl;
+
+		s = K::Time::getTimeMS();
+		for (int r = 0; r < runs; ++r) {
+			w.process(in.data(), out.data());
+			in[r % size] = out[(r * 7) % size];
+		}
+		e = K::Time::getTimeMS();
+		std::cout << "window float, block: " << (e-s) << " ms" << std::endl;
+
+		s = K::Time::getTimeMS();
+		for (int r = 0; r < runs; ++r) {
+			ws.process(inS.data(), outS.data());
+			inS[r % size] = outS[(r * 7) % size];
+		}
+		e = K::Time::getTimeMS();
+		std::cout << "window int16, block: " << (e-s) << " ms" << std::endl;
+
+	}
+
 }
 
 #endif
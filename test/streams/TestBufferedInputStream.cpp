@@ -65,4 +65,49 @@ TEST(BufferedInputStream, readBlocks) {
 
 }
 
+TEST(BufferedInputStream, zeroCopy) {
+
+	const std::string data = TestHelper::getLoremIpsum(64);
+
+	for (int mirror = 0; mirror < 2; ++mirror) {
+		for (unsigned int size = 1; size < 5000; size = size * 3 + 1) {
+
+			ByteArrayInputStream bais((uint8_t*) data.data(), (unsigned int) data.size());
+			BufferedInputStream bis(&bais, size, mirror != 0);
+
+			// consume random parts of contiguous views
+			std::string res;
+			while (true) {
+				const size_t want = (size_t) (rand() % 300) + 1;
+				RingBufferSpan<const uint8_t> span = bis.getAvailable(want);
+				if (span.empty()) {
+					if (bis.isEOF()) {break;}
+					continue;
+				}
+				ASSERT_GE(span.len, std::min(want, data.size() - res.size()));
+				const size_t use = std::min(span.len, (size_t) (rand() % 500));
+				res.append((const char*) span.data, use);
+				bis.consume(use);
+			}
+			ASSERT_EQ(data, res);
+
+		}
+	}
+
+}
+
+TEST(BufferedInputStream, skip) {
+
+	const char* data = "Lorem ipsum dolor sit amet, consetetur sadipscing elitr, sed diam";
+	ByteArrayInputStream bais((uint8_t*) data, (unsigned int) strlen(data));
+	BufferedInputStream bis(&bais, 8);
+
+	ASSERT_EQ('L', bis.read());
+	bis.skip(5);
+	ASSERT_EQ('i', bis.read());
+	bis.skip(20);
+	ASSERT_EQ(data[27], bis.read());
+
+}
+
 #endif
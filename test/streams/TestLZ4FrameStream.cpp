@@ -0,0 +1,213 @@
+/*
+ * TestLZ4FrameStream.cpp
+ *
+ */
+
+#ifdef WITH_TESTS
+#include "../Test.h"
+#include "../../streams/LZ4FrameOutputStream.h"
+#include "../../streams/LZ4FrameInputStream.h"
+#include "../../streams/LZ4FrameFileReader.h"
+#include "../../streams/LZ4OutputStream.h"
+#include "../../streams/ByteArrayOutputStream.h"
+#include "../../streams/ByteArrayInputStream.h"
+#include "../../streams/FileOutputStream.h"
+#include "../../os/Time.h"
+
+#include <vector>
+#include <functional>
+
+using namespace K;
+
+/** mix of compressible text and random bytes */
+static std::vector<uint8_t> getLZ4FrameData(const size_t len) {
+	std::vector<uint8_t> data(len);
+	const std::string lipsum = TestHelper::getLoremIpsum(64);
+	for (size_t i = 0; i < len; ++i) {
+		data[i] = ((i / 100000) % 3 == 2) ? ((uint8_t) rand()) : ((uint8_t) lipsum[i % lipsum.size()]);
+	}
+	return data;
+}
+
+TEST(LZ4FrameStream, xxh32) {
+	ASSERT_EQ(0x02CC5D05u, LZ4Frame::xxh32("", 0));
+	ASSERT_EQ(0x550D7456u, LZ4Frame::xxh32("a", 1));
+	ASSERT_EQ(0x32D153FFu, LZ4Frame::xxh32("abc", 3));
+}
+
+TEST(LZ4FrameStream, compressDecompress) {
+
+	for (size_t len : {(size_t) 0, (size_t) 1, (size_t) 65535, (size_t) 65536, (size_t) 1000000}) {
+
+		const std::vector<uint8_t> data = getLZ4FrameData(len);
+
+		ByteArrayOutputStream baos;
+		{
+			LZ4FrameOutputStream los(baos, 64*1024);
+			for (size_t i = 0; i < len; ) {
+				const size_t cnt = std::min(len - i, (size_t) (rand() % 30000));
+				los.write(data.data() + i, cnt);
+				i += cnt;
+			}
+			los.close();
+		}
+
+		// block based decompression
+		ByteArrayInputStream bais(baos.getData(), baos.getDataLength());
+		LZ4FrameInputStream lis(bais);
+		std::vector<uint8_t> res;
+		uint8_t buf[7777];
+		while (true) {
+			const ssize_t read = lis.read(buf, sizeof(buf));
+			if (read == -1) {break;}
+			res.insert(res.end(), buf, buf + read);
+		}
+		ASSERT_EQ(data, res);
+
+		// byte based decompression
+		ByteArrayInputStream bais2(baos.getData(), baos.getDataLength());
+		LZ4FrameInputStream lis2(bais2);
+		for (size_t i = 0; i < std::min(len, (size_t) 200000); ++i) {ASSERT_EQ(data[i], lis2.read());}
+
+	}
+
+}
+
+TEST(LZ4FrameStream, corrupted) {
+
+	const std::vector<uint8_t> data = getLZ4FrameData(300000);
+	ByteArrayOutputStream baos;
+	LZ4FrameOutputStream los(baos, 64*1024);
+	los.write(data.data(), data.size());
+	los.close();
+
+	std::vector<uint8_t> comp(baos.getData(), baos.getData() + baos.getDataLength());
+	comp[1000] ^= 0x10;
+
+	ByteArrayInputStream bais(comp.data(), comp.size());
+	LZ4FrameInputStream lis(bais);
+	uint8_t buf[4096];
+	ASSERT_THROW(while (lis.read(buf, 4096) != -1) {}, StreamException);
+
+}
+
+TEST(LZ4FrameStream, randomAccess) {
+
+	const std::vector<uint8_t> data = getLZ4FrameData(3*1024*1024 + 123);
+	const std::string file = getTempFile("lz4frame.lz4");
+	{
+		FileOutputStream fos(file);
+		LZ4FrameOutputStream los(fos, 256*1024);
+		los.write(data.data(), data.size());
+		los.close();
+	}
+
+	LZ4FrameFileReader reader(file);
+	ASSERT_EQ(data.size(), reader.getSize());
+	ASSERT_EQ(13u, reader.getNumBlocks());
+
+	std::vector<uint8_t> buf(1024*1024);
+	for (int i = 0; i < 100; ++i) {
+		const size_t offset = (size_t) rand() % data.size();
+		const size_t len = (size_t) rand() % buf.size();
+		const size_t read = reader.read(offset, buf.data(), len);
+		ASSERT_EQ(std::min(len, data.size() - offset), read);
+		for (size_t j = 0; j < read; ++j) {ASSERT_EQ(data[offset + j], buf[j]);}
+	}
+
+}
+
+TEST(LZ4FrameStream, corruptedIndex) {
+
+	const std::vector<uint8_t> data = getLZ4FrameData(300000);
+	ByteArrayOutputStream baos;
+	{
+		LZ4FrameOutputStream los(baos, 64*1024);
+		los.write(data.data(), data.size());
+		los.close();
+	}
+	const std::vector<uint8_t> valid(baos.getData(), baos.getData() + baos.getDataLength());
+	const std::string file = getTempFile("lz4frame_index.lz4");
+
+	// write a modified copy of the file and open it
+	auto open = [&] (std::function<void(std::vector<uint8_t>&)> modify) {
+		std::vector<uint8_t> comp = valid;
+		modify(comp);
+		{
+			FileOutputStream fos(file);
+			fos.write(comp.data(), comp.size());
+			fos.close();
+		}
+		LZ4FrameFileReader reader(file);
+		std::vector<uint8_t> buf(data.size());
+		reader.read(0, buf.data(), buf.size());
+	};
+
+	// the 5 index entries precede the 16 byte trailer
+	const size_t num = 5;
+	auto entry = [&] (std::vector<uint8_t>& comp, const size_t i) {return &comp[comp.size() - 16 - (num - i) * 16];};
+	auto set64 = [] (uint8_t* dst, const uint64_t val) {for (int i = 0; i < 8; ++i) {dst[i] = (uint8_t) (val >> (i*8));}};
+
+	ASSERT_NO_THROW(open([] (std::vector<uint8_t>&) {}));
+
+	// non-monotonic compressed offsets
+	ASSERT_THROW(open([&] (std::vector<uint8_t>& c) {std::swap_ranges(entry(c, 1), entry(c, 1) + 8, entry(c, 2));}), StreamException);
+
+	// compressed offset behind the blocks
+	ASSERT_THROW(open([&] (std::vector<uint8_t>& c) {set64(entry(c, 4), c.size());}), StreamException);
+
+	// non-monotonic / too large uncompressed offsets
+	ASSERT_THROW(open([&] (std::vector<uint8_t>& c) {std::swap_ranges(entry(c, 1) + 8, entry(c, 1) + 16, entry(c, 2) + 8);}), StreamException);
+	ASSERT_THROW(open([&] (std::vector<uint8_t>& c) {set64(entry(c, 4) + 8, data.size());}), StreamException);
+
+	// block size field exceeding the loaded data
+	ASSERT_THROW(open([&] (std::vector<uint8_t>& c) {
+		const uint64_t pos = LZ4Frame::read64(entry(c, 1));
+		c[pos + 2] = 0x7F;
+	}), StreamException);
+
+}
+
+TEST(LZ4FrameStream, benchmark) {
+
+	const std::vector<uint8_t> data = getLZ4FrameData(64*1024*1024);
+
+	{
+		ByteArrayOutputStream baos;
+		LZ4OutputStream los(baos, 4*1024*1024);
+		uint64_t s = K::Time::getTimeMS();
+		los.write(data.data(), data.size());
+		los.flush();
+		uint64_t e = K::Time::getTimeMS();
+		std::cout << "LZ4OutputStream (4 MiB buffer): " << (e-s) << " ms" << std::endl;
+	}
+
+	ByteArrayOutputStream baos;
+	{
+		LZ4FrameOutputStream los(baos);
+		uint64_t s = K::Time::getTimeMS();
+		los.write(data.data(), data.size());
+		los.close();
+		uint64_t e = K::Time::getTimeMS();
+		std::cout << "LZ4FrameOutputStream (4 MiB blocks, parallel): " << (e-s) << " ms, " << baos.getDataLength() << " bytes" << std::endl;
+	}
+
+	{
+		ByteArrayInputStream bais(baos.getData(), baos.getDataLength());
+		LZ4FrameInputStream lis(bais);
+		std::vector<uint8_t> buf(1024*1024);
+		uint64_t s = K::Time::getTimeMS();
+		size_t total = 0;
+		while (true) {
+			const ssize_t read = lis.read(buf.data(), buf.size());
+			if (read == -1) {break;}
+			total += (size_t) read;
+		}
+		uint64_t e = K::Time::getTimeMS();
+		ASSERT_EQ(data.size(), total);
+		std::cout << "LZ4FrameInputStream (parallel): " << (e-s) << " ms" << std::endl;
+	}
+
+}
+
+#endif
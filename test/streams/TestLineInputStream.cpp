@@ -16,6 +16,8 @@
 #include "../../streams/BufferedInputStream.h"
 #include "../../streams/ByteArrayInputStream.h"
 
+#include <vector>
+
 using namespace K;
 
 TEST(LineInputStream, readLines) {
@@ -51,4 +53,27 @@ TEST(LineInputStream, readLines) {
 
 }
 
+TEST(LineInputStream, readLinesBlocks) {
+
+	// many (non-empty) lines with all kinds of line-breaks, split into arbitrary blocks
+	std::vector<std::string> lines;
+	std::string str;
+	const char* breaks[] = {"\n", "\r\n", "\r"};
+	for (int i = 0; i < 2000; ++i) {
+		lines.push_back(std::string((size_t) (rand() % 200 + 1), (char) ('a' + i % 26)));
+		str += lines.back() + breaks[i % 3];
+	}
+
+	for (int mirror = 0; mirror < 2; ++mirror) {
+		for (unsigned int bs = 1; bs < 10000; bs = bs * 7 + 3) {
+			ByteArrayInputStream bais((uint8_t*) str.data(), (unsigned int) str.length());
+			BufferedInputStream bis(&bais, bs, mirror != 0);
+			LineInputStream lis(&bis);
+			for (const std::string& l : lines) {ASSERT_EQ(l, lis.readLine());}
+			ASSERT_THROW(lis.readLine(), IOException);
+		}
+	}
+
+}
+
 #endif
@@ -0,0 +1,121 @@
+/*
+ * TestLineReader.cpp
+ *
+ */
+
+#ifdef WITH_TESTS
+
+#include "../Test.h"
+
+#include "../../streams/LineReader.h"
+#include "../../streams/LineInputStream.h"
+#include "../../streams/ByteArrayInputStream.h"
+#include "../../os/Time.h"
+
+#include <vector>
+
+using namespace K;
+
+TEST(LineReader, findLineBreak) {
+	std::string s(100, 'x');
+	const uint8_t* p = (const uint8_t*) s.data();
+	ASSERT_EQ(nullptr, LineReader::findLineBreak(p, p + s.length()));
+	for (size_t i = 0; i < s.length(); ++i) {
+		for (char c : {'\n', '\r'}) {
+			std::string t = s;
+			t[i] = c;
+			const uint8_t* q = (const uint8_t*) t.data();
+			ASSERT_EQ(q + i, LineReader::findLineBreak(q, q + t.length()));
+			ASSERT_EQ(nullptr, LineReader::findLineBreak(q + i + 1, q + t.length()));
+		}
+	}
+}
+
+TEST(LineReader, views) {
+
+	// the "\r\n" of each line is split at every possible block boundary
+	const std::string str = "first\r\nsecond\n\r\nfourth\rfifth\r\n\nlast";
+	const std::vector<std::string> lines = {"first", "second", "", "fourth", "fifth", "", "last"};
+
+	for (unsigned int bs = 1; bs < 40; ++bs) {
+		ByteArrayInputStream bais((uint8_t*) str.data(), (unsigned int) str.length());
+		BufferedInputStream bis(&bais, bs);
+		LineReader lr(&bis);
+		LineView view;
+		for (const std::string& l : lines) {
+			ASSERT_TRUE(lr.readLine(view));
+			ASSERT_TRUE(view == l);
+		}
+		ASSERT_FALSE(lr.readLine(view));
+	}
+
+}
+
+TEST(LineReader, payloadRemains) {
+
+	// only the header lines are consumed, the payload remains within the stream
+	const std::string str = "GET / HTTP/1.1\r\nHost: a\r\n\r\npayload";
+	ByteArrayInputStream bais((uint8_t*) str.data(), (unsigned int) str.length());
+	BufferedInputStream bis(&bais);
+	LineInputStream lis(&bis);
+
+	std::string line;
+	ASSERT_TRUE(lis.readLine(line));	ASSERT_EQ("GET / HTTP/1.1", line);
+	ASSERT_TRUE(lis.readLine(line));	ASSERT_EQ("Host: a", line);
+	ASSERT_TRUE(lis.readLine(line));	ASSERT_EQ("", line);
+
+	uint8_t buf[16];
+	ASSERT_EQ(7, bis.read(buf, 16));
+	ASSERT_EQ("payload", std::string((const char*) buf, 7));
+
+}
+
+TEST(LineReader, maxLineLength) {
+
+	const std::string str = std::string(100, 'a') + "\n" + std::string(1000, 'b') + "\n";
+	ByteArrayInputStream bais((uint8_t*) str.data(), (unsigned int) str.length());
+	BufferedInputStream bis(&bais, 64);
+	LineReader lr(&bis, 500);
+
+	std::string line;
+	ASSERT_TRUE(lr.readLine(line));
+	ASSERT_EQ(100u, line.length());
+	ASSERT_THROW(lr.readLine(line), IOException);
+
+}
+
+TEST(LineReader, benchmark) {
+
+	std::string str;
+	for (int i = 0; i < 200000; ++i) {str += "Content-Type: text/html; charset=UTF-8\r\n";}
+
+	// byte by byte (not buffered)
+	{
+		ByteArrayInputStream bais((uint8_t*) str.data(), (unsigned int) str.length());
+		LineInputStream lis(&bais);
+		uint64_t s = K::Time::getTimeMS();
+		size_t cnt = 0;
+		std::string line;
+		while (lis.readLine(line)) {++cnt;}
+		uint64_t e = K::Time::getTimeMS();
+		ASSERT_EQ(200000u, cnt);
+		std::cout << "lines, byte by byte: " << (e-s) << " ms" << std::endl;
+	}
+
+	// views into the buffer
+	{
+		ByteArrayInputStream bais((uint8_t*) str.data(), (unsigned int) str.length());
+		BufferedInputStream bis(&bais);
+		LineReader lr(&bis);
+		uint64_t s = K::Time::getTimeMS();
+		size_t cnt = 0;
+		LineView view;
+		while (lr.readLine(view)) {++cnt;}
+		uint64_t e = K::Time::getTimeMS();
+		ASSERT_EQ(200000u, cnt);
+		std::cout << "lines, buffered views: " << (e-s) << " ms" << std::endl;
+	}
+
+}
+
+#endif
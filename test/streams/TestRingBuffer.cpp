@@ -0,0 +1,112 @@
+/*
+ * TestRingBuffer.cpp
+ *
+ */
+
+#ifdef WITH_TESTS
+#include "../Test.h"
+#include <cstdint>
+#include <vector>
+#include "../../streams/RingBuffer.h"
+
+using namespace K;
+
+TEST(RingBuffer, addGet) {
+
+	RingBuffer<uint16_t> buf(16);
+	for (unsigned int i = 0; i < 1000; ++i) {buf.add((uint16_t) i);}
+	ASSERT_EQ(1000u, buf.getNumUsed());
+	ASSERT_EQ(1024u, buf.getCapacity());
+
+	for (unsigned int i = 0; i < 1000; ++i) {
+		ASSERT_EQ((uint16_t) i, buf[0]);
+		ASSERT_EQ((uint16_t) i, buf.peek());
+		ASSERT_EQ((uint16_t) i, buf.get());
+	}
+	ASSERT_TRUE(buf.empty());
+
+}
+
+/** write and read in random chunks, crossing the wrap-around many times */
+static void checkSpans(const bool mirror) {
+
+	RingBuffer<uint8_t> buf(4096, mirror);
+	uint8_t wr = 0;
+	uint8_t rd = 0;
+	size_t total = 0;
+
+	for (int run = 0; run < 20000; ++run) {
+
+		// producer: write into the writable span, without growing the buffer
+		const size_t want = (size_t) (rand() % 700) + 1;
+		if (buf.getNumFree() >= want && (mirror || buf.getCapacity() == 4096)) {
+			RingBufferSpan<uint8_t> span = buf.getWritable(1);
+			const size_t cnt = std::min(want, span.len);
+			for (size_t i = 0; i < cnt; ++i) {span.data[i] = wr++;}
+			buf.commit(cnt);
+		}
+
+		// consumer: use the readable span
+		RingBufferSpan<const uint8_t> span = buf.getReadable();
+		if (mirror) {ASSERT_EQ(buf.getNumUsed(), span.len);}
+		const size_t cnt = std::min(span.len, (size_t) (rand() % 600));
+		for (size_t i = 0; i < cnt; ++i) {ASSERT_EQ(rd++, span.data[i]);}
+		buf.consume(cnt);
+		total += cnt;
+
+	}
+
+	ASSERT_EQ(4096u, buf.getCapacity());
+	ASSERT_LT(1000000u, total);
+
+}
+
+TEST(RingBuffer, spans) {
+	checkSpans(false);
+}
+
+TEST(RingBuffer, spansMirrored) {
+	RingBuffer<uint8_t> buf(4096, true);
+#if defined(__linux__)
+	ASSERT_TRUE(buf.isMirrored());
+#endif
+	checkSpans(true);
+}
+
+TEST(RingBuffer, contiguous) {
+
+	for (int mirror = 0; mirror < 2; ++mirror) {
+
+		RingBuffer<int> buf(64, mirror != 0);
+		int v = 0;
+		for (int i = 0; i < 50; ++i) {buf.add(v++);}
+		buf.consume(40);
+		for (int i = 0; i < 40; ++i) {buf.add(v++);}			// wraps
+
+		// ensure a contiguous readable span
+		RingBufferSpan<const int> span = buf.getReadable(50);
+		ASSERT_EQ(50u, span.len);
+		for (int i = 0; i < 50; ++i) {ASSERT_EQ(40 + i, span.data[i]);}
+
+		// a larger writable span than available: grows
+		RingBufferSpan<int> ws = buf.getWritable(100);
+		ASSERT_LE(100u, ws.len);
+		for (int i = 0; i < 100; ++i) {ws.data[i] = v++;}
+		buf.commit(100);
+
+		std::vector<int> out(200);
+		ASSERT_EQ(150u, buf.read(out.data(), 200));
+		for (int i = 0; i < 150; ++i) {ASSERT_EQ(40 + i, out[i]);}
+
+	}
+
+}
+
+TEST(RingBuffer, bounds) {
+	RingBuffer<uint8_t> buf(16);
+	buf.add((uint8_t) 1);
+	ASSERT_THROW(buf.consume(2), Exception);
+	ASSERT_THROW(buf.commit(100), Exception);
+}
+
+#endif
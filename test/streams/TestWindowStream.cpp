@@ -6,6 +6,10 @@
 #include "../../streams/window/WindowInputStream.h"
 #include "../../streams/ByteArrayInOutStream.h"
 #include "../../streams/FileInputStream.h"
+#include "../../streams/window/TrieStream.h"
+#include "../../os/Time.h"
+
+#include <cmath>
 
 using namespace K;
 
@@ -117,4 +121,122 @@ TEST(WindowStream, test5) {
 }
 
 
+
+/** binary test data: records of counters, floats and some noise */
+static std::vector<uint8_t> getWindowBinary(const size_t len) {
+	std::vector<uint8_t> data;
+	data.reserve(len + 16);
+	uint32_t cnt = 0;
+	while (data.size() < len) {
+		const float f = std::sin((float) cnt * 0.01f);
+		const uint8_t* pf = (const uint8_t*) &f;
+		const uint8_t* pc = (const uint8_t*) &cnt;
+		data.insert(data.end(), pc, pc + 4);
+		data.insert(data.end(), pf, pf + 4);
+		data.push_back((uint8_t) (rand() % 4));
+		++cnt;
+	}
+	data.resize(len);
+	return data;
+}
+
+static std::vector<uint8_t> getWindowText(const size_t len) {
+	const std::string s = TestHelper::getLoremIpsum((int) (len / 400 + 1));
+	return std::vector<uint8_t>(s.begin(), s.begin() + len);
+}
+
+static size_t windowCompress(const std::vector<uint8_t>& data, ByteArrayInOutStream& baios, const WindowMatcher matcher, const bool lazy) {
+	WindowOutputStream wos(&baios, matcher, lazy);
+	for (size_t i = 0; i < data.size(); i += 3000) {
+		wos.write(data.data() + i, std::min((size_t) 3000, data.size() - i));
+	}
+	wos.close();
+	return baios.length();
+}
+
+static std::vector<uint8_t> windowDecompress(ByteArrayInOutStream& baios) {
+	WindowInputStream wis(&baios);
+	std::vector<uint8_t> res;
+	while (true) {
+		const int i = wis.read();
+		if (i == -1) {break;}
+		res.push_back((uint8_t) i);
+	}
+	return res;
+}
+
+TEST(WindowStream, hashChain) {
+
+	std::vector<std::vector<uint8_t>> inputs = {
+		{},
+		{'a'},
+		{'a','b','c','a','b','c','a','b','c'},
+		std::vector<uint8_t>(100000, 0),
+		getWindowText(200000),
+		getWindowBinary(200000),
+	};
+
+	for (const std::vector<uint8_t>& data : inputs) {
+		for (bool lazy : {false, true}) {
+			ByteArrayInOutStream baios;
+			windowCompress(data, baios, WindowMatcher::HASH_CHAIN, lazy);
+			ASSERT_EQ(data, windowDecompress(baios));
+		}
+	}
+
+}
+
+/** larger than the window: slides the finder's buffer and wraps the decoder's window */
+TEST(WindowStream, hashChainLarge) {
+
+	std::vector<uint8_t> data = getWindowText(1500000);
+	const std::vector<uint8_t> bin = getWindowBinary(1500000);
+	data.insert(data.end(), bin.begin(), bin.end());
+
+	ByteArrayInOutStream baios;
+	const size_t size = windowCompress(data, baios, WindowMatcher::HASH_CHAIN, true);
+	ASSERT_LT(size, data.size() * 3 / 4);
+	ASSERT_EQ(data, windowDecompress(baios));
+
+}
+
+TEST(WindowStream, benchmark) {
+
+	// the index list is quadratic: compare all on a small input, the hash chains also on a large one
+	for (const size_t len : {(size_t) 16*1024, (size_t) 1024*1024}) {
+
+		const std::vector<std::pair<std::string, std::vector<uint8_t>>> corpora = {
+			{"text", getWindowText(len)},
+			{"binary", getWindowBinary(len)},
+		};
+
+		for (const auto& corpus : corpora) {
+
+			const std::vector<uint8_t>& data = corpus.second;
+
+			for (int mode = (len > 16*1024) ? (1) : (0); mode < 3; ++mode) {
+				const WindowMatcher matcher = (mode == 0) ? (WindowMatcher::INDEX_LIST) : (WindowMatcher::HASH_CHAIN);
+				const bool lazy = (mode == 2);
+				ByteArrayInOutStream baios;
+				const uint64_t s = K::Time::getTimeMS();
+				const size_t size = windowCompress(data, baios, matcher, lazy);
+				const uint64_t e = K::Time::getTimeMS();
+				const char* name = (mode == 0) ? ("index list") : (mode == 1) ? ("hash chain") : ("hash chain + lazy");
+				std::cout << corpus.first << " " << name << ": " << (e-s) << " ms, " << data.size() << " -> " << size << std::endl;
+			}
+
+			ByteArrayInOutStream baios;
+			const uint64_t s = K::Time::getTimeMS();
+			TrieStream ts(&baios);
+			ts.write(data.data(), data.size());
+			ts.close();
+			const uint64_t e = K::Time::getTimeMS();
+			std::cout << corpus.first << " trie: " << (e-s) << " ms, " << data.size() << " -> " << baios.length() << std::endl;
+
+		}
+
+	}
+
+}
+
 #endif
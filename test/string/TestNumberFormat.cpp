@@ -0,0 +1,73 @@
+#ifdef WITH_TESTS
+
+#include "../Test.h"
+#include "../../string/NumberFormat.h"
+#include <random>
+#include <string>
+using namespace K;
+
+static std::string numberFormat(const double v) {
+	char buf[NumberFormat::MAX_DOUBLE_LEN];
+	return std::string(buf, NumberFormat::format(v, buf));
+}
+
+TEST(NumberFormat, integers) {
+
+	char buf[NumberFormat::MAX_INT_LEN + 1];
+	std::minstd_rand gen(1337);
+	for (int i = 0; i < 100000; ++i) {
+		const int64_t v = (int64_t) (((uint64_t) gen() << 40) ^ ((uint64_t) gen() << 20) ^ gen()) >> (i % 64);
+		ASSERT_EQ(std::to_string(v), std::string(buf, NumberFormat::format(v, buf)));
+	}
+
+	ASSERT_EQ("0", std::string(buf, NumberFormat::format((int64_t) 0, buf)));
+	ASSERT_EQ("-9223372036854775808", std::string(buf, NumberFormat::format(INT64_MIN, buf)));
+	ASSERT_EQ("18446744073709551615", std::string(buf, NumberFormat::format(UINT64_MAX, buf)));
+
+}
+
+TEST(NumberFormat, doubles) {
+
+	ASSERT_EQ("1.0", numberFormat(1.0));
+	ASSERT_EQ("-2.5", numberFormat(-2.5));
+	ASSERT_EQ("0.1", numberFormat(0.1));
+	ASSERT_EQ("0.30000000000000004", numberFormat(0.1 + 0.2));
+	ASSERT_EQ("123456.789", numberFormat(123456.789));
+	ASSERT_EQ("100000000000000000000.0", numberFormat(1e20));
+	ASSERT_EQ("1e21", numberFormat(1e21));
+	ASSERT_EQ("0.000001", numberFormat(1e-6));
+	ASSERT_EQ("1e-7", numberFormat(1e-7));
+	ASSERT_EQ("5e-324", numberFormat(5e-324));
+	ASSERT_EQ("1.7976931348623157e308", numberFormat(1.7976931348623157e308));
+	ASSERT_EQ("-0.0", numberFormat(-0.0));
+	ASSERT_EQ("0.0", numberFormat(0.0));
+	ASSERT_EQ("NaN", numberFormat(NAN));
+	ASSERT_EQ("-Infinity", numberFormat(-INFINITY));
+
+	// round-trip and shortest (compared with the shortest printf precision)
+	std::mt19937_64 gen(1337);
+	for (int i = 0; i < 20000; ++i) {
+		const uint64_t bits = gen();
+		double v;
+		memcpy(&v, &bits, 8);
+		if (i % 2) {v = std::uniform_real_distribution<double>(-1000, 1000)(gen);}
+		if (!std::isfinite(v) || v == 0) {continue;}
+
+		const std::string str = numberFormat(v);
+		ASSERT_EQ(v, strtod(str.c_str(), nullptr)) << str;
+
+		char digits[18];
+		int exp10;
+		const int len = NumberFormat::shortest(std::fabs(v), digits, exp10);
+		char tmp[40];
+		int prec = 1;
+		for (; prec < 17; ++prec) {
+			snprintf(tmp, sizeof(tmp), "%.*e", prec - 1, v);
+			if (strtod(tmp, nullptr) == v) {break;}
+		}
+		ASSERT_EQ(prec, len) << str;
+	}
+
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifdef WITH_TESTS
+
+#include "../Test.h"
+#include "../../string/NumberParser.h"
+#include <random>
+#include <cmath>
+
+using namespace K;
+
+static const char* parseStr(const std::string& str, double& res) {
+	return NumberParser::parse(str.data(), str.data() + str.size(), res);
+}
+
+TEST(NumberParser, doubles) {
+
+	double d;
+	ASSERT_NE(nullptr, parseStr("1.5", d));		ASSERT_EQ(1.5, d);
+	ASSERT_NE(nullptr, parseStr("-.25", d));	ASSERT_EQ(-0.25, d);
+	ASSERT_NE(nullptr, parseStr("+3e2", d));	ASSERT_EQ(300.0, d);
+	ASSERT_NE(nullptr, parseStr("5.", d));		ASSERT_EQ(5.0, d);
+	ASSERT_NE(nullptr, parseStr("1e400", d));	ASSERT_TRUE(std::isinf(d));
+	ASSERT_EQ(nullptr, parseStr("", d));
+	ASSERT_EQ(nullptr, parseStr("-", d));
+	ASSERT_EQ(nullptr, parseStr(".", d));
+	ASSERT_EQ(nullptr, parseStr("x", d));
+
+	// stops behind the number. an exponent without digits is not consumed
+	const std::string str = "12.5e 7";
+	ASSERT_EQ(str.data() + 4, parseStr(str, d));
+	ASSERT_EQ(12.5, d);
+
+	// the range's end is respected (no null-termination)
+	ASSERT_EQ(str.data() + 2, NumberParser::parse(str.data(), str.data() + 2, d));
+	ASSERT_EQ(12.0, d);
+
+	// fast and slow path must match strtod
+	std::minstd_rand gen(1337);
+	std::uniform_real_distribution<double> dVal(-1e6, 1e6);
+	std::uniform_int_distribution<int> dExp(-330, 310);
+	for (int i = 0; i < 100000; ++i) {
+		char tmp[64];
+		snprintf(tmp, sizeof(tmp), (i % 3 == 0) ? "%.17g" : (i % 3 == 1) ? "%.6fe%d" : "%.3f", dVal(gen), dExp(gen));
+		ASSERT_NE(nullptr, parseStr(tmp, d));
+		ASSERT_EQ(strtod(tmp, nullptr), d) << tmp;
+	}
+
+}
+
+TEST(NumberParser, ints) {
+
+	const std::string str = "-9223372036854775807 42/7 +5";
+	const char* end = str.data() + str.size();
+	int64_t i = 0;
+	int32_t j = 0;
+
+	const char* p = NumberParser::parse(str.data(), end, i);
+	ASSERT_EQ(-9223372036854775807LL, i);
+	p = NumberParser::parse(p + 1, end, j);
+	ASSERT_EQ(42, j);
+	ASSERT_EQ('/', *p);
+	p = NumberParser::parse(p + 1, end, j);
+	ASSERT_EQ(7, j);
+	p = NumberParser::parse(p + 1, end, j);
+	ASSERT_EQ(5, j);
+	ASSERT_EQ(end, p);
+
+	ASSERT_EQ(nullptr, NumberParser::parse(end, end, j));
+	ASSERT_EQ(nullptr, NumberParser::parse(str.data() + 20, end, j));
+	ASSERT_EQ(nullptr, NumberParser::parse(str.data(), str.data() + 1, i));
+
+}
+
+#endif